@@ -0,0 +1,408 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+#if JUCE_LINUX || JUCE_MAC
+#include <sys/resource.h>
+#endif
+
+class OfflineBenchmark::Instance : public Thread
+{
+public:
+
+	Instance(const Settings& settings_, const MidiMessageSequence& sequence_, double lengthSeconds_, int index_) :
+		Thread("Benchmark Thread " + String(index_ + 1)),
+		index(index_),
+		settings(settings_),
+		sequence(sequence_),
+		lengthSeconds(lengthSeconds_)
+	{
+		processor = new BackendProcessor();
+	}
+
+	~Instance()
+	{
+		stopThread(5000);
+		processor = nullptr;
+	}
+
+	bool loadPreset()
+	{
+		ModulatorSynthChain* chain = processor->getMainSynthChain();
+
+		const File projectDirectory = settings.presetFile.getParentDirectory().getParentDirectory();
+
+		GET_PROJECT_HANDLER(chain).setWorkingProject(projectDirectory, nullptr);
+
+		FileInputStream fis(settings.presetFile);
+
+		ValueTree v = ValueTree::readFromStream(fis);
+
+		if (!v.isValid() || v.getProperty("Type", var::undefined()).toString() != "SynthChain")
+			return false;
+
+		processor->prepareToPlay(settings.sampleRate, settings.blockSize);
+		processor->loadPreset(v);
+
+		return true;
+	}
+
+	void run() override
+	{
+		AudioSampleBuffer buffer(2, settings.blockSize);
+		MidiBuffer midiBuffer;
+
+		const int64 numSamplesToRender = (int64)((lengthSeconds + settings.tailSeconds) * settings.sampleRate);
+		const double blockSeconds = (double)settings.blockSize / settings.sampleRate;
+
+		const int streamingFailuresBefore = processor->getDebugLogger().getNumStreamingFailures();
+
+		ProcessorProfiler& profiler = processor->getProcessorProfiler();
+		const bool shouldProfile = settings.profileFile != File();
+
+		profiler.setEnabled(shouldProfile);
+
+		int eventIndex = 0;
+		int64 samplePosition = 0;
+
+		const double startTime = Time::getMillisecondCounterHiRes();
+
+		while (samplePosition < numSamplesToRender && !threadShouldExit())
+		{
+			const double blockEndSeconds = (double)(samplePosition + settings.blockSize) / settings.sampleRate;
+
+			midiBuffer.clear();
+
+			while (eventIndex < sequence.getNumEvents())
+			{
+				const MidiMessage& m = sequence.getEventPointer(eventIndex)->message;
+
+				if (m.getTimeStamp() >= blockEndSeconds)
+					break;
+
+				const int offset = jlimit<int>(0, settings.blockSize - 1, (int)(m.getTimeStamp() * settings.sampleRate) - (int)samplePosition);
+
+				midiBuffer.addEvent(m, offset);
+				eventIndex++;
+			}
+
+			buffer.clear();
+
+			const double blockStart = Time::getMillisecondCounterHiRes();
+
+			processor->processBlock(buffer, midiBuffer);
+
+			const double blockMilliseconds = Time::getMillisecondCounterHiRes() - blockStart;
+
+			// This is the only thread that drains the profiler, so the queues never fill up between two blocks
+			if (shouldProfile)
+				profiler.drain();
+
+			result.worstBlockMilliseconds = jmax<double>(result.worstBlockMilliseconds, blockMilliseconds);
+			result.numBlocks++;
+
+			samplePosition += settings.blockSize;
+
+			if (settings.renderInRealtime)
+			{
+				const double deadline = startTime + 1000.0 * (double)result.numBlocks * blockSeconds;
+				const int millisecondsToWait = (int)(deadline - Time::getMillisecondCounterHiRes());
+
+				if (millisecondsToWait > 0)
+					Thread::sleep(millisecondsToWait);
+			}
+			else
+			{
+				result.renderSeconds += blockMilliseconds * 0.001;
+			}
+		}
+
+		if (settings.renderInRealtime)
+			result.renderSeconds = (Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+
+		result.audioSeconds = (double)samplePosition / settings.sampleRate;
+		result.numStreamingUnderruns = processor->getDebugLogger().getNumStreamingFailures() - streamingFailuresBefore;
+		result.sampleMemory = (int64)processor->getSampleManager().getModulatorSamplerSoundPool()->getMemoryUsageForAllSamples();
+
+		if (shouldProfile)
+		{
+			File profileFile = settings.profileFile;
+
+			if (settings.numThreads > 1)
+				profileFile = profileFile.getSiblingFile(profileFile.getFileNameWithoutExtension() + String(index + 1) + profileFile.getFileExtension());
+
+			profiler.writeJSONDumpToFile(profileFile);
+			profiler.setEnabled(false);
+
+			result.numDroppedProfilerRecords = profiler.getNumDroppedRecords();
+		}
+	}
+
+	const ThreadResult& getResult() const { return result; }
+
+private:
+
+	const int index;
+
+	const Settings& settings;
+	const MidiMessageSequence& sequence;
+	const double lengthSeconds;
+
+	ScopedPointer<BackendProcessor> processor;
+
+	ThreadResult result;
+};
+
+OfflineBenchmark::OfflineBenchmark(const Settings& settings_) :
+	settings(settings_)
+{
+
+}
+
+OfflineBenchmark::~OfflineBenchmark()
+{
+	instances.clear();
+}
+
+OfflineBenchmark::ErrorCodes OfflineBenchmark::benchmarkFromCommandLine(const String& commandLine)
+{
+	const String options = commandLine.fromFirstOccurrenceOf("benchmark ", false, false);
+
+	StringArray args = StringArray::fromTokens(options, true);
+
+	Settings s;
+
+	ErrorCodes result = parseSettings(args, s);
+
+	if (result != OK)
+		return result;
+
+	CompileExporter::setExportingFromCommandLine();
+
+	OfflineBenchmark benchmark(s);
+
+	result = benchmark.run();
+
+	if (result != OK)
+		return result;
+
+	const String json = JSON::toString(benchmark.getResultAsJSON());
+
+	if (s.outputFile != File())
+	{
+		if (!s.outputFile.replaceWithText(json))
+			return OutputFileNotWritable;
+	}
+	else
+	{
+		std::cout << json << std::endl;
+	}
+
+	return OK;
+}
+
+String OfflineBenchmark::getErrorMessage(ErrorCodes code)
+{
+	switch (code)
+	{
+	case OK:					return "OK";
+	case MissingArguments:		return "Missing arguments";
+	case PresetIsInvalid:		return "The preset file is not valid";
+	case MidiFileIsInvalid:		return "The MIDI file is not valid";
+	case InvalidSettings:		return "Invalid sample rate, block size or thread count";
+	case OutputFileNotWritable:	return "The output file can't be written";
+	case numErrorCodes:			break;
+	}
+
+	return String();
+}
+
+OfflineBenchmark::ErrorCodes OfflineBenchmark::parseSettings(const StringArray& args, Settings& s)
+{
+	if (args.size() < 2)
+		return MissingArguments;
+
+	s.presetFile = File(args[0].unquoted());
+
+	if (!s.presetFile.existsAsFile())
+		return PresetIsInvalid;
+
+	for (int i = 1; i < args.size(); i++)
+	{
+		const String arg = args[i];
+
+		if (arg.startsWith("-m:"))				s.midiFile = File(arg.fromFirstOccurrenceOf("-m:", false, false).unquoted());
+		else if (arg.startsWith("-o:"))			s.outputFile = File(arg.fromFirstOccurrenceOf("-o:", false, false).unquoted());
+		else if (arg.startsWith("-profile:"))	s.profileFile = File(arg.fromFirstOccurrenceOf("-profile:", false, false).unquoted());
+		else if (arg.startsWith("-sr:"))		s.sampleRate = arg.fromFirstOccurrenceOf("-sr:", false, false).getDoubleValue();
+		else if (arg.startsWith("-bs:"))		s.blockSize = arg.fromFirstOccurrenceOf("-bs:", false, false).getIntValue();
+		else if (arg.startsWith("-t:"))			s.numThreads = arg.fromFirstOccurrenceOf("-t:", false, false).getIntValue();
+		else if (arg.startsWith("-tail:"))		s.tailSeconds = arg.fromFirstOccurrenceOf("-tail:", false, false).getDoubleValue();
+		else if (arg == "-realtime")			s.renderInRealtime = true;
+	}
+
+	if (!s.midiFile.existsAsFile())
+		return MidiFileIsInvalid;
+
+	if (s.sampleRate <= 0.0 || s.blockSize <= 0 || s.numThreads <= 0 || s.tailSeconds < 0.0)
+		return InvalidSettings;
+
+	return OK;
+}
+
+OfflineBenchmark::ErrorCodes OfflineBenchmark::run()
+{
+	MidiFile midiFile;
+
+	FileInputStream fis(settings.midiFile);
+
+	if (fis.failedToOpen() || !midiFile.readFrom(fis))
+		return MidiFileIsInvalid;
+
+	midiFile.convertTimestampTicksToSeconds();
+
+	sequence.clear();
+
+	for (int i = 0; i < midiFile.getNumTracks(); i++)
+		sequence.addSequence(*midiFile.getTrack(i), 0.0, 0.0, 1.0e12);
+
+	sequence.updateMatchedPairs();
+
+	sequenceLengthSeconds = sequence.getEndTime();
+
+	const double loadStart = Time::getMillisecondCounterHiRes();
+
+	instances.clear();
+
+	for (int i = 0; i < settings.numThreads; i++)
+	{
+		Instance* instance = new Instance(settings, sequence, sequenceLengthSeconds, i);
+
+		instances.add(instance);
+
+		if (!instance->loadPreset())
+			return PresetIsInvalid;
+	}
+
+	loadingSeconds = (Time::getMillisecondCounterHiRes() - loadStart) * 0.001;
+
+	for (int i = 0; i < instances.size(); i++)
+		instances[i]->startThread(9);
+
+	for (int i = 0; i < instances.size(); i++)
+		instances[i]->waitForThreadToExit(-1);
+
+	results.clear();
+
+	for (int i = 0; i < instances.size(); i++)
+		results.add(instances[i]->getResult());
+
+	instances.clear();
+
+	return OK;
+}
+
+var OfflineBenchmark::getResultAsJSON() const
+{
+	DynamicObject::Ptr obj = new DynamicObject();
+
+	obj->setProperty("Version", 1);
+	obj->setProperty("Preset", settings.presetFile.getFileName());
+	obj->setProperty("MidiFile", settings.midiFile.getFileName());
+	obj->setProperty("SampleRate", settings.sampleRate);
+	obj->setProperty("BlockSize", settings.blockSize);
+	obj->setProperty("NumThreads", settings.numThreads);
+	obj->setProperty("Realtime", settings.renderInRealtime);
+	obj->setProperty("LoadingTime", loadingSeconds);
+
+	double worstRealtimeFactor = 0.0;
+	double worstBlockMilliseconds = 0.0;
+	int numUnderruns = 0;
+	int numDroppedProfilerRecords = 0;
+
+	Array<var> threadList;
+
+	for (int i = 0; i < results.size(); i++)
+	{
+		const ThreadResult& r = results.getReference(i);
+
+		const double realtimeFactor = r.audioSeconds > 0.0 ? r.renderSeconds / r.audioSeconds : 0.0;
+
+		worstRealtimeFactor = jmax<double>(worstRealtimeFactor, realtimeFactor);
+		worstBlockMilliseconds = jmax<double>(worstBlockMilliseconds, r.worstBlockMilliseconds);
+		numUnderruns += r.numStreamingUnderruns;
+		numDroppedProfilerRecords += r.numDroppedProfilerRecords;
+
+		DynamicObject::Ptr t = new DynamicObject();
+
+		t->setProperty("RealtimeFactor", realtimeFactor);
+		t->setProperty("RenderTime", r.renderSeconds);
+		t->setProperty("AudioLength", r.audioSeconds);
+		t->setProperty("NumBlocks", r.numBlocks);
+		t->setProperty("WorstBlockTime", r.worstBlockMilliseconds);
+		t->setProperty("StreamingUnderruns", r.numStreamingUnderruns);
+		t->setProperty("DroppedProfilerRecords", r.numDroppedProfilerRecords);
+		t->setProperty("SampleMemory", r.sampleMemory);
+
+		threadList.add(var(t));
+	}
+
+	const double blockBudgetMilliseconds = 1000.0 * (double)settings.blockSize / settings.sampleRate;
+
+	obj->setProperty("RealtimeFactor", worstRealtimeFactor);
+	obj->setProperty("WorstBlockTime", worstBlockMilliseconds);
+	obj->setProperty("WorstBlockPercentage", 100.0 * worstBlockMilliseconds / blockBudgetMilliseconds);
+	obj->setProperty("StreamingUnderruns", numUnderruns);
+	obj->setProperty("DroppedProfilerRecords", numDroppedProfilerRecords);
+	obj->setProperty("PeakMemory", getPeakMemoryUsage());
+	obj->setProperty("Threads", threadList);
+
+	return var(obj);
+}
+
+int64 OfflineBenchmark::getPeakMemoryUsage()
+{
+#if JUCE_LINUX || JUCE_MAC
+	struct rusage usage;
+
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+
+#if JUCE_MAC
+	return (int64)usage.ru_maxrss;
+#else
+	return (int64)usage.ru_maxrss * 1024;
+#endif
+
+#else
+	return 0;
+#endif
+}
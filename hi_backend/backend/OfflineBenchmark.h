@@ -0,0 +1,131 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+#ifndef OFFLINEBENCHMARK_H_INCLUDED
+#define OFFLINEBENCHMARK_H_INCLUDED
+
+/** Renders a preset offline without an audio device and measures the performance.
+*
+*	This is used by the command line mode of the standalone application:
+*
+*		HISE benchmark "File.hip" -m:"File.mid" [-sr:44100] [-bs:512] [-t:1] [-tail:2] [-realtime] [-o:"Result.json"] [-profile:"Profile.json"]
+*
+*	It loads the preset into one BackendProcessor per thread, feeds the given MIDI file into it and renders the
+*	whole sequence as fast as possible (or in real time if -realtime is supplied, which gives the streaming
+*	thread a realistic chance to keep up).
+*
+*	The result is written as JSON object with a fixed set of properties (see getResultAsJSON()), so you can
+*	compare the output between different builds.
+*
+*	If -profile is supplied, the ProcessorProfiler of every instance is enabled and drained after each block by the
+*	rendering thread, and its JSON dump is written to the given file (with the thread number appended if there is
+*	more than one thread). This adds a small overhead to the measured render time.
+*/
+class OfflineBenchmark
+{
+public:
+
+	enum ErrorCodes
+	{
+		OK = 0,
+		MissingArguments,
+		PresetIsInvalid,
+		MidiFileIsInvalid,
+		InvalidSettings,
+		OutputFileNotWritable,
+		numErrorCodes
+	};
+
+	struct Settings
+	{
+		File presetFile;
+		File midiFile;
+		File outputFile;
+		File profileFile;
+
+		double sampleRate = 44100.0;
+		int blockSize = 512;
+		int numThreads = 1;
+		double tailSeconds = 2.0;
+		bool renderInRealtime = false;
+	};
+
+	/** The measurements of a single rendering thread. */
+	struct ThreadResult
+	{
+		double renderSeconds = 0.0;
+		double audioSeconds = 0.0;
+		double worstBlockMilliseconds = 0.0;
+		int numBlocks = 0;
+		int numStreamingUnderruns = 0;
+		int numDroppedProfilerRecords = 0;
+		int64 sampleMemory = 0;
+	};
+
+	OfflineBenchmark(const Settings& settings);
+
+	~OfflineBenchmark();
+
+	/** Parses the command line, runs the benchmark and prints the result. */
+	static ErrorCodes benchmarkFromCommandLine(const String& commandLine);
+
+	static String getErrorMessage(ErrorCodes code);
+
+	/** Loads the preset into every instance and renders the MIDI file. Call this from the message thread. */
+	ErrorCodes run();
+
+	/** Returns the JSON object with the measurements of the last run. */
+	var getResultAsJSON() const;
+
+	/** Returns the peak resident memory of the process in bytes (or 0 if it can't be determined on this platform). */
+	static int64 getPeakMemoryUsage();
+
+private:
+
+	class Instance;
+
+	static ErrorCodes parseSettings(const StringArray& args, Settings& s);
+
+	Settings settings;
+
+	MidiMessageSequence sequence;
+	double sequenceLengthSeconds = 0.0;
+
+	OwnedArray<Instance> instances;
+	Array<ThreadResult> results;
+
+	double loadingSeconds = 0.0;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineBenchmark)
+};
+
+#endif  // OFFLINEBENCHMARK_H_INCLUDED
@@ -0,0 +1,198 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+CpuProfilerTable::CpuProfilerTable(BackendRootWindow* rootWindow) :
+	profiler(rootWindow->getBackendProcessor()->getProcessorProfiler()),
+	font(GLOBAL_FONT())
+{
+	setName(getHeadline());
+
+	addAndMakeVisible(table);
+	table.setModel(this);
+
+	laf = new TableHeaderLookAndFeel();
+
+	table.getHeader().setLookAndFeel(laf);
+	table.getHeader().setSize(getWidth(), 22);
+
+	table.setColour(ListBox::outlineColourId, Colours::black.withAlpha(0.5f));
+	table.setColour(ListBox::backgroundColourId, HiseColourScheme::getColour(HiseColourScheme::ColourIds::DebugAreaBackgroundColourId));
+
+	table.setOutlineThickness(0);
+	table.getViewport()->setScrollBarsShown(true, false, false, false);
+	table.getHeader().setInterceptsMouseClicks(false, false);
+
+	table.getHeader().addColumn("Processor", ProcessorId, 200);
+	table.getHeader().addColumn("Type", Type, 100);
+	table.getHeader().addColumn("Avg %", Average, 60);
+	table.getHeader().addColumn("Peak %", Peak, 60);
+	table.getHeader().addColumn("Self %", Self, 60);
+	table.getHeader().addColumn("Calls", CallsPerBlock, 50);
+
+	table.addMouseListener(this, true);
+
+	rebuildTree();
+
+	startTimer(500);
+}
+
+CpuProfilerTable::~CpuProfilerTable()
+{
+	stopTimer();
+}
+
+void CpuProfilerTable::timerCallback()
+{
+	if (!profiler.isEnabled())
+		return;
+
+	profiler.drain();
+	rebuildTree();
+}
+
+void CpuProfilerTable::rebuildTree()
+{
+	rows.clear();
+
+	root = profiler.createTree();
+	root->addToFlatList(rows);
+
+	setName(getHeadline());
+
+	table.updateContent();
+	table.repaint();
+
+	if (getParentComponent() != nullptr) getParentComponent()->repaint();
+}
+
+int CpuProfilerTable::getNumRows()
+{
+	return rows.size();
+}
+
+void CpuProfilerTable::paintRowBackground(Graphics& g, int rowNumber, int /*width*/, int /*height*/, bool rowIsSelected)
+{
+	if (rowNumber % 2) g.fillAll(Colours::white.withAlpha(0.05f));
+
+	if (rowIsSelected)
+		g.fillAll(Colour(0x44000000));
+}
+
+void CpuProfilerTable::paintCell(Graphics& g, int rowNumber, int columnId, int width, int height, bool /*rowIsSelected*/)
+{
+	if (const ProcessorProfiler::Node* n = rows[rowNumber])
+	{
+		g.setColour(Colours::white.withAlpha(.8f));
+		g.setFont(font);
+
+		String text;
+		int offset = 2;
+
+		switch (columnId)
+		{
+		case ProcessorId:	text = n->id; offset += n->depth * 10; break;
+		case Type:			text = n->type; break;
+		case Average:		text = String(n->averagePercentage, 2); break;
+		case Peak:			text = String(n->peakPercentage, 2); break;
+		case Self:			text = String(n->selfPercentage, 2); break;
+		case CallsPerBlock:	text = String(n->callsPerBlock, 1); break;
+		}
+
+		if (columnId == Peak && n->peakPercentage > 50.0)
+			g.setColour(Colours::red.withAlpha(0.8f));
+
+		g.drawText(text, offset, 0, width - offset - 2, height, Justification::centredLeft, true);
+	}
+}
+
+String CpuProfilerTable::getHeadline() const
+{
+	String x;
+
+	x << "CPU Profiler";
+
+	if (!profiler.isEnabled())
+		x << " (disabled)";
+	else
+		x << " - " << String(profiler.getNumMeasuredBlocks()) << " buffers";
+
+	if (profiler.getNumDroppedRecords() > 0)
+		x << " (" << String(profiler.getNumDroppedRecords()) << " dropped)";
+
+	return x;
+}
+
+void CpuProfilerTable::resized()
+{
+	table.setBounds(getLocalBounds());
+
+	table.getHeader().setColumnWidth(ProcessorId, jmax<int>(100, getWidth() - 300));
+}
+
+void CpuProfilerTable::mouseDown(const MouseEvent &e)
+{
+	if (e.mods.isLeftButtonDown()) return;
+
+	PopupMenu m;
+
+	m.setLookAndFeel(&plaf);
+
+	enum
+	{
+		ToggleProfiling = 1,
+		ResetStatistics,
+		ExportAsJSON,
+		numOperations
+	};
+
+	m.addItem(ToggleProfiling, "Enable profiling", true, profiler.isEnabled());
+	m.addItem(ResetStatistics, "Reset statistics");
+	m.addSeparator();
+	m.addItem(ExportAsJSON, "Export as JSON", profiler.getNumMeasuredBlocks() > 0);
+
+	const int result = m.show();
+
+	switch (result)
+	{
+	case ToggleProfiling:	profiler.setEnabled(!profiler.isEnabled()); rebuildTree(); break;
+	case ResetStatistics:	profiler.reset(); rebuildTree(); break;
+	case ExportAsJSON:
+	{
+		FileChooser fc("Export CPU profile", File::getSpecialLocation(File::userDesktopDirectory), "*.json");
+
+		if (fc.browseForFileToSave(true))
+			profiler.writeJSONDumpToFile(fc.getResult());
+
+		break;
+	}
+	}
+}
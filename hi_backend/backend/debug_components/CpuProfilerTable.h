@@ -0,0 +1,97 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+#ifndef CPUPROFILERTABLE_H_INCLUDED
+#define CPUPROFILERTABLE_H_INCLUDED
+
+/** A table that shows the CPU usage of every processor in a hierarchical view.
+*	@ingroup debugComponents
+*
+*	It periodically drains the ProcessorProfiler of the main controller and rebuilds the processor tree.
+*	Right click to enable the profiling, reset the statistics or export them as JSON file.
+*/
+class CpuProfilerTable : public Component,
+						 public TableListBoxModel,
+						 public Timer
+{
+public:
+
+	enum ColumnId
+	{
+		ProcessorId = 1,
+		Type,
+		Average,
+		Peak,
+		Self,
+		CallsPerBlock,
+		numColumns
+	};
+
+	CpuProfilerTable(BackendRootWindow *rootWindow);
+
+	SET_GENERIC_PANEL_ID("CpuProfiler");
+
+	~CpuProfilerTable();
+
+	void timerCallback() override;
+
+	int getNumRows() override;
+
+	void paintRowBackground(Graphics& g, int rowNumber, int /*width*/, int /*height*/, bool rowIsSelected) override;
+
+	void paintCell(Graphics& g, int rowNumber, int columnId, int width, int height, bool /*rowIsSelected*/) override;
+
+	String getHeadline() const;
+
+	void resized() override;
+
+	void mouseDown(const MouseEvent &e) override;
+
+private:
+
+	void rebuildTree();
+
+	ProcessorProfiler& profiler;
+
+	TableListBox table;
+	Font font;
+
+	ScopedPointer<ProcessorProfiler::Node> root;
+	Array<const ProcessorProfiler::Node*> rows;
+
+	ScopedPointer<TableHeaderLookAndFeel> laf;
+	PopupLookAndFeel plaf;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CpuProfilerTable)
+};
+
+#endif  // CPUPROFILERTABLE_H_INCLUDED
@@ -61,6 +61,7 @@ void SliderPackData::setValue(int sliderIndex, float value, NotificationType not
 	if (sliderIndex >= 0 && sliderIndex < getNumSliders())
 	{
 		values[sliderIndex] = value;
+		++dataVersion;
 
 		if (notifySliderPack == sendNotification)
 		{
@@ -136,11 +137,14 @@ void SliderPackData::fromBase64(const String &encodedValues)
 	{
 		values.append(newData[i]);
 	}
+
+	++dataVersion;
 }
 
 void SliderPackData::setNumSliders(int numSliders)
 {
 	values.resize(numSliders);
+	++dataVersion;
 
 	sendChangeMessage();
 }
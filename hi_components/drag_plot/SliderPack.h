@@ -77,6 +77,7 @@ public:
 	void swapData(Array<var> &otherData)
 	{
 		values = var(otherData);
+		++dataVersion;
 
 		sendChangeMessage();
 	}
@@ -95,6 +96,9 @@ public:
 	bool isFlashActive() const { return flashActive; }
 	bool isValueOverlayShown() const { return showValueOverlay; }
 
+	/** Returns a counter that is increased whenever the values change. */
+	int getDataVersion() const noexcept { return dataVersion.load(); }
+
 private:
 
 	bool flashActive;
@@ -112,6 +116,8 @@ private:
 
 	var values;
 
+	std::atomic<int> dataVersion { 0 };
+
 	//Array<float> values;
 };
 
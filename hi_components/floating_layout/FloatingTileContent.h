@@ -422,6 +422,7 @@ public:
 			toggleGlobalLayoutMode,
 			exportAsJSON,
 			loadFromJSON,
+			CpuProfiler,
 			MenuCommandOffset = 10000,
 
 			numOptions
@@ -52,6 +52,7 @@ void FloatingTileContent::Factory::registerAllPanelTypes()
 	registerType<GenericPanel<PatchBrowser>>(PopupMenuOptions::PatchBrowser);
 	registerType<GenericPanel<FileBrowser>>(PopupMenuOptions::FileBrowser);
 	registerType<GenericPanel<SamplePoolTable>>(PopupMenuOptions::SamplePoolTable);
+	registerType<GenericPanel<CpuProfilerTable>>(PopupMenuOptions::CpuProfiler);
 	registerType<GenericPanel<PoolTableSubTypes::ImageFilePoolTable>>(PopupMenuOptions::ImageTable);
 	registerType<GenericPanel<PoolTableSubTypes::AudioFilePoolTable>>(PopupMenuOptions::AudioFileTable);
 	registerType<MainTopBar>(PopupMenuOptions::MenuCommandOffset);
@@ -556,6 +557,7 @@ void FloatingTileContent::Factory::handlePopupMenu(PopupMenu& m, FloatingTile* p
 		addToPopupMenu(m, PopupMenuOptions::PatchBrowser, "Patch Browser");
 		addToPopupMenu(m, PopupMenuOptions::FileBrowser, "File Browser");
 		addToPopupMenu(m, PopupMenuOptions::SamplePoolTable, "SamplePoolTable");
+		addToPopupMenu(m, PopupMenuOptions::CpuProfiler, "CPU Profiler");
 		addToPopupMenu(m, PopupMenuOptions::SliderPackPanel, "Array Editor");
 		addToPopupMenu(m, PopupMenuOptions::MidiKeyboard, "Virtual Keyboard");
 		addToPopupMenu(m, PopupMenuOptions::PopoutButton, "Popout Button");
@@ -642,6 +644,7 @@ void FloatingTileContent::Factory::handlePopupMenu(PopupMenu& m, FloatingTile* p
 	case PopupMenuOptions::FileBrowser:			parent->setNewContent(GET_PANEL_NAME(GenericPanel<FileBrowser>)); break;
 	case PopupMenuOptions::ModuleBrowser:		parent->setNewContent(GET_PANEL_NAME(GenericPanel<ModuleBrowser>)); break;
 	case PopupMenuOptions::SamplePoolTable:		parent->setNewContent(GET_PANEL_NAME(GenericPanel<SamplePoolTable>)); break;
+	case PopupMenuOptions::CpuProfiler:			parent->setNewContent(GET_PANEL_NAME(GenericPanel<CpuProfilerTable>)); break;
 	case PopupMenuOptions::AudioFileTable:		parent->setNewContent(GET_PANEL_NAME(GenericPanel<PoolTableSubTypes::AudioFilePoolTable>)); break;
 	case PopupMenuOptions::ImageTable:			parent->setNewContent(GET_PANEL_NAME(GenericPanel<PoolTableSubTypes::ImageFilePoolTable>)); break;
 	case PopupMenuOptions::ScriptWatchTable:		parent->setNewContent(GET_PANEL_NAME(GenericPanel<ScriptWatchTable>)); break;
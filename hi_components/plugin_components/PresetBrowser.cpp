@@ -44,8 +44,9 @@ void PresetBrowserColumn::ButtonLookAndFeel::drawButtonText(Graphics& g, TextBut
 	g.drawText(button.getButtonText(), 0, 0, button.getWidth(), button.getHeight(), Justification::centred);
 }
 
-PresetBrowserColumn::ColumnListModel::ColumnListModel(int index_, Listener* listener_) :
+PresetBrowserColumn::ColumnListModel::ColumnListModel(const MainController::UserPresetHandler::PresetIndex& presetIndex_, int index_, Listener* listener_) :
 root(File()),
+presetIndex(presetIndex_),
 index(index_),
 listener(listener_)
 {
@@ -56,55 +57,34 @@ listener(listener_)
 
 int PresetBrowserColumn::ColumnListModel::getNumRows()
 {
-    if(wildcard.isEmpty())
-    {   
-        if (!root.isDirectory())
-	    {
-		    entries.clear();
-		    return 0;
-	    }
+	// The entries are only collected again if the preset index or the displayed directory has changed
+	const int indexVersion = presetIndex.getVersion();
 
-	    entries.clear();
-	    root.findChildFiles(entries, displayDirectories ? File::findDirectories : File::findFiles, false);
+	if (!entriesNeedUpdate && indexVersion == lastIndexVersion)
+		return entries.size();
 
-		for (int i = 0; i < entries.size(); i++)
-		{
-			if (entries[i].isHidden() || entries[i].getFileName().startsWith("."))
-			{
-				entries.remove(i--);
-			}
-		}
-			
-	    entries.sort();
+	entriesNeedUpdate = false;
+	lastIndexVersion = indexVersion;
+
+	// The entries are taken from the preset index, so this doesn't touch the file system
+	entries.clearQuick();
+
+    if(wildcard.isEmpty())
+    {   
+		if (root == File())
+			return 0;
 
-	    return entries.size();
+		if (displayDirectories)
+			presetIndex.getChildDirectories(root, entries);
+		else
+			presetIndex.getPresetsInDirectory(root, entries);
     }
     else
     {
-        Array<File> allFiles;
-        
-        totalRoot.findChildFiles(allFiles, File::findFiles, true);
-        
-        entries.clear();
-        
-        for(int i = 0; i < allFiles.size(); i++)
-        {
-            if(allFiles[i].getFullPathName().containsIgnoreCase(wildcard))
-                entries.add(allFiles[i]);
-        }
-        
-		for (int i = 0; i < entries.size(); i++)
-		{
-			if (entries[i].isHidden() || entries[i].getFileName().startsWith("."))
-			{
-				entries.remove(i--);
-			}
-		}
-
-        entries.sort();
-        
-        return entries.size();
+		presetIndex.search(wildcard, entries);
     }
+
+	return entries.size();
 }
 
 void PresetBrowserColumn::ColumnListModel::listBoxItemClicked(int row, const MouseEvent &e)
@@ -209,7 +189,7 @@ index(index_)
 	addButton->addListener(this);
 	editButton->addListener(this);
 
-	listModel = new ColumnListModel(index, listener);
+	listModel = new ColumnListModel(mc->getUserPresetHandler().getPresetIndex(), index, listener);
 
 	
 	listModel->setTotalRoot(rootDirectory);
@@ -290,6 +270,8 @@ void PresetBrowserColumn::buttonClicked(Button* b)
 			newDirectory.createDirectory();
 
 			setNewRootDirectory(currentRoot);
+
+			mc->getUserPresetHandler().sendRebuildMessage();
 		}
 		else
 		{
@@ -362,6 +344,9 @@ mc(mc_)
 
 	mc->getUserPresetHandler().addListener(this);
 
+	// Make sure the index picks up changes that were made outside of the browser
+	mc->getUserPresetHandler().getPresetIndex().rescan();
+
 	addAndMakeVisible(bankColumn = new PresetBrowserColumn(mc, 0, rootFile, this));
 	addAndMakeVisible(categoryColumn = new PresetBrowserColumn(mc, 1, rootFile, this));
 	addAndMakeVisible(presetColumn = new PresetBrowserColumn(mc, 2, rootFile, this));
@@ -420,15 +405,7 @@ void MultiColumnPresetBrowser::paint(Graphics& g)
 void MultiColumnPresetBrowser::rebuildAllPresets()
 {
 	allPresets.clear();
-	rootFile.findChildFiles(allPresets, File::findFiles, true, "*.preset");
-
-	for (int i = 0; i < allPresets.size(); i++)
-	{
-		if (allPresets[i].isHidden() || allPresets[i].getFileName().startsWith("."))
-		{
-			allPresets.remove(i--);
-		}
-	}
+	mc->getUserPresetHandler().getPresetIndex().getAllPresets(allPresets);
 
 	File f = mc->getUserPresetHandler().getCurrentlyLoadedFile();
 
@@ -567,7 +544,7 @@ void MultiColumnPresetBrowser::renameEntry(int columnIndex, int rowIndex, const
             presetColumn->setNewRootDirectory(File());
         }
         
-        rebuildAllPresets();
+        mc->getUserPresetHandler().sendRebuildMessage();
         
 		
 	}
@@ -593,7 +570,7 @@ void MultiColumnPresetBrowser::renameEntry(int columnIndex, int rowIndex, const
             presetColumn->setNewRootDirectory(newCategory);
         }
         
-        rebuildAllPresets();
+        mc->getUserPresetHandler().sendRebuildMessage();
 	}
 	else if (columnIndex == 2)
 	{
@@ -609,7 +586,7 @@ void MultiColumnPresetBrowser::renameEntry(int columnIndex, int rowIndex, const
 			presetColumn->setNewRootDirectory(currentCategoryFile);
 		}
 
-		rebuildAllPresets();
+		mc->getUserPresetHandler().sendRebuildMessage();
 	}
 }
 
@@ -644,7 +621,7 @@ void MultiColumnPresetBrowser::deleteEntry(int columnIndex, int /*rowIndex*/, co
 		presetColumn->setNewRootDirectory(currentCategoryFile);
 	}
 
-	rebuildAllPresets();
+	mc->getUserPresetHandler().sendRebuildMessage();
 }
 
 
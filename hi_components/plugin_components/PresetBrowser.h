@@ -139,11 +139,12 @@ public:
 			virtual void renameEntry(int columnIndex, int rowIndex, const File& file, bool doubleClick) = 0;
 		};
 
-		ColumnListModel(int index_, Listener* listener_);
+		ColumnListModel(const MainController::UserPresetHandler::PresetIndex& presetIndex_, int index_, Listener* listener_);
 
-		void setRootDirectory(const File& newRootDirectory) { root = newRootDirectory; }
+		void setRootDirectory(const File& newRootDirectory) { root = newRootDirectory; entriesNeedUpdate = true; }
 		void toggleEditMode() { editMode = !editMode; }
-		void setDisplayDirectories(bool shouldDisplayDirectories) { displayDirectories = shouldDisplayDirectories; }
+		void setDisplayDirectories(bool shouldDisplayDirectories) { displayDirectories = shouldDisplayDirectories; entriesNeedUpdate = true; }
+		void setWildcard(const String& newWildcard) { wildcard = newWildcard; entriesNeedUpdate = true; }
 
 		int getNumRows() override;
 		void listBoxItemClicked(int row, const MouseEvent &) override;
@@ -164,8 +165,6 @@ public:
 			return entries.indexOf(f);
 		}
 
-        String wildcard;
-        
 		Colour highlightColour;
 		Font font;
 
@@ -173,10 +172,16 @@ public:
 
 		Image deleteIcon;
 
+		const MainController::UserPresetHandler::PresetIndex& presetIndex;
+
 		Listener* listener;
 		bool editMode = false;
 		bool displayDirectories = true;
+		String wildcard;
 		Array<File> entries;
+
+		bool entriesNeedUpdate = true;
+		int lastIndexVersion = -1;
 		File root;
 		const int index;
 		
@@ -212,7 +217,7 @@ public:
 
 	void labelTextChanged(Label* l) override
 	{
-	    listModel->wildcard = l->getText();
+	    listModel->setWildcard(l->getText());
       
 	    listbox->deselectAllRows();
 	    listbox->updateContent();
@@ -227,12 +232,18 @@ public:
 		editButton->setVisible(!isResultBar);
 	}
 
+	/** Updates the list with the current state of the preset index. */
+	void updateContent()
+	{
+		listbox->updateContent();
+		listbox->repaint();
+	}
+
 	void timerCallback() override
     {
         if(!isVisible()) return;
         
-	    listbox->updateContent();
-	    listbox->repaint();
+	    updateContent();
     }
 	
 	void setSelectedFile(const File& file, NotificationType notifyListeners=dontSendNotification)
@@ -333,6 +344,10 @@ public:
 	void presetListUpdated() override
 	{
 		rebuildAllPresets();
+
+		bankColumn->updateContent();
+		categoryColumn->updateContent();
+		presetColumn->updateContent();
 	}
 
 	void rebuildAllPresets();
@@ -32,8 +32,8 @@
 
 //==============================================================================
 Plotter::Plotter() :
-freeModePlotterQueue(nullptr),
-freeMode(false)
+freeMode(false),
+freeModeTap(4096)
 {
 	setName("Modulator Data Plotter: Idle");
 
@@ -56,17 +56,20 @@ freeMode(false)
 
 	setSize(380, 200);
 
+	startTimer(30);
 }
 
 Plotter::~Plotter()
 {
+	stopTimer();
+
 	speedSlider = nullptr;
 	
 };
 
 void Plotter::addPlottedModulator(Modulator *m)
 {
-	modQueue.add(new PlotterQueue(m));
+	modQueue.add(new PlotterQueue(m, m->getPlotterTap()));
 
 	m->setPlotter(this);
 
@@ -100,78 +103,62 @@ void Plotter::removePlottedModulator(Modulator *m)
 	}
 }
 
-void Plotter::handleAsyncUpdate()
+void Plotter::timerCallback()
 {
-	for (int i = 0; i < currentQueuePosition; i++)
+	if (freeMode)
 	{
-		currentRingBufferPosition = (currentRingBufferPosition + 1) % 1024;
+		if (freeModePlotterQueue == nullptr)
+			return;
 
-		float value = 0.0f;
+		freeModePlotterQueue->pull();
 
-		if (freeMode)
-		{
-			value = freeModePlotterQueue.data[i];
-		}
-		else
-		{
-			for (int j = 0; j < modQueue.size(); j++)
-			{
-				value += modQueue[j]->data[i];
-			}
-		}
+		const int numNewValues = freeModePlotterQueue->pos;
 
-		internalBuffer[currentRingBufferPosition] = value;
+		if (numNewValues == 0)
+			return;
 
-	}
-
-	currentQueuePosition = 0;
+		for (int i = 0; i < numNewValues; i++)
+		{
+			currentRingBufferPosition = (currentRingBufferPosition + 1) % 1024;
+			internalBuffer[currentRingBufferPosition] = freeModePlotterQueue->data[i];
+		}
 
-	if (freeMode)
-	{
-		freeModePlotterQueue.pos = 0;
+		freeModePlotterQueue->removeValues(numNewValues);
 	}
 	else
 	{
+		if (modQueue.size() == 0)
+			return;
+
+		bool newValuesArrived = false;
+
+		// Every tap is read on its own, so a modulator that doesn't send values can't stall the others
 		for (int i = 0; i < modQueue.size(); i++)
-		{
-			modQueue.getUnchecked(i)->pos = 0;
-		}
-	}
-	
-	repaint();
-};
+			newValuesArrived |= modQueue.getUnchecked(i)->pullIntoHistory();
 
-void Plotter::addValue(const Modulator *m, float addedValue)
-{
+		if (!newValuesArrived)
+			return;
 
-	for(int i = 0; i < modQueue.size(); i++)
-	{
-		if(modQueue[i]->attachedMod == m)
+		// The histories are summed up with their latest values aligned at the current ring buffer position
+		for (int age = 0; age < 1024; age++)
 		{
-			modQueue[i]->addValue(addedValue);
+			float value = 0.0f;
 
-			if(i == modQueue.size() -1) 
-			{
-				currentQueuePosition++;
-				triggerAsyncUpdate();
-			}
+			for (int j = 0; j < modQueue.size(); j++)
+				value += modQueue.getUnchecked(j)->getHistoryValue(age);
 
+			internalBuffer[(currentRingBufferPosition - age + 1024) % 1024] = value;
 		}
-		
-	}	
+	}
+	
+	repaint();
 };
 
 void Plotter::addValue(float addedValue)
 {
-	freeModePlotterQueue.addValue(addedValue);
-	freeModePlotterQueue.addValue(addedValue);
-	currentQueuePosition++;
-	currentQueuePosition++;
-	freeModePlotterQueue.addValue(addedValue);
-	freeModePlotterQueue.addValue(addedValue);
-	currentQueuePosition++;
-	currentQueuePosition++;
-	triggerAsyncUpdate();
+	const float values[4] = { addedValue, addedValue, addedValue, addedValue };
+
+	freeModeTap.pushSamples(values, 4);
 }
 
 void Plotter::paint (Graphics& g)
@@ -247,8 +234,6 @@ void Plotter::resized()
 
 void Plotter::resetPlotter()
 {
-	//cancelPendingUpdate();
-	currentQueuePosition = 0;
 	currentRingBufferPosition = 0;
 		
 	smoothedValue = 0.0f;
@@ -300,5 +285,5 @@ void Plotter::setFreeMode(bool shouldUseFreeMode)
 
 	setOpaque(shouldUseFreeMode);
 
-	freeModePlotterQueue = PlotterQueue(nullptr);
+	freeModePlotterQueue = shouldUseFreeMode ? new PlotterQueue(nullptr, freeModeTap) : nullptr;
 }
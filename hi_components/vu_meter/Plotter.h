@@ -44,13 +44,12 @@ class ScriptContentComponent;
 /** A plotter component that displays the Modulator value
 *	@ingroup debugComponents
 *
-*	You can add values with addValue(). This should be periodic 
-*	(either within the audio callback or with a designated timer in your Editor, as
-*	the plotter only writes something if new data is added.
+*	The plotted modulators push their values into their AnalyserTap and the plotter pulls them
+*	in its timer callback. In free mode you can add values with addValue() from any thread.
 */
 class Plotter    : public Component,
 				   public SettableTooltipClient,
-				   public AsyncUpdater,
+				   public Timer,
 				   public Slider::Listener
 {
 public:
@@ -65,22 +64,18 @@ public:
 		pathColour2
 	};
 
-	/** Clears the queue and triggers a repaint of the component.
-	*/
-	void handleAsyncUpdate() override;
+	/** Pulls the new values from the taps and repaints the component. */
+	void timerCallback() override;
 
     void paint (Graphics&) override;
     void resized() override;
 
 	void sliderValueChanged (Slider* ) override { setSpeed((int)speedSlider->getValue()); };
 
-	/** Adds a value to the queue to be displayed at the next timerCallback(). */
-	void addValue(const Modulator *m, float addedValue);
-
 	/** If set to true, you don't need any modulators, but call addValue(float newValue) directly. */
 	void setFreeMode(bool shouldUseFreeMode);
 
-	/** Adds a value to the queue without having a modulator attached. */
+	/** Adds a value to the queue without having a modulator attached. This never locks, so it can be called from the audio thread. */
 	void addValue(float addedValue);
 
 	/** Changes the speed of the modulator. */
@@ -105,45 +100,83 @@ private:
 
 	struct PlotterQueue
 	{
-		PlotterQueue(Modulator *m):
+		PlotterQueue(Modulator *m, AnalyserTap& tap):
 			attachedMod(m),
-			pos(0)
+			reader(new AnalyserTap::Reader(tap)),
+			pos(0),
+			historyPosition(0)
 		{
 			for(int i = 0; i < 1024; i++)
 			{
 				data[i] = 0.0f;
+				history[i] = 0.0f;
 			}
 		}
 
 		void reset()
 		{
 			for(int i = 0; i<1024; i++) data[i] = 0.0f;
+			for(int i = 0; i<1024; i++) history[i] = 0.0f;
 			pos = 0;
-
+			historyPosition = 0;
 		}
 
 		bool isActive() const { return attachedMod.get() != nullptr; };
 
-		void addValue(float addedValue)
+		/** Pulls the new values from the tap. */
+		void pull()
+		{
+			if (AnalyserTap* tap = reader->getTap())
+				pos += tap->popSamples(data + pos, 1024 - pos);
+		}
+
+		/** Removes the given amount of values that were written to the plotter buffer. */
+		void removeValues(int numToRemove)
 		{
-			//jassert(pos < 1024);
+			pos -= numToRemove;
+			memmove(data, data + numToRemove, sizeof(float) * pos);
+		}
+
+		/** Pulls the new values from the tap and appends them to the history. Returns false if there were no new values. */
+		bool pullIntoHistory()
+		{
+			pull();
+
+			if (pos == 0)
+				return false;
+
+			for (int i = 0; i < pos; i++)
+			{
+				historyPosition = (historyPosition + 1) % 1024;
+				history[historyPosition] = data[i];
+			}
 
-			if(pos >= 1024) return;
+			pos = 0;
+
+			return true;
+		}
 
-			const float newValue = addedValue;
-			
-			data[pos++] = newValue;
-			
+		/** Returns the value with the given age in the history (0 is the latest value). */
+		float getHistoryValue(int age) const
+		{
+			return history[(historyPosition - age + 1024) % 1024];
 		}
 
 		float data[1024];
 
-		int pos;
+		/** The last 1024 values of this tap, so it can advance independently from the other taps. */
+		float history[1024];
 
 		WeakReference<Modulator> attachedMod;
+
+		ScopedPointer<AnalyserTap::Reader> reader;
+
+		int pos;
+		int historyPosition;
 	};
 
-	PlotterQueue freeModePlotterQueue;
+	AnalyserTap freeModeTap;
+	ScopedPointer<PlotterQueue> freeModePlotterQueue;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Plotter)
 
@@ -152,7 +185,6 @@ private:
 
 	OwnedArray<PlotterQueue> modQueue;
 
-	int currentQueuePosition;
 	int currentRingBufferPosition;
 	
 	float smoothedValue;
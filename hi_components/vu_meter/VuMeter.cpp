@@ -93,6 +93,18 @@ void VuMeter::setPeak(float left, float right/*=0.0f*/)
 	}
 }
 
+void VuMeter::setPeakFromTap(AnalyserTap& tap)
+{
+	AnalyserTap::Levels levels;
+
+	if (tap.popLevels(levels))
+		setPeak(levels.peak[0], levels.peak[1]);
+	else if (type == StereoHorizontal || type == StereoVertical)
+		setPeak(0.0f, 0.0f); // nothing was pushed (eg. the effect is bypassed), so let the meter fall
+	else
+		setPeak(l * 0.8f);
+}
+
 void VuMeter::drawMonoMeter(Graphics &g)
 {
 	const float w = (float)getWidth();
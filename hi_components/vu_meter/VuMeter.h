@@ -90,6 +90,12 @@ public:
 
 	void setPeakMultiChannel(float *numbers, int numChannels);
 
+	/** Sets the peak levels from the given tap. Call this in your timer callback.
+	*
+	*	If no new levels have arrived (eg. because the effect is bypassed), the meter decays instead of freezing.
+	*/
+	void setPeakFromTap(AnalyserTap& tap);
+
 private:
 
 	void drawMonoMeter(Graphics &g);
@@ -252,6 +252,16 @@ void SamplerSoundWaveform::setSoundToDisplay(const ModulatorSamplerSound *s)
 
 		if (sound->isMonolithic())
 		{
+			if (MonolithPeakCache* peakCache = sound->getPeakCache())
+			{
+				// Draw the waveform from the peak file instead of decoding the sample
+				numSamplesInCurrentSample = (int)sound->getMonolithLength();
+				setPreview(new MonolithPeakCache::Thumbnail(peakCache, sound->getMonolithOffset(), sound->getMonolithLength(), sound->getMonolithSampleRate(), (int64)s->getProperty(ModulatorSamplerSound::ID)));
+
+				updateRanges();
+				return;
+			}
+
 			afr = sound->createReaderForPreview();
 		}
 		else
@@ -261,6 +271,9 @@ void SamplerSoundWaveform::setSoundToDisplay(const ModulatorSamplerSound *s)
 		
 		if (afr != nullptr)
 		{
+			if (dynamic_cast<AudioThumbnail*>(preview.get()) == nullptr)
+				setPreview(new AudioThumbnail(16, afm, sampler->getCache()));
+
 			numSamplesInCurrentSample = (int)afr->lengthInSamples;
 			preview->setReader(afr.release(), (int64)s->getProperty(ModulatorSamplerSound::ID));
 
@@ -316,6 +316,21 @@ public:
 
 	SampleArea *getSampleArea(int index) {return areas[index];};
 
+	/** Replaces the thumbnail that is used to draw the waveform (eg. with one that reads a precalculated peak file). */
+	void setPreview(AudioThumbnailBase* newPreview)
+	{
+		jassert(newPreview != nullptr);
+
+		if (newPreview == preview.get())
+			return;
+
+		preview->removeChangeListener(this);
+		preview = newPreview;
+		preview->addChangeListener(this);
+
+		repaint();
+	}
+
 	virtual double getSampleRate() const = 0;
 
 	/** draws the waveform of the audio data
@@ -332,7 +347,7 @@ protected:
 
 	AudioFormatManager afm;
 	ScopedPointer<Viewport> displayViewport;
-	ScopedPointer<AudioThumbnail> preview;
+	ScopedPointer<AudioThumbnailBase> preview;
 
 private:
 
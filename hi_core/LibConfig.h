@@ -39,7 +39,9 @@
 #define USE_OLD_FILE_FORMAT 0
 #define HI_USE_BACKWARD_COMPATIBILITY 1
 
+// The default voice amount of a synth. The voice amount can be changed at runtime up to NUM_MAX_POLYPHONIC_VOICES
 #define NUM_POLYPHONIC_VOICES 128
+#define NUM_MAX_POLYPHONIC_VOICES 512
 #define NUM_GLOBAL_VARIABLES 128
 #define NUM_MIC_POSITIONS 8
 #define NUM_MAX_CHANNELS 16
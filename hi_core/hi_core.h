@@ -207,6 +207,13 @@ Set this to 0 to disable host information like tempo, playing position etc...
 #define ENABLE_HOST_INFO 1
 #endif
 
+/** Config: ENABLE_PROCESSOR_PROFILER
+Set this to 0 to remove the per processor CPU profiler (it's deactivated at runtime by default).
+*/
+#ifndef ENABLE_PROCESSOR_PROFILER
+#define ENABLE_PROCESSOR_PROFILER 1
+#endif
+
 /** Config: ENABLE_CPU_MEASUREMENT
 
 Set this to 0 to deactivate the CPU peak meter.
@@ -215,6 +222,76 @@ Set this to 0 to deactivate the CPU peak meter.
 #define ENABLE_CPU_MEASUREMENT 1
 #endif
 
+/** Config: ENABLE_SHARED_SAMPLE_CACHE
+
+If enabled, the monolith files and preload buffers are shared between all plugin instances of the same process that load the same samples.
+*/
+#ifndef ENABLE_SHARED_SAMPLE_CACHE
+#define ENABLE_SHARED_SAMPLE_CACHE 1
+#endif
+
+/** Config: ENABLE_ZERO_COPY_PRELOAD
+
+If enabled, the preload buffers of uncompressed mono monoliths point directly into the memory mapped file instead of copying the data.
+*/
+#ifndef ENABLE_ZERO_COPY_PRELOAD
+#define ENABLE_ZERO_COPY_PRELOAD 1
+#endif
+
+/** Config: ZERO_COPY_PRELOAD_LOCK_BUDGET
+
+The amount of memory in megabytes that zero copy preload buffers can lock in the RAM (using mlock). The pages of the buffers beyond this limit are only pre-faulted.
+*/
+#ifndef ZERO_COPY_PRELOAD_LOCK_BUDGET
+#define ZERO_COPY_PRELOAD_LOCK_BUDGET 256
+#endif
+
+/** Config: ENABLE_LAZY_SAMPLE_PRELOADING
+
+If enabled, the samplers are playable immediately after loading a sample map and the preload buffers are loaded by a background thread.
+A voice that starts a sample which isn't preloaded yet streams it from the disk with a short fade in.
+*/
+#ifndef ENABLE_LAZY_SAMPLE_PRELOADING
+#define ENABLE_LAZY_SAMPLE_PRELOADING 0
+#endif
+
+/** Config: ENABLE_DIFFERENTIAL_PRESET_LOADING
+
+If enabled, loading a user preset only restores the controls whose value has changed, without muting the audio.
+The full restore (with all control callbacks and the fade out) is only used if the preset changes more than the plain control values.
+*/
+#ifndef ENABLE_DIFFERENTIAL_PRESET_LOADING
+#define ENABLE_DIFFERENTIAL_PRESET_LOADING 1
+#endif
+
+/** Config: USE_BINARY_PLUGIN_STATE
+
+If enabled, compiled plugins save their state in a compact binary format that is cached between the host calls.
+States that were saved with the old ValueTree format can always be restored.
+*/
+#ifndef USE_BINARY_PLUGIN_STATE
+#define USE_BINARY_PLUGIN_STATE 1
+#endif
+
+/** Config: ENABLE_HOST_AUTOMATION_QUEUE
+
+If enabled, the host parameter changes of compiled plugins are passed to the audio thread through a lock free queue
+and delivered to the script controls as timestamped events (with an optional smoothing per parameter).
+If disabled, the control values are set directly on the thread that the host uses.
+*/
+#ifndef ENABLE_HOST_AUTOMATION_QUEUE
+#define ENABLE_HOST_AUTOMATION_QUEUE 1
+#endif
+
+/** Config: HISE_EVENT_BUFFER_SIZE
+
+The number of events that each HiseEventBuffer reserves when it is created. The buffers of the main controller and the sound
+generators grow to the block size in prepareToPlay() if it is bigger. Events that don't fit into a buffer are dropped and
+reported to the DebugLogger.
+*/
+#ifndef HISE_EVENT_BUFFER_SIZE
+#define HISE_EVENT_BUFFER_SIZE 256
+#endif
 
 #ifndef ENABLE_APPLE_SANDBOX
 #define ENABLE_APPLE_SANDBOX 0
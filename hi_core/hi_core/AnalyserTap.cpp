@@ -0,0 +1,192 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+AnalyserTap::AnalyserTap(int ringSize_):
+	ringSize((uint32)nextPowerOfTwo(jmax<int>(16, ringSize_))),
+	ringMask(ringSize - 1),
+	writePosition(0),
+	readPosition(0),
+	numReaders(0),
+	decimation(1),
+	numDroppedSamples(0)
+{
+
+}
+
+AnalyserTap::~AnalyserTap()
+{
+	masterReference.clear();
+}
+
+void AnalyserTap::addReader()
+{
+	if (ring == nullptr)
+	{
+		ring.calloc(ringSize);
+		levelQueue = new moodycamel::ReaderWriterQueue<Levels>(ANALYSER_TAP_LEVEL_QUEUE_SIZE);
+	}
+
+	// Skip everything that was left over from the last reader
+	readPosition.store(writePosition.load(std::memory_order_acquire), std::memory_order_release);
+
+	Levels l;
+
+	while (levelQueue->try_dequeue(l))
+		;
+
+	numReaders.fetch_add(1, std::memory_order_release);
+}
+
+void AnalyserTap::removeReader()
+{
+	// The memory is kept because the audio thread might still be pushing
+	numReaders.fetch_sub(1, std::memory_order_release);
+}
+
+void AnalyserTap::pushSamples(const float* data, int numSamples) noexcept
+{
+	if (isActive())
+		pushInternal<false>(data, nullptr, numSamples);
+}
+
+void AnalyserTap::pushStereoSamples(const float* left, const float* right, int numSamples) noexcept
+{
+	if (isActive())
+		pushInternal<true>(left, right, numSamples);
+}
+
+template <bool isStereo> void AnalyserTap::pushInternal(const float* left, const float* right, int numSamples) noexcept
+{
+	const int factor = decimation.load(std::memory_order_relaxed);
+	const uint32 r = readPosition.load(std::memory_order_acquire);
+	uint32 w = writePosition.load(std::memory_order_relaxed);
+
+	int numDropped = 0;
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		if (++decimationCounter < factor)
+			continue;
+
+		decimationCounter = 0;
+
+		if (w - r >= ringSize)
+		{
+			numDropped++;
+			continue;
+		}
+
+		ring[w & ringMask] = isStereo ? 0.5f * (left[i] + right[i]) : left[i];
+		w++;
+	}
+
+	writePosition.store(w, std::memory_order_release);
+
+	if (numDropped != 0)
+		numDroppedSamples += numDropped;
+}
+
+void AnalyserTap::pushLevels(const AudioSampleBuffer& buffer, int startSample, int numSamples) noexcept
+{
+	if (!isActive() || numSamples <= 0 || buffer.getNumChannels() == 0)
+		return;
+
+	Levels l;
+
+	for (int c = 0; c < 2; c++)
+	{
+		const int channel = jmin<int>(c, buffer.getNumChannels() - 1);
+
+		l.peak[c] = buffer.getMagnitude(channel, startSample, numSamples);
+		l.rms[c] = buffer.getRMSLevel(channel, startSample, numSamples);
+	}
+
+	l.numSamples = numSamples;
+
+	levelQueue->try_enqueue(l);
+}
+
+int AnalyserTap::popSamples(float* destination, int maxNumSamples) noexcept
+{
+	if (ring == nullptr)
+		return 0;
+
+	const uint32 w = writePosition.load(std::memory_order_acquire);
+	const uint32 r = readPosition.load(std::memory_order_relaxed);
+
+	const int numToCopy = jmin<int>(maxNumSamples, (int)(w - r));
+
+	for (int i = 0; i < numToCopy; i++)
+		destination[i] = ring[(r + (uint32)i) & ringMask];
+
+	readPosition.store(r + (uint32)numToCopy, std::memory_order_release);
+
+	return numToCopy;
+}
+
+int AnalyserTap::getNumAvailableSamples() const noexcept
+{
+	return (int)(writePosition.load(std::memory_order_acquire) - readPosition.load(std::memory_order_relaxed));
+}
+
+bool AnalyserTap::popLevels(Levels& result) noexcept
+{
+	if (levelQueue == nullptr)
+		return false;
+
+	Levels l;
+	bool found = false;
+	double squareSum[2] = { 0.0, 0.0 };
+
+	result.numSamples = 0;
+
+	while (levelQueue->try_dequeue(l))
+	{
+		for (int c = 0; c < 2; c++)
+		{
+			result.peak[c] = found ? jmax<float>(result.peak[c], l.peak[c]) : l.peak[c];
+			squareSum[c] += (double)l.rms[c] * (double)l.rms[c] * (double)l.numSamples;
+		}
+
+		result.numSamples += l.numSamples;
+		found = true;
+	}
+
+	if (found)
+	{
+		for (int c = 0; c < 2; c++)
+			result.rms[c] = result.numSamples > 0 ? (float)std::sqrt(squareSum[c] / (double)result.numSamples) : 0.0f;
+	}
+
+	return found;
+}
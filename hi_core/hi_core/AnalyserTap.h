@@ -0,0 +1,173 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+#ifndef ANALYSERTAP_H_INCLUDED
+#define ANALYSERTAP_H_INCLUDED
+
+#include "../additional_libraries/lockfree_fifo/readerwriterqueue.h"
+
+#define ANALYSER_TAP_LEVEL_QUEUE_SIZE 256
+
+/** A lock free connection that sends analysis data from the audio thread to a display.
+*
+*	A processor owns one AnalyserTap for every kind of data that it wants to show (eg. the values of a modulator for
+*	the plotter, the levels of an effect for a meter or its output signal for a spectrum display). The audio thread
+*	pushes the data into a single producer / single consumer ring and the display pulls it in its timer callback at
+*	its own frame rate. The audio thread never calls into a component and never waits for the message thread.
+*
+*	There are two kinds of data:
+*
+*	- samples: a mono signal that is decimated by the factor set with setDecimation(). Use this for plotters or
+*	  pull the signal with a decimation of 1 and analyse it with the FFT of your choice on the UI side.
+*	- levels: the peak and RMS value of every block (up to two channels). Use this for meters.
+*
+*	The tap does nothing until a display connects with a Reader, so the memory is only allocated when it's needed
+*	and if no display is open, pushing data costs a single atomic read on the audio thread. There must only be one
+*	Reader at a time (the data is consumed by pulling it) and it must be created and deleted on the message thread.
+*/
+class AnalyserTap
+{
+public:
+
+	/** The merged levels since the last call to popLevels(). */
+	struct Levels
+	{
+		float peak[2];
+		float rms[2];
+		int numSamples;
+	};
+
+	/** Connects a display to a tap for the lifetime of this object.
+	*
+	*	It holds a weak reference to the tap, so it's safe to delete the processor that owns the tap before the display.
+	*/
+	class Reader
+	{
+	public:
+
+		Reader(AnalyserTap& tap_):
+			tap(&tap_)
+		{
+			tap->addReader();
+		}
+
+		~Reader()
+		{
+			if (tap != nullptr)
+				tap->removeReader();
+		}
+
+		/** Returns the tap or nullptr if it was deleted. */
+		AnalyserTap* getTap() noexcept { return tap.get(); }
+
+	private:
+
+		WeakReference<AnalyserTap> tap;
+
+		JUCE_DECLARE_NON_COPYABLE(Reader)
+	};
+
+	/** Creates a tap. The ring size is rounded up to the next power of two and allocated when the first Reader connects. */
+	AnalyserTap(int ringSize=8192);
+
+	~AnalyserTap();
+
+	/** Returns true if a display is connected. Check this before you calculate data that is only needed for the display. */
+	bool isActive() const noexcept { return numReaders.load(std::memory_order_acquire) > 0; }
+
+	/** Sets the decimation factor for pushed samples (1 means every sample is used). */
+	void setDecimation(int factor) noexcept { decimation.store(jmax<int>(1, factor)); }
+
+	// ================================================================================================================ Audio thread
+
+	/** Adds a single sample (the decimation is applied). */
+	void pushSample(float value) noexcept
+	{
+		if (isActive())
+			pushSamples(&value, 1);
+	}
+
+	/** Adds the samples (the decimation is applied). Samples that don't fit into the ring are dropped. */
+	void pushSamples(const float* data, int numSamples) noexcept;
+
+	/** Adds the average of both channels. */
+	void pushStereoSamples(const float* left, const float* right, int numSamples) noexcept;
+
+	/** Calculates the peak and RMS level of the (first two channels of the) buffer and adds them. */
+	void pushLevels(const AudioSampleBuffer& buffer, int startSample, int numSamples) noexcept;
+
+	// ================================================================================================================ Message thread
+
+	/** Copies up to maxNumSamples samples into the destination and returns the number of copied samples. */
+	int popSamples(float* destination, int maxNumSamples) noexcept;
+
+	/** Returns the number of samples that can be pulled. */
+	int getNumAvailableSamples() const noexcept;
+
+	/** Merges all levels since the last call into the given object. Returns false if there were no new levels. */
+	bool popLevels(Levels& result) noexcept;
+
+	/** Returns the number of samples that were dropped because the display didn't pull them fast enough. */
+	int getNumDroppedSamples() const noexcept { return numDroppedSamples.get(); }
+
+private:
+
+	void addReader();
+	void removeReader();
+
+	template <bool isStereo> void pushInternal(const float* left, const float* right, int numSamples) noexcept;
+
+	const uint32 ringSize;
+	const uint32 ringMask;
+
+	HeapBlock<float> ring;
+	ScopedPointer<moodycamel::ReaderWriterQueue<Levels>> levelQueue;
+
+	std::atomic<uint32> writePosition;
+	std::atomic<uint32> readPosition;
+
+	std::atomic<int> numReaders;
+	std::atomic<int> decimation;
+
+	Atomic<int> numDroppedSamples;
+
+	// Only accessed by the audio thread
+	int decimationCounter = 0;
+
+	friend class WeakReference<AnalyserTap>;
+	WeakReference<AnalyserTap>::Master masterReference;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalyserTap)
+};
+
+#endif  // ANALYSERTAP_H_INCLUDED
@@ -33,6 +33,8 @@
 #ifndef CUSTOMDATACONTAINERS_H_INCLUDED
 #define CUSTOMDATACONTAINERS_H_INCLUDED
 
+// The fixed capacity of an UnorderedStack. The synth voices use the VoiceStack with a runtime capacity, so nothing
+// in HISE depends on this anymore (it's only kept for the UnorderedStack itself and its unit test).
 #define UNORDERED_STACK_SIZE NUM_POLYPHONIC_VOICES
 
 
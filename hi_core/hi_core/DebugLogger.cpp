@@ -270,7 +270,8 @@ struct DebugLogger::Failure : public DebugLogger::Message
 
 
 DebugLogger::DebugLogger(MainController* mc_):
-	mc(mc_)
+	mc(mc_),
+	traceRecorder(this)
 {
 	pendingEvents.ensureStorageAllocated(NUM_MESSAGE_SLOTS);
 	pendingFailures.ensureStorageAllocated(NUM_MESSAGE_SLOTS);
@@ -281,7 +282,7 @@ DebugLogger::DebugLogger(MainController* mc_):
 
 DebugLogger::~DebugLogger()
 {
-
+	traceRecorder.stopRecording();
 }
 
 double DebugLogger::getCurrentTimeStamp() const
@@ -291,12 +292,22 @@ double DebugLogger::getCurrentTimeStamp() const
 
 void DebugLogger::addFailure(const DebugLogger::Failure& f)
 {
+	// A failure without a processor or ID can be recreated from the trace record on the writer thread
+	const bool addToPendingList = !traceRecorder.isRecording() || f.p.get() != nullptr || !f.id.isNull();
+
+	traceRecorder.addRecord(TraceRecorder::RecordType::Failure, f.callbackIndex, f.messageIndex, (int)f.type, (int)f.location, addToPendingList ? 1 : 0, f.extraValue);
+
+	if (!addToPendingList)
+		return;
+
 	ScopedLock sl(debugLock);
 	pendingFailures.add(f);
 }
 
 void DebugLogger::addPerformanceWarning(const PerformanceWarning& f)
 {
+	traceRecorder.addRecord(TraceRecorder::RecordType::PerformanceWarning, f.callbackIndex, f.messageIndex, f.d.location, f.voiceAmount, 0, (double)f.d.thisPercentage);
+
 	ScopedLock sl(debugLock);
 	pendingPerformanceWarnings.add(f);
 }
@@ -304,9 +315,21 @@ void DebugLogger::addPerformanceWarning(const PerformanceWarning& f)
 
 void DebugLogger::addStreamingFailure(double voiceUptime)
 {
-	Failure f = Failure(messageIndex++, callbackIndex, Location::SampleRendering, FailureType::StreamingFailure, nullptr, getCurrentTimeStamp(), voiceUptime);
+	++numStreamingFailures;
 
-	addFailure(f);
+	if (!isLogging())
+		return;
+
+	if (!traceRecorder.isRecording())
+	{
+		// The failure can't be recorded because the trace file couldn't be opened, so the timer will report this once.
+		if (!streamingFailureNotRecorded.exchange(true))
+			streamingFailureReportPending.store(true);
+
+		return;
+	}
+
+	traceRecorder.addRecord(TraceRecorder::RecordType::StreamingFailure, callbackIndex, messageIndex++, 0, 0, 0, voiceUptime);
 }
 
 void DebugLogger::logEvents(const HiseEventBuffer& masterBuffer)
@@ -320,15 +343,91 @@ void DebugLogger::logEvents(const HiseEventBuffer& masterBuffer)
 			if (e->isAftertouch())
 				continue;
 
-			ScopedLock sl(debugLock);
-
-			Event e2(messageIndex++, callbackIndex, *e);
+			const int packedEvent = (int)e->getType() | (e->getNoteNumber() << 8) | ((int)e->getVelocity() << 16) | (e->getChannel() << 24);
 
-			pendingEvents.add(e2);
+			traceRecorder.addRecord(TraceRecorder::RecordType::Event, callbackIndex, messageIndex++, packedEvent, (int)e->getEventId(), (int)e->getTimeStamp());
 		}
 	}
 }
 
+void DebugLogger::checkEventBuffer(Processor* p, Location location, HiseEventBuffer& b)
+{
+	const int numDropped = b.resetDroppedEventCounter();
+
+	if (numDropped == 0)
+		return;
+
+	numDroppedEvents += numDropped;
+
+	if (!isLogging())
+		return;
+
+	Failure f(messageIndex++, callbackIndex, location, FailureType::EventBufferOverflow, p, getCurrentTimeStamp(), (double)numDropped);
+	addFailure(f);
+}
+
+void DebugLogger::logVoiceStart(int voiceIndex, const HiseEvent& e)
+{
+	if (isLogging())
+		traceRecorder.addRecord(TraceRecorder::RecordType::VoiceStart, callbackIndex, messageIndex, voiceIndex, (int)e.getEventId(), e.getNoteNumber());
+}
+
+void DebugLogger::logVoiceStop(int voiceIndex, const HiseEvent& e)
+{
+	if (isLogging())
+		traceRecorder.addRecord(TraceRecorder::RecordType::VoiceStop, callbackIndex, messageIndex, voiceIndex, (int)e.getEventId(), e.getNoteNumber());
+}
+
+void DebugLogger::logStreamingRequest(bool previousRequestIsPending, int64 positionInSampleFile)
+{
+	if (isLogging())
+		traceRecorder.addRecord(TraceRecorder::RecordType::StreamingRequest, callbackIndex, messageIndex, previousRequestIsPending ? 1 : 0, 0, 0, (double)positionInSampleFile);
+}
+
+void DebugLogger::traceRecordDrained(const TraceRecorder::Record& r)
+{
+	const double ts = Time::highResolutionTicksToSeconds(r.ticks - traceRecorder.getStartTicks());
+
+	switch (r.getType())
+	{
+	case TraceRecorder::RecordType::Event:
+	{
+		HiseEvent e((HiseEvent::Type)(r.data1 & 0xFF), (uint8)((r.data1 >> 8) & 0xFF), (uint8)((r.data1 >> 16) & 0xFF), (uint8)((r.data1 >> 24) & 0xFF));
+
+		e.setEventId((uint16)r.data2);
+		e.setTimeStamp((uint16)r.data3);
+
+		Event e2(r.sequenceIndex, r.callbackIndex, e);
+
+		ScopedLock sl(debugLock);
+		pendingEvents.add(e2);
+		break;
+	}
+	case TraceRecorder::RecordType::StreamingFailure:
+	{
+		Failure f(r.sequenceIndex, r.callbackIndex, Location::SampleRendering, FailureType::StreamingFailure, nullptr, ts, r.value);
+
+		ScopedLock sl(debugLock);
+		pendingFailures.add(f);
+		break;
+	}
+	case TraceRecorder::RecordType::Failure:
+	{
+		// This failure was already added to the pending list
+		if (r.data3 != 0)
+			break;
+
+		Failure f(r.sequenceIndex, r.callbackIndex, (Location)r.data2, (FailureType)r.data1, nullptr, ts, r.value);
+
+		ScopedLock sl(debugLock);
+		pendingFailures.add(f);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
 void DebugLogger::logMessage(const String& errorMessage)
 {
 	ScopedLock sl(messageLock);
@@ -364,6 +463,10 @@ void DebugLogger::logParameterChange(JavascriptProcessor* p, ReferenceCountedObj
 
 				DebugLogger::ParameterChange pc(messageIndex++, callbackIndex, getCurrentTimeStamp(), id, newValue);
 
+				const double numericValue = (newValue.isInt() || newValue.isDouble() || newValue.isBool()) ? (double)newValue : 0.0;
+
+				traceRecorder.addRecord(TraceRecorder::RecordType::ParameterChange, callbackIndex, pc.messageIndex, c->getTraceNameIndex(), 0, 0, numericValue);
+
 				ScopedLock sl(debugLock);
 
 				if (pendingParameterChanges.getLast().id == id)
@@ -385,6 +488,8 @@ void DebugLogger::checkAudioCallbackProperties(double sampleRate, int samplesPer
 
 	locationForErrorInCurrentCallback = Location::Empty;
 
+	traceRecorder.addRecord(TraceRecorder::RecordType::AudioCallback, callbackIndex, messageIndex, samplesPerBlock, 0, 0, sampleRate);
+
 	if (sampleRate != lastSampleRate)
 	{
 		addAudioDeviceChange(FailureType::SampleRateChange, lastSampleRate, sampleRate);
@@ -542,6 +647,12 @@ void DebugLogger::startLogging()
 
 	pendingFailures.ensureStorageAllocated(200);
 
+	streamingFailureNotRecorded.store(false);
+	streamingFailureReportPending.store(false);
+
+	if (!traceRecorder.startRecording(currentLogFile.withFileExtension("htrace")))
+		logMessage("The trace file couldn't be opened. Streaming failures and events won't be recorded.");
+
 	startTimer(200);
 
 	for (int i = 0; i < listeners.size(); i++)
@@ -570,6 +681,9 @@ struct MessageComparator
 
 void DebugLogger::timerCallback()
 {
+	if (streamingFailureReportPending.exchange(false))
+		logMessage("A streaming failure occurred but couldn't be recorded because the trace file isn't open. Further failures will be counted only.");
+
 	Array<Failure> failureCopy;
 	Array<StringMessage> messageCopy;
 	Array<PerformanceWarning> warningCopy;
@@ -797,6 +911,11 @@ void DebugLogger::stopLogging()
 	currentlyLogging = false;
 	stopTimer();
 
+	traceRecorder.stopRecording();
+
+	// Write the messages of the last drained records
+	timerCallback();
+
 	for (int i = 0; i < listeners.size(); i++)
 	{
 		if (listeners[i].get() != nullptr)
@@ -907,6 +1026,7 @@ String DebugLogger::getNameForFailure(FailureType f)
 		RETURN_CASE_STRING_FAILURE(PriorityInversion);
 		RETURN_CASE_STRING_FAILURE(SampleLoadingError);
 		RETURN_CASE_STRING_FAILURE(StreamingFailure);
+		RETURN_CASE_STRING_FAILURE(EventBufferOverflow);
         RETURN_CASE_STRING_FAILURE(numFailureTypes);
 	}
 
@@ -37,7 +37,15 @@
 class MainController;
 class JavascriptProcessor;
 
-class DebugLogger : public Timer
+/** Logs failures, performance warnings and events into a human readable markdown file.
+*
+*	Everything that happens on the audio thread (or the streaming threads) is also written into a binary trace file
+*	(with the same name and the extension .htrace) using a TraceRecorder. These paths are lock free: the records are
+*	converted into the markdown messages on the writer thread of the TraceRecorder. Only failures that refer to a
+*	Processor still need to take the lock.
+*/
+class DebugLogger : public Timer,
+					public TraceRecorder::Consumer
 {
 public:
 
@@ -66,6 +74,7 @@ public:
 		PriorityInversion, //< when the audio thread lock is locked by another thread
 		SampleLoadingError,
 		StreamingFailure,
+		EventBufferOverflow, //< events were dropped because a HiseEventBuffer was full
 		numFailureTypes
 	};
 
@@ -168,8 +177,31 @@ public:
 
 	void addStreamingFailure(double voiceUptime);
 
+	/** Returns the number of streaming failures since the creation of the logger (this is counted even if the logger is not active). */
+	int getNumStreamingFailures() const noexcept { return numStreamingFailures.get(); }
+
 	void logEvents(const HiseEventBuffer& masterBuffer);
 
+	/** Logs the events that the given buffer dropped since the last check and resets its counter. */
+	void checkEventBuffer(Processor* p, Location location, HiseEventBuffer& b);
+
+	/** Returns the number of dropped events since the creation of the logger (this is counted even if the logger is not active). */
+	int getNumDroppedEvents() const noexcept { return numDroppedEvents.get(); }
+
+	/** Adds a voice start record to the trace. */
+	void logVoiceStart(int voiceIndex, const HiseEvent& e);
+
+	/** Adds a voice stop record to the trace. */
+	void logVoiceStop(int voiceIndex, const HiseEvent& e);
+
+	/** Adds a streaming request record to the trace. */
+	void logStreamingRequest(bool previousRequestIsPending, int64 positionInSampleFile);
+
+	/** Converts the records from the audio thread into messages for the log file. */
+	void traceRecordDrained(const TraceRecorder::Record& r) override;
+
+	TraceRecorder& getTraceRecorder() noexcept { return traceRecorder; }
+
 	void logMessage(const String& errorMessage);
 
 	void logPerformanceWarning(const PerformanceData& logData);
@@ -249,6 +281,12 @@ private:
 	int callbackIndex = 0;
 	int messageIndex = 0;
 
+	Atomic<int> numStreamingFailures;
+
+	std::atomic<bool> streamingFailureNotRecorded { false };
+	std::atomic<bool> streamingFailureReportPending { false };
+	Atomic<int> numDroppedEvents;
+
 	void addAudioDeviceChange(FailureType changeType, double oldValue, double newValue);
 
 	double lastSampleRate = -1.0;
@@ -277,6 +315,8 @@ private:
 	CriticalSection debugLock;
 	CriticalSection messageLock;
 
+	TraceRecorder traceRecorder;
+
 	File currentLogFile;
 	bool currentlyLogging = false;
 	bool currentlyFailing = false;
@@ -70,6 +70,7 @@ String HiseEvent::getTypeAsString() const noexcept
 	case HiseEvent::Type::VolumeFade: return "VolumeFade";
 	case HiseEvent::Type::PitchFade: return "PitchFade";
 	case HiseEvent::Type::TimerEvent: return "TimerEvent";
+	case HiseEvent::Type::PluginParameter: return "PluginParameter";
 	case HiseEvent::Type::numTypes: jassertfalse;
 	default: jassertfalse;
 	}
@@ -90,8 +91,7 @@ double HiseEvent::getPitchFactorForEvent() const
 
 HiseEventBuffer::HiseEventBuffer()
 {
-	numUsed = HISE_EVENT_BUFFER_SIZE;
-	clear();
+	ensureAllocatedSize(HISE_EVENT_BUFFER_SIZE);
 }
 
 void HiseEventBuffer::clear()
@@ -104,38 +104,52 @@ void HiseEventBuffer::clear()
 	}
 }
 
+void HiseEventBuffer::ensureAllocatedSize(int numEventsToAllocate)
+{
+	if (numEventsToAllocate <= numAllocated)
+		return;
+
+	HeapBlock<HiseEvent> newBuffer(numEventsToAllocate, true);
+
+	if (numUsed != 0)
+		CopyHelpers::copyEvents(newBuffer, buffer, numUsed);
+
+	buffer.swapWith(newBuffer);
+	numAllocated = numEventsToAllocate;
+}
+
 void HiseEventBuffer::addEvent(const HiseEvent& hiseEvent)
 {
-	if (numUsed >= HISE_EVENT_BUFFER_SIZE)
+	if (numUsed >= numAllocated)
 	{
-		// Buffer full..
-		jassertfalse;
+		numDroppedEvents++;
 		return;
 	}
 
-	if (numUsed == 0)
+	const uint32 messageTimestamp = hiseEvent.getTimeStamp();
+
+	// Most events arrive in order, so check the end first
+	if (numUsed == 0 || buffer[numUsed - 1].getTimeStamp() <= messageTimestamp)
 	{
-		insertEventAtPosition(hiseEvent, 0);
+		insertEventAtPosition(hiseEvent, numUsed);
 		return;
 	}
 
-	jassert(numUsed < HISE_EVENT_BUFFER_SIZE);
+	// Look for the first event with a bigger timestamp
+	int start = 0;
+	int end = numUsed - 1;
 
-    const int numToLookFor = jmin<int>(numUsed, HISE_EVENT_BUFFER_SIZE);
-    
-	for (int i = 0; i < numToLookFor; i++)
+	while (start < end)
 	{
-		const int timestampInBuffer = buffer[i].getTimeStamp();
-		const int messageTimestamp = hiseEvent.getTimeStamp();
+		const int middle = (start + end) / 2;
 
-		if (timestampInBuffer > messageTimestamp)
-		{
-			insertEventAtPosition(hiseEvent, i);
-			return;
-		}
+		if (buffer[middle].getTimeStamp() > messageTimestamp)
+			end = middle;
+		else
+			start = middle + 1;
 	}
 
-	insertEventAtPosition(hiseEvent, numUsed);
+	insertEventAtPosition(hiseEvent, start);
 }
 
 void HiseEventBuffer::addEvent(const MidiMessage& midiMessage, int sampleNumber)
@@ -159,25 +173,21 @@ void HiseEventBuffer::addEvents(const MidiBuffer& otherBuffer)
 
 	while (it.getNextEvent(m, samplePos))
 	{
-		jassert(index < HISE_EVENT_BUFFER_SIZE);
-
 		HiseEvent e(m);
 
 		if (e.isEmpty()) continue;
 
+		if (index >= numAllocated)
+		{
+			numDroppedEvents++;
+			continue;
+		}
+
 		e.swapWith(buffer[index]);
 
 		buffer[index].setTimeStamp((uint16)samplePos);
 
 		numUsed++;
-
-		if (numUsed >= HISE_EVENT_BUFFER_SIZE)
-		{
-			// Buffer full..
-			jassertfalse;
-			return;
-		}
-
 		index++;
 	}
 }
@@ -185,17 +195,41 @@ void HiseEventBuffer::addEvents(const MidiBuffer& otherBuffer)
 
 void HiseEventBuffer::addEvents(const HiseEventBuffer &otherBuffer)
 {
-	Iterator iter(otherBuffer);
+	const int numToAdd = otherBuffer.numUsed;
+
+	if (numToAdd == 0)
+		return;
 
-	while (HiseEvent* e = iter.getNextEventPointer(false, false))
+	if (numUsed + numToAdd > numAllocated)
 	{
-		addEvent(*e);
+		// Add them one by one so that the events which don't fit are counted
+		Iterator iter(otherBuffer);
+
+		while (HiseEvent* e = iter.getNextEventPointer(false, false))
+			addEvent(*e);
+
+		return;
 	}
+
+	// Both buffers are sorted, so they can be merged from the back without moving an event twice
+	int thisIndex = numUsed - 1;
+	int otherIndex = numToAdd - 1;
+	int writeIndex = numUsed + numToAdd - 1;
+
+	while (otherIndex >= 0)
+	{
+		if (thisIndex >= 0 && buffer[thisIndex].getTimeStamp() > otherBuffer.buffer[otherIndex].getTimeStamp())
+			buffer[writeIndex--] = buffer[thisIndex--];
+		else
+			buffer[writeIndex--] = otherBuffer.buffer[otherIndex--];
+	}
+
+	numUsed += numToAdd;
 }
 
 HiseEvent HiseEventBuffer::getEvent(int index) const
 {
-	if (index >= 0 && index < HISE_EVENT_BUFFER_SIZE)
+	if (index >= 0 && index < numUsed)
 	{
 		return buffer[index];
 	}
@@ -274,13 +308,16 @@ void HiseEventBuffer::moveEventsAbove(HiseEventBuffer& targetBuffer, int lowestT
 
 void HiseEventBuffer::copyFrom(const HiseEventBuffer& otherBuffer)
 {
-    const int eventsToCopy = jmin<int>(otherBuffer.numUsed, HISE_EVENT_BUFFER_SIZE);
-    
-	memcpy(buffer, otherBuffer.buffer, sizeof(HiseEvent) * eventsToCopy);
+	const int eventsToCopy = jmin<int>(otherBuffer.numUsed, numAllocated);
+
+	CopyHelpers::copyEvents(buffer, otherBuffer.buffer, eventsToCopy);
 
-	jassert(otherBuffer.numUsed < HISE_EVENT_BUFFER_SIZE);
+	if (eventsToCopy < numUsed)
+		HiseEvent::clear(buffer + eventsToCopy, numUsed - eventsToCopy);
 
-	numUsed = otherBuffer.numUsed;
+	numDroppedEvents += otherBuffer.numUsed - eventsToCopy;
+
+	numUsed = eventsToCopy;
 }
 
 
@@ -298,7 +335,6 @@ bool HiseEventBuffer::Iterator::getNextEvent(HiseEvent& b, int &samplePosition,
 		  (skipIgnoredEvents && buffer->buffer[index].isIgnored())))
 	{
 		index++;
-		jassert(index < HISE_EVENT_BUFFER_SIZE);
 	}
 		
 	if (index < buffer->numUsed)
@@ -329,7 +365,6 @@ const HiseEvent* HiseEventBuffer::Iterator::getNextConstEventPointer(bool skipIg
 		  (skipIgnoredEvents && buffer->buffer[index].isIgnored())))
 	{
 		index++;
-		jassert(index < HISE_EVENT_BUFFER_SIZE);
 	}
 
 	if (index < buffer->numUsed)
@@ -354,23 +389,11 @@ void HiseEventBuffer::insertEventAtPosition(const HiseEvent& e, int positionInBu
 		return;
 	}
 
-	if (numUsed > positionInBuffer)
-	{
-		for (int i = jmin<int>(numUsed-1, HISE_EVENT_BUFFER_SIZE-2); i >= positionInBuffer; i--)
-		{
-			jassert(i + 1 < HISE_EVENT_BUFFER_SIZE);
+	jassert(numUsed < numAllocated && positionInBuffer <= numUsed);
 
-			buffer[i + 1] = buffer[i];
-		}
-	}
+	if (numUsed > positionInBuffer)
+		std::move_backward(buffer + positionInBuffer, buffer + numUsed, buffer + numUsed + 1);
 
-    if(positionInBuffer < HISE_EVENT_BUFFER_SIZE)
-    {
-        buffer[positionInBuffer] = HiseEvent(e);
-        numUsed++;
-    }
-    else
-    {
-        jassertfalse;
-    }
+	buffer[positionInBuffer] = HiseEvent(e);
+	numUsed++;
 }
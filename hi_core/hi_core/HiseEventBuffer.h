@@ -55,6 +55,7 @@ public:
 		VolumeFade,
 		PitchFade,
 		TimerEvent,
+		PluginParameter,
 		numTypes
 	};
 
@@ -197,6 +198,23 @@ public:
 		return e;
 	}
 
+	/** Creates an event that sets the control with the given index of a MIDI processor to a host parameter value.
+	*
+	*	The processor index is stored as channel (like the timer index), the control index as event ID and the
+	*	value uses the four bytes of the transpose, gain and detune values (which are meaningless for this type).
+	*/
+	static HiseEvent createPluginParameterEvent(uint8 processorIndex, uint16 controlIndex, float parameterValue, uint16 offset)
+	{
+		HiseEvent e(Type::PluginParameter, 0, 0, processorIndex);
+
+		e.setEventId(controlIndex);
+		e.setParameterValue(parameterValue);
+		e.setArtificial();
+		e.setTimeStamp(offset);
+
+		return e;
+	}
+
 	bool isVolumeFade() const noexcept{ return type == Type::VolumeFade; };
 	bool isPitchFade() const noexcept{ return type == Type::PitchFade; }
 
@@ -205,6 +223,24 @@ public:
 	bool isTimerEvent() const noexcept { return type == Type::TimerEvent; };
 	int getTimerIndex() const noexcept { return channel; }	
 
+	bool isPluginParameterEvent() const noexcept { return type == Type::PluginParameter; };
+
+	/** Returns the index of the control that receives the value of a plugin parameter event. */
+	int getParameterControlIndex() const noexcept { return (int)eventId; };
+
+	float getParameterValue() const noexcept
+	{
+		float v;
+		memcpy(&v, &transposeValue, sizeof(float));
+		return v;
+	}
+
+	void setParameterValue(float newValue) noexcept
+	{
+		static_assert(offsetof(HiseEvent, cents) - offsetof(HiseEvent, transposeValue) == sizeof(float) - 1, "The value must fit into the detune bytes");
+		memcpy(&transposeValue, &newValue, sizeof(float));
+	}
+
 	// ========================================================================================================================== MIDI Message methods
 
 	uint16 getTimeStamp() const noexcept{ return timeStamp; };
@@ -355,8 +391,13 @@ private:
 	
 };
 
-#define HISE_EVENT_BUFFER_SIZE 256
-
+/** A sorted list of HiseEvents that is used to pass the events of one audio callback around.
+*
+*	The storage is allocated in advance (HISE_EVENT_BUFFER_SIZE events or the amount given to ensureAllocatedSize())
+*	and is never resized on the audio thread. Events are inserted with a binary search for their timestamp (events
+*	with the same timestamp keep the order in which they were added). If the buffer is full, the event is dropped and
+*	counted, so you can report it with DebugLogger::checkEventBuffer().
+*/
 class HiseEventBuffer
 {
 public:
@@ -494,6 +535,26 @@ public:
 	bool isEmpty() const noexcept{ return numUsed == 0; };
 	int getNumUsed() const { return numUsed; }
 
+	/** Returns the number of events that fit into the buffer. */
+	int getNumAllocated() const noexcept { return numAllocated; }
+
+	/** Grows the storage so that it can hold at least the given number of events. The events in the buffer are kept.
+	*
+	*	This allocates, so don't call it while the buffer is used on the audio thread.
+	*/
+	void ensureAllocatedSize(int numEventsToAllocate);
+
+	/** Returns the number of events that were dropped because the buffer was full. */
+	int getNumDroppedEvents() const noexcept { return numDroppedEvents; }
+
+	/** Resets the counter for the dropped events and returns its last value. */
+	int resetDroppedEventCounter() noexcept
+	{
+		const int numDropped = numDroppedEvents;
+		numDroppedEvents = 0;
+		return numDropped;
+	}
+
 	HiseEvent getEvent(int index) const;
 
 	void subtractFromTimeStamps(int delta);
@@ -557,11 +618,13 @@ private:
 
 	void insertEventAtPosition(const HiseEvent& e, int positionInBuffer);
 
-	HiseEvent buffer[HISE_EVENT_BUFFER_SIZE];
+	HeapBlock<HiseEvent> buffer;
 
+	int numAllocated = 0;
 	int numUsed = 0;
+	int numDroppedEvents = 0;
 
-	
+	JUCE_DECLARE_NON_COPYABLE(HiseEventBuffer)
 };
 
 
@@ -50,12 +50,16 @@ public:
 		testPitchWheel();
 		testEventBuffer();
 		testFadeEvent();
+		testPluginParameterEvents();
 		testEventBufferCopyMethods();
 		testMidiBufferCopyMethods();
 		testMidiBufferIterators();
 		testEventBufferMoveOperations();
 		testEventHandler();
 		testEventBufferStack();
+		testEventBufferInsertOrder();
+		testEventBufferCapacity();
+		testEventBufferPerformance();
 		
 	}
 
@@ -226,6 +230,232 @@ private:
 		expect(stack.getNumUsed() == 0);
 	}
 
+	void testEventBufferInsertOrder()
+	{
+		beginTest("Testing insert order");
+
+		HiseEventBuffer b;
+		Array<HiseEvent> reference;
+
+		for (int i = 0; i < HISE_EVENT_BUFFER_SIZE; i++)
+		{
+			HiseEvent e = generateRandomHiseEvent();
+
+			// Provoke a lot of equal timestamps
+			e.setTimeStamp((uint16)r.nextInt(32));
+
+			b.addEvent(e);
+			addToReference(reference, e);
+		}
+
+		expectEquals<int>(b.getNumUsed(), reference.size(), "Size");
+
+		for (int i = 0; i < reference.size(); i++)
+			expect(b.getEvent(i) == reference[i], "Event " + String(i));
+
+		beginTest("Testing merging two buffers");
+
+		HiseEventBuffer b1, b2;
+		Array<HiseEvent> mergeReference;
+
+		const int numToFill = HISE_EVENT_BUFFER_SIZE / 2;
+
+		for (int i = 0; i < numToFill; i++)
+		{
+			HiseEvent e = generateRandomHiseEvent();
+			e.setTimeStamp((uint16)r.nextInt(64));
+
+			b1.addEvent(e);
+			addToReference(mergeReference, e);
+		}
+
+		for (int i = 0; i < numToFill; i++)
+		{
+			HiseEvent e = generateRandomHiseEvent();
+			e.setTimeStamp((uint16)r.nextInt(64));
+
+			b2.addEvent(e);
+		}
+
+		HiseEventBuffer::Iterator iter(b2);
+
+		while (const HiseEvent* e = iter.getNextConstEventPointer())
+			addToReference(mergeReference, *e);
+
+		b1.addEvents(b2);
+
+		expectEquals<int>(b1.getNumUsed(), mergeReference.size(), "Merged size");
+
+		for (int i = 0; i < mergeReference.size(); i++)
+			expect(b1.getEvent(i) == mergeReference[i], "Merged event " + String(i));
+	}
+
+	void testEventBufferCapacity()
+	{
+		beginTest("Testing overflow");
+
+		HiseEventBuffer b;
+
+		expectEquals<int>(b.getNumAllocated(), HISE_EVENT_BUFFER_SIZE, "Initial capacity");
+
+		for (int i = 0; i < HISE_EVENT_BUFFER_SIZE + 10; i++)
+			b.addEvent(generateRandomHiseEvent());
+
+		expectEquals<int>(b.getNumUsed(), HISE_EVENT_BUFFER_SIZE, "Full buffer");
+		expectEquals<int>(b.getNumDroppedEvents(), 10, "Dropped events");
+		expectEquals<int>(b.resetDroppedEventCounter(), 10, "Reset counter");
+		expectEquals<int>(b.getNumDroppedEvents(), 0, "Counter after reset");
+
+		beginTest("Testing growing");
+
+		Array<HiseEvent> before;
+
+		for (int i = 0; i < b.getNumUsed(); i++)
+			before.add(b.getEvent(i));
+
+		b.ensureAllocatedSize(HISE_EVENT_BUFFER_SIZE * 4);
+
+		expectEquals<int>(b.getNumAllocated(), HISE_EVENT_BUFFER_SIZE * 4, "Capacity");
+		expectEquals<int>(b.getNumUsed(), before.size(), "Size after growing");
+
+		for (int i = 0; i < before.size(); i++)
+			expect(b.getEvent(i) == before[i], "Event after growing " + String(i));
+
+		for (int i = 0; i < HISE_EVENT_BUFFER_SIZE; i++)
+			b.addEvent(generateRandomHiseEvent());
+
+		expectEquals<int>(b.getNumUsed(), HISE_EVENT_BUFFER_SIZE * 2, "Size after adding");
+		expectEquals<int>(b.getNumDroppedEvents(), 0, "No dropped events");
+
+		beginTest("Testing copying into a smaller buffer");
+
+		HiseEventBuffer smallBuffer;
+
+		smallBuffer.copyFrom(b);
+
+		expectEquals<int>(smallBuffer.getNumUsed(), HISE_EVENT_BUFFER_SIZE, "Copied events");
+		expectEquals<int>(smallBuffer.getNumDroppedEvents(), HISE_EVENT_BUFFER_SIZE, "Dropped events after copying");
+
+		for (int i = 0; i < smallBuffer.getNumUsed(); i++)
+			expect(smallBuffer.getEvent(i) == b.getEvent(i), "Copied event " + String(i));
+
+		HiseEventBuffer mergeTarget;
+
+		mergeTarget.addEvents(smallBuffer);
+		mergeTarget.addEvents(smallBuffer);
+
+		expectEquals<int>(mergeTarget.getNumUsed(), HISE_EVENT_BUFFER_SIZE, "Merged events");
+		expectEquals<int>(mergeTarget.getNumDroppedEvents(), HISE_EVENT_BUFFER_SIZE, "Dropped events after merging");
+	}
+
+	void testEventBufferPerformance()
+	{
+		const int numIterations = 1000;
+		const int numEventsPerBlock = 1024;
+
+		beginTest("Benchmarking sorted insertion of " + String(numEventsPerBlock) + " events");
+
+		HiseEventBuffer b;
+		b.ensureAllocatedSize(numEventsPerBlock);
+
+		// An MPE controller: 16 channels that send pitch bend, pressure and timbre every 24 samples
+		Array<HiseEvent> mpeEvents;
+
+		for (int timestamp = 0; mpeEvents.size() < numEventsPerBlock; timestamp += 24)
+		{
+			for (int channel = 1; channel <= 16 && mpeEvents.size() < numEventsPerBlock; channel++)
+			{
+				HiseEvent e(HiseEvent::Type::Controller, 74, (uint8)r.nextInt(128), (uint8)channel);
+				e.setTimeStamp((uint16)(timestamp + r.nextInt(3)));
+				mpeEvents.add(e);
+			}
+		}
+
+		Array<HiseEvent> randomEvents;
+
+		for (int i = 0; i < numEventsPerBlock; i++)
+		{
+			HiseEvent e = generateRandomHiseEvent();
+			e.setTimeStamp((uint16)r.nextInt(512));
+			randomEvents.add(e);
+		}
+
+		logMessage("MPE events: " + String(measureInsertion(b, mpeEvents, numIterations), 1) + " ns per event");
+		logMessage("Random events: " + String(measureInsertion(b, randomEvents, numIterations), 1) + " ns per event");
+
+		const double start = Time::getMillisecondCounterHiRes();
+
+		for (int i = 0; i < numIterations; i++)
+		{
+			Array<HiseEvent> linearBuffer;
+			linearBuffer.ensureStorageAllocated(numEventsPerBlock);
+
+			for (int j = 0; j < randomEvents.size(); j++)
+				addToReference(linearBuffer, randomEvents[j]);
+		}
+
+		const double linearTime = Time::getMillisecondCounterHiRes() - start;
+
+		logMessage("Random events with linear search: " + String(linearTime * 1000000.0 / (double)(numIterations * numEventsPerBlock), 1) + " ns per event");
+
+		expectEquals<int>(b.getNumDroppedEvents(), 0, "No dropped events");
+
+		beginTest("Benchmarking merging two buffers");
+
+		HiseEventBuffer source;
+		HiseEventBuffer target;
+
+		source.ensureAllocatedSize(numEventsPerBlock);
+		target.ensureAllocatedSize(numEventsPerBlock * 2);
+
+		for (int i = 0; i < numEventsPerBlock; i++)
+			source.addEvent(randomEvents[i]);
+
+		const double mergeStart = Time::getMillisecondCounterHiRes();
+
+		for (int i = 0; i < numIterations; i++)
+		{
+			target.copyFrom(source);
+			target.addEvents(source);
+		}
+
+		const double mergeTime = Time::getMillisecondCounterHiRes() - mergeStart;
+
+		logMessage("Merging: " + String(mergeTime * 1000000.0 / (double)(numIterations * numEventsPerBlock), 1) + " ns per event");
+
+		expectEquals<int>(target.getNumUsed(), numEventsPerBlock * 2, "Merged size");
+		expectEquals<int>(target.getNumDroppedEvents(), 0, "No dropped events");
+	}
+
+	/** Returns the average time in nanoseconds for adding one event. */
+	double measureInsertion(HiseEventBuffer& b, const Array<HiseEvent>& events, int numIterations)
+	{
+		const double start = Time::getMillisecondCounterHiRes();
+
+		for (int i = 0; i < numIterations; i++)
+		{
+			b.clear();
+
+			for (int j = 0; j < events.size(); j++)
+				b.addEvent(events[j]);
+		}
+
+		const double duration = Time::getMillisecondCounterHiRes() - start;
+
+		return duration * 1000000.0 / (double)(numIterations * events.size());
+	}
+
+	/** Inserts the event after the last event with the same timestamp (this is the expected behaviour of the HiseEventBuffer). */
+	static void addToReference(Array<HiseEvent>& list, const HiseEvent& e)
+	{
+		int index = 0;
+
+		while (index < list.size() && list[index].getTimeStamp() <= e.getTimeStamp())
+			index++;
+
+		list.insert(index, e);
+	}
+
 	void testPitchWheel()
 	{
 
@@ -393,6 +623,83 @@ private:
 
 	}
 
+	void testPluginParameterEvents()
+	{
+		beginTest("Testing plugin parameter events");
+
+		HiseEvent e = HiseEvent::createPluginParameterEvent(3, 1200, -0.3742f, 17);
+
+		expect(e.isPluginParameterEvent(), "Type");
+		expect(e.isArtificial(), "Parameter Artificial");
+		expectEquals<int>(e.getChannel(), 3, "Processor Index");
+		expectEquals<int>(e.getParameterControlIndex(), 1200, "Control Index");
+		expectEquals<float>(e.getParameterValue(), -0.3742f, "Value");
+		expectEquals<int>(e.getTimeStamp(), 17, "Timestamp");
+
+		HostAutomationQueue queue;
+
+		const int first = queue.addParameter(1, 4);
+		const int second = queue.addParameter(1, 5);
+
+		queue.addChange(first, 0.5f);
+		queue.addChange(second, 2.0f);
+		queue.addChange(first, 0.25f);
+
+		expect(queue.hasPendingChanges(first), "Pending");
+
+		HiseEventBuffer b;
+
+		queue.fillEventBuffer(b, 512, 44100.0, true);
+
+		expect(!queue.hasPendingChanges(first), "Not pending");
+		expectEquals<int>(b.getNumUsed(), 3, "Event amount");
+
+		HiseEventBuffer::Iterator iter(b);
+
+		const HiseEvent* e1 = iter.getNextConstEventPointer();
+		const HiseEvent* e2 = iter.getNextConstEventPointer();
+		const HiseEvent* e3 = iter.getNextConstEventPointer();
+
+		expectEquals<float>(e1->getParameterValue(), 0.5f, "Order 1");
+		expectEquals<int>(e2->getParameterControlIndex(), 5, "Order 2");
+		expectEquals<float>(e3->getParameterValue(), 0.25f, "Order 3");
+
+		b.clear();
+
+		queue.addChange(first, 0.75f);
+		queue.invalidate(first);
+		queue.fillEventBuffer(b, 512, 44100.0, true);
+
+		expect(b.isEmpty(), "Invalidated changes");
+
+		beginTest("Testing plugin parameter smoothing");
+
+		// 2048 samples = 32 steps with 64 samples
+		queue.setSmoothingTime(second, 2048.0 / 44.1);
+		queue.addChange(second, 4.0f);
+		queue.fillEventBuffer(b, 512, 44100.0, true);
+
+		expectEquals<int>(b.getNumUsed(), 512 / HostAutomationQueue::SMOOTHING_INTERVAL, "Steps per buffer");
+		expect(queue.hasPendingChanges(second), "Ramp is pending");
+
+		for (int i = 0; i < 3; i++)
+		{
+			b.clear();
+			queue.fillEventBuffer(b, 512, 44100.0, true);
+		}
+
+		HiseEventBuffer::Iterator rampIter(b);
+
+		const HiseEvent* last = nullptr;
+
+		while (const HiseEvent* s = rampIter.getNextConstEventPointer())
+			last = s;
+
+		expect(last != nullptr, "Last step");
+		expectEquals<float>(last->getParameterValue(), 4.0f, "Ramp target");
+		expect(!queue.hasPendingChanges(second), "Ramp finished");
+	}
+
 	void testMidiBufferIterators()
 	{
 		beginTest("Testing iterators");
@@ -0,0 +1,273 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+HostAutomationQueue::ThreadQueue::ThreadQueue():
+	owner(nullptr),
+	queue(AUTOMATION_QUEUE_SIZE)
+{
+
+}
+
+HostAutomationQueue::HostAutomationQueue():
+	numThreads(0),
+	numDroppedChanges(0),
+	sequenceCounter(0),
+	audioThreadId(nullptr),
+	lastCallbackTime(0.0),
+	lastCallbackLength(0.0)
+{
+	for (int i = 0; i < NUM_AUTOMATION_THREADS; i++)
+		queues.add(new ThreadQueue());
+}
+
+HostAutomationQueue::~HostAutomationQueue()
+{
+
+}
+
+int HostAutomationQueue::addParameter(int processorIndex, int controlIndex)
+{
+	// Parameters must be registered before the audio callback starts...
+	jassert(!isAudioThreadRunning());
+
+	parameters.add(new Parameter(processorIndex, controlIndex));
+	rampingParameters.ensureStorageAllocated(parameters.size());
+
+	return parameters.size() - 1;
+}
+
+void HostAutomationQueue::setSmoothingTime(int parameterIndex, double milliseconds)
+{
+	if (auto p = parameters[parameterIndex])
+		p->smoothingTime.store(jmax<double>(0.0, milliseconds));
+}
+
+void HostAutomationQueue::addChange(int parameterIndex, float newValue) noexcept
+{
+	jassert(isPositiveAndBelow(parameterIndex, parameters.size()));
+
+	ThreadQueue* q = getQueueForCurrentThread();
+
+	if (q == nullptr)
+	{
+		// You are setting parameters from more threads than there are queues...
+		++numDroppedChanges;
+		return;
+	}
+
+	const bool isAudioThread = audioThreadId.get() == Thread::getCurrentThreadId();
+
+	Change c = { parameterIndex, newValue, isAudioThread ? -1.0 : Time::getMillisecondCounterHiRes(), ++sequenceCounter };
+
+	if (q->queue.try_enqueue(c))
+		++parameters.getUnchecked(parameterIndex)->numPendingChanges;
+	else
+		++numDroppedChanges;
+}
+
+void HostAutomationQueue::invalidate(int parameterIndex) noexcept
+{
+	if (auto p = parameters[parameterIndex])
+		p->invalidatedSequenceIndex.set(sequenceCounter.get());
+}
+
+bool HostAutomationQueue::hasPendingChanges(int parameterIndex) const noexcept
+{
+	if (auto p = parameters[parameterIndex])
+		return p->numPendingChanges.get() > 0;
+
+	return false;
+}
+
+bool HostAutomationQueue::isAudioThreadRunning() const noexcept
+{
+	const double timeout = jmax<double>(100.0, 4.0 * lastCallbackLength.load());
+
+	return Time::getMillisecondCounterHiRes() - lastCallbackTime.load() < timeout;
+}
+
+void HostAutomationQueue::fillEventBuffer(HiseEventBuffer& buffer, int numSamples, double sampleRate, bool isNonRealtime) noexcept
+{
+	if (numSamples <= 0 || sampleRate <= 0.0)
+		return;
+
+	audioThreadId.set(Thread::getCurrentThreadId());
+
+	const double now = Time::getMillisecondCounterHiRes();
+	const double blockLength = 1000.0 * (double)numSamples / sampleRate;
+
+	lastCallbackTime.store(now);
+	lastCallbackLength.store(blockLength);
+
+	// The changes that arrived during the last block are spread over this block (this adds one block of latency
+	// but keeps the distance between the changes intact).
+	const double blockStart = now - blockLength;
+
+	const int numUsedQueues = jmin<int>(numThreads.get(), NUM_AUTOMATION_THREADS);
+
+	for (int i = 0; i < numUsedQueues; i++)
+	{
+		ThreadQueue& q = *queues.getUnchecked(i);
+
+		while (buffer.getNumUsed() < buffer.getNumAllocated() - MIN_FREE_EVENTS)
+		{
+			Change c;
+
+			if (!q.queue.try_dequeue(c))
+				break;
+
+			Parameter& p = *parameters.getUnchecked(c.parameterIndex);
+
+			--p.numPendingChanges;
+
+			if (c.sequenceIndex <= p.invalidatedSequenceIndex.get())
+				continue;
+
+			int offset = 0;
+
+			if (!isNonRealtime && c.timeStamp > 0.0)
+				offset = jlimit<int>(0, numSamples - 1, roundToInt((c.timeStamp - blockStart) / blockLength * (double)numSamples));
+
+			if (p.smoothingTime.load() > 0.0 && p.valueInitialised)
+			{
+				p.advanceRamp(buffer, offset);
+
+				// A running ramp is just retargeted, otherwise the ramp counts as pending change until it's finished
+				if (p.numStepsLeft == 0)
+				{
+					++p.numPendingChanges;
+					rampingParameters.addIfNotAlreadyThere(c.parameterIndex);
+				}
+
+				p.startRamp(c.value, offset, sampleRate, c.sequenceIndex);
+			}
+			else
+			{
+				if (p.numStepsLeft != 0)
+				{
+					p.stopRamp();
+					rampingParameters.removeFirstMatchingValue(c.parameterIndex);
+				}
+
+				addEvent(buffer, p, c.value, offset);
+			}
+		}
+	}
+
+	for (int i = 0; i < rampingParameters.size(); i++)
+	{
+		Parameter& p = *parameters.getUnchecked(rampingParameters.getUnchecked(i));
+
+		if (p.rampSequenceIndex > p.invalidatedSequenceIndex.get())
+			p.advanceRamp(buffer, numSamples);
+		else
+			p.stopRamp();
+
+		if (p.numStepsLeft == 0)
+		{
+			rampingParameters.remove(i--);
+			continue;
+		}
+
+		p.nextStepOffset -= numSamples;
+	}
+}
+
+HostAutomationQueue::ThreadQueue* HostAutomationQueue::getQueueForCurrentThread() noexcept
+{
+	const Thread::ThreadID threadId = Thread::getCurrentThreadId();
+	const int numUsedQueues = jmin<int>(numThreads.get(), NUM_AUTOMATION_THREADS);
+
+	for (int i = 0; i < numUsedQueues; i++)
+	{
+		if (queues.getUnchecked(i)->owner.get() == threadId)
+			return queues.getUnchecked(i);
+	}
+
+	const int newIndex = ++numThreads - 1;
+
+	if (newIndex >= NUM_AUTOMATION_THREADS)
+		return nullptr;
+
+	ThreadQueue* q = queues.getUnchecked(newIndex);
+	q->owner.set(threadId);
+
+	return q;
+}
+
+void HostAutomationQueue::addEvent(HiseEventBuffer& buffer, Parameter& p, float value, int offset) noexcept
+{
+	p.currentValue = value;
+	p.valueInitialised = true;
+
+	buffer.addEvent(HiseEvent::createPluginParameterEvent((uint8)p.processorIndex, (uint16)p.controlIndex, value, (uint16)offset));
+}
+
+void HostAutomationQueue::Parameter::startRamp(float newTargetValue, int offset, double sampleRate, int sequenceIndex)
+{
+	const double numSamples = smoothingTime.load() * 0.001 * sampleRate;
+
+	targetValue = newTargetValue;
+	numStepsLeft = jmax<int>(1, roundToInt(numSamples / (double)SMOOTHING_INTERVAL));
+	delta = (targetValue - currentValue) / (float)numStepsLeft;
+	nextStepOffset = offset;
+	rampSequenceIndex = sequenceIndex;
+}
+
+void HostAutomationQueue::Parameter::advanceRamp(HiseEventBuffer& buffer, int endOffset)
+{
+	if (numStepsLeft == 0)
+		return;
+
+	while (numStepsLeft > 0 && nextStepOffset < endOffset)
+	{
+		currentValue = (--numStepsLeft == 0) ? targetValue : currentValue + delta;
+
+		// If the buffer is full, the step is skipped and the next one catches up
+		if (buffer.getNumUsed() < buffer.getNumAllocated())
+			buffer.addEvent(HiseEvent::createPluginParameterEvent((uint8)processorIndex, (uint16)controlIndex, currentValue, (uint16)jmax<int>(0, nextStepOffset)));
+
+		nextStepOffset += SMOOTHING_INTERVAL;
+	}
+
+	if (numStepsLeft == 0)
+		--numPendingChanges;
+}
+
+void HostAutomationQueue::Parameter::stopRamp()
+{
+	if (numStepsLeft != 0)
+	{
+		numStepsLeft = 0;
+		--numPendingChanges;
+	}
+}
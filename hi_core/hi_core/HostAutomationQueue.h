@@ -0,0 +1,181 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+
+
+#ifndef HOSTAUTOMATIONQUEUE_H_INCLUDED
+#define HOSTAUTOMATIONQUEUE_H_INCLUDED
+
+#include "../additional_libraries/lockfree_fifo/readerwriterqueue.h"
+
+#define NUM_AUTOMATION_THREADS 8
+#define AUTOMATION_QUEUE_SIZE 2048
+
+/** A lock free queue that delivers host parameter changes to the audio thread.
+*
+*	Hosts call the setValue() method of a plugin parameter from whatever thread they like (the message thread,
+*	a dedicated automation thread or the audio thread itself). Instead of forwarding the change to the script
+*	control right away (which needs to lock against the audio thread), the parameter pushes it into this queue
+*	together with the time it arrived. Like the TraceRecorder, every thread that adds a change claims one of the
+*	NUM_AUTOMATION_THREADS single producer / single consumer queues, so adding a change never locks or allocates.
+*
+*	At the start of every audio callback, the MainController calls fillEventBuffer(). It converts the arrival time
+*	of each change into a sample offset within the current buffer and adds a HiseEvent of the type
+*	HiseEvent::Type::PluginParameter to the master event buffer. The events are processed in order by the
+*	MIDI processor that owns the control (see HiseEvent::createPluginParameterEvent()).
+*
+*	If a parameter has a smoothing time, a change starts a linear ramp from the last value to the new value and
+*	the queue sends an event every SMOOTHING_INTERVAL samples until the target is reached.
+*
+*	All parameters must be registered with addParameter() before the audio callback starts.
+*/
+class HostAutomationQueue
+{
+public:
+
+	enum
+	{
+		SMOOTHING_INTERVAL = 64, //< the number of samples between two events of a smoothed parameter
+		MIN_FREE_EVENTS = 32 //< changes are kept in the queue if the event buffer has less space than this
+	};
+
+	HostAutomationQueue();
+
+	~HostAutomationQueue();
+
+	/** Registers a parameter and returns the index that you need to pass into addChange().
+	*
+	*	@param processorIndex the index of the MIDI processor in its chain (the event's channel).
+	*	@param controlIndex the index of the control that will receive the value.
+	*/
+	int addParameter(int processorIndex, int controlIndex);
+
+	/** Sets the time in milliseconds that a change needs to reach its target value. 0.0 disables the smoothing. */
+	void setSmoothingTime(int parameterIndex, double milliseconds);
+
+	/** Adds a change to the queue of the current thread. This can be called from any thread and never locks. */
+	void addChange(int parameterIndex, float newValue) noexcept;
+
+	/** Discards all pending changes and stops the smoothing of the given parameter.
+	*
+	*	Call this if you set the control value directly so that an older value in the queue doesn't overwrite it.
+	*/
+	void invalidate(int parameterIndex) noexcept;
+
+	/** Checks if there are changes for the parameter that haven't reached the control yet. */
+	bool hasPendingChanges(int parameterIndex) const noexcept;
+
+	/** Checks whether the audio thread has collected the changes recently.
+	*
+	*	If this returns false (because the host has stopped the audio processing), you must apply the change directly
+	*	or it will only be delivered when the audio callback restarts.
+	*/
+	bool isAudioThreadRunning() const noexcept;
+
+	/** Adds the pending changes as HiseEvents to the buffer. Call this at the start of the audio callback.
+	*
+	*	This must not be called from more than one thread at the same time.
+	*/
+	void fillEventBuffer(HiseEventBuffer& buffer, int numSamples, double sampleRate, bool isNonRealtime) noexcept;
+
+private:
+
+	struct Change
+	{
+		int parameterIndex;
+		float value;
+		double timeStamp; //< the time in milliseconds (or -1.0 if the change was added by the audio thread)
+		int sequenceIndex;
+	};
+
+	struct Parameter
+	{
+		Parameter(int processorIndex_, int controlIndex_):
+			processorIndex(processorIndex_),
+			controlIndex(controlIndex_)
+		{}
+
+		void startRamp(float targetValue, int offset, double sampleRate, int sequenceIndex);
+
+		void advanceRamp(HiseEventBuffer& buffer, int endOffset);
+
+		void stopRamp();
+
+		const int processorIndex;
+		const int controlIndex;
+
+		std::atomic<double> smoothingTime{ 0.0 };
+
+		Atomic<int> invalidatedSequenceIndex;
+		Atomic<int> numPendingChanges;
+
+		// Only accessed by the audio thread
+
+		bool valueInitialised = false;
+		float currentValue = 0.0f;
+		float targetValue = 0.0f;
+		float delta = 0.0f;
+		int numStepsLeft = 0;
+		int nextStepOffset = 0;
+		int rampSequenceIndex = 0;
+	};
+
+	struct ThreadQueue
+	{
+		ThreadQueue();
+
+		Atomic<Thread::ThreadID> owner;
+
+		moodycamel::ReaderWriterQueue<Change> queue;
+	};
+
+	ThreadQueue* getQueueForCurrentThread() noexcept;
+
+	void addEvent(HiseEventBuffer& buffer, Parameter& p, float value, int offset) noexcept;
+
+	OwnedArray<Parameter> parameters;
+	Array<int> rampingParameters;
+
+	OwnedArray<ThreadQueue> queues;
+	Atomic<int> numThreads;
+	Atomic<int> numDroppedChanges;
+	Atomic<int> sequenceCounter;
+
+	Atomic<Thread::ThreadID> audioThreadId;
+	std::atomic<double> lastCallbackTime;
+	std::atomic<double> lastCallbackLength;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HostAutomationQueue)
+};
+
+#endif  // HOSTAUTOMATIONQUEUE_H_INCLUDED
@@ -36,9 +36,22 @@ JavascriptTokeniser::~JavascriptTokeniser() {}
 
 int JavascriptTokeniser::readNextToken (CodeDocument::Iterator& source)
 {
+    if (tokenCache != nullptr)
+    {
+        const int cachedType = tokenCache->readNextToken (source);
+
+        if (cachedType != -1)
+            return cachedType;
+    }
+
     return JavascriptTokeniserFunctions::readNextToken (source);
 }
 
+void JavascriptTokeniser::setTokenCache (JavascriptTokenCache* newCache) noexcept
+{
+    tokenCache = newCache;
+}
+
 CodeEditorComponent::ColourScheme JavascriptTokeniser::getDefaultColourScheme()
 {
     struct Type
@@ -74,3 +87,355 @@ bool JavascriptTokeniser::isReservedKeyword (const String& token) noexcept
 {
     return JavascriptTokeniserFunctions::isReservedKeyword (token.getCharPointer(), token.length());
 }
+
+
+JavascriptTokenCache::JavascriptTokenCache(CodeDocument& doc_) :
+	doc(doc_),
+	numTokenisedLines(0)
+{
+	doc.addListener(this);
+
+	rebuild();
+}
+
+JavascriptTokenCache::~JavascriptTokenCache()
+{
+	masterReference.clear();
+
+	doc.removeListener(this);
+}
+
+void JavascriptTokenCache::rebuild()
+{
+	lines.clear();
+
+	bool inComment = false;
+
+	for (int i = 0; i < doc.getNumLines(); i++)
+	{
+		Line* l = lines.add(new Line());
+
+		inComment = tokeniseLine(*l, doc.getLine(i), inComment);
+	}
+}
+
+void JavascriptTokenCache::codeDocumentTextInserted(const String& /*newText*/, int insertIndex)
+{
+	const int firstLine = CodeDocument::Position(doc, insertIndex).getLineNumber();
+	const int numNewLines = doc.getNumLines() - lines.size();
+
+	// Inserting the lines one by one gets slower than a rebuild when a lot of text is pasted
+	if (numNewLines < 0 || numNewLines > 64 || !isPositiveAndBelow(firstLine, lines.size()))
+	{
+		rebuild();
+		return;
+	}
+
+	for (int i = 0; i < numNewLines; i++)
+		lines.insert(firstLine + 1, new Line());
+
+	updateLines(firstLine, firstLine + numNewLines);
+}
+
+void JavascriptTokenCache::codeDocumentTextDeleted(int startIndex, int /*endIndex*/)
+{
+	const int firstLine = CodeDocument::Position(doc, startIndex).getLineNumber();
+	const int numRemovedLines = lines.size() - doc.getNumLines();
+
+	if (numRemovedLines < 0 || !isPositiveAndBelow(firstLine, doc.getNumLines()))
+	{
+		rebuild();
+		return;
+	}
+
+	lines.removeRange(firstLine + 1, numRemovedLines);
+
+	updateLines(firstLine, firstLine);
+}
+
+void JavascriptTokenCache::updateLines(int firstLine, int lastChangedLine)
+{
+	bool inComment = lines[firstLine]->startsInComment;
+
+	for (int i = firstLine; i < lines.size(); i++)
+	{
+		inComment = tokeniseLine(*lines.getUnchecked(i), doc.getLine(i), inComment);
+
+		// Stop as soon as the next line starts with the same state as before
+		if (i >= lastChangedLine && (i == lines.size() - 1 || lines.getUnchecked(i + 1)->startsInComment == inComment))
+			break;
+	}
+}
+
+int JavascriptTokenCache::getBracketIndex(juce_wchar c) noexcept
+{
+	switch (c)
+	{
+	case '(':	return RoundOpen;
+	case ')':	return RoundClose;
+	case '[':	return SquareOpen;
+	case ']':	return SquareClose;
+	case '{':	return CurlyOpen;
+	case '}':	return CurlyClose;
+	case '"':	return Quotes;
+	default:	return -1;
+	}
+}
+
+static JavascriptTokenCache::DeclarationType getDeclarationTypeForKeyword(String::CharPointerType t, int length)
+{
+	typedef JavascriptTokenCache::DeclarationType Type;
+
+	static const char* const keywords[(int)Type::numDeclarationTypes] = { "var", "reg", "const", "local", "global", "function", "namespace" };
+
+	for (int i = 0; i < (int)Type::numDeclarationTypes; i++)
+	{
+		if (length == (int)strlen(keywords[i]) && t.compareUpTo(CharPointer_ASCII(keywords[i]), length) == 0)
+			return (Type)i;
+	}
+
+	return Type::numDeclarationTypes;
+}
+
+bool JavascriptTokenCache::tokeniseLine(Line& l, const String& lineText, bool startsInComment)
+{
+	numTokenisedLines++;
+
+	l.tokens.clearQuick();
+	l.declarations.clearQuick();
+	zeromem(l.bracketCounts, sizeof(l.bracketCounts));
+	l.startsInComment = startsInComment;
+
+	const String text = lineText.trimCharactersAtEnd("\r\n");
+
+	JavascriptTokeniserFunctions::StringIterator it(text);
+
+	if (startsInComment)
+	{
+		const int endOfComment = text.indexOf("*/");
+
+		if (endOfComment == -1)
+		{
+			if (text.isNotEmpty())
+			{
+				const Token t = { 0, text.length(), JavascriptTokeniser::tokenType_comment, 0 };
+				l.tokens.add(t);
+			}
+
+			return true;
+		}
+
+		while (it.numChars < endOfComment + 2)
+			it.skip();
+
+		const Token t = { 0, it.numChars, JavascriptTokeniser::tokenType_comment, 0 };
+		l.tokens.add(t);
+	}
+
+	DeclarationType lastKeyword = DeclarationType::numDeclarationTypes;
+
+	for (;;)
+	{
+		String::CharPointerType tokenText = it.t;
+
+		int numWhitespace = 0;
+
+		while (tokenText.isWhitespace())
+		{
+			++tokenText;
+			++numWhitespace;
+		}
+
+		// Trailing whitespace is skipped by readNextToken()
+		if (tokenText.isEmpty())
+			break;
+
+		const int start = it.numChars;
+		const int type = JavascriptTokeniserFunctions::readNextToken(it);
+		const int length = it.numChars - start - numWhitespace;
+
+		if (it.numChars <= start)
+			break;
+
+		Token t = { start, it.numChars, type, 0 };
+
+		if (type == JavascriptTokeniser::tokenType_bracket)
+		{
+			t.bracket = *tokenText;
+			l.bracketCounts[getBracketIndex(t.bracket)]++;
+		}
+		else if (type == JavascriptTokeniser::tokenType_string)
+		{
+			for (int i = 0; i < length; i++)
+			{
+				if (tokenText.getAndAdvance() == '"')
+					l.bracketCounts[Quotes]++;
+			}
+		}
+		else if (type == JavascriptTokeniser::tokenType_comment && tokenText[1] == '*')
+		{
+			const bool isClosed = length >= 4 && text.substring(it.numChars - 2, it.numChars) == "*/";
+
+			l.tokens.add(t);
+
+			if (!isClosed)
+				return true;
+
+			continue;
+		}
+
+		if (type == JavascriptTokeniser::tokenType_identifier && lastKeyword != DeclarationType::numDeclarationTypes)
+		{
+			const Declaration d = { String(tokenText, length), lastKeyword, -1 };
+			l.declarations.add(d);
+		}
+
+		if (type == JavascriptTokeniser::tokenType_keyword || type == JavascriptTokeniser::tokenType_identifier)
+		{
+			const DeclarationType thisKeyword = getDeclarationTypeForKeyword(tokenText, length);
+
+			// const var x
+			if (!(lastKeyword == DeclarationType::Constant && thisKeyword == DeclarationType::Variable))
+				lastKeyword = thisKeyword;
+		}
+		else
+		{
+			lastKeyword = DeclarationType::numDeclarationTypes;
+		}
+
+		l.tokens.add(t);
+	}
+
+	return false;
+}
+
+const JavascriptTokenCache::Token* JavascriptTokenCache::getTokenAt(int lineNumber, int column) const noexcept
+{
+	const Line* l = lines[lineNumber];
+
+	if (l == nullptr || column < 0)
+		return nullptr;
+
+	// Binary search for the first token that ends after the column
+	int low = 0;
+	int high = l->tokens.size();
+
+	while (low < high)
+	{
+		const int mid = (low + high) / 2;
+
+		if (l->tokens.getReference(mid).end <= column)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return low < l->tokens.size() ? &l->tokens.getReference(low) : nullptr;
+}
+
+int JavascriptTokenCache::readNextToken(CodeDocument::Iterator& source) const
+{
+	if (!isInSync())
+		return -1;
+
+	int lineNumber = source.getLine();
+
+	while (isPositiveAndBelow(lineNumber, lines.size()))
+	{
+		const int column = source.getPosition() - CodeDocument::Position(doc, lineNumber, 0).getPosition();
+
+		if (column < 0)
+			return -1;
+
+		if (const Token* t = getTokenAt(lineNumber, column))
+		{
+			for (int i = column; i < t->end; i++)
+				source.skip();
+
+			return t->type;
+		}
+
+		// Only whitespace is left, so continue with the next line
+		source.skipToEndOfLine();
+		lineNumber++;
+	}
+
+	return JavascriptTokeniser::tokenType_error;
+}
+
+int JavascriptTokenCache::getNumBrackets(juce_wchar bracketCharacter) const
+{
+	const int index = getBracketIndex(bracketCharacter);
+
+	if (index == -1)
+		return 0;
+
+	int numBrackets = 0;
+
+	for (int i = 0; i < lines.size(); i++)
+		numBrackets += lines.getUnchecked(i)->bracketCounts[index];
+
+	return numBrackets;
+}
+
+int JavascriptTokenCache::findMatchingBracket(int position) const
+{
+	if (!isInSync())
+		return -1;
+
+	const CodeDocument::Position pos(doc, position);
+	const int lineNumber = pos.getLineNumber();
+	const Token* t = getTokenAt(lineNumber, pos.getIndexInLine());
+
+	// The position must point to the bracket character (the last character of the token)
+	if (t == nullptr || t->type != JavascriptTokeniser::tokenType_bracket || t->end - 1 != pos.getIndexInLine())
+		return -1;
+
+	const int bracketIndex = getBracketIndex(t->bracket);
+	const bool searchForward = (bracketIndex % 2) == 0;
+	const int matchIndex = searchForward ? bracketIndex + 1 : bracketIndex - 1;
+	const juce_wchar matchCharacter = String("()[]{}")[matchIndex];
+
+	int depth = 0;
+	int tokenIndex = (int)(t - lines[lineNumber]->tokens.begin());
+
+	for (int i = lineNumber; isPositiveAndBelow(i, lines.size()); i += (searchForward ? 1 : -1))
+	{
+		const Line& l = *lines.getUnchecked(i);
+
+		if (i != lineNumber)
+		{
+			if (l.bracketCounts[bracketIndex] == 0 && l.bracketCounts[matchIndex] == 0)
+				continue;
+
+			tokenIndex = searchForward ? 0 : l.tokens.size() - 1;
+		}
+
+		for (; isPositiveAndBelow(tokenIndex, l.tokens.size()); tokenIndex += (searchForward ? 1 : -1))
+		{
+			const Token& other = l.tokens.getReference(tokenIndex);
+
+			if (other.bracket == t->bracket)
+				depth++;
+			else if (other.bracket == matchCharacter && --depth == 0)
+				return CodeDocument::Position(doc, i, other.end - 1).getPosition();
+		}
+	}
+
+	return -1;
+}
+
+void JavascriptTokenCache::getDeclarations(Array<Declaration>& declarations) const
+{
+	for (int i = 0; i < lines.size(); i++)
+	{
+		const Line& l = *lines.getUnchecked(i);
+
+		for (int j = 0; j < l.declarations.size(); j++)
+		{
+			Declaration d = l.declarations.getUnchecked(j);
+			d.lineNumber = i;
+			declarations.add(d);
+		}
+	}
+}
@@ -34,6 +34,8 @@
 #define JAVASCRIPT_TOKENISER_H_INCLUDED
 
 
+class JavascriptTokenCache;
+
 class JavascriptTokeniser    : public CodeTokeniser
 {
 public:
@@ -47,6 +49,13 @@ public:
 
     static bool isReservedKeyword (const String& token) noexcept;
 
+    /** Reads the tokens from the given cache instead of lexing the document.
+    *
+    *	The cache must belong to the document that is displayed with this tokeniser (the JavascriptCodeEditor 
+    *	takes care of this). If the cache is deleted or out of sync, the document will be lexed as before.
+    */
+    void setTokenCache (JavascriptTokenCache* newCache) noexcept;
+
     enum TokenType
     {
         tokenType_error = 0,
@@ -64,8 +73,127 @@ public:
 
 private:
     //==============================================================================
+    WeakReference<JavascriptTokenCache> tokenCache;
+
     JUCE_LEAK_DETECTOR (JavascriptTokeniser)
 };
 
 
+/** Keeps the tokens of a CodeDocument line by line and updates them when the document changes.
+*
+*	The only state that is carried from one line to the next is whether the line starts inside a block comment.
+*	So after an edit, only the changed lines are tokenised again (and the following lines until the comment state 
+*	is the same as before), which keeps typing fast in long scripts.
+*
+*	The cache also stores the bracket count and the declared symbols of every line, so the bracket matching and
+*	the autocomplete popup don't need to scan the whole document.
+*/
+class JavascriptTokenCache : public CodeDocument::Listener
+{
+public:
+
+	/** A token inside a line. The range includes the whitespace before the token. */
+	struct Token
+	{
+		int start;
+		int end;
+		int type;
+		juce_wchar bracket;
+	};
+
+	enum class DeclarationType
+	{
+		Variable = 0,
+		Register,
+		Constant,
+		Local,
+		Global,
+		Function,
+		Namespace,
+		numDeclarationTypes
+	};
+
+	/** A symbol that is defined with var, reg, const, local, global, function or namespace. */
+	struct Declaration
+	{
+		String name;
+		DeclarationType type;
+		int lineNumber;
+	};
+
+	JavascriptTokenCache(CodeDocument& doc);
+	~JavascriptTokenCache();
+
+	void codeDocumentTextInserted(const String& newText, int insertIndex) override;
+	void codeDocumentTextDeleted(int startIndex, int endIndex) override;
+
+	/** Reads the next token from the cache and advances the iterator. Returns -1 if the cache can't be used. */
+	int readNextToken(CodeDocument::Iterator& source) const;
+
+	/** Returns the number of occurrences of the given bracket or quote character outside of comments and strings.
+	*
+	*	For double quotes, it returns the number of quotes in string literals.
+	*/
+	int getNumBrackets(juce_wchar bracketCharacter) const;
+
+	/** Returns the position of the bracket that matches the bracket at the given position or -1 if there is no match. */
+	int findMatchingBracket(int position) const;
+
+	/** Adds all symbols that are declared in the document to the given array. */
+	void getDeclarations(Array<Declaration>& declarations) const;
+
+	/** Returns the number of lines that were tokenised so far. */
+	int getNumTokenisedLines() const noexcept { return numTokenisedLines; }
+
+	/** Tokenises the whole document. */
+	void rebuild();
+
+private:
+
+	friend class WeakReference<JavascriptTokenCache>;
+	WeakReference<JavascriptTokenCache>::Master masterReference;
+
+	enum BracketIndex
+	{
+		RoundOpen = 0,
+		RoundClose,
+		SquareOpen,
+		SquareClose,
+		CurlyOpen,
+		CurlyClose,
+		Quotes,
+		numBracketIndexes
+	};
+
+	struct Line
+	{
+		Line() : startsInComment(false) { zeromem(bracketCounts, sizeof(bracketCounts)); };
+
+		Array<Token> tokens;
+		Array<Declaration> declarations;
+		int bracketCounts[numBracketIndexes];
+		bool startsInComment;
+	};
+
+	static int getBracketIndex(juce_wchar c) noexcept;
+
+	bool isInSync() const noexcept { return lines.size() == doc.getNumLines(); }
+
+	const Token* getTokenAt(int lineNumber, int column) const noexcept;
+
+	/** Tokenises the line and returns true if the line ends inside a block comment. */
+	bool tokeniseLine(Line& l, const String& lineText, bool startsInComment);
+
+	void updateLines(int firstLine, int lastChangedLine);
+
+	CodeDocument& doc;
+
+	OwnedArray<Line> lines;
+
+	int numTokenisedLines;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(JavascriptTokenCache)
+};
+
+
 #endif   // JUCE_CPLUSPLUSCODETOKENISER_H_INCLUDED
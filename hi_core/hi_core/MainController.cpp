@@ -60,6 +60,7 @@ MainController::MainController():
 	codeHandler(this),
 	processorChangeHandler(this),
 	debugLogger(this),
+	processorProfiler(this),
 	presetLoadRampFlag(0),
 	suspendIndex(0),
 	controlUndoManager(new UndoManager()),
@@ -474,8 +475,16 @@ void MainController::processBlockCommon(AudioSampleBuffer &buffer, MidiBuffer &m
 
 #else
 	ignoreUnused(midiMessages);
+
+	masterEventBuffer.clear();
+#endif
+
+#if ENABLE_HOST_AUTOMATION_QUEUE
+	hostAutomationQueue.fillEventBuffer(masterEventBuffer, buffer.getNumSamples(), sampleRate, thisAsProcessor->isNonRealtime());
 #endif
 
+	getDebugLogger().checkEventBuffer(nullptr, DebugLogger::Location::MainRenderCallback, masterEventBuffer);
+
 #if ENABLE_HOST_INFO
 	AudioPlayHead::CurrentPositionInfo newTime;
 
@@ -504,6 +513,10 @@ void MainController::processBlockCommon(AudioSampleBuffer &buffer, MidiBuffer &m
 	startCpuBenchmark(buffer.getNumSamples());
 #endif
 
+#if ENABLE_PROCESSOR_PROFILER
+	ProcessorProfiler::ScopedBlockTimer sbt(processorProfiler, buffer.getNumSamples());
+#endif
+
 #if !FRONTEND_IS_PLUGIN
 
 	if(replaceBufferContent) buffer.clear();
@@ -620,6 +633,8 @@ void MainController::prepareToPlay(double sampleRate_, int samplesPerBlock)
 
 	ProcessorHelpers::increaseBufferIfNeeded(multiChannelBuffer, samplesPerBlock);
 
+	masterEventBuffer.ensureAllocatedSize(samplesPerBlock);
+
 #if IS_STANDALONE_APP || IS_STANDALONE_FRONTEND
 	getMainSynthChain()->getMatrix().setNumDestinationChannels(2);
 #else
@@ -892,10 +907,19 @@ void MainController::UserPresetHandler::incPreset(bool next, bool stayInSameDire
 {
 	Array<File> allPresets;
 
-	auto userDirectory = GET_PROJECT_HANDLER(mc->getMainSynthChain()).getSubDirectory(ProjectHandler::SubDirectories::UserPresets);
+	if (presetIndex.isReady())
+	{
+		presetIndex.getAllPresets(allPresets);
+	}
+	else
+	{
+		auto userDirectory = GET_PROJECT_HANDLER(mc->getMainSynthChain()).getSubDirectory(ProjectHandler::SubDirectories::UserPresets);
 
-	userDirectory.findChildFiles(allPresets, File::findFiles, true, "*.preset");
-	allPresets.sort();
+		userDirectory.findChildFiles(allPresets, File::findFiles, true, "*.preset");
+		allPresets.sort();
+
+		presetIndex.rescan();
+	}
 
 	if (!currentlyLoadedFile.existsAsFile())
 	{
@@ -906,8 +930,16 @@ void MainController::UserPresetHandler::incPreset(bool next, bool stayInSameDire
 		if (stayInSameDirectory)
 		{
 			allPresets.clear();
-			currentlyLoadedFile.getParentDirectory().findChildFiles(allPresets, File::findFiles, false, "*.preset");
-			allPresets.sort();
+
+			if (presetIndex.isReady())
+			{
+				presetIndex.getPresetsInDirectory(currentlyLoadedFile.getParentDirectory(), allPresets);
+			}
+			else
+			{
+				currentlyLoadedFile.getParentDirectory().findChildFiles(allPresets, File::findFiles, false, "*.preset");
+				allPresets.sort();
+			}
 		}
 
 		if (allPresets.size() == 1)
@@ -932,6 +964,15 @@ void MainController::UserPresetHandler::incPreset(bool next, bool stayInSameDire
 
 	loadUserPreset(currentlyLoadedFile);
 
+	// Parse the neighbours in the background so that the next step doesn't need to wait for the file
+	const int loadedIndex = allPresets.indexOf(currentlyLoadedFile);
+
+	if (loadedIndex != -1 && allPresets.size() > 1)
+	{
+		parser.prefetch(allPresets[(loadedIndex + 1) % allPresets.size()]);
+		parser.prefetch(allPresets[(loadedIndex + allPresets.size() - 1) % allPresets.size()]);
+	}
+
 
 #if 0
 
@@ -33,6 +33,8 @@
 #ifndef MAINCONTROLLER_H_INCLUDED
 #define MAINCONTROLLER_H_INCLUDED
 
+#define NUM_CACHED_USER_PRESETS 8
+
 /** A class for handling application wide tasks.
 *	@ingroup core
 *
@@ -288,16 +290,23 @@ public:
 
 		void loadUserPreset(const ValueTree& presetToLoad);
 
+		/** Parses the preset file on a background thread and applies it when it's ready. */
 		void loadUserPreset(const File& fileToLoad);
 
+		/** Called on the message thread when the preset file was parsed. */
+		void presetParsed(const File& parsedFile, const ValueTree& parsedPreset);
+
 		File getCurrentlyLoadedFile() const { return currentlyLoadedFile; };
 
 		void setCurrentlyLoadedFile(const File& f) { currentlyLoadedFile = f; };
 
 		void incPreset(bool next, bool stayInSameDirectory);
 
+		/** Rescans the preset index and notifies the listeners. Call this whenever you have changed the preset files. */
 		void sendRebuildMessage()
 		{
+			presetIndex.rescan();
+
 			for (int i = 0; i < listeners.size(); i++)
 			{
 				if (listeners[i] != nullptr)
@@ -314,6 +323,126 @@ public:
 			saver.triggerAsyncUpdate();
 		}
 
+		/** A persistent index of all user presets that is built and updated on a background thread.
+		*
+		*	It stores the name, bank, category, tags, modification time and the optional description of every preset
+		*	in a hidden file in the user preset folder. At startup this file is loaded and the background thread only
+		*	compares the modification time of every directory with the stored value. Directories that have changed are
+		*	listed again and only new or modified preset files are parsed (and only their root element), so thousands
+		*	of presets don't stall the preset browser.
+		*
+		*	Whenever new entries are available (also in the middle of the first scan), the listeners of the
+		*	UserPresetHandler are notified with presetListUpdated().
+		*
+		*	Tags and description are read from the optional "Tags" (comma separated) and "Description" attributes of
+		*	the root element of the preset file.
+		*/
+		class PresetIndex : public Thread,
+							public AsyncUpdater
+		{
+		public:
+
+			struct Entry
+			{
+				File file;
+				String name;
+				String bank;
+				String category;
+				StringArray tags;
+				String description;
+				Time modificationTime;
+
+				/** All lowercase words of the entry used by the full text search. */
+				String searchText;
+			};
+
+			/** Creates the index. If the handler is nullptr, no listeners are notified. */
+			PresetIndex(UserPresetHandler* handler);
+			~PresetIndex();
+
+			/** Checks the user preset directory for changes on the background thread. */
+			void rescan();
+
+			/** Checks the given directory for changes on the background thread. */
+			void rescan(const File& userPresetDirectory);
+
+			/** Loads the index of the given directory and updates it on the calling thread.
+			*
+			*	This is what the background thread does after rescan(), so only call it directly if no rescan is
+			*	pending (eg. in the unit tests).
+			*/
+			void updateIndex(const File& userPresetDirectory);
+
+			/** Returns true if the index was loaded or scanned at least once. */
+			bool isReady() const noexcept { return ready; }
+
+			/** Returns a number that changes whenever an entry or a directory was added, removed or changed. */
+			int getVersion() const noexcept { return version.load(); }
+
+			/** Adds all indexed subdirectories of the given directory (sorted). */
+			void getChildDirectories(const File& parent, Array<File>& result) const;
+
+			/** Adds all presets in the given directory (sorted, not recursive). */
+			void getPresetsInDirectory(const File& directory, Array<File>& result) const;
+
+			/** Adds all presets of the index sorted by their path. */
+			void getAllPresets(Array<File>& result) const;
+
+			/** Searches the index.
+			*
+			*	Every whitespace separated word of the search term must be found in the name, bank, category, tags
+			*	or description. Presets whose name starts with the first word come first.
+			*/
+			void search(const String& searchTerm, Array<File>& result) const;
+
+			/** Returns a copy of the entry for the given file (or an entry with an empty file if it's not indexed). */
+			Entry getEntry(const File& f) const;
+
+			void run() override;
+
+			void handleAsyncUpdate() override;
+
+		private:
+
+			struct DirectoryEntry
+			{
+				File directory;
+				Time modificationTime;
+			};
+
+			void loadIndexFile(const File& newRoot);
+			void saveIndexFile();
+
+			void scanDirectory(const File& directory, Array<File>& visitedDirectories);
+			void updatePresetsInDirectory(const File& directory, Array<File>& childDirectories);
+
+			void removeDirectory(const File& directory);
+
+			Entry createEntry(const File& f, const XmlElement* metadata) const;
+
+			static File getIndexFile(const File& root) { return root.getChildFile(".PresetIndex.xml"); }
+
+			UserPresetHandler* handler;
+
+			CriticalSection lock;
+
+			Array<Entry> entries;
+			Array<DirectoryEntry> directories;
+
+			File root;
+			File rootToScan;
+
+			std::atomic<bool> ready { false };
+			std::atomic<int> version { 0 };
+			bool changed = false;
+			bool rescanPending = false;
+			int numUnreportedEntries = 0;
+		};
+
+		/** Returns the preset index. Call rescan() if you have changed the preset directory. */
+		PresetIndex& getPresetIndex() { return presetIndex; }
+		const PresetIndex& getPresetIndex() const { return presetIndex; }
+
 		// ===========================================================================================================
 
 	private:
@@ -345,8 +474,69 @@ public:
 
 		Saver saver;
 
+		/** Parses user preset files on a background thread and keeps the last NUM_CACHED_USER_PRESETS in a cache.
+		*
+		*	Only the most recent load request is parsed (so skipping through presets doesn't queue up), and the presets
+		*	next to the loaded one can be prefetched so that browsing with the arrow keys is instant.
+		*/
+		class Parser : public Thread,
+					   public AsyncUpdater
+		{
+		public:
+
+			Parser(UserPresetHandler* handler_);
+			~Parser();
+
+			/** Parses the file on the background thread and calls presetParsed() on the message thread. */
+			void parseAsync(const File& f);
+
+			/** Parses the file on the background thread and keeps it in the cache. */
+			void prefetch(const File& f);
+
+			/** Removes the file from the cache. Call this if you have changed the file. */
+			void invalidate(const File& f);
+
+			void run() override;
+
+			void handleAsyncUpdate() override;
+
+		private:
+
+			struct CacheEntry
+			{
+				File file;
+				Time modificationTime;
+				ValueTree preset;
+			};
+
+			ValueTree getPreset(const File& f);
+
+			UserPresetHandler* handler;
+
+			CriticalSection lock;
+
+			Array<CacheEntry> cache;
+
+			File fileToParse;
+			Array<File> filesToPrefetch;
+
+			File parsedFile;
+			ValueTree parsedPreset;
+		};
+
+		Parser parser;
+
+		PresetIndex presetIndex;
+
+		bool loadPresetDifferentially();
+
+		void sendPresetChangeMessage();
+
 		void loadPresetInternal();
 
+		/** Undoes the mute of a preset load that won't be applied. */
+		void cancelPresetLoadRamp();
+
 		Array<WeakReference<Listener>> listeners;
 		
 		MainController* mc;
@@ -356,6 +546,8 @@ public:
 
 		File currentlyLoadedFile;
 
+		bool restoreSkipped = false;
+
 		JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(UserPresetHandler)
 
 	};
@@ -603,6 +795,11 @@ public:
 
 	DebugLogger& getDebugLogger() { return debugLogger; }
 	const DebugLogger& getDebugLogger() const { return debugLogger; }
+
+	ProcessorProfiler& getProcessorProfiler() { return processorProfiler; }
+	const ProcessorProfiler& getProcessorProfiler() const { return processorProfiler; }
+
+	HostAutomationQueue& getHostAutomationQueue() { return hostAutomationQueue; }
     
 	void setKeyboardCoulour(int keyNumber, Colour colour);
 
@@ -1007,6 +1204,10 @@ private:
 
 	DebugLogger debugLogger;
 
+	ProcessorProfiler processorProfiler;
+
+	HostAutomationQueue hostAutomationQueue;
+
 #if USE_BACKEND
     
 	
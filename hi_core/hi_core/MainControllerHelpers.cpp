@@ -38,6 +38,9 @@ mc(mc_)
 {
 	tempBuffer.ensureSize(2048);
 
+	// The MIDI learn callback happens in the audio thread
+	enableAllocationFreeMessages(50);
+
 	clear();
 }
 
@@ -79,6 +82,8 @@ void MidiControllerAutomationHandler::setUnlearndedMidiControlNumber(int ccNumbe
 	unlearnedData = AutomationData();
 
 	anyUsed = true;
+
+	sendAllocationFreeChangeMessage();
 }
 
 int MidiControllerAutomationHandler::getMidiControllerNumber(Processor *interfaceProcessor, int attributeIndex) const
@@ -124,6 +129,8 @@ void MidiControllerAutomationHandler::clear()
 	unlearnedData = AutomationData();
 
 	anyUsed = false;
+
+	sendChangeMessage();
 }
 
 void MidiControllerAutomationHandler::removeMidiControlledParameter(Processor *interfaceProcessor, int attributeIndex)
@@ -142,6 +149,8 @@ void MidiControllerAutomationHandler::removeMidiControlledParameter(Processor *i
 	}
 
 	refreshAnyUsedState();
+
+	sendChangeMessage();
 }
 
 MidiControllerAutomationHandler::AutomationData::AutomationData() :
@@ -212,6 +221,8 @@ void MidiControllerAutomationHandler::restoreFromValueTree(const ValueTree &v)
 	}
 
 	refreshAnyUsedState();
+
+	sendChangeMessage();
 }
 
 void MidiControllerAutomationHandler::handleParameterData(MidiBuffer &b)
@@ -103,8 +103,10 @@ private:
 *
 *	For faster performance, one CC value can only control one parameter.
 *
+*	It sends a change message whenever the assignments (and therefore the exported ValueTree) change.
 */
-class MidiControllerAutomationHandler : public RestorableObject
+class MidiControllerAutomationHandler : public RestorableObject,
+										public SafeChangeBroadcaster
 {
 public:
 
@@ -248,7 +248,9 @@ void MainController::SampleManager::setDiskMode(DiskMode mode) noexcept
 
 MainController::UserPresetHandler::UserPresetHandler(MainController* mc_) : 
 	mc(mc_),
-	saver(this)
+	saver(this),
+	parser(this),
+	presetIndex(this)
 {
 	auto h = dynamic_cast<ThreadWithQuasiModalProgressWindow::Holder*>(mc);
 
@@ -287,47 +289,175 @@ void MainController::UserPresetHandler::loadUserPreset(const ValueTree& presetTo
 
 void MainController::UserPresetHandler::loadUserPreset(const File& fileToLoad)
 {
-	mc->allNotesOff();
-	mc->presetLoadRampFlag.set(-1);
+	// Skip a pending full restore of the previous preset (it will be unmuted when this one is applied).
+	// The previous preset is kept in currentPreset so that it can be applied if this one can't be parsed.
+	if (isTimerRunning())
+	{
+		stopTimer();
+		restoreSkipped = true;
+	}
 
 	currentlyLoadedFile = fileToLoad;
-	currentPreset = ValueTree();
 
-	startTimer(50);
+	parser.parseAsync(fileToLoad);
 }
 
-void MainController::UserPresetHandler::loadPresetInternal()
+void MainController::UserPresetHandler::presetParsed(const File& parsedFile, const ValueTree& parsedPreset)
 {
-#if USE_BACKEND
-	if (!GET_PROJECT_HANDLER(mc->getMainSynthChain()).isActive()) return;
-#endif
+	// Another preset was requested in the meantime
+	if (parsedFile != currentlyLoadedFile)
+		return;
 
-	if (!currentPreset.isValid())
+	if (!parsedPreset.isValid())
 	{
-		ScopedPointer<XmlElement> xml = XmlDocument::parse(currentlyLoadedFile);
+		mc->getDebugLogger().logMessage("Can't parse user preset " + parsedFile.getFullPathName());
+
+		if (restoreSkipped)
+		{
+			// Apply the previous preset that is still muted
+			restoreSkipped = false;
+			startTimer(50);
+		}
+		else
+			cancelPresetLoadRamp();
+
+		return;
+	}
 
-		if (xml != nullptr)
+	restoreSkipped = false;
+
+	ModulatorSynthChain* chain = mc->getMainSynthChain();
+
+	ValueTree preset = parsedPreset;
+
+	if (!UserPresetHelpers::checkVersionNumber(chain, preset.getProperty("Version").toString()))
+	{
+		if (PresetHandler::showYesNoWindow("Update user preset", "This user preset was built with a previous version. Do you want to update it?", PresetHandler::IconType::Question))
 		{
-			currentPreset = ValueTree::fromXml(*xml);
+			UserPresetHelpers::addMissingControlsToUserPreset(chain, parsedFile);
+			UserPresetHelpers::updateVersionNumber(chain, parsedFile);
+
+			parser.invalidate(parsedFile);
+
+			ScopedPointer<XmlElement> xml = XmlDocument::parse(parsedFile);
+
+			if (xml != nullptr)
+				preset = ValueTree::fromXml(*xml);
 		}
 	}
 
+	mc->getDebugLogger().logMessage("### Loading user preset " + parsedFile.getFileNameWithoutExtension() + "\n");
+
+	currentPreset = preset;
+
+#if ENABLE_DIFFERENTIAL_PRESET_LOADING
+	if (loadPresetDifferentially())
+		return;
+#endif
+
+	mc->allNotesOff();
+	mc->presetLoadRampFlag.set(RampFlags::FadeOut);
+
+	startTimer(50);
+}
+
+static ValueTree getContentDataFromPreset(const ValueTree& preset, const Processor* p)
+{
+	for (int i = 0; i < preset.getNumChildren(); i++)
+	{
+		if (preset.getChild(i).getProperty("Processor") == p->getId())
+			return preset.getChild(i);
+	}
+
+	return ValueTree();
+}
+
+bool MainController::UserPresetHandler::loadPresetDifferentially()
+{
+#if USE_BACKEND
+	if (!GET_PROJECT_HANDLER(mc->getMainSynthChain()).isActive()) return false;
+#endif
+
+	ValueTree autoData = currentPreset.getChildWithName("MidiAutomation");
+
+	if (autoData.isValid() && !autoData.isEquivalentTo(mc->getMacroManager().getMidiControlAutomationHandler()->exportAsValueTree()))
+		return false;
+
+	Array<ScriptingApi::Content*> contents;
+	Array<ValueTree> contentData;
+
 	Processor::Iterator<JavascriptMidiProcessor> iter(mc->getMainSynthChain());
 
 	while (JavascriptMidiProcessor *sp = iter.getNextProcessor())
 	{
 		if (!sp->isFront()) continue;
 
-		ValueTree v;
+		ValueTree v = getContentDataFromPreset(currentPreset, sp);
+
+		if (!v.isValid()) continue;
+
+		if (!sp->getScriptingContent()->canRestoreChangedControlsOnly(v))
+			return false;
+
+		contents.add(sp->getScriptingContent());
+		contentData.add(v);
+	}
+
+	for (int i = 0; i < contents.size(); i++)
+		contents[i]->restoreChangedControlsFromPreset(contentData[i]);
+
+	auto h = dynamic_cast<ThreadWithQuasiModalProgressWindow::Holder*>(mc);
 
-		for (int i = 0; i < currentPreset.getNumChildren(); i++)
+	// Fade in if a previous full restore was skipped
+	if (mc->presetLoadRampFlag.get() != RampFlags::Active && !h->isBusy())
+		mc->presetLoadRampFlag.set(RampFlags::FadeIn);
+
+	sendPresetChangeMessage();
+
+	return true;
+}
+
+void MainController::UserPresetHandler::sendPresetChangeMessage()
+{
+	for (int i = 0; i < listeners.size(); i++)
+	{
+		if (listeners[i] != nullptr)
 		{
-			if (currentPreset.getChild(i).getProperty("Processor") == sp->getId())
-			{
-				v = currentPreset.getChild(i);
-				break;
-			}
+			listeners[i]->presetChanged(currentlyLoadedFile);
 		}
+	}
+}
+
+void MainController::UserPresetHandler::cancelPresetLoadRamp()
+{
+	auto h = dynamic_cast<ThreadWithQuasiModalProgressWindow::Holder*>(mc);
+
+	// A pending task will unmute the audio when it's done
+	if (h->isBusy())
+		return;
+
+	// The audio thread might switch from FadeOut to Bypassed in the meantime
+	if (!mc->presetLoadRampFlag.compareAndSetBool(RampFlags::Active, RampFlags::FadeOut))
+		mc->presetLoadRampFlag.compareAndSetBool(RampFlags::FadeIn, RampFlags::Bypassed);
+}
+
+void MainController::UserPresetHandler::loadPresetInternal()
+{
+#if USE_BACKEND
+	if (!GET_PROJECT_HANDLER(mc->getMainSynthChain()).isActive())
+	{
+		cancelPresetLoadRamp();
+		return;
+	}
+#endif
+
+	Processor::Iterator<JavascriptMidiProcessor> iter(mc->getMainSynthChain());
+
+	while (JavascriptMidiProcessor *sp = iter.getNextProcessor())
+	{
+		if (!sp->isFront()) continue;
+
+		ValueTree v = getContentDataFromPreset(currentPreset, sp);
 
 		if (v.isValid())
 		{
@@ -347,13 +477,656 @@ void MainController::UserPresetHandler::loadPresetInternal()
 		mc->presetLoadRampFlag.set(1);
 	}
 
-	for (int i = 0; i < listeners.size(); i++)
+	sendPresetChangeMessage();
+}
+
+MainController::UserPresetHandler::Parser::Parser(UserPresetHandler* handler_) :
+	Thread("User Preset Parser"),
+	handler(handler_)
+{
+	startThread(3);
+}
+
+MainController::UserPresetHandler::Parser::~Parser()
+{
+	cancelPendingUpdate();
+	stopThread(1000);
+}
+
+void MainController::UserPresetHandler::Parser::parseAsync(const File& f)
+{
 	{
-		if (listeners[i] != nullptr)
+		ScopedLock sl(lock);
+		fileToParse = f;
+	}
+
+	notify();
+}
+
+void MainController::UserPresetHandler::Parser::prefetch(const File& f)
+{
+	{
+		ScopedLock sl(lock);
+		filesToPrefetch.addIfNotAlreadyThere(f);
+	}
+
+	notify();
+}
+
+void MainController::UserPresetHandler::Parser::invalidate(const File& f)
+{
+	ScopedLock sl(lock);
+
+	for (int i = 0; i < cache.size(); i++)
+	{
+		if (cache.getReference(i).file == f)
 		{
-			listeners[i]->presetChanged(currentlyLoadedFile);
+			cache.remove(i);
+			return;
+		}
+	}
+}
+
+void MainController::UserPresetHandler::Parser::run()
+{
+	while (!threadShouldExit())
+	{
+		File f;
+		bool isPrefetch = false;
+
+		{
+			ScopedLock sl(lock);
+
+			if (fileToParse != File())
+			{
+				f = fileToParse;
+				fileToParse = File();
+			}
+			else if (!filesToPrefetch.isEmpty())
+			{
+				f = filesToPrefetch.removeAndReturn(0);
+				isPrefetch = true;
+			}
+		}
+
+		if (f == File())
+		{
+			wait(-1);
+			continue;
+		}
+
+		ValueTree preset = getPreset(f);
+
+		if (!isPrefetch)
+		{
+			{
+				ScopedLock sl(lock);
+				parsedFile = f;
+				parsedPreset = preset;
+			}
+
+			triggerAsyncUpdate();
+		}
+	}
+}
+
+void MainController::UserPresetHandler::Parser::handleAsyncUpdate()
+{
+	File f;
+	ValueTree preset;
+
+	{
+		ScopedLock sl(lock);
+		f = parsedFile;
+		preset = parsedPreset;
+		parsedPreset = ValueTree();
+	}
+
+	handler->presetParsed(f, preset);
+}
+
+ValueTree MainController::UserPresetHandler::Parser::getPreset(const File& f)
+{
+	const Time modificationTime = f.getLastModificationTime();
+
+	{
+		ScopedLock sl(lock);
+
+		for (int i = 0; i < cache.size(); i++)
+		{
+			if (cache.getReference(i).file == f && cache.getReference(i).modificationTime == modificationTime)
+			{
+				// Move it to the end so that the least recently used preset is removed first
+				CacheEntry e = cache.removeAndReturn(i);
+				cache.add(e);
+
+				return e.preset;
+			}
+		}
+	}
+
+	ValueTree preset;
+
+	ScopedPointer<XmlElement> xml = XmlDocument::parse(f);
+
+	if (xml != nullptr)
+		preset = ValueTree::fromXml(*xml);
+
+	if (preset.isValid())
+	{
+		invalidate(f);
+
+		ScopedLock sl(lock);
+
+		CacheEntry e = { f, modificationTime, preset };
+		cache.add(e);
+
+		while (cache.size() > NUM_CACHED_USER_PRESETS)
+			cache.remove(0);
+	}
+
+	return preset;
+}
+
+MainController::UserPresetHandler::PresetIndex::PresetIndex(UserPresetHandler* handler_) :
+	Thread("User Preset Index"),
+	handler(handler_)
+{
+	startThread(2);
+}
+
+MainController::UserPresetHandler::PresetIndex::~PresetIndex()
+{
+	cancelPendingUpdate();
+	stopThread(1000);
+}
+
+void MainController::UserPresetHandler::PresetIndex::rescan()
+{
+	rescan(GET_PROJECT_HANDLER(handler->mc->getMainSynthChain()).getSubDirectory(ProjectHandler::SubDirectories::UserPresets));
+}
+
+void MainController::UserPresetHandler::PresetIndex::rescan(const File& userPresetDirectory)
+{
+	{
+		ScopedLock sl(lock);
+		rootToScan = userPresetDirectory;
+		rescanPending = true;
+	}
+
+	notify();
+}
+
+void MainController::UserPresetHandler::PresetIndex::getChildDirectories(const File& parent, Array<File>& result) const
+{
+	{
+		ScopedLock sl(lock);
+
+		for (int i = 0; i < directories.size(); i++)
+		{
+			if (directories.getReference(i).directory.getParentDirectory() == parent)
+				result.add(directories.getReference(i).directory);
+		}
+	}
+
+	result.sort();
+}
+
+void MainController::UserPresetHandler::PresetIndex::getPresetsInDirectory(const File& directory, Array<File>& result) const
+{
+	{
+		ScopedLock sl(lock);
+
+		for (int i = 0; i < entries.size(); i++)
+		{
+			if (entries.getReference(i).file.getParentDirectory() == directory)
+				result.add(entries.getReference(i).file);
+		}
+	}
+
+	result.sort();
+}
+
+void MainController::UserPresetHandler::PresetIndex::getAllPresets(Array<File>& result) const
+{
+	{
+		ScopedLock sl(lock);
+
+		result.ensureStorageAllocated(result.size() + entries.size());
+
+		for (int i = 0; i < entries.size(); i++)
+			result.add(entries.getReference(i).file);
+	}
+
+	result.sort();
+}
+
+void MainController::UserPresetHandler::PresetIndex::search(const String& searchTerm, Array<File>& result) const
+{
+	StringArray words = StringArray::fromTokens(searchTerm.toLowerCase(), " \t", "\"");
+	words.removeEmptyStrings();
+
+	if (words.isEmpty())
+	{
+		getAllPresets(result);
+		return;
+	}
+
+	Array<File> prefixMatches;
+	Array<File> otherMatches;
+
+	{
+		ScopedLock sl(lock);
+
+		for (int i = 0; i < entries.size(); i++)
+		{
+			const Entry& e = entries.getReference(i);
+
+			bool matches = true;
+
+			for (int j = 0; j < words.size(); j++)
+			{
+				if (!e.searchText.contains(words[j]))
+				{
+					matches = false;
+					break;
+				}
+			}
+
+			if (!matches)
+				continue;
+
+			if (e.name.startsWithIgnoreCase(words[0]))
+				prefixMatches.add(e.file);
+			else
+				otherMatches.add(e.file);
+		}
+	}
+
+	prefixMatches.sort();
+	otherMatches.sort();
+
+	result.addArray(prefixMatches);
+	result.addArray(otherMatches);
+}
+
+MainController::UserPresetHandler::PresetIndex::Entry MainController::UserPresetHandler::PresetIndex::getEntry(const File& f) const
+{
+	ScopedLock sl(lock);
+
+	for (int i = 0; i < entries.size(); i++)
+	{
+		if (entries.getReference(i).file == f)
+			return entries.getReference(i);
+	}
+
+	return Entry();
+}
+
+void MainController::UserPresetHandler::PresetIndex::run()
+{
+	while (!threadShouldExit())
+	{
+		File newRoot;
+		bool shouldScan = false;
+
+		{
+			ScopedLock sl(lock);
+
+			shouldScan = rescanPending;
+			newRoot = rootToScan;
+			rescanPending = false;
+		}
+
+		if (!shouldScan)
+		{
+			wait(-1);
+			continue;
+		}
+
+		updateIndex(newRoot);
+	}
+}
+
+void MainController::UserPresetHandler::PresetIndex::updateIndex(const File& userPresetDirectory)
+{
+	if (userPresetDirectory != root)
+		loadIndexFile(userPresetDirectory);
+
+	if (!root.isDirectory())
+	{
+		{
+			ScopedLock sl(lock);
+			entries.clear();
+			directories.clear();
+			++version;
+		}
+
+		ready = true;
+		triggerAsyncUpdate();
+		return;
+	}
+
+	Array<File> visitedDirectories;
+
+	scanDirectory(root, visitedDirectories);
+
+	if (threadShouldExit())
+		return;
+
+	for (int i = directories.size() - 1; i >= 0; i--)
+	{
+		const File d = directories.getReference(i).directory;
+
+		if (!visitedDirectories.contains(d))
+			removeDirectory(d);
+	}
+
+	ready = true;
+
+	if (changed)
+		saveIndexFile();
+
+	numUnreportedEntries = 0;
+	triggerAsyncUpdate();
+}
+
+void MainController::UserPresetHandler::PresetIndex::handleAsyncUpdate()
+{
+	if (handler == nullptr)
+		return;
+
+	for (int i = 0; i < handler->listeners.size(); i++)
+	{
+		if (handler->listeners[i] != nullptr)
+			handler->listeners[i]->presetListUpdated();
+	}
+}
+
+void MainController::UserPresetHandler::PresetIndex::loadIndexFile(const File& newRoot)
+{
+	{
+		ScopedLock sl(lock);
+
+		root = newRoot;
+		entries.clear();
+		directories.clear();
+		++version;
+	}
+
+	ready = false;
+	changed = false;
+
+	ScopedPointer<XmlElement> xml = XmlDocument::parse(getIndexFile(newRoot));
+
+	if (xml == nullptr || !xml->hasTagName("PresetIndex"))
+		return;
+
+	Array<Entry> loadedEntries;
+	Array<DirectoryEntry> loadedDirectories;
+
+	forEachXmlChildElementWithTagName(*xml, d, "Directory")
+	{
+		DirectoryEntry e = { newRoot.getChildFile(d->getStringAttribute("Path")), Time(d->getStringAttribute("Modified").getLargeIntValue()) };
+		loadedDirectories.add(e);
+	}
+
+	forEachXmlChildElementWithTagName(*xml, p, "Preset")
+	{
+		Entry e = createEntry(newRoot.getChildFile(p->getStringAttribute("Path")), p);
+		e.modificationTime = Time(p->getStringAttribute("Modified").getLargeIntValue());
+		loadedEntries.add(e);
+	}
+
+	{
+		ScopedLock sl(lock);
+		entries.swapWith(loadedEntries);
+		directories.swapWith(loadedDirectories);
+		++version;
+	}
+
+	ready = true;
+	triggerAsyncUpdate();
+}
+
+void MainController::UserPresetHandler::PresetIndex::saveIndexFile()
+{
+	XmlElement xml("PresetIndex");
+
+	xml.setAttribute("Version", 1);
+
+	for (int i = 0; i < directories.size(); i++)
+	{
+		const DirectoryEntry& d = directories.getReference(i);
+
+		XmlElement* c = new XmlElement("Directory");
+		c->setAttribute("Path", d.directory.getRelativePathFrom(root));
+		c->setAttribute("Modified", String(d.modificationTime.toMilliseconds()));
+		xml.addChildElement(c);
+	}
+
+	for (int i = 0; i < entries.size(); i++)
+	{
+		const Entry& e = entries.getReference(i);
+
+		XmlElement* c = new XmlElement("Preset");
+		c->setAttribute("Path", e.file.getRelativePathFrom(root));
+		c->setAttribute("Modified", String(e.modificationTime.toMilliseconds()));
+
+		if (e.tags.size() != 0)
+			c->setAttribute("Tags", e.tags.joinIntoString(","));
+
+		if (e.description.isNotEmpty())
+			c->setAttribute("Description", e.description);
+
+		xml.addChildElement(c);
+	}
+
+	xml.writeToFile(getIndexFile(root), "");
+
+	changed = false;
+}
+
+void MainController::UserPresetHandler::PresetIndex::scanDirectory(const File& directory, Array<File>& visitedDirectories)
+{
+	if (threadShouldExit())
+		return;
+
+	visitedDirectories.add(directory);
+
+	const Time modificationTime = directory.getLastModificationTime();
+
+	int directoryIndex = -1;
+
+	for (int i = 0; i < directories.size(); i++)
+	{
+		if (directories.getReference(i).directory == directory)
+		{
+			directoryIndex = i;
+			break;
+		}
+	}
+
+	Array<File> childDirectories;
+
+	// Writing the index file changes the time of the root directory, so the root is always listed (it only
+	// contains the banks) and its time is not a reason to write the index file again
+	const bool isRoot = directory == root;
+
+	if (directoryIndex == -1 || isRoot || directories.getReference(directoryIndex).modificationTime != modificationTime)
+	{
+		updatePresetsInDirectory(directory, childDirectories);
+
+		if (threadShouldExit())
+			return;
+
+		ScopedLock sl(lock);
+
+		if (directoryIndex == -1)
+		{
+			DirectoryEntry d = { directory, modificationTime };
+			directories.add(d);
+			changed = true;
+			++version;
+		}
+		else if (directories.getReference(directoryIndex).modificationTime != modificationTime)
+		{
+			// Store the new time even if the content didn't change, otherwise the directory is listed on every scan
+			directories.getReference(directoryIndex).modificationTime = modificationTime;
+			changed |= !isRoot;
 		}
 	}
+	else
+	{
+		for (int i = 0; i < directories.size(); i++)
+		{
+			if (directories.getReference(i).directory.getParentDirectory() == directory)
+				childDirectories.add(directories.getReference(i).directory);
+		}
+	}
+
+	for (int i = 0; i < childDirectories.size(); i++)
+		scanDirectory(childDirectories[i], visitedDirectories);
+}
+
+void MainController::UserPresetHandler::PresetIndex::updatePresetsInDirectory(const File& directory, Array<File>& childDirectories)
+{
+	Array<File> children;
+	Array<File> presetFiles;
+
+	directory.findChildFiles(children, File::findFilesAndDirectories, false);
+
+	for (int i = 0; i < children.size(); i++)
+	{
+		const File& c = children.getReference(i);
+
+		if (c.isHidden() || c.getFileName().startsWith("."))
+			continue;
+
+		if (c.isDirectory())
+			childDirectories.add(c);
+		else if (c.hasFileExtension(".preset"))
+			presetFiles.add(c);
+	}
+
+	HashMap<String, int> existingEntries;
+
+	{
+		ScopedLock sl(lock);
+
+		for (int i = entries.size() - 1; i >= 0; i--)
+		{
+			const File& f = entries.getReference(i).file;
+
+			if (f.getParentDirectory() == directory && !presetFiles.contains(f))
+			{
+				entries.remove(i);
+				changed = true;
+				++version;
+			}
+		}
+
+		for (int i = 0; i < entries.size(); i++)
+		{
+			if (entries.getReference(i).file.getParentDirectory() == directory)
+				existingEntries.set(entries.getReference(i).file.getFullPathName(), i);
+		}
+	}
+
+	for (int i = 0; i < presetFiles.size(); i++)
+	{
+		if (threadShouldExit())
+			return;
+
+		const File& f = presetFiles.getReference(i);
+		const Time modificationTime = f.getLastModificationTime();
+		const int existingIndex = existingEntries.contains(f.getFullPathName()) ? existingEntries[f.getFullPathName()] : -1;
+
+		if (existingIndex != -1 && entries.getReference(existingIndex).modificationTime == modificationTime)
+			continue;
+
+		// Only the root element is parsed to get the metadata
+		XmlDocument doc(f);
+		ScopedPointer<XmlElement> xml = doc.getDocumentElement(true);
+
+		Entry e = createEntry(f, xml);
+		e.modificationTime = modificationTime;
+
+		{
+			ScopedLock sl(lock);
+
+			if (existingIndex != -1)
+				entries.set(existingIndex, e);
+			else
+				entries.add(e);
+
+			++version;
+		}
+
+		changed = true;
+
+		if (++numUnreportedEntries >= 64)
+		{
+			numUnreportedEntries = 0;
+			triggerAsyncUpdate();
+		}
+	}
+}
+
+void MainController::UserPresetHandler::PresetIndex::removeDirectory(const File& directory)
+{
+	ScopedLock sl(lock);
+
+	for (int i = entries.size() - 1; i >= 0; i--)
+	{
+		if (entries.getReference(i).file.getParentDirectory() == directory)
+			entries.remove(i);
+	}
+
+	for (int i = 0; i < directories.size(); i++)
+	{
+		if (directories.getReference(i).directory == directory)
+		{
+			directories.remove(i);
+			break;
+		}
+	}
+
+	changed = true;
+	++version;
+}
+
+MainController::UserPresetHandler::PresetIndex::Entry MainController::UserPresetHandler::PresetIndex::createEntry(const File& f, const XmlElement* metadata) const
+{
+	Entry e;
+
+	e.file = f;
+	e.name = f.getFileNameWithoutExtension();
+
+	const File categoryDirectory = f.getParentDirectory();
+
+	if (categoryDirectory != root)
+	{
+		e.category = categoryDirectory.getFileName();
+
+		const File bankDirectory = categoryDirectory.getParentDirectory();
+
+		if (bankDirectory != root)
+			e.bank = bankDirectory.getFileName();
+	}
+
+	if (metadata != nullptr)
+	{
+		e.tags = StringArray::fromTokens(metadata->getStringAttribute("Tags"), ",", "");
+		e.tags.trim();
+		e.tags.removeEmptyStrings();
+
+		e.description = metadata->getStringAttribute("Description");
+	}
+
+	e.searchText = (e.name + " " + e.bank + " " + e.category + " " + e.tags.joinIntoString(" ") + " " + e.description).toLowerCase();
+
+	return e;
 }
 
 
@@ -416,32 +416,8 @@ void UserPresetHelpers::saveUserPreset(ModulatorSynthChain *chain, const String&
 
 void UserPresetHelpers::loadUserPreset(ModulatorSynthChain *chain, const File &fileToLoad)
 {
-	ScopedPointer<XmlElement> xml = XmlDocument::parse(fileToLoad);
-    
-    if(xml != nullptr)
-    {
-		if (!checkVersionNumber(chain, *xml))
-		{
-			if (PresetHandler::showYesNoWindow("Update user preset", "This user preset was built with a previous version. Do you want to update it?", PresetHandler::IconType::Question))
-			{
-				addMissingControlsToUserPreset(chain, fileToLoad);
-				updateVersionNumber(chain, fileToLoad);
-
-				xml = XmlDocument::parse(fileToLoad);
-			}
-		}
-
-        ValueTree parent = ValueTree::fromXml(*xml);
-        
-		chain->getMainController()->getDebugLogger().logMessage("### Loading user preset " + fileToLoad.getFileNameWithoutExtension() + "\n");
-
-        if (parent.isValid())
-        {
-			chain->getMainController()->getUserPresetHandler().setCurrentlyLoadedFile(fileToLoad);
-
-            loadUserPreset(chain, parent);
-        }
-    }
+	// The file is parsed on a background thread, the version check happens in presetParsed()
+	chain->getMainController()->getUserPresetHandler().loadUserPreset(fileToLoad);
 }
 
 void UserPresetHelpers::loadUserPreset(ModulatorSynthChain* chain, const ValueTree &parent)
@@ -540,8 +516,11 @@ bool UserPresetHelpers::updateVersionNumber(ModulatorSynthChain* chain, const Fi
 
 bool UserPresetHelpers::checkVersionNumber(ModulatorSynthChain* chain, XmlElement& element)
 {
-	const String presetVersion = element.getStringAttribute("Version");
+	return checkVersionNumber(chain, element.getStringAttribute("Version"));
+}
 
+bool UserPresetHelpers::checkVersionNumber(ModulatorSynthChain* chain, const String& presetVersion)
+{
 	SemanticVersionChecker versionChecker(presetVersion, getCurrentVersionNumber(chain));
 
 	if (!versionChecker.newVersionNumberIsValid())
@@ -524,6 +524,8 @@ public:
 
 	static bool checkVersionNumber(ModulatorSynthChain* chain, XmlElement& element);
 
+	static bool checkVersionNumber(ModulatorSynthChain* chain, const String& presetVersion);
+
 	static String getCurrentVersionNumber(ModulatorSynthChain* chain);
 
     static File getUserPresetFile(ModulatorSynthChain *chain, const String &fileNameWithoutExtension);
@@ -0,0 +1,257 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+#include  "JuceHeader.h"
+
+class PresetIndexUnitTests : public UnitTest
+{
+public:
+
+	typedef MainController::UserPresetHandler::PresetIndex PresetIndex;
+
+	PresetIndexUnitTests():
+		UnitTest("Testing user preset index")
+	{
+
+	}
+
+	void runTest() override
+	{
+		root = File::getSpecialLocation(File::tempDirectory).getNonexistentChildFile("PresetIndexTest", "", false);
+		root.createDirectory();
+
+		testIndexing();
+		testSearch();
+		testPersistence();
+		testModifiedDirectory();
+		testChangedPresets();
+
+		root.deleteRecursively();
+	}
+
+private:
+
+	void testIndexing()
+	{
+		beginTest("Testing the index of a preset directory");
+
+		createPreset("Bank/Pads/Warm Pad", "Pad, Warm", "A soft pad");
+		createPreset("Bank/Pads/Glass Pad", "Pad", "");
+		createPreset("Bank/Leads/Saw Lead", "", "");
+
+		// The file system might only store whole seconds, so the times are set explicitly
+		setModificationTime("", 0);
+		setModificationTime("Bank", 0);
+		setModificationTime("Bank/Pads", 0);
+		setModificationTime("Bank/Leads", 0);
+
+		PresetIndex index(nullptr);
+		index.updateIndex(root);
+
+		expect(index.isReady(), "Index is ready");
+
+		Array<File> presets;
+		index.getAllPresets(presets);
+		expectEquals<int>(presets.size(), 3, "Number of presets");
+
+		Array<File> banks;
+		index.getChildDirectories(root, banks);
+		expectEquals<int>(banks.size(), 1, "Number of banks");
+
+		Array<File> categories;
+		index.getChildDirectories(root.getChildFile("Bank"), categories);
+		expectEquals<int>(categories.size(), 2, "Number of categories");
+		expectEquals(categories[0].getFileName(), String("Leads"), "Categories are sorted");
+
+		Array<File> pads;
+		index.getPresetsInDirectory(root.getChildFile("Bank/Pads"), pads);
+		expectEquals<int>(pads.size(), 2, "Presets in category");
+		expectEquals(pads[0].getFileNameWithoutExtension(), String("Glass Pad"), "Presets are sorted");
+
+		PresetIndex::Entry e = index.getEntry(root.getChildFile("Bank/Pads/Warm Pad.preset"));
+
+		expectEquals(e.bank, String("Bank"), "Bank");
+		expectEquals(e.category, String("Pads"), "Category");
+		expectEquals(e.tags.joinIntoString(","), String("Pad,Warm"), "Tags");
+		expectEquals(e.description, String("A soft pad"), "Description");
+
+		expect(getIndexFile().existsAsFile(), "Index file was written");
+	}
+
+	void testSearch()
+	{
+		beginTest("Testing the full text search");
+
+		PresetIndex index(nullptr);
+		index.updateIndex(root);
+
+		Array<File> result;
+
+		index.search("pad", result);
+		expectEquals<int>(result.size(), 2, "Search for tag");
+
+		result.clear();
+		index.search("pad soft", result);
+		expectEquals<int>(result.size(), 1, "Every word must match");
+
+		result.clear();
+		index.search("glass pad", result);
+		expectEquals(result[0].getFileNameWithoutExtension(), String("Glass Pad"), "Name prefix matches come first");
+
+		result.clear();
+		index.search("leads", result);
+		expectEquals<int>(result.size(), 1, "Search for category");
+
+		result.clear();
+		index.search("strings", result);
+		expectEquals<int>(result.size(), 0, "No match");
+	}
+
+	void testPersistence()
+	{
+		beginTest("Testing the persistence of the index");
+
+		// A preset that is added without changing the directory time is only missing if the index file is used
+		createPreset("Bank/Pads/Hidden Pad", "", "");
+		setModificationTime("Bank/Pads", 0);
+
+		PresetIndex index(nullptr);
+		index.updateIndex(root);
+
+		Array<File> presets;
+		index.getAllPresets(presets);
+		expectEquals<int>(presets.size(), 3, "Entries are loaded from the index file");
+		expectEquals(index.getEntry(root.getChildFile("Bank/Pads/Warm Pad.preset")).description, String("A soft pad"), "Description is stored");
+
+		root.getChildFile("Bank/Pads/Hidden Pad.preset").deleteFile();
+		setModificationTime("Bank/Pads", 0);
+	}
+
+	void testModifiedDirectory()
+	{
+		beginTest("Testing a directory that was modified without changing the presets");
+
+		const File pads = root.getChildFile("Bank/Pads");
+
+		setModificationTime("Bank/Pads", 1);
+
+		{
+			PresetIndex index(nullptr);
+			index.updateIndex(root);
+		}
+
+		ScopedPointer<XmlElement> xml = XmlDocument::parse(getIndexFile());
+
+		expect(xml != nullptr, "Index file can be parsed");
+
+		if (xml == nullptr)
+			return;
+
+		bool timeWasStored = false;
+
+		forEachXmlChildElementWithTagName(*xml, d, "Directory")
+		{
+			if (d->getStringAttribute("Path") == pads.getRelativePathFrom(root))
+				timeWasStored = d->getStringAttribute("Modified").getLargeIntValue() == pads.getLastModificationTime().toMilliseconds();
+		}
+
+		expect(timeWasStored, "New modification time was stored");
+	}
+
+	void testChangedPresets()
+	{
+		beginTest("Testing added and removed presets");
+
+		PresetIndex index(nullptr);
+		index.updateIndex(root);
+
+		const int version = index.getVersion();
+
+		index.updateIndex(root);
+		expectEquals<int>(index.getVersion(), version, "Version doesn't change without changes");
+
+		const File leads = root.getChildFile("Bank/Leads");
+
+		createPreset("Bank/Leads/Square Lead", "", "");
+		setModificationTime("Bank/Leads", 1);
+		index.updateIndex(root);
+
+		Array<File> presets;
+		index.getPresetsInDirectory(leads, presets);
+		expectEquals<int>(presets.size(), 2, "New preset was added");
+		expect(index.getVersion() != version, "Version changed");
+
+		leads.getChildFile("Saw Lead.preset").deleteFile();
+		setModificationTime("Bank/Leads", 2);
+		index.updateIndex(root);
+
+		presets.clear();
+		index.getPresetsInDirectory(leads, presets);
+		expectEquals<int>(presets.size(), 1, "Deleted preset was removed");
+		expectEquals(presets[0].getFileNameWithoutExtension(), String("Square Lead"), "Remaining preset");
+
+		root.getChildFile("Bank/Leads").deleteRecursively();
+		setModificationTime("Bank", 1);
+		index.updateIndex(root);
+
+		Array<File> categories;
+		index.getChildDirectories(root.getChildFile("Bank"), categories);
+		expectEquals<int>(categories.size(), 1, "Deleted directory was removed");
+	}
+
+	void createPreset(const String& path, const String& tags, const String& description)
+	{
+		XmlElement xml("Preset");
+
+		if (tags.isNotEmpty())
+			xml.setAttribute("Tags", tags);
+
+		if (description.isNotEmpty())
+			xml.setAttribute("Description", description);
+
+		File f = root.getChildFile(path + ".preset");
+		f.getParentDirectory().createDirectory();
+		xml.writeToFile(f, "");
+	}
+
+	void setModificationTime(const String& path, int seconds)
+	{
+		root.getChildFile(path).setLastModificationTime(Time((int64)(1500000000 + seconds) * 1000));
+	}
+
+	File getIndexFile() const { return root.getChildFile(".PresetIndex.xml"); }
+
+	File root;
+};
+
+static PresetIndexUnitTests presetIndexUnitTests;
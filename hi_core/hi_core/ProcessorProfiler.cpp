@@ -0,0 +1,310 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+
+ProcessorProfiler::ThreadQueue::ThreadQueue():
+	owner(nullptr),
+	queue(16384)
+{
+
+}
+
+ProcessorProfiler::ProcessorProfiler(MainController* mc_):
+	mc(mc_),
+	enabled(false),
+	numThreads(0),
+	numDroppedRecords(0)
+{
+
+}
+
+ProcessorProfiler::~ProcessorProfiler()
+{
+	enabled.store(false);
+}
+
+void ProcessorProfiler::setEnabled(bool shouldBeEnabled)
+{
+	if (shouldBeEnabled == enabled.load())
+		return;
+
+	if (shouldBeEnabled)
+	{
+		if (queues.isEmpty())
+		{
+			for (int i = 0; i < NUM_PROFILER_THREADS; i++)
+				queues.add(new ThreadQueue());
+		}
+
+		reset();
+	}
+
+	enabled.store(shouldBeEnabled);
+}
+
+void ProcessorProfiler::addRecord(const void* processor, uint64 cycles, int numSamples) noexcept
+{
+	const Thread::ThreadID threadId = Thread::getCurrentThreadId();
+	const int numUsedQueues = jmin<int>(numThreads.get(), NUM_PROFILER_THREADS);
+
+	ThreadQueue* q = nullptr;
+
+	for (int i = 0; i < numUsedQueues; i++)
+	{
+		if (queues.getUnchecked(i)->owner.get() == threadId)
+		{
+			q = queues.getUnchecked(i);
+			break;
+		}
+	}
+
+	if (q == nullptr)
+	{
+		const int newIndex = ++numThreads - 1;
+
+		if (newIndex >= NUM_PROFILER_THREADS)
+		{
+			// You are rendering from more threads than there are queues...
+			++numDroppedRecords;
+			return;
+		}
+
+		q = queues.getUnchecked(newIndex);
+		q->owner.set(threadId);
+	}
+
+	Record r = { processor, cycles, numSamples };
+
+	if (!q->queue.try_enqueue(r))
+		++numDroppedRecords;
+}
+
+void ProcessorProfiler::drain()
+{
+	const int numUsedQueues = jmin<int>(numThreads.get(), NUM_PROFILER_THREADS);
+
+	for (int i = 0; i < numUsedQueues; i++)
+	{
+		ThreadQueue& q = *queues.getUnchecked(i);
+
+		Record r;
+
+		while (q.queue.try_dequeue(r))
+		{
+			if (r.processor == nullptr)
+			{
+				flushBlock(q, r);
+			}
+			else
+			{
+				q.pendingCycles.set(r.processor, q.pendingCycles[r.processor] + r.cycles);
+				q.pendingCalls.set(r.processor, q.pendingCalls[r.processor] + 1);
+			}
+		}
+	}
+}
+
+void ProcessorProfiler::reset()
+{
+	const int numUsedQueues = jmin<int>(numThreads.get(), NUM_PROFILER_THREADS);
+
+	for (int i = 0; i < numUsedQueues; i++)
+	{
+		ThreadQueue& q = *queues.getUnchecked(i);
+
+		Record r;
+
+		while (q.queue.try_dequeue(r))
+			;
+
+		q.pendingCycles.clear();
+		q.pendingCalls.clear();
+	}
+
+	stats.clear();
+	blockStats = Stats();
+	numBlocks = 0;
+	numDroppedRecords.set(0);
+
+	startCycles = getCycleCount();
+	startTicks = Time::getHighResolutionTicks();
+}
+
+void ProcessorProfiler::flushBlock(ThreadQueue& q, const Record& blockRecord)
+{
+	const double sampleRate = mc->getMainSynthChain()->getSampleRate();
+
+	if (sampleRate <= 0.0 || blockRecord.numSamples == 0)
+		return;
+
+	const double budgetCycles = getCyclesPerSecond() * (double)blockRecord.numSamples / sampleRate;
+
+	for (HashMap<const void*, uint64>::Iterator it(q.pendingCycles); it.next();)
+	{
+		const double percentage = 100.0 * (double)it.getValue() / budgetCycles;
+
+		Stats s = stats[it.getKey()];
+
+		s.percentageSum += percentage;
+		s.peakPercentage = jmax<double>(s.peakPercentage, percentage);
+		s.numCalls += q.pendingCalls[it.getKey()];
+
+		stats.set(it.getKey(), s);
+	}
+
+	q.pendingCycles.clear();
+	q.pendingCalls.clear();
+
+	const double blockPercentage = 100.0 * (double)blockRecord.cycles / budgetCycles;
+
+	blockStats.percentageSum += blockPercentage;
+	blockStats.peakPercentage = jmax<double>(blockStats.peakPercentage, blockPercentage);
+	blockStats.numCalls++;
+
+	numBlocks++;
+}
+
+double ProcessorProfiler::getCyclesPerSecond() const
+{
+	const double elapsedSeconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks);
+
+	if (elapsedSeconds < 0.001)
+	{
+#if JUCE_INTEL
+		return 1.0e6 * (double)SystemStats::getCpuSpeedInMegaherz();
+#else
+		return (double)Time::getHighResolutionTicksPerSecond();
+#endif
+	}
+
+	return (double)(getCycleCount() - startCycles) / elapsedSeconds;
+}
+
+void ProcessorProfiler::fillNode(Node& n, const Processor* p, int depth) const
+{
+	n.processor = const_cast<Processor*>(p);
+	n.id = p->getId();
+	n.type = p->getType().toString();
+	n.depth = depth;
+
+	if (numBlocks > 0 && stats.contains(p))
+	{
+		const Stats s = stats[p];
+
+		n.averagePercentage = s.percentageSum / (double)numBlocks;
+		n.peakPercentage = s.peakPercentage;
+		n.callsPerBlock = (double)s.numCalls / (double)numBlocks;
+	}
+
+	double childPercentage = 0.0;
+
+	for (int i = 0; i < p->getNumChildProcessors(); i++)
+	{
+		if (const Processor* c = p->getChildProcessor(i))
+		{
+			Node* child = new Node();
+			fillNode(*child, c, depth + 1);
+			childPercentage += child->averagePercentage;
+			n.children.add(child);
+		}
+	}
+
+	n.selfPercentage = jmax<double>(0.0, n.averagePercentage - childPercentage);
+}
+
+ProcessorProfiler::Node* ProcessorProfiler::createTree() const
+{
+	ScopedPointer<Node> root = new Node();
+
+	fillNode(*root, mc->getMainSynthChain(), 0);
+
+	return root.release();
+}
+
+var ProcessorProfiler::createJSONDump() const
+{
+	DynamicObject::Ptr obj = new DynamicObject();
+
+	obj->setProperty("Version", 1);
+	obj->setProperty("SampleRate", mc->getMainSynthChain()->getSampleRate());
+	obj->setProperty("BlockSize", mc->getMainSynthChain()->getBlockSize());
+	obj->setProperty("NumBlocks", numBlocks);
+	obj->setProperty("DroppedRecords", getNumDroppedRecords());
+	obj->setProperty("AverageBlockPercentage", numBlocks > 0 ? blockStats.percentageSum / (double)numBlocks : 0.0);
+	obj->setProperty("PeakBlockPercentage", blockStats.peakPercentage);
+
+	ScopedPointer<Node> root = createTree();
+
+	obj->setProperty("Root", root->toJSON());
+
+	return var(obj);
+}
+
+bool ProcessorProfiler::writeJSONDumpToFile(const File& f)
+{
+	drain();
+
+	return f.replaceWithText(JSON::toString(createJSONDump()));
+}
+
+var ProcessorProfiler::Node::toJSON() const
+{
+	DynamicObject::Ptr obj = new DynamicObject();
+
+	obj->setProperty("ID", id);
+	obj->setProperty("Type", type);
+	obj->setProperty("Average", averagePercentage);
+	obj->setProperty("Peak", peakPercentage);
+	obj->setProperty("Self", selfPercentage);
+	obj->setProperty("CallsPerBlock", callsPerBlock);
+
+	if (children.size() > 0)
+	{
+		Array<var> childList;
+
+		for (int i = 0; i < children.size(); i++)
+			childList.add(children[i]->toJSON());
+
+		obj->setProperty("Children", childList);
+	}
+
+	return var(obj);
+}
+
+void ProcessorProfiler::Node::addToFlatList(Array<const Node*>& list) const
+{
+	list.add(this);
+
+	for (int i = 0; i < children.size(); i++)
+		children[i]->addToFlatList(list);
+}
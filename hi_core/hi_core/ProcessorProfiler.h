@@ -0,0 +1,262 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+
+#ifndef PROCESSORPROFILER_H_INCLUDED
+#define PROCESSORPROFILER_H_INCLUDED
+
+#include "../additional_libraries/lockfree_fifo/readerwriterqueue.h"
+
+#if JUCE_INTEL
+#if JUCE_MSVC
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+class MainController;
+class Processor;
+
+#define NUM_PROFILER_THREADS 8
+
+/** A low overhead profiler that measures the time spent in each Processor.
+*
+*	The profiler is always compiled (unless you set ENABLE_PROCESSOR_PROFILER to 0), but it only starts measuring
+*	after you call setEnabled(true). If it is disabled, a measurement point costs a single atomic read.
+*
+*	In order to time a processor, add the macro PROFILE_PROCESSOR(p) to the scope that renders it. It will read the
+*	cycle counter of the CPU and push a compact record into a lock free queue that belongs to the current thread (so
+*	the audio thread never waits for another thread and never allocates once the queues are created). Every thread
+*	claims one of the NUM_PROFILER_THREADS queues the first time it adds a record.
+*
+*	Script callbacks are measured as part of their processor (eg. a ScriptFX's processBlock callback is counted
+*	for the ScriptFX module).
+*
+*	Call drain() periodically from a single thread. In the backend, the CpuProfilerTable does this on the message thread,
+*	the headless benchmark mode (HISE benchmark ... -profile:"Profile.json") drains the queue on the rendering thread after
+*	every block and writes the dump when it's done. It collects the records and updates the statistics for every
+*	processor. You can then create a tree of Node objects that mirrors the processor hierarchy using createTree() or dump
+*	the statistics as JSON using createJSONDump().
+*
+*	The queues have a fixed size, so if they are not drained often enough (which can happen quickly with many voices,
+*	since every envelope is timed for each voice), new records are dropped. The dropped records are counted and
+*	reported by the CpuProfilerTable and in the JSON dump.
+*/
+class ProcessorProfiler
+{
+public:
+
+	/** A single measurement. If processor is nullptr, it marks the end of an audio callback. */
+	struct Record
+	{
+		const void* processor;
+		uint64 cycles;
+		int numSamples;
+	};
+
+	/** A node in the profiling tree. The percentage values are relative to the available time for one buffer. */
+	struct Node
+	{
+		/** Creates a JSON object with the statistics of this node and all of its children. */
+		var toJSON() const;
+
+		/** Adds this node and all of its children to the given list. Use this to display the tree in a flat table. */
+		void addToFlatList(Array<const Node*>& list) const;
+
+		WeakReference<Processor> processor;
+
+		String id;
+		String type;
+		int depth = 0;
+
+		double averagePercentage = 0.0;
+		double peakPercentage = 0.0;
+		double selfPercentage = 0.0;
+		double callsPerBlock = 0.0;
+
+		OwnedArray<Node> children;
+	};
+
+	/** Measures the lifetime of the object and adds a record for the given processor. */
+	class ScopedTimer
+	{
+	public:
+
+		ScopedTimer(ProcessorProfiler& profiler_, const Processor* p_) noexcept:
+			profiler(profiler_.isEnabled() ? &profiler_ : nullptr),
+			p(p_),
+			start(profiler != nullptr ? getCycleCount() : 0)
+		{}
+
+		~ScopedTimer()
+		{
+			if (profiler != nullptr)
+				profiler->addRecord(p, getCycleCount() - start, 0);
+		}
+
+	private:
+
+		ProcessorProfiler* profiler;
+		const Processor* p;
+		const uint64 start;
+
+		JUCE_DECLARE_NON_COPYABLE(ScopedTimer)
+	};
+
+	/** Measures a whole audio callback. Use this in the main render callback. */
+	class ScopedBlockTimer
+	{
+	public:
+
+		ScopedBlockTimer(ProcessorProfiler& profiler_, int numSamples_) noexcept:
+			profiler(profiler_.isEnabled() ? &profiler_ : nullptr),
+			numSamples(numSamples_),
+			start(profiler != nullptr ? getCycleCount() : 0)
+		{}
+
+		~ScopedBlockTimer()
+		{
+			if (profiler != nullptr)
+				profiler->addRecord(nullptr, getCycleCount() - start, numSamples);
+		}
+
+	private:
+
+		ProcessorProfiler* profiler;
+		const int numSamples;
+		const uint64 start;
+
+		JUCE_DECLARE_NON_COPYABLE(ScopedBlockTimer)
+	};
+
+	ProcessorProfiler(MainController* mc);
+
+	~ProcessorProfiler();
+
+	/** Returns the current value of the CPU cycle counter (or the high resolution ticks on non Intel platforms). */
+	static forcedinline uint64 getCycleCount() noexcept
+	{
+#if JUCE_INTEL
+		return (uint64)__rdtsc();
+#else
+		return (uint64)Time::getHighResolutionTicks();
+#endif
+	}
+
+	/** Enables or disables the profiling. The queues are allocated the first time you enable it. */
+	void setEnabled(bool shouldBeEnabled);
+
+	bool isEnabled() const noexcept { return enabled.load(); }
+
+	/** Adds a record to the queue of the current thread. This is called by the ScopedTimer objects. */
+	void addRecord(const void* processor, uint64 cycles, int numSamples) noexcept;
+
+	/** Collects all pending records and updates the statistics.
+	*
+	*	This must not be called from more than one thread at the same time.
+	*/
+	void drain();
+
+	/** Clears all statistics. */
+	void reset();
+
+	/** Creates a tree that mirrors the processor hierarchy starting from the main synth chain. */
+	Node* createTree() const;
+
+	/** Creates a JSON object containing the block statistics and the processor tree. */
+	var createJSONDump() const;
+
+	/** Drains the queues and writes the JSON dump to the given file. */
+	bool writeJSONDumpToFile(const File& f);
+
+	/** Returns the number of measured audio callbacks since the last reset. */
+	int getNumMeasuredBlocks() const noexcept { return numBlocks; }
+
+	/** Returns the number of records that were dropped because a queue was full. */
+	int getNumDroppedRecords() const noexcept { return numDroppedRecords.get(); }
+
+private:
+
+	struct Stats
+	{
+		double percentageSum = 0.0;
+		double peakPercentage = 0.0;
+		int64 numCalls = 0;
+	};
+
+	struct ThreadQueue
+	{
+		ThreadQueue();
+
+		Atomic<Thread::ThreadID> owner;
+
+		moodycamel::ReaderWriterQueue<Record> queue;
+
+		// Only accessed by the thread calling drain()
+		HashMap<const void*, uint64> pendingCycles;
+		HashMap<const void*, int> pendingCalls;
+	};
+
+	void flushBlock(ThreadQueue& q, const Record& blockRecord);
+
+	double getCyclesPerSecond() const;
+
+	void fillNode(Node& n, const Processor* p, int depth) const;
+
+	MainController* mc;
+
+	std::atomic<bool> enabled;
+
+	OwnedArray<ThreadQueue> queues;
+	Atomic<int> numThreads;
+	Atomic<int> numDroppedRecords;
+
+	HashMap<const void*, Stats> stats;
+
+	Stats blockStats;
+	int numBlocks = 0;
+
+	uint64 startCycles = 0;
+	int64 startTicks = 0;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProcessorProfiler)
+};
+
+#if ENABLE_PROCESSOR_PROFILER
+#define PROFILE_PROCESSOR(p) ProcessorProfiler::ScopedTimer JUCE_JOIN_MACRO(spt, __LINE__)(p->getMainController()->getProcessorProfiler(), p)
+#else
+#define PROFILE_PROCESSOR(p)
+#endif
+
+#endif  // PROCESSORPROFILER_H_INCLUDED
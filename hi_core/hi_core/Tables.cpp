@@ -113,6 +113,8 @@ void Table::fillLookUpTable()
 
 	ScopedLock sl(getLock());
 	FloatVectorOperations::copy(getWritePointer(), newValues.getRawDataPointer(), getTableSize());
+
+	increaseDataVersion();
 };
 
 float *MidiTable::getWritePointer() {return data;};
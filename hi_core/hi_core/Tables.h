@@ -174,9 +174,20 @@ public:
 		return lock;
 	};
 
+	/** Returns a counter that is increased whenever the table data changes.
+	*
+	*	Compare it with the last value you have seen if you need to know whether the data has changed.
+	*/
+	int getDataVersion() const noexcept { return dataVersion.load(); }
+
 		/** Overwrite this and return a pointer to the data array. */
 	virtual float *getWritePointer() = 0;
 
+protected:
+
+	/** Call this whenever you change the data directly. */
+	void increaseDataVersion() noexcept { ++dataVersion; }
+
 private:
 
 	class GraphPointComparator
@@ -197,6 +208,8 @@ private:
 
 	CriticalSection lock;
 
+	std::atomic<int> dataVersion { 0 };
+
 	Array<GraphPoint> graphPoints;
 };
 
@@ -352,6 +365,7 @@ public:
 	void setValue(int index, float newValue)
 	{
 		data[index] = newValue;
+		increaseDataVersion();
 	}
 
 	String exportData() const override
@@ -378,6 +392,8 @@ public:
 		{
 			data[i] = savedData[i];
 		}
+
+		increaseDataVersion();
 	};
 
 	const float *getReadPointer() const override {return data;};
@@ -0,0 +1,541 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+
+#define TRACE_FILE_MAGIC 0x43525448 // "HTRC"
+#define TRACE_FILE_VERSION 1
+#define TRACE_NUM_DROPPED_OFFSET 24
+#define TRACE_RECORD_SIZE 40
+
+TraceRecorder::ThreadQueue::ThreadQueue():
+	owner(nullptr),
+	queue(TRACE_QUEUE_SIZE)
+{
+
+}
+
+TraceRecorder::TraceRecorder(Consumer* consumer_):
+	Thread("Trace Writer"),
+	consumer(consumer_),
+	recording(false),
+	numThreads(0),
+	numDroppedRecords(0)
+{
+
+}
+
+TraceRecorder::~TraceRecorder()
+{
+	stopRecording();
+}
+
+bool TraceRecorder::startRecording(const File& traceFile)
+{
+	stopRecording();
+
+	if (queues.isEmpty())
+	{
+		for (int i = 0; i < NUM_TRACE_THREADS; i++)
+			queues.add(new ThreadQueue());
+	}
+
+	traceFile.deleteFile();
+
+	output = new FileOutputStream(traceFile);
+
+	if (output->failedToOpen())
+	{
+		output = nullptr;
+		return false;
+	}
+
+	currentTraceFile = traceFile;
+	startTicks = Time::getHighResolutionTicks();
+	numDroppedRecords.set(0);
+
+	{
+		ScopedLock sl(nameLock);
+		numWrittenNames = 0;
+	}
+
+	output->writeInt(TRACE_FILE_MAGIC);
+	output->writeInt(TRACE_FILE_VERSION);
+	output->writeInt64(Time::getHighResolutionTicksPerSecond());
+	output->writeInt64(startTicks);
+	output->writeInt(0); // the number of dropped records will be written when the recording stops
+
+	recording.store(true);
+
+	startThread(4);
+
+	return true;
+}
+
+void TraceRecorder::stopRecording()
+{
+	if (!recording.load())
+		return;
+
+	recording.store(false);
+
+	stopThread(2000);
+
+	drain();
+
+	if (output != nullptr)
+	{
+		output->flush();
+
+		if (output->setPosition(TRACE_NUM_DROPPED_OFFSET))
+			output->writeInt(numDroppedRecords.get());
+
+		output = nullptr;
+	}
+}
+
+void TraceRecorder::addRecord(RecordType type, int callbackIndex, int sequenceIndex, int data1, int data2, int data3, double value) noexcept
+{
+	if (!recording.load())
+		return;
+
+	const Thread::ThreadID threadId = Thread::getCurrentThreadId();
+	const int numUsedQueues = jmin<int>(numThreads.get(), NUM_TRACE_THREADS);
+
+	ThreadQueue* q = nullptr;
+	int threadIndex = 0;
+
+	for (int i = 0; i < numUsedQueues; i++)
+	{
+		if (queues.getUnchecked(i)->owner.get() == threadId)
+		{
+			q = queues.getUnchecked(i);
+			threadIndex = i;
+			break;
+		}
+	}
+
+	if (q == nullptr)
+	{
+		threadIndex = ++numThreads - 1;
+
+		if (threadIndex >= NUM_TRACE_THREADS)
+		{
+			// You are logging from more threads than there are queues...
+			++numDroppedRecords;
+			return;
+		}
+
+		q = queues.getUnchecked(threadIndex);
+		q->owner.set(threadId);
+	}
+
+	Record r = { Time::getHighResolutionTicks(), (uint16)type, (uint16)threadIndex, callbackIndex, sequenceIndex, data1, data2, data3, value };
+
+	if (!q->queue.try_enqueue(r))
+		++numDroppedRecords;
+}
+
+int TraceRecorder::getNameIndex(const String& name)
+{
+	ScopedLock sl(nameLock);
+
+	const int index = names.indexOf(name);
+
+	if (index != -1)
+		return index;
+
+	names.add(name);
+	return names.size() - 1;
+}
+
+void TraceRecorder::run()
+{
+	while (!threadShouldExit())
+	{
+		wait(50);
+		drain();
+	}
+}
+
+void TraceRecorder::drain()
+{
+	if (output == nullptr)
+		return;
+
+	writeNewNames();
+
+	const int numUsedQueues = jmin<int>(numThreads.get(), NUM_TRACE_THREADS);
+
+	for (int i = 0; i < numUsedQueues; i++)
+	{
+		ThreadQueue& q = *queues.getUnchecked(i);
+
+		Record r;
+
+		while (q.queue.try_dequeue(r))
+		{
+			output->writeInt64(r.ticks);
+			output->writeShort((short)r.type);
+			output->writeShort((short)r.threadIndex);
+			output->writeInt(r.callbackIndex);
+			output->writeInt(r.sequenceIndex);
+			output->writeInt(r.data1);
+			output->writeInt(r.data2);
+			output->writeInt(r.data3);
+			output->writeDouble(r.value);
+
+			if (consumer != nullptr)
+				consumer->traceRecordDrained(r);
+		}
+	}
+
+	output->flush();
+}
+
+void TraceRecorder::writeNewNames()
+{
+	StringArray newNames;
+	int firstIndex;
+
+	{
+		ScopedLock sl(nameLock);
+
+		firstIndex = numWrittenNames;
+
+		for (int i = numWrittenNames; i < names.size(); i++)
+			newNames.add(names[i]);
+
+		numWrittenNames = names.size();
+	}
+
+	for (int i = 0; i < newNames.size(); i++)
+	{
+		const int numBytes = (int)newNames[i].getNumBytesAsUTF8();
+
+		output->writeInt64(Time::getHighResolutionTicks());
+		output->writeShort((short)RecordType::NameDefinition);
+		output->writeShort(0);
+		output->writeInt(0);
+		output->writeInt(0);
+		output->writeInt(firstIndex + i);
+		output->writeInt(numBytes);
+		output->writeInt(0);
+		output->writeDouble(0.0);
+		output->write(newNames[i].toRawUTF8(), (size_t)numBytes);
+	}
+}
+
+double TraceRecorder::Trace::getTimeInSeconds(const Record& r) const noexcept
+{
+	if (ticksPerSecond == 0)
+		return 0.0;
+
+	return (double)(r.ticks - startTicks) / (double)ticksPerSecond;
+}
+
+Result TraceRecorder::readTraceFile(const File& traceFile, Trace& trace)
+{
+	FileInputStream fis(traceFile);
+
+	if (fis.failedToOpen())
+		return Result::fail("Can't open " + traceFile.getFullPathName());
+
+	if (fis.readInt() != TRACE_FILE_MAGIC)
+		return Result::fail(traceFile.getFileName() + " is not a trace file");
+
+	const int version = fis.readInt();
+
+	if (version != TRACE_FILE_VERSION)
+		return Result::fail("Unsupported trace file version: " + String(version));
+
+	trace.ticksPerSecond = fis.readInt64();
+	trace.startTicks = fis.readInt64();
+	trace.numDroppedRecords = fis.readInt();
+
+	while (fis.getNumBytesRemaining() >= TRACE_RECORD_SIZE)
+	{
+		Record r;
+
+		r.ticks = fis.readInt64();
+		r.type = (uint16)fis.readShort();
+		r.threadIndex = (uint16)fis.readShort();
+		r.callbackIndex = fis.readInt();
+		r.sequenceIndex = fis.readInt();
+		r.data1 = fis.readInt();
+		r.data2 = fis.readInt();
+		r.data3 = fis.readInt();
+		r.value = fis.readDouble();
+
+		if (r.getType() == RecordType::NameDefinition)
+		{
+			if (r.data2 < 0 || r.data2 > fis.getNumBytesRemaining())
+				return Result::fail("Corrupt name definition in trace file");
+
+			MemoryBlock mb;
+			fis.readIntoMemoryBlock(mb, r.data2);
+
+			while (trace.names.size() <= r.data1)
+				trace.names.add(String());
+
+			trace.names.set(r.data1, mb.toString());
+			continue;
+		}
+
+		if (r.type == 0 || r.type >= (uint16)RecordType::numRecordTypes)
+			return Result::fail("Corrupt record in trace file");
+
+		trace.records.add(r);
+	}
+
+	struct TimeSorter
+	{
+		static int compareElements(const Record& first, const Record& second)
+		{
+			if (first.ticks < second.ticks) return -1;
+			if (first.ticks > second.ticks) return 1;
+			return 0;
+		}
+	};
+
+	TimeSorter sorter;
+	trace.records.sort(sorter, true);
+
+	return Result::ok();
+}
+
+String TraceRecorder::getNameForRecordType(RecordType t)
+{
+	switch (t)
+	{
+	case RecordType::Empty:					return "Empty";
+	case RecordType::AudioCallback:			return "AudioCallback";
+	case RecordType::Event:					return "Event";
+	case RecordType::VoiceStart:			return "VoiceStart";
+	case RecordType::VoiceStop:				return "VoiceStop";
+	case RecordType::StreamingRequest:		return "StreamingRequest";
+	case RecordType::StreamingFailure:		return "StreamingFailure";
+	case RecordType::Failure:				return "Failure";
+	case RecordType::PerformanceWarning:	return "PerformanceWarning";
+	case RecordType::ParameterChange:		return "ParameterChange";
+	case RecordType::NameDefinition:		return "NameDefinition";
+	case RecordType::numRecordTypes:		break;
+	}
+
+	return "Undefined";
+}
+
+String TraceRecorder::getRecordDescription(const Trace& trace, const Record& r)
+{
+	String s;
+
+	switch (r.getType())
+	{
+	case RecordType::AudioCallback:
+		s << "Buffer size: " << r.data1 << ", Sample rate: " << String(r.value, 0);
+		break;
+	case RecordType::Event:
+	{
+		HiseEvent e((HiseEvent::Type)(r.data1 & 0xFF), (uint8)((r.data1 >> 8) & 0xFF), (uint8)((r.data1 >> 16) & 0xFF), (uint8)((r.data1 >> 24) & 0xFF));
+
+		s << e.getTypeAsString() << " ";
+		s << "V1: " << (e.isNoteOnOrOff() ? MidiMessage::getMidiNoteName(e.getNoteNumber(), true, true, 3) : String(e.getNoteNumber()));
+		s << ", V2: " << String(e.getVelocity()) << ", Ch: " << String(e.getChannel());
+		s << ", ID: " << r.data2 << ", TS: " << r.data3;
+		break;
+	}
+	case RecordType::VoiceStart:
+	case RecordType::VoiceStop:
+		s << "Voice: " << r.data1 << ", ID: " << r.data2 << ", Note: " << MidiMessage::getMidiNoteName(r.data3, true, true, 3);
+		break;
+	case RecordType::StreamingRequest:
+		s << "Position: " << String((int64)r.value) << (r.data1 != 0 ? " (previous request still pending)" : "");
+		break;
+	case RecordType::StreamingFailure:
+		s << "Voice uptime: " << String(r.value, 1);
+		break;
+	case RecordType::Failure:
+		s << DebugLogger::getNameForFailure((DebugLogger::FailureType)r.data1) << " at " << DebugLogger::getNameForLocation((DebugLogger::Location)r.data2);
+
+		if (r.value != 0.0)
+			s << ", Info: " << String(r.value, 3);
+
+		break;
+	case RecordType::PerformanceWarning:
+		s << DebugLogger::getNameForLocation((DebugLogger::Location)r.data1) << ", Voices: " << r.data2 << ", CPU: " << String(r.value, 1) << "%";
+		break;
+	case RecordType::ParameterChange:
+		s << trace.names[r.data1] << ": " << String(r.value, 3);
+		break;
+	case RecordType::Empty:
+	case RecordType::NameDefinition:
+	case RecordType::numRecordTypes:
+		break;
+	}
+
+	return s;
+}
+
+String TraceRecorder::createTimeline(const Trace& trace)
+{
+	String timeline;
+	NewLine nl;
+
+	timeline << "Records: " << trace.records.size() << ", Dropped: " << trace.numDroppedRecords << nl << nl;
+
+	for (int i = 0; i < trace.records.size(); i++)
+	{
+		const Record& r = trace.records.getReference(i);
+
+		timeline << String(trace.getTimeInSeconds(r) * 1000.0, 3).paddedLeft(' ', 12) << " ms | ";
+		timeline << "T" << String(r.threadIndex).paddedRight(' ', 3) << "| ";
+		timeline << "CI " << String(r.callbackIndex).paddedRight(' ', 8) << "| ";
+		timeline << getNameForRecordType(r.getType()).paddedRight(' ', 20) << getRecordDescription(trace, r) << nl;
+	}
+
+	return timeline;
+}
+
+var TraceRecorder::createChromeTrace(const Trace& trace)
+{
+	Array<var> events;
+	Array<int> usedThreads;
+
+	for (int i = 0; i < trace.records.size(); i++)
+	{
+		const Record& r = trace.records.getReference(i);
+
+		DynamicObject::Ptr e = new DynamicObject();
+
+		e->setProperty("name", getNameForRecordType(r.getType()));
+		e->setProperty("pid", 1);
+		e->setProperty("tid", (int)r.threadIndex);
+		e->setProperty("ts", trace.getTimeInSeconds(r) * 1.0e6);
+
+		DynamicObject::Ptr args = new DynamicObject();
+
+		args->setProperty("CallbackIndex", r.callbackIndex);
+		args->setProperty("Info", getRecordDescription(trace, r));
+
+		e->setProperty("args", var(args));
+
+		switch (r.getType())
+		{
+		case RecordType::AudioCallback:
+			e->setProperty("ph", "X");
+			e->setProperty("dur", r.value > 0.0 ? 1.0e6 * (double)r.data1 / r.value : 0.0);
+			break;
+		case RecordType::VoiceStart:
+		case RecordType::VoiceStop:
+			e->setProperty("name", "Voice " + String(r.data1));
+			e->setProperty("cat", "voice");
+			e->setProperty("ph", r.getType() == RecordType::VoiceStart ? "b" : "e");
+			e->setProperty("id", String(r.data1) + "_" + String(r.data2));
+			break;
+		default:
+			e->setProperty("ph", "i");
+			e->setProperty("s", "t");
+			break;
+		}
+
+		events.add(var(e));
+
+		usedThreads.addIfNotAlreadyThere((int)r.threadIndex);
+	}
+
+	for (int i = 0; i < usedThreads.size(); i++)
+	{
+		DynamicObject::Ptr m = new DynamicObject();
+		DynamicObject::Ptr args = new DynamicObject();
+
+		args->setProperty("name", "Thread " + String(usedThreads[i]));
+
+		m->setProperty("name", "thread_name");
+		m->setProperty("ph", "M");
+		m->setProperty("pid", 1);
+		m->setProperty("tid", usedThreads[i]);
+		m->setProperty("args", var(args));
+
+		events.add(var(m));
+	}
+
+	DynamicObject::Ptr obj = new DynamicObject();
+
+	obj->setProperty("traceEvents", events);
+	obj->setProperty("displayTimeUnit", "ms");
+
+	return var(obj);
+}
+
+Result TraceRecorder::decodeFromCommandLine(const String& commandLine)
+{
+	const String options = commandLine.fromFirstOccurrenceOf("trace ", false, false);
+
+	StringArray args = StringArray::fromTokens(options, true);
+
+	if (args.isEmpty())
+		return Result::fail("Missing arguments");
+
+	const File traceFile(args[0].unquoted());
+
+	bool useChromeFormat = false;
+	File outputFile;
+
+	for (int i = 1; i < args.size(); i++)
+	{
+		if (args[i] == "-chrome")
+			useChromeFormat = true;
+		else if (args[i].startsWith("-o:"))
+			outputFile = File(args[i].fromFirstOccurrenceOf("-o:", false, false).unquoted());
+	}
+
+	Trace trace;
+
+	Result r = readTraceFile(traceFile, trace);
+
+	if (!r.wasOk())
+		return r;
+
+	const String text = useChromeFormat ? JSON::toString(createChromeTrace(trace)) : createTimeline(trace);
+
+	if (outputFile != File())
+	{
+		if (!outputFile.replaceWithText(text))
+			return Result::fail("The output file can't be written");
+	}
+	else
+	{
+		std::cout << text << std::endl;
+	}
+
+	return Result::ok();
+}
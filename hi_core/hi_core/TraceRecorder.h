@@ -0,0 +1,200 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+
+#ifndef TRACERECORDER_H_INCLUDED
+#define TRACERECORDER_H_INCLUDED
+
+#include "../additional_libraries/lockfree_fifo/readerwriterqueue.h"
+
+#define NUM_TRACE_THREADS 16
+#define TRACE_QUEUE_SIZE 8192
+
+/** A lock free recorder that writes compact binary records into a trace file.
+*
+*	The DebugLogger uses this class to log everything that happens on the audio thread (or the streaming threads).
+*	Adding a record never locks or allocates: it pushes a Record into a single producer / single consumer queue
+*	that belongs to the calling thread (every thread claims one of the NUM_TRACE_THREADS queues the first time it
+*	adds a record). If a queue is full, the record is dropped and counted.
+*
+*	While recording, a background thread drains the queues every few milliseconds, appends the records to the
+*	trace file and passes them to the Consumer (the DebugLogger uses this to create its human readable log).
+*
+*	The file format is a small header followed by the raw records. Strings (eg. parameter names) can't be part of a
+*	record, so you need to register them with getNameIndex() on a non realtime thread and pass the index instead.
+*	Use readTraceFile() to decode a trace and createTimeline() or createChromeTrace() to convert it into a readable
+*	timeline or a JSON file that can be loaded into chrome://tracing.
+*/
+class TraceRecorder : public Thread
+{
+public:
+
+	enum class RecordType : uint16
+	{
+		Empty = 0,
+		AudioCallback, //< the start of an audio callback. data1: buffer size, value: sample rate
+		Event, //< a HiseEvent. data1: type | number << 8 | value << 16 | channel << 24, data2: event ID, data3: timestamp
+		VoiceStart, //< data1: voice index, data2: event ID, data3: note number
+		VoiceStop, //< data1: voice index, data2: event ID, data3: note number
+		StreamingRequest, //< data1: 1 if the previous request was still pending, value: the position in the sample file
+		StreamingFailure, //< value: the voice uptime
+		Failure, //< data1: DebugLogger::FailureType, data2: DebugLogger::Location, value: the additional info
+		PerformanceWarning, //< data1: DebugLogger::Location, data2: voice amount, value: CPU percentage
+		ParameterChange, //< data1: the name index, value: the new value
+		NameDefinition, //< data1: the name index, data2: the number of UTF-8 bytes that follow the record
+		numRecordTypes
+	};
+
+	/** A single trace record. This is a POD with a fixed size so it can be written directly into the file. */
+	struct Record
+	{
+		int64 ticks;
+		uint16 type;
+		uint16 threadIndex;
+		int32 callbackIndex;
+		int32 sequenceIndex;
+		int32 data1;
+		int32 data2;
+		int32 data3;
+		double value;
+
+		RecordType getType() const noexcept { return (RecordType)type; }
+	};
+
+	/** Subclass this to get notified on the writer thread about every record that was written. */
+	struct Consumer
+	{
+		virtual ~Consumer() {};
+
+		/** Called on the writer thread for each drained record (the NameDefinition records are filtered out). */
+		virtual void traceRecordDrained(const Record& r) = 0;
+	};
+
+	/** The content of a decoded trace file. */
+	struct Trace
+	{
+		Array<Record> records;
+		StringArray names;
+		int64 ticksPerSecond = 0;
+		int64 startTicks = 0;
+		int numDroppedRecords = 0;
+
+		/** Returns the time of the record in seconds since the start of the trace. */
+		double getTimeInSeconds(const Record& r) const noexcept;
+	};
+
+	TraceRecorder(Consumer* consumer=nullptr);
+
+	~TraceRecorder();
+
+	/** Starts writing a new trace file. The queues are allocated the first time you call this. */
+	bool startRecording(const File& traceFile);
+
+	/** Drains the remaining records, stops the writer thread and closes the file. */
+	void stopRecording();
+
+	bool isRecording() const noexcept { return recording.load(); }
+
+	/** Adds a record to the queue of the current thread. This can be called from any thread and never locks. */
+	void addRecord(RecordType type, int callbackIndex, int sequenceIndex, int data1, int data2 = 0, int data3 = 0, double value = 0.0) noexcept;
+
+	/** Returns an index for the given name that you can use in a record. Don't call this from the audio thread. */
+	int getNameIndex(const String& name);
+
+	/** Returns the number of records that were dropped because a queue was full. */
+	int getNumDroppedRecords() const noexcept { return numDroppedRecords.get(); }
+
+	File getCurrentTraceFile() const { return currentTraceFile; }
+
+	/** Returns the high resolution ticks at the start of the current recording. */
+	int64 getStartTicks() const noexcept { return startTicks; }
+
+	void run() override;
+
+	// ================================================================================================================ Decoding
+
+	/** Reads a trace file that was written by this class. */
+	static Result readTraceFile(const File& traceFile, Trace& trace);
+
+	/** Creates a human readable timeline with one line per record. */
+	static String createTimeline(const Trace& trace);
+
+	/** Creates a JSON object in the Chrome trace event format. */
+	static var createChromeTrace(const Trace& trace);
+
+	/** Decodes the trace file from the command line.
+	*
+	*	Usage: HISE trace "File.htrace" [-chrome] [-o:"Output.json"]
+	*/
+	static Result decodeFromCommandLine(const String& commandLine);
+
+	static String getNameForRecordType(RecordType t);
+
+private:
+
+	struct ThreadQueue
+	{
+		ThreadQueue();
+
+		Atomic<Thread::ThreadID> owner;
+
+		moodycamel::ReaderWriterQueue<Record> queue;
+	};
+
+	void drain();
+
+	void writeNewNames();
+
+	static String getRecordDescription(const Trace& trace, const Record& r);
+
+	Consumer* consumer;
+
+	std::atomic<bool> recording;
+
+	OwnedArray<ThreadQueue> queues;
+	Atomic<int> numThreads;
+	Atomic<int> numDroppedRecords;
+
+	CriticalSection nameLock;
+	StringArray names;
+	int numWrittenNames = 0;
+
+	File currentTraceFile;
+	ScopedPointer<FileOutputStream> output;
+
+	int64 startTicks = 0;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TraceRecorder)
+};
+
+#endif  // TRACERECORDER_H_INCLUDED
@@ -496,6 +496,12 @@ public:
         flagTimer.startTimer(timerIntervalMilliseconds);
     }
 
+	/** Returns true if a change message was sent but has not been delivered to the listeners yet. */
+	bool hasPendingChangeMessage() const
+	{
+		return dispatcher.isUpdatePending() || flagTimer.send.load();
+	}
+
 private:
 
     class FlagTimer: public Timer
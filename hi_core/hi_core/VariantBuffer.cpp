@@ -294,6 +294,99 @@ VariantBuffer * VariantBuffer::Factory::getFreeVariantBuffer()
 	return nullptr;
 }
 
+VariantBuffer::OperationChain::OperationChain(VariantBuffer& target_) :
+	target(target_),
+	numOperations(0)
+{
+
+}
+
+bool VariantBuffer::OperationChain::addOperation(OpType type, float value)
+{
+	if (numOperations >= MaxNumOperations)
+		return false;
+
+	Operation& op = operations[numOperations++];
+
+	op.type = type;
+	op.value = FloatSanitizers::sanitizeFloatNumber(value);
+	op.data = nullptr;
+
+	return true;
+}
+
+bool VariantBuffer::OperationChain::addOperation(OpType type, const VariantBuffer& other)
+{
+	if (numOperations >= MaxNumOperations)
+		return false;
+
+	if (other.size != target.size || other.buffer.getNumSamples() != target.buffer.getNumSamples())
+		return false;
+
+	const float* d = other.buffer.getReadPointer(0);
+	const float* t = target.buffer.getReadPointer(0);
+
+	// Reading the same samples is fine, but an offset would read values that were already processed
+	if (d != t && d < t + target.size && t < d + other.size)
+		return false;
+
+	Operation& op = operations[numOperations++];
+
+	op.type = type;
+	op.value = 0.0f;
+	op.data = d;
+
+	return true;
+}
+
+void VariantBuffer::OperationChain::process() const
+{
+	float* d = target.buffer.getWritePointer(0);
+	const int numSamples = target.size;
+
+	for (int offset = 0; offset < numSamples; offset += ChunkSize)
+	{
+		const int numThisTime = jmin<int>(ChunkSize, numSamples - offset);
+		float* dst = d + offset;
+
+		for (int i = 0; i < numOperations; i++)
+		{
+			const Operation& op = operations[i];
+			const float* src = op.data != nullptr ? op.data + offset : nullptr;
+
+			switch (op.type)
+			{
+			case Assign:
+				if (src == nullptr)
+				{
+					FloatVectorOperations::fill(dst, op.value, numThisTime);
+				}
+				else if (src != dst)
+				{
+					FloatVectorOperations::copy(dst, src, numThisTime);
+					FloatSanitizers::sanitizeArray(dst, numThisTime);
+				}
+				break;
+			case Add:
+				if (src == nullptr)	FloatVectorOperations::add(dst, op.value, numThisTime);
+				else				FloatVectorOperations::add(dst, src, numThisTime);
+				break;
+			case Subtract:
+				if (src == nullptr)	FloatVectorOperations::add(dst, -1.0f * op.value, numThisTime);
+				else				FloatVectorOperations::subtract(dst, src, numThisTime);
+				break;
+			case Multiply:
+				if (src == nullptr)	FloatVectorOperations::multiply(dst, op.value, numThisTime);
+				else				FloatVectorOperations::multiply(dst, src, numThisTime);
+				break;
+			case numOpTypes:
+				jassertfalse;
+				break;
+			}
+		}
+	}
+}
+
 void operator>>(float f, VariantBuffer &b)
 {
 	FloatVectorOperations::fill(b.buffer.getWritePointer(0), f, b.size);
@@ -65,6 +65,8 @@
 *
 *	If the Intel IPP library is used, the data will be allocated using the IPP allocators for aligned data
 *
+*	If you apply multiple operations to the same buffer, use an OperationChain to process them in a single pass.
+*
 */
 class VariantBuffer : public DynamicObject
 {
@@ -154,6 +156,67 @@ public:
 	var getSample(int sampleIndex);
 	void setSample(int sampleIndex, float newValue);
 
+	/** A list of inplace operations that are applied to a buffer in a single pass.
+	*
+	*	Applying the operators one after another (eg. b *= g; b += c; b *= 0.5f) iterates over the whole buffer for
+	*	every operation. This class processes the target buffer in chunks that stay in the cache and applies all
+	*	operations to one chunk before moving on to the next one.
+	*
+	*	It does not allocate, so you can create it on the stack in the audio thread.
+	*/
+	class OperationChain
+	{
+	public:
+
+		enum OpType
+		{
+			Assign = 0, ///< b << x
+			Add,		///< b += x
+			Subtract,	///< b -= x
+			Multiply,	///< b *= x
+			numOpTypes
+		};
+
+		OperationChain(VariantBuffer& target_);
+
+		/** Adds an operation with a scalar value. Returns false if the chain is full. */
+		bool addOperation(OpType type, float value);
+
+		/** Adds an operation with another buffer.
+		*
+		*	Returns false if the chain is full, the buffer sizes don't match or the other buffer partially overlaps
+		*	the target (in which case the single pass would yield a different result). In this case, you'll need to
+		*	apply the operators one by one.
+		*/
+		bool addOperation(OpType type, const VariantBuffer& other);
+
+		int getNumOperations() const noexcept { return numOperations; }
+
+		/** Applies all operations to the target buffer. */
+		void process() const;
+
+		enum
+		{
+			MaxNumOperations = 16,
+			ChunkSize = 1024
+		};
+
+	private:
+
+		struct Operation
+		{
+			OpType type;
+			float value;
+			const float* data;
+		};
+
+		VariantBuffer& target;
+		Operation operations[MaxNumOperations];
+		int numOperations;
+
+		JUCE_DECLARE_NON_COPYABLE(OperationChain)
+	};
+
 	
 	class Factory : public DynamicObject
 	{
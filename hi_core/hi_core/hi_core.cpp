@@ -55,7 +55,11 @@ namespace juce
 #endif
 
 #include "UtilityClasses.cpp"
+#include "TraceRecorder.cpp"
 #include "DebugLogger.cpp"
+#include "ProcessorProfiler.cpp"
+#include "HostAutomationQueue.cpp"
+#include "AnalyserTap.cpp"
 #include "ThreadWithQuasiModalProgressWindow.cpp"
 #include "HI_LookAndFeels.cpp"
 #include "Tables.cpp"
@@ -64,7 +64,11 @@ namespace juce
 #include "UtilityClasses.h"
 #include "HI_LookAndFeels.h"
 #include "HiseEventBuffer.h"
+#include "TraceRecorder.h"
 #include "DebugLogger.h"
+#include "ProcessorProfiler.h"
+#include "HostAutomationQueue.h"
+#include "AnalyserTap.h"
 
 
 #include "ThreadWithQuasiModalProgressWindow.h"
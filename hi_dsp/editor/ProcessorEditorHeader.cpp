@@ -45,6 +45,9 @@ ProcessorEditorHeader::ProcessorEditorHeader(ProcessorEditor *p) :
 	valueMeter->setColour (VuMeter::backgroundColour, Colour (0xFF333333));
 	valueMeter->setColour (VuMeter::ledColour, Colours::lightgrey);
 	valueMeter->setColour (VuMeter::outlineColour, isHeaderOfModulatorSynth() ? Colour (0x45000000) : Colour (0x45ffffff));
+
+	if (MasterEffectProcessor* mep = dynamic_cast<MasterEffectProcessor*>(getProcessor()))
+		levelReader = new AnalyserTap::Reader(mep->getLevelTap());
 	
 	#if JUCE_DEBUG
 	startTimer(150);
@@ -349,6 +352,7 @@ ProcessorEditorHeader::ProcessorEditorHeader(ProcessorEditor *p) :
 
 ProcessorEditorHeader::~ProcessorEditorHeader()
 {
+	levelReader = nullptr;
     valueMeter = nullptr;
     idLabel = nullptr;
     typeLabel = nullptr;
@@ -1169,6 +1173,10 @@ void ProcessorEditorHeader::timerCallback()
 
 			
 			
+		}
+		else if (levelReader != nullptr && levelReader->getTap() != nullptr)
+		{
+			valueMeter->setPeakFromTap(*levelReader->getTap());
 		}
 		else
 		{
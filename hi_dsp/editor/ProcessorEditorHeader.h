@@ -160,6 +160,7 @@ private:
 	ScopedPointer<ChainIcon> chainIcon;
 
     ScopedPointer<VuMeter> valueMeter;
+	ScopedPointer<AnalyserTap::Reader> levelReader;
     ScopedPointer<Label> idLabel;
     ScopedPointer<Label> typeLabel;
     ScopedPointer<TextButton> debugButton;
@@ -52,11 +52,13 @@
 #endif
 
 #include "modules/DspCoreModules.cpp"
+#include "modules/ModulationArena.cpp"
 #include "modules/Modulators.cpp"
 #include "modules/ModulatorChain.cpp"
 #include "modules/MidiProcessor.cpp"
 #include "modules/EffectProcessor.cpp"
 #include "modules/EffectProcessorChain.cpp"
+#include "modules/VoiceAllocator.cpp"
 #include "modules/ModulatorSynth.cpp"
 #include "modules/ModulatorSynthChain.cpp"
 
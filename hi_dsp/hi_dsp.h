@@ -124,6 +124,7 @@ class ProcessorEditor;
 *	Contains all classes related to Modulators
 */
 
+#include "modules/ModulationArena.h"
 #include "modules/Modulators.h"
 #include "modules/ModulatorChain.h"
 
@@ -169,6 +170,7 @@ class ProcessorEditor;
 */
 
 
+#include "modules/VoiceAllocator.h"
 #include "modules/ModulatorSynth.h"
 #include "modules/ModulatorSynthChain.h"
 #include "modules/DspCoreModules.h"
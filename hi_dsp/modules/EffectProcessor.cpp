@@ -45,4 +45,17 @@ void EffectProcessor::checkTailing(AudioSampleBuffer &b, int startSample, int nu
 	const float out = maxL + maxR;
 		
 	isTailing = (in == 0.0f && out >= 0.01f);
-}
\ No newline at end of file
+}
+
+void VoiceEffectProcessor::setVoiceAmount(int newVoiceAmount)
+{
+	for (int i = 0; i < getNumInternalChains(); i++)
+	{
+		ModulatorChain* c = dynamic_cast<ModulatorChain*>(getChildProcessor(i));
+
+		if (c != nullptr && c->polyManager.getVoiceAmount() == numVoices)
+			c->setVoiceAmount(newVoiceAmount);
+	}
+
+	numVoices = newVoiceAmount;
+}
@@ -336,6 +336,8 @@ public:
 
 			applyEffect(stereoBuffer, 0, samplesToUse);
 
+			levelTap.pushLevels(stereoBuffer, 0, samplesToUse);
+
 #if ENABLE_ALL_PEAK_METERS
 			currentValues.outL = stereoBuffer.getMagnitude(0, 0, samplesToUse);
 			currentValues.outR = stereoBuffer.getMagnitude(1, 0, samplesToUse);
@@ -358,6 +360,13 @@ public:
 			}
 		}
 	};
+
+	/** Returns the tap that sends the output levels to a meter. */
+	AnalyserTap& getLevelTap() { return levelTap; }
+
+private:
+
+	AnalyserTap levelTap;
 };
 
 /** A EffectProcessor which allows monophonic modulation of its parameters.
@@ -494,6 +503,15 @@ public:
 
 	virtual ~VoiceEffectProcessor() {};
 
+	/** Changes the amount of voices. This is called by the owner synth when its voice amount changes (before prepareToPlay()).
+	*
+	*	The default implementation resizes all internal chains that have the same voice amount as the effect.
+	*	Overwrite this method if you keep additional per voice data and call the base class method.
+	*/
+	virtual void setVoiceAmount(int newVoiceAmount);
+
+	int getVoiceAmount() const noexcept { return numVoices; }
+
 	Path getSpecialSymbol() const override
 	{
 		Path path;
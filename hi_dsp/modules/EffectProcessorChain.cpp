@@ -40,6 +40,17 @@ EffectProcessorChain::EffectProcessorChain(Processor *parentProcessor_, const St
 	setEditorState(Processor::Visible, false, dontSendNotification);
 }
 
+void EffectProcessorChain::setVoiceAmount(int newVoiceAmount)
+{
+	if (EffectProcessorChainFactoryType* f = dynamic_cast<EffectProcessorChainFactoryType*>(effectChainFactory.get()))
+		f->setNumVoices(newVoiceAmount);
+
+	for (int i = 0; i < voiceEffects.size(); i++)
+		voiceEffects[i]->setVoiceAmount(newVoiceAmount);
+
+	VoiceEffectProcessor::setVoiceAmount(newVoiceAmount);
+}
+
 ProcessorEditorBody *::EffectProcessorChain::createEditor(ProcessorEditor *parentEditor)
 {
 #if USE_BACKEND
@@ -40,6 +40,9 @@
 
 #define FOR_ALL_EFFECTS(x) {for(int i = 0; i < allEffects.size(); ++i) {if(!allEffects[i]->isBypassed())allEffects[i]->x;}}
 
+#define PROFILE_EACH_VOICE_EFFECT(x) {for(int i = 0; i < voiceEffects.size(); ++i) {if(!voiceEffects[i]->isBypassed()) {PROFILE_PROCESSOR(voiceEffects[i]); voiceEffects[i]->x;}}}
+#define PROFILE_EACH_MASTER_EFFECT(x) {for(int i = 0; i < masterEffects.size(); ++i) {if(!masterEffects[i]->isBypassed()) {PROFILE_PROCESSOR(masterEffects[i]); masterEffects[i]->x;}}}
+
 
 /** A EffectProcessorChain renders multiple EffectProcessors.
 *	@ingroup effect
@@ -75,6 +78,9 @@ public:
 
 	void setInternalAttribute(int , float ) override {};
 
+	/** Changes the voice amount of all polyphonic effects. Effects that are added later will be created with the new voice amount. */
+	void setVoiceAmount(int newVoiceAmount) override;
+
 	void prepareToPlay(double sampleRate, int samplesPerBlock) override
 	{
 		// Skip the effectProcessor's prepareToPlay since it assumes all child processors are ModulatorChains
@@ -106,7 +112,7 @@ public:
 
         ADD_GLITCH_DETECTOR(parentProcessor, DebugLogger::Location::VoiceEffectRendering);
         
-		FOR_EACH_VOICE_EFFECT(renderVoice(voiceIndex, b, startSample, numSamples)); 
+		PROFILE_EACH_VOICE_EFFECT(renderVoice(voiceIndex, b, startSample, numSamples)); 
 	};
 
 	void renderNextBlock(AudioSampleBuffer &buffer, int startSample, int numSamples) override
@@ -144,7 +150,7 @@ public:
 
 		ADD_GLITCH_DETECTOR(parentProcessor, DebugLogger::Location::MasterEffectRendering);
         
-		FOR_EACH_MASTER_EFFECT(renderWholeBuffer(b));
+		PROFILE_EACH_MASTER_EFFECT(renderWholeBuffer(b));
 
 #if ENABLE_ALL_PEAK_METERS
 		currentValues.outL = (b.getMagnitude(0, 0, b.getNumSamples()));
@@ -386,6 +392,9 @@ public:
 	void fillTypeNameList();
 
 	Processor* createProcessor	(int typeIndex, const String &id) override;
+
+	/** Sets the voice amount for all effects that are created from now on. */
+	void setNumVoices(int newNumVoices) noexcept { numVoices = newNumVoices; }
 	
 protected:
 
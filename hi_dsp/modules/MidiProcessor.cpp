@@ -133,6 +133,20 @@ void MidiProcessorChain::renderNextHiseEventBuffer(HiseEventBuffer &buffer, int
 
 
 	buffer.moveEventsAbove(futureEventBuffer, numSamples);
+
+	getMainController()->getDebugLogger().checkEventBuffer(this, DebugLogger::Location::SynthRendering, artificialEvents);
+	getMainController()->getDebugLogger().checkEventBuffer(this, DebugLogger::Location::SynthRendering, futureEventBuffer);
+}
+
+void MidiProcessorChain::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+	MidiProcessor::prepareToPlay(sampleRate, samplesPerBlock);
+
+	futureEventBuffer.ensureAllocatedSize(samplesPerBlock);
+	artificialEvents.ensureAllocatedSize(samplesPerBlock);
+
+	for (int i = 0; i < processors.size(); i++)
+		processors[i]->prepareToPlay(sampleRate, samplesPerBlock);
 }
 
 MidiProcessorFactoryType::MidiProcessorFactoryType(Processor *p) :
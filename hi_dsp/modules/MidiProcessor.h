@@ -191,19 +191,22 @@ public:
 
 	void renderNextHiseEventBuffer(HiseEventBuffer &buffer, int numSamples);
 
+	/** Grows the event buffers of the chain to the block size and prepares the child processors. */
+	void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+
 	/** Sequentially processes all processors. */
 	void processHiseEvent(HiseEvent &m) override
 	{
 		if (isBypassed())
 		{
-			if (m.isTimerEvent()) m.ignoreEvent(true);
+			if (m.isTimerEvent() || m.isPluginParameterEvent()) m.ignoreEvent(true);
 			return;
 		}
 		for(int i = 0; (i < processors.size()); i++)
 		{
 			if (processors[i]->isBypassed())
 			{
-				if (m.isTimerEvent() && processors[i]->getIndexInChain() == m.getTimerIndex())
+				if ((m.isTimerEvent() || m.isPluginParameterEvent()) && processors[i]->getIndexInChain() == m.getChannel())
 				{
 					m.ignoreEvent(true);
 				}
@@ -214,6 +217,8 @@ public:
             if(m.isIgnored())
                 continue;
             
+			PROFILE_PROCESSOR(processors[i]);
+
 			processors[i]->processHiseEvent(m);
 		}
 	};
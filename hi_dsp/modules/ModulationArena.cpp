@@ -0,0 +1,199 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+ModulationArena::ModulationArena(size_t numBytesToAllocate):
+	numBytes(getAlignedSize(numBytesToAllocate))
+{
+	allocatedData.calloc(numBytes + Alignment);
+
+	const size_t misalignment = (size_t)allocatedData.getData() & ((size_t)Alignment - 1);
+
+	data = allocatedData.getData() + (misalignment == 0 ? 0 : (size_t)Alignment - misalignment);
+}
+
+void* ModulationArena::allocate(size_t numBytesToUse) noexcept
+{
+	const size_t alignedSize = getAlignedSize(numBytesToUse);
+
+	// The layout must be calculated with getAlignedSize() before creating the arena...
+	jassert(position + alignedSize <= numBytes);
+
+	void* p = data + position;
+	position += alignedSize;
+
+	return p;
+}
+
+ModulationArena::ScopedStatePlacement::ScopedStatePlacement(ModulationArena* arenaToUse):
+	arena(arenaToUse),
+	previous(getCurrentPlacement().get())
+{
+	getCurrentPlacement() = this;
+}
+
+ModulationArena::ScopedStatePlacement::~ScopedStatePlacement()
+{
+	getCurrentPlacement() = previous;
+}
+
+void* ModulationArena::allocateState(size_t numBytesToUse)
+{
+	if (ScopedStatePlacement* placement = getCurrentPlacement().get())
+	{
+		placement->lastStateSize = numBytesToUse;
+
+		if (placement->arena != nullptr)
+			return placement->arena->allocate(numBytesToUse);
+	}
+
+	return ::operator new(numBytesToUse);
+}
+
+ThreadLocalValue<ModulationArena::ScopedStatePlacement*>& ModulationArena::getCurrentPlacement()
+{
+	static ThreadLocalValue<ScopedStatePlacement*> currentPlacement;
+
+	return currentPlacement;
+}
+
+/** ============================================================================================================================== UNIT TEST */
+
+class ModulationArenaTest : public UnitTest
+{
+public:
+
+	/** Gives the test access to the state types of the EnvelopeModulator. */
+	struct StateAccess : public EnvelopeModulator
+	{
+		typedef EnvelopeModulator::ModulatorState State;
+		typedef EnvelopeModulator::StateList List;
+	};
+
+	struct CountingState : public StateAccess::State
+	{
+		CountingState(int voiceIndex, int& counter_) :
+			StateAccess::State(voiceIndex),
+			counter(counter_)
+		{};
+
+		~CountingState() { counter++; }
+
+		int& counter;
+		float values[5];
+	};
+
+	ModulationArenaTest() :
+		UnitTest("Testing modulation arena")
+	{
+
+	}
+
+	void runTest() override
+	{
+		beginTest("Testing alignment");
+
+		const size_t stateSize = ModulationArena::getAlignedSize(sizeof(CountingState));
+
+		ModulationArena::Ptr arena = new ModulationArena(ModulationArena::getAlignedSize(1) + ModulationArena::getAlignedSize(100) + 
+														 ModulationArena::getAlignedSize(64) + 4 * stateSize);
+
+		expect(isAligned(arena->allocate(0)), "Empty allocation");
+
+		char* a = static_cast<char*>(arena->allocate(1));
+		char* b = static_cast<char*>(arena->allocate(100));
+		char* c = static_cast<char*>(arena->allocate(64));
+
+		expect(isAligned(a) && isAligned(b) && isAligned(c), "Allocations start at a cache line");
+		expectEquals<int>((int)(b - a), 64, "Padding of a small allocation");
+		expectEquals<int>((int)(c - b), 128, "Padding of a big allocation");
+		expectEquals<int>((int)arena->getNumUsedBytes(), 256, "Used bytes");
+
+		expect(arena->contains(c + 63), "Contains last byte");
+
+		int x = 0;
+		expect(!arena->contains(&x), "Doesn't contain stack variable");
+
+		expectEquals<int>(ModulationArena::getAlignedNumSamples(1), 16, "Aligned samples 1");
+		expectEquals<int>(ModulationArena::getAlignedNumSamples(16), 16, "Aligned samples 16");
+		expectEquals<int>(ModulationArena::getAlignedNumSamples(17), 32, "Aligned samples 17");
+
+		beginTest("Testing in place destruction");
+
+		int numDestroyed = 0;
+
+		Array<StateAccess::State*> newStates;
+
+		{
+			ModulationArena::ScopedStatePlacement placement(arena);
+
+			for (int i = 0; i < 4; i++)
+				newStates.add(new CountingState(i, numDestroyed));
+
+			expectEquals<int>((int)placement.getLastStateSize(), (int)sizeof(CountingState), "State size");
+		}
+
+		for (int i = 0; i < newStates.size(); i++)
+		{
+			expect(arena->contains(newStates[i]), "State is placed in the arena");
+			expect(isAligned(newStates[i]), "State starts at a cache line");
+		}
+
+		{
+			StateAccess::List list;
+
+			list.setArenaStates(arena, newStates);
+
+			expectEquals<int>(arena->getReferenceCount(), 2, "List holds the arena");
+
+			list.add(new CountingState(4, numDestroyed));
+
+			expect(!arena->contains(list[4]), "Heap state");
+
+			list.removeRange(0, 1);
+
+			expectEquals<int>(numDestroyed, 1, "Removed arena state is destroyed");
+			expectEquals<int>(list.size(), 4, "List size after removing");
+		}
+
+		expectEquals<int>(numDestroyed, 5, "Arena and heap states are destroyed");
+		expectEquals<int>(arena->getReferenceCount(), 1, "List releases the arena");
+	}
+
+private:
+
+	static bool isAligned(const void* p)
+	{
+		return ((pointer_sized_uint)p & ((pointer_sized_uint)ModulationArena::Alignment - 1)) == 0;
+	}
+};
+
+static ModulationArenaTest modulationArenaTest;
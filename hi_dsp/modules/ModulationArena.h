@@ -0,0 +1,146 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+#ifndef MODULATIONARENA_H_INCLUDED
+#define MODULATIONARENA_H_INCLUDED
+
+/** A single cache line aligned memory block that holds the per voice modulation data of a ModulatorSynth.
+*	@ingroup modulator
+*
+*	When a ModulatorSynth is prepared, it collects all polyphonic chains and envelopes in the order they are rendered
+*	and places their per voice data into one arena:
+*
+*	- the ModulatorState objects of every voice of an EnvelopeModulator
+*	- the calculated voice values of a ModulatorChain (one slice per voice, padded to a cache line).
+*
+*	Every allocation starts at a cache line, so the data of two modulators never share a line and the voice slices can be
+*	processed with aligned vector operations.
+*
+*	The arena is reference counted: every chain and envelope that uses memory of the arena holds a reference to it, so the
+*	memory stays valid until the last of them is deleted or moves to another arena.
+*
+*	Rebuilding the arena recreates the envelope states, so the synth only does this in prepareToPlay() while no voice is
+*	playing (and in ModulatorSampler::setVoiceAmount(), which kills all voices anyway). Until the next rebuild, the
+*	per voice data falls back to private memory:
+*
+*	- modulators that are added while editing allocate their states on the heap
+*	- chains that are resized allocate their own (aligned) arena.
+*
+*	This only costs the locality of the data, the rendering stays correct.
+*/
+class ModulationArena: public ReferenceCountedObject
+{
+public:
+
+	typedef ReferenceCountedObjectPtr<ModulationArena> Ptr;
+
+	enum
+	{
+		Alignment = 64
+	};
+
+	/** Allocates a zeroed block with the given size. Use getAlignedSize() to calculate the size of each allocation. */
+	ModulationArena(size_t numBytesToAllocate);
+
+	/** Returns a pointer to the next free (aligned) position and advances the position by the aligned size. */
+	void* allocate(size_t numBytesToUse) noexcept;
+
+	/** Checks if the given pointer points into this arena. */
+	bool contains(const void* p) const noexcept
+	{
+		const char* c = static_cast<const char*>(p);
+		return c >= data && c < data + numBytes;
+	}
+
+	size_t getNumBytes() const noexcept { return numBytes; }
+
+	size_t getNumUsedBytes() const noexcept { return position; }
+
+	/** Rounds up the size so that the next allocation starts at a cache line. */
+	static size_t getAlignedSize(size_t numBytesToUse) noexcept
+	{
+		return (numBytesToUse + (size_t)Alignment - 1) & ~((size_t)Alignment - 1);
+	}
+
+	/** Rounds up the amount of samples so that every voice slice starts at a cache line. */
+	static int getAlignedNumSamples(int numSamples) noexcept
+	{
+		const int numFloatsPerLine = Alignment / (int)sizeof(float);
+
+		return (jmax<int>(0, numSamples) + numFloatsPerLine - 1) & ~(numFloatsPerLine - 1);
+	}
+
+	/** Places all ModulatorState objects that are created by the current thread during the lifetime of this object into
+	*	the given arena.
+	*
+	*	If you pass in nullptr, the states are allocated on the heap, but the size of the last state is still recorded, so
+	*	you can use this to find out how much space a state needs.
+	*/
+	class ScopedStatePlacement
+	{
+	public:
+
+		ScopedStatePlacement(ModulationArena* arenaToUse);
+
+		~ScopedStatePlacement();
+
+		/** Returns the size of the last state that was created while this object was active. */
+		size_t getLastStateSize() const noexcept { return lastStateSize; }
+
+	private:
+
+		friend class ModulationArena;
+
+		ModulationArena* arena;
+		ScopedStatePlacement* previous;
+		size_t lastStateSize = 0;
+
+		JUCE_DECLARE_NON_COPYABLE(ScopedStatePlacement)
+	};
+
+	/** Allocates the memory for a ModulatorState. This uses the arena of the active ScopedStatePlacement or the heap. */
+	static void* allocateState(size_t numBytesToUse);
+
+private:
+
+	static ThreadLocalValue<ScopedStatePlacement*>& getCurrentPlacement();
+
+	HeapBlock<char> allocatedData;
+
+	char* data;
+	size_t numBytes;
+	size_t position = 0;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulationArena)
+};
+
+#endif  // MODULATIONARENA_H_INCLUDED
@@ -35,15 +35,16 @@ ModulatorChain::ModulatorChain(MainController *mc, const String &uid, int numVoi
 	Modulation(m),
 	handler(this),
 	parentProcessor(p),
+	voiceValues(nullptr),
+	voiceValueStride(0),
 	isVoiceStartChain(false)
 {
-	internalVoiceBuffer = AudioSampleBuffer(numVoices, 0);
-	envelopeTempBuffer = AudioSampleBuffer(1, 0);
 
 	activeVoices.setRange(0, numVoices, false);
 	setFactoryType(new ModulatorChainFactoryType(numVoices, m, p));
 
-	FloatVectorOperations::fill(lastVoiceValues, 1.0, NUM_POLYPHONIC_VOICES);
+	lastVoiceValues.allocate(numVoices, false);
+	FloatVectorOperations::fill(lastVoiceValues, 1.0, numVoices);
 
 	if (Identifier::isValidIdentifier(uid))
 	{
@@ -180,8 +181,11 @@ void ModulatorChain::prepareToPlay(double sampleRate, int samplesPerBlock)
 	EnvelopeModulator::prepareToPlay(sampleRate, samplesPerBlock);
 	blockSize = samplesPerBlock;
 
-	ProcessorHelpers::increaseBufferIfNeeded(internalVoiceBuffer, samplesPerBlock);
-	ProcessorHelpers::increaseBufferIfNeeded(envelopeTempBuffer, samplesPerBlock);
+	const int alignedNumSamples = ModulationArena::getAlignedNumSamples(samplesPerBlock);
+
+	// Keep the voice values in the arena of the synth if they are big enough
+	if (alignedNumSamples > voiceValueStride)
+		allocateVoiceValues(polyManager.getVoiceAmount(), alignedNumSamples);
 
 	for(int i = 0; i < envelopeModulators.size(); i++) envelopeModulators[i]->prepareToPlay(sampleRate, samplesPerBlock);
 	for(int i = 0; i < variantModulators.size(); i++) variantModulators[i]->prepareToPlay(sampleRate, samplesPerBlock);
@@ -189,6 +193,85 @@ void ModulatorChain::prepareToPlay(double sampleRate, int samplesPerBlock)
 	jassert(checkModulatorStructure());
 };
 
+void ModulatorChain::setVoiceAmount(int newVoiceAmount)
+{
+	const int oldVoiceAmount = polyManager.getVoiceAmount();
+
+	if (newVoiceAmount == oldVoiceAmount)
+		return;
+
+	allocateVoiceValues(newVoiceAmount, voiceValueStride);
+
+	if (newVoiceAmount > oldVoiceAmount)
+	{
+		// Make sure the BigInteger doesn't allocate on the audio thread
+		activeVoices.setBit(newVoiceAmount - 1, true);
+		activeVoices.clearBit(newVoiceAmount - 1);
+	}
+	else
+	{
+		activeVoices.setRange(newVoiceAmount, oldVoiceAmount - newVoiceAmount, false);
+	}
+
+	HeapBlock<float> newLastVoiceValues(newVoiceAmount);
+	FloatVectorOperations::fill(newLastVoiceValues, 1.0f, newVoiceAmount);
+	FloatVectorOperations::copy(newLastVoiceValues, lastVoiceValues, jmin<int>(oldVoiceAmount, newVoiceAmount));
+	lastVoiceValues.swapWith(newLastVoiceValues);
+
+	if (ModulatorChainFactoryType* f = dynamic_cast<ModulatorChainFactoryType*>(modulatorFactory.get()))
+		f->setNumVoices(newVoiceAmount);
+	else if (VoiceStartModulatorFactoryType* vf = dynamic_cast<VoiceStartModulatorFactoryType*>(modulatorFactory.get()))
+		vf->setNumVoices(newVoiceAmount);
+
+	for (int i = 0; i < voiceStartModulators.size(); i++)
+		voiceStartModulators[i]->setVoiceAmount(newVoiceAmount);
+
+	for (int i = 0; i < envelopeModulators.size(); i++)
+		envelopeModulators[i]->setVoiceAmount(newVoiceAmount);
+
+	EnvelopeModulator::setVoiceAmount(newVoiceAmount);
+}
+
+void ModulatorChain::addToRenderOrder(Array<EnvelopeModulator*>& renderOrder)
+{
+	for (int i = 0; i < envelopeModulators.size(); i++)
+		envelopeModulators[i]->addToRenderOrder(renderOrder);
+
+	renderOrder.add(this);
+}
+
+size_t ModulatorChain::getRequiredArenaSize(int alignedNumSamples) const
+{
+	return ModulationArena::getAlignedSize(sizeof(float) * (size_t)(polyManager.getVoiceAmount() * alignedNumSamples));
+}
+
+void ModulatorChain::moveIntoArena(ModulationArena* arena, int alignedNumSamples)
+{
+	const int numVoices = polyManager.getVoiceAmount();
+
+	voiceValues = static_cast<float*>(arena->allocate(sizeof(float) * (size_t)(numVoices * alignedNumSamples)));
+	voiceValueStride = alignedNumSamples;
+	voiceValueArena = arena;
+}
+
+void ModulatorChain::allocateVoiceValues(int numVoices, int alignedNumSamples)
+{
+	const size_t numBytes = sizeof(float) * (size_t)(numVoices * alignedNumSamples);
+
+	ModulationArena::Ptr newArena = new ModulationArena(numBytes);
+	float* newVoiceValues = static_cast<float*>(newArena->allocate(numBytes));
+
+	if (voiceValues != nullptr)
+	{
+		for (int i = 0; i < jmin<int>(numVoices, polyManager.getVoiceAmount()); i++)
+			FloatVectorOperations::copy(newVoiceValues + i * alignedNumSamples, getVoiceValues(i), jmin<int>(alignedNumSamples, voiceValueStride));
+	}
+
+	voiceValues = newVoiceValues;
+	voiceValueStride = alignedNumSamples;
+	voiceValueArena = newArena;
+}
+
 float ModulatorChain::calculateNewValue()
 {
 	jassertfalse;
@@ -386,6 +469,7 @@ ProcessorEditorBody *ModulatorChain::createEditor(ProcessorEditor *parentEditor)
 void ModulatorChain::renderVoice(int voiceIndex, int startSample, int numSamples)
 {
     ADD_GLITCH_DETECTOR(parentProcessor, DebugLogger::Location::ModulatorChainVoiceRendering);
+	PROFILE_PROCESSOR(this);
     
 	// Use the internal buffer from timeModulation as working buffer.
 
@@ -427,11 +511,11 @@ void ModulatorChain::renderVoice(int voiceIndex, int startSample, int numSamples
 
 			if (m->isInMonophonicMode())
 				continue;
+
+			PROFILE_PROCESSOR(m);
 			
 			m->polyManager.setCurrentVoice(voiceIndex);
 
-			FloatVectorOperations::fill(envelopeTempBuffer.getWritePointer(0, startSample), 1.0f, numSamples);
-
 			float* bufferPointer = internalBuffer.getWritePointer(0, 0);
 
 			AudioSampleBuffer b1(&bufferPointer, 1, startSample + numSamples);
@@ -449,7 +533,7 @@ void ModulatorChain::renderVoice(int voiceIndex, int startSample, int numSamples
 		FloatVectorOperations::clip(internalBuffer.getWritePointer(0, startIndex), internalBuffer.getReadPointer(0, startIndex), (getMode() == Modulation::GainMode ? 0.0f : -1.0f), 1.0f, sampleAmount);
 
 	// Copy the result to the voice buffer
-	FloatVectorOperations::copy(internalVoiceBuffer.getWritePointer(voiceIndex, startIndex), internalBuffer.getReadPointer(0, startIndex), sampleAmount);
+	FloatVectorOperations::copy(getVoiceValues(voiceIndex) + startIndex, internalBuffer.getReadPointer(0, startIndex), sampleAmount);
 
 #if ENABLE_PLOTTER
 	if(voiceIndex == polyManager.getLastStartedVoice())
@@ -467,6 +551,7 @@ void ModulatorChain::renderNextBlock(AudioSampleBuffer& buffer, int startSample,
 
 	{
 		ADD_GLITCH_DETECTOR(parentProcessor, DebugLogger::Location::ModulatorChainTimeVariantRendering);
+		PROFILE_PROCESSOR(this);
 
 		jassert(getSampleRate() > 0);
 
@@ -475,6 +560,7 @@ void ModulatorChain::renderNextBlock(AudioSampleBuffer& buffer, int startSample,
 		for (auto v : variantModulators)
 		{
 			if (v->isBypassed()) continue;
+			PROFILE_PROCESSOR(v);
 			v->renderNextBlock(internalBuffer, startSample, numSamples);
 		}
 
@@ -483,6 +569,7 @@ void ModulatorChain::renderNextBlock(AudioSampleBuffer& buffer, int startSample,
 			if (m->isBypassed()) continue;
 			if (!m->isInMonophonicMode()) continue;
 
+			PROFILE_PROCESSOR(m);
 			m->renderNextBlock(internalBuffer, startSample, numSamples);
 		}
 
@@ -108,6 +108,12 @@ public:
 
 	/** Sets the sample rate for all modulators in the chain and initialized the UpdateMerger. */
 	void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+
+	/** Resizes the voice buffers and changes the voice amount of all polyphonic modulators in the chain. 
+	*
+	*	Modulators that are added later will be created with the new voice amount.
+	*/
+	void setVoiceAmount(int newVoiceAmount) override;
 	
 	/** Checks if the chain is bypassed or contains no modulators. 
 	*
@@ -167,13 +173,25 @@ public:
 	*/
 	void renderVoice(int voiceIndex, int startSample, int numSamples);
 
-	/** Returns a read pointer to the calculated voice values. The array size is supposed to be the size of the internal buffer. */
+	/** Returns a read pointer to the calculated voice values. The array size is supposed to be the size of the internal buffer. 
+	*
+	*	The values of all voices are stored in one block and every voice starts at a cache line.
+	*/
 	float *getVoiceValues(int voiceIndex) noexcept
-	{ return internalVoiceBuffer.getWritePointer(voiceIndex); };
+	{ return voiceValues + voiceIndex * voiceValueStride; };
 
 	/** Returns a write pointer to the calculated voice values. You can change them and the array size should be known. */
 	const float *getVoiceValues(int voiceIndex) const noexcept
-	{ return internalVoiceBuffer.getReadPointer(voiceIndex); }
+	{ return voiceValues + voiceIndex * voiceValueStride; }
+
+	/** Adds all polyphonic envelopes of this chain and the chain itself to the list. */
+	void addToRenderOrder(Array<EnvelopeModulator*>& renderOrder) override;
+
+	/** Returns the size of the voice values of all voices. */
+	size_t getRequiredArenaSize(int alignedNumSamples) const override;
+
+	/** Moves the voice values into the given arena. The envelopes of the chain are moved by the synth itself. */
+	void moveIntoArena(ModulationArena* arena, int alignedNumSamples) override;
 
 	/** This ocverrides the TimeVariant::renderNextBlock method and only calculates the TimeVariant modulators.
 	*
@@ -324,10 +342,13 @@ private:
 
 	ScopedPointer<FactoryType> modulatorFactory;
 	
-	// A AudioSampleBuffer with one channel per voice
-	AudioSampleBuffer internalVoiceBuffer;
-	
-	AudioSampleBuffer envelopeTempBuffer;
+	/** Allocates the voice values in an arena that only this chain uses. */
+	void allocateVoiceValues(int numVoices, int alignedNumSamples);
+
+	// The voice values are either placed in the arena of the synth or in an own arena
+	ModulationArena::Ptr voiceValueArena;
+	float* voiceValues;
+	int voiceValueStride;
 
 	ModulatorChainHandler handler;
 
@@ -351,7 +372,7 @@ private:
 	float envelopeOutputValue3;
 	float envelopeOutputValue4;
 
-	float lastVoiceValues[NUM_POLYPHONIC_VOICES];
+	HeapBlock<float> lastVoiceValues;
 
 	bool isVoiceStartChain;
 
@@ -430,6 +451,14 @@ public:
 	}
 
 	Processor *createProcessor(int typeIndex, const String &id);
+
+	/** Sets the voice amount for all modulators that are created from now on. */
+	void setNumVoices(int newNumVoices) noexcept
+	{
+		numVoices = newNumVoices;
+		voiceStartFactory->setNumVoices(newNumVoices);
+		envelopeFactory->setNumVoices(newNumVoices);
+	}
 	
 
 	const Array<ProcessorEntry> &getTypeNames() const override
@@ -55,6 +55,9 @@ pitchModulationActive(false)
 	internalBuffer = AudioSampleBuffer(2, 0);
 	gainBuffer = AudioSampleBuffer(1, 0);
 
+	activeVoices.setCapacity(numVoices);
+	voiceAllocator.prepare(numVoices);
+
 	for (int i = 0; i < 4; i++)
 	{
 		nextTimerCallbackTimes[i] = 0.0;
@@ -106,6 +109,12 @@ ValueTree ModulatorSynth::exportAsValueTree() const
 
 	v.setProperty("IconColour", iconColour.toString(), nullptr);
 
+	if (stealingPolicy != VoiceAllocator::StealingPolicy::Oldest)
+		v.setProperty("StealingPolicy", (int)stealingPolicy, nullptr);
+
+	if (getNumVoices() != NUM_POLYPHONIC_VOICES)
+		v.setProperty("VoiceAmount", getNumVoices(), nullptr);
+
 	return v;
 }
 
@@ -113,6 +122,10 @@ void ModulatorSynth::restoreFromValueTree(const ValueTree &v)
 {
 	RESTORE_MATRIX();
 
+	// The ModulatorSampler restores its voice amount itself
+	if (v.hasProperty("VoiceAmount"))
+		ModulatorSynth::setVoiceAmount(v.getProperty("VoiceAmount"));
+
 	loadAttribute(Gain, "Gain");
 	loadAttribute(Balance, "Balance");
 	loadAttribute(VoiceLimit, "VoiceLimit");
@@ -120,6 +133,9 @@ void ModulatorSynth::restoreFromValueTree(const ValueTree &v)
 
 	iconColour = Colour::fromString(v.getProperty("IconColour", Colours::transparentBlack.toString()).toString());
 
+	const int policyIndex = v.getProperty("StealingPolicy", (int)VoiceAllocator::StealingPolicy::Oldest);
+	stealingPolicy = (VoiceAllocator::StealingPolicy)jlimit<int>(0, (int)VoiceAllocator::StealingPolicy::numStealingPolicies - 1, policyIndex);
+
 	Processor::restoreFromValueTree(v);
 }
 
@@ -300,6 +316,8 @@ void ModulatorSynth::processHiseEventBuffer(const HiseEventBuffer &inputBuffer,
 	}
 
 	midiProcessorChain->renderNextHiseEventBuffer(eventBuffer, numSamples);
+
+	getMainController()->getDebugLogger().checkEventBuffer(this, DebugLogger::Location::SynthRendering, eventBuffer);
 }
 
 void ModulatorSynth::addProcessorsWhenEmpty()
@@ -322,6 +340,7 @@ void ModulatorSynth::renderNextBlockWithModulators(AudioSampleBuffer& outputBuff
 	jassert(isOnAir());
 
     ADD_GLITCH_DETECTOR(this, DebugLogger::Location::SynthRendering);
+	PROFILE_PROCESSOR(this);
     
 	int numSamples = getBlockSize(); //outputBuffer.getNumSamples();
 
@@ -690,6 +709,10 @@ void ModulatorSynth::startVoiceWithHiseEvent(ModulatorSynthVoice* voice, Synthes
 
 	activeVoices.insert(voice);
 
+	voiceAllocator.voiceStarted(voice->getVoiceIndex(), e.getNoteNumber(), getVoicePriority(e));
+
+	getMainController()->getDebugLogger().logVoiceStart(voice->getVoiceIndex(), e);
+
 	Synthesiser::startVoice(static_cast<SynthesiserVoice*>(voice), sound, e.getChannel(), e.getNoteNumber(), e.getFloatVelocity());
 }
 
@@ -716,6 +739,13 @@ void ModulatorSynth::prepareToPlay(double newSampleRate, int samplesPerBlock)
 		ProcessorHelpers::increaseBufferIfNeeded(pitchBuffer, samplesPerBlock);
 		ProcessorHelpers::increaseBufferIfNeeded(gainBuffer, samplesPerBlock);
 		ProcessorHelpers::increaseBufferIfNeeded(internalBuffer, samplesPerBlock);
+
+		eventBuffer.ensureAllocatedSize(samplesPerBlock);
+
+		if (getNumVoices() != 0 && getNumVoices() != gainChain->polyManager.getVoiceAmount())
+			resizeVoiceStorage();
+
+		updateModulationArena(samplesPerBlock);
 		
 		for(int i = 0; i < getNumVoices(); i++)
 		{
@@ -741,6 +771,73 @@ void ModulatorSynth::prepareToPlay(double newSampleRate, int samplesPerBlock)
 }
 
 	
+void ModulatorSynth::resizeVoiceStorage()
+{
+	const int numVoices = getNumVoices();
+	const int oldNumVoices = gainChain->polyManager.getVoiceAmount();
+
+	activeVoices.setCapacity(numVoices);
+	voiceAllocator.prepare(numVoices);
+
+	if (numVoices == oldNumVoices)
+		return;
+
+	for (int i = 0; i < getNumInternalChains(); i++)
+	{
+		Processor *p = getChildProcessor(i);
+
+		if (ModulatorChain *c = dynamic_cast<ModulatorChain*>(p))
+		{
+			// Monophonic chains (eg. the mix chain of the WaveSynth) keep their single voice
+			if (c->polyManager.getVoiceAmount() == oldNumVoices)
+				c->setVoiceAmount(numVoices);
+		}
+		else if (EffectProcessorChain *e = dynamic_cast<EffectProcessorChain*>(p))
+		{
+			e->setVoiceAmount(numVoices);
+		}
+	}
+}
+
+void ModulatorSynth::updateModulationArena(int samplesPerBlock)
+{
+	// Recreating the envelope states would reset the envelopes of the playing voices
+	if (activeVoices.size() != 0)
+		return;
+
+	const int numVoices = gainChain->polyManager.getVoiceAmount();
+	const int alignedNumSamples = ModulationArena::getAlignedNumSamples(samplesPerBlock);
+
+	Array<EnvelopeModulator*> renderOrder;
+
+	for (int i = 0; i < getNumInternalChains(); i++)
+	{
+		ModulatorChain* c = dynamic_cast<ModulatorChain*>(getChildProcessor(i));
+
+		// Monophonic chains don't need a slot for every voice
+		if (c != nullptr && c->polyManager.getVoiceAmount() == numVoices)
+			c->addToRenderOrder(renderOrder);
+	}
+
+	if (modulationArena != nullptr && renderOrder == modulationRenderOrder && 
+		alignedNumSamples == modulationArenaNumSamples && numVoices == modulationArenaNumVoices)
+		return;
+
+	size_t numBytes = 0;
+
+	for (int i = 0; i < renderOrder.size(); i++)
+		numBytes += renderOrder[i]->getRequiredArenaSize(alignedNumSamples);
+
+	modulationArena = new ModulationArena(numBytes);
+
+	for (int i = 0; i < renderOrder.size(); i++)
+		renderOrder[i]->moveIntoArena(modulationArena, alignedNumSamples);
+
+	modulationRenderOrder.swapWith(renderOrder);
+	modulationArenaNumSamples = alignedNumSamples;
+	modulationArenaNumVoices = numVoices;
+}
+
 void ModulatorSynth::numSourceChannelsChanged()
 {
 	ScopedLock sl(getSynthLock());
@@ -819,6 +916,21 @@ void ModulatorSynth::noteOn(const HiseEvent &m)
 	const int transposedMidiNoteNumber = midiNoteNumber + m.getTransposeAmount();
 	const float velocity = m.getFloatVelocity();
 
+	// The voice amount can change after the synth was created (eg. ModulatorSampler::setVoiceAmount()).
+	// This doesn't allocate, so it can be done lazily.
+	if (voiceAllocator.getNumVoices() != jmin<int>(voices.size(), voiceAllocator.getCapacity()))
+	{
+		voiceAllocator.reset(voices.size());
+
+		for (int i = 0; i < activeVoices.size(); i++)
+		{
+			ModulatorSynthVoice *v = activeVoices[i];
+
+			if (v->getCurrentlyPlayingNote() >= 0)
+				voiceAllocator.voiceStarted(v->getVoiceIndex(), v->getCurrentlyPlayingNote(), getVoicePriority(v->getCurrentHiseEvent()));
+		}
+	}
+
     for (int i = sounds.size(); --i >= 0;)
     {
 		SynthesiserSound *s = sounds.getUnchecked(i);
@@ -826,29 +938,26 @@ void ModulatorSynth::noteOn(const HiseEvent &m)
 
 		if (soundCanBePlayed(sound, midiChannel, transposedMidiNoteNumber, velocity))
         {
+			// if the voiceLimit is reached, kill the voice!
+			if (voiceAllocator.getNumStealableVoices() >= voiceLimit)
+			{
+				killLastVoice(midiNoteNumber);
+			}
+
             // If hitting a note that's still ringing, stop it first (it could be
             // still playing because of the sustain or sostenuto pedal).
-            for (int j = voices.size(); --j >= 0;)
+			// Use the untransposed number for detecting repeated notes
+			for (int j = voiceAllocator.getFirstVoiceForNote(midiNoteNumber); j != -1; j = voiceAllocator.getNextVoiceForNote(j))
             {
                 ModulatorSynthVoice* const voice = static_cast<ModulatorSynthVoice*>(voices.getUnchecked (j));
 
-				const bool voiceIsActive = voice->isPlayingChannel(midiChannel) && !voice->isBeingKilled();
-
-				// if the voiceLimit is reached, kill the voice!
-
-				if(voiceIsActive && j >= (voiceLimit - 1)) 
-				{
-					killLastVoice();
-				}
-
-                else if (voice->getCurrentlyPlayingNote() == midiNoteNumber // Use the untransposed number for detecting repeated notes
-                     && voice->isPlayingChannel (midiChannel) && !(voice->getCurrentHiseEvent() == m))
+                if (voice->isPlayingChannel (midiChannel) && !(voice->getCurrentHiseEvent() == m))
 				{
 					handleRetriggeredNote(voice);
 				}
             }
 
-			ModulatorSynthVoice *v = static_cast<ModulatorSynthVoice*>(findFreeVoice (sound, midiChannel, midiNoteNumber, isNoteStealingEnabled()));
+			ModulatorSynthVoice *v = getFreeVoiceForSound(sound, midiChannel, midiNoteNumber);
 
 			if( v != nullptr)
 			{
@@ -869,6 +978,36 @@ void ModulatorSynth::noteOn(const HiseEvent &m)
 	}
 }
 
+ModulatorSynthVoice* ModulatorSynth::getFreeVoiceForSound(SynthesiserSound *sound, int midiChannel, int noteNumber)
+{
+	const int freeIndex = voiceAllocator.getFreeVoice();
+
+	if (freeIndex != -1)
+	{
+		ModulatorSynthVoice *v = static_cast<ModulatorSynthVoice*>(voices.getUnchecked(freeIndex));
+
+		if (v->canPlaySound(sound))
+			return v;
+
+		return static_cast<ModulatorSynthVoice*>(findFreeVoice(sound, midiChannel, noteNumber, false));
+	}
+
+	if (!isNoteStealingEnabled())
+		return nullptr;
+
+	const int stolenIndex = voiceAllocator.getVoiceToSteal(stealingPolicy, noteNumber);
+
+	if (stolenIndex == -1)
+		return nullptr;
+
+	ModulatorSynthVoice *v = static_cast<ModulatorSynthVoice*>(voices.getUnchecked(stolenIndex));
+
+	activeVoices.remove(v);
+	v->resetVoice();
+
+	return v;
+}
+
 void ModulatorSynth::noteOn(int midiChannel, int midiNoteNumber, float velocity)
 {
 	jassertfalse;
@@ -887,11 +1026,12 @@ void ModulatorSynth::noteOff(const HiseEvent &m)
 
 	jassert(eventId != 0);
 
-	for (int i = voices.size(); --i >= 0;)
+	// Only active voices can play the event
+	for (int i = activeVoices.size(); --i >= 0;)
 	{
-		SynthesiserVoice* const voice = voices.getUnchecked(i);
+		ModulatorSynthVoice* const mvoice = activeVoices[i];
 
-		ModulatorSynthVoice* const mvoice = static_cast<ModulatorSynthVoice*>(voices.getUnchecked(i));
+		SynthesiserVoice* const voice = mvoice;
 
 		if (mvoice->getCurrentHiseEvent().getEventId() == eventId
 			&& voice->isPlayingChannel(midiChannel))
@@ -973,6 +1113,9 @@ void ModulatorSynthVoice::resetVoice()
 
 	ModulatorSynth *os = getOwnerSynth();
 
+	if (isActive)
+		os->getMainController()->getDebugLogger().logVoiceStop(voiceIndex, currentHiseEvent);
+
 	ModulatorChain *g = static_cast<ModulatorChain*>(os->getChildProcessor(ModulatorSynth::GainModulation));
 	ModulatorChain *p = static_cast<ModulatorChain*>(os->getChildProcessor(ModulatorSynth::PitchModulation));
 	EffectProcessorChain *e = static_cast<EffectProcessorChain*>(os->getChildProcessor(ModulatorSynth::EffectChain));
@@ -988,6 +1131,8 @@ void ModulatorSynthVoice::resetVoice()
 	isTailing = false;
     isActive = false;
 
+	os->getVoiceAllocator().voiceStopped(voiceIndex);
+
 	killThisVoice = false;
 	killFadeLevel = 1.0f;
 
@@ -1040,6 +1185,8 @@ void ModulatorSynthVoice::stopNote(float, bool)
 
 		isTailing = true;
 
+		os->getVoiceAllocator().voiceReleased(voiceIndex);
+
 		c->stopVoice(voiceIndex);
 		p->stopVoice(voiceIndex);
 		e->stopVoice(voiceIndex);
@@ -1066,7 +1213,7 @@ bool ModulatorSynth::getMidiInputFlag()
 
 void ModulatorSynth::killAllVoicesWithNoteNumber(int noteNumber)
 {
-	for(int i = 0; i < voices.size(); i++)
+	for (int i = voiceAllocator.getFirstVoiceForNote(noteNumber); i != -1; i = voiceAllocator.getNextVoiceForNote(i))
 	{	
 		if(voices[i]->isPlayingChannel(1) && voices[i]->getCurrentlyPlayingNote() == noteNumber)
 		{
@@ -1078,54 +1225,13 @@ void ModulatorSynth::killAllVoicesWithNoteNumber(int noteNumber)
 
 
 	
-void ModulatorSynth::killLastVoice()
+void ModulatorSynth::killLastVoice(int noteNumber)
 {
-	ModulatorSynthVoice *oldest = nullptr;
-	double oldestUptime = DBL_MAX;
+	const int voiceIndex = voiceAllocator.getVoiceToSteal(stealingPolicy, noteNumber);
 
-	// search all tailing notes
-	for(int i = 0; i < voices.size(); i++)
-	{
-		ModulatorSynthVoice *v = static_cast<ModulatorSynthVoice*>(voices[i]);
-
-		if(v->isBeingKilled() || !v->isTailingOff()) continue;
-
-		const double voiceUptime = v->getVoiceUptime();
-
-		if(voiceUptime < oldestUptime)
-		{
-			oldestUptime = voiceUptime;
-			oldest = v;
-		}
-	}
-	
-	
-	if(oldest != nullptr)
+	if (voiceIndex != -1)
 	{
-		oldest->killVoice();
-		return;
-	}
-
-	// search all notes
-	for(int i = 0; i < voices.size(); i++)
-	{
-		ModulatorSynthVoice *v = static_cast<ModulatorSynthVoice*>(voices[i]);
-
-		if(v->isBeingKilled()) continue;
-
-		const double voiceUptime = v->getVoiceUptime();
-
-		if(voiceUptime < oldestUptime)
-		{
-			oldestUptime = voiceUptime;
-			oldest = v;
-		}
-	}
-
-	if(oldest != nullptr)
-	{
-		oldest->killVoice();
-		return;
+		static_cast<ModulatorSynthVoice*>(voices[voiceIndex])->killVoice();
 	}
 };
 
@@ -1133,6 +1239,7 @@ void ModulatorSynth::deleteAllVoices()
 {
 	ScopedLock sl(lock);
 	activeVoices.clear();
+	voiceAllocator.reset(0);
 	clearVoices();
 }
 
@@ -1141,7 +1248,53 @@ void ModulatorSynth::setVoiceLimit(int newVoiceLimit)
 	// The voice limit must be smaller than the total amount of voices!
 	//jassert(voices.size() == 0 || newVoiceLimit <= voices.size());
 
-	voiceLimit = jmin<int>(newVoiceLimit, NUM_POLYPHONIC_VOICES);
+	voiceLimit = jmin<int>(newVoiceLimit, NUM_MAX_POLYPHONIC_VOICES);
+}
+
+void ModulatorSynth::setVoiceAmount(int newVoiceAmount)
+{
+	newVoiceAmount = jlimit<int>(1, NUM_MAX_POLYPHONIC_VOICES, newVoiceAmount);
+
+	if (newVoiceAmount == getNumVoices())
+		return;
+
+	// Check if the synth supports this before the old voices are deleted
+	ScopedPointer<ModulatorSynthVoice> testVoice = createVoice();
+
+	if (testVoice == nullptr)
+		return;
+
+	testVoice = nullptr;
+
+	ScopedLock sl(isOnAir() ? getSynthLock() : getDummyLockWhenNotOnAir());
+
+	if (getAttribute(VoiceLimit) > newVoiceAmount)
+		setAttribute(VoiceLimit, (float)newVoiceAmount, sendNotification);
+
+	allNotesOff(1, false);
+	deleteAllVoices();
+
+	// The voices read their index from the current voice amount, so they must be added one by one
+	for (int i = 0; i < newVoiceAmount; i++)
+		addVoice(createVoice());
+
+	// Let the synth apply its parameters to the new voices
+	for (int i = numModulatorSynthParameters; i < getNumParameters(); i++)
+		setInternalAttribute(i, getAttribute(i));
+
+	if (Processor::getSampleRate() != -1.0)
+	{
+		for (int i = 0; i < getNumVoices(); i++)
+			static_cast<ModulatorSynthVoice*>(getVoice(i))->prepareToPlay(Processor::getSampleRate(), getBlockSize());
+	}
+
+	resizeVoiceStorage();
+
+	// All voices were killed, so the per voice modulation data can be rebuilt with the new voice amount
+	if (Processor::getSampleRate() != -1.0)
+		updateModulationArena(getBlockSize());
+
+	setKillFadeOutTime(killFadeTime);
 }
 
 void ModulatorSynth::setKillFadeOutTime(double fadeTimeMilliSeconds)
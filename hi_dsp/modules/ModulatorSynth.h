@@ -43,9 +43,78 @@ class ModulatorSynthVoice;
 typedef HiseEventBuffer EVENT_BUFFER_TO_USE;
 
 
-class VoiceStack : public UnorderedStack<ModulatorSynthVoice*>
+/** An unordered stack for the active voices of a ModulatorSynth.
+*
+*	It works like the UnorderedStack, but the capacity is set at runtime to the voice amount of the synth.
+*/
+class VoiceStack
 {
+public:
+
+	/** Allocates the storage for the given amount of voices. This keeps the voices that fit into the new storage. */
+	void setCapacity(int newCapacity)
+	{
+		HeapBlock<ModulatorSynthVoice*> newData(newCapacity, true);
+
+		position = jmin<int>(position, newCapacity);
+
+		for (int i = 0; i < position; i++)
+			newData[i] = data[i];
+
+		data.swapWith(newData);
+		capacity = newCapacity;
+	}
+
+	void insert(ModulatorSynthVoice* voice) noexcept
+	{
+		if (position < capacity && !contains(voice))
+			data[position++] = voice;
+	}
+
+	void remove(ModulatorSynthVoice* voice) noexcept
+	{
+		for (int i = 0; i < position; i++)
+		{
+			if (data[i] == voice)
+			{
+				removeElement(i);
+				return;
+			}
+		}
+	}
+
+	/** Removes the element at the given index and puts the last element into its slot. */
+	void removeElement(int index) noexcept
+	{
+		if (index < position)
+		{
+			data[index] = data[--position];
+			data[position] = nullptr;
+		}
+	}
+
+	bool contains(const ModulatorSynthVoice* voice) const noexcept
+	{
+		for (int i = 0; i < position; i++)
+		{
+			if (data[i] == voice)
+				return true;
+		}
 
+		return false;
+	}
+
+	ModulatorSynthVoice* operator[](int index) const noexcept { return data[index]; }
+
+	int size() const noexcept { return position; }
+
+	void clear() noexcept { position = 0; }
+
+private:
+
+	HeapBlock<ModulatorSynthVoice*> data;
+	int capacity = 0;
+	int position = 0;
 };
 
 /** A ModulatorSynth is a synthesiser with a ModulatorChain for volume and pitch that allows
@@ -225,13 +294,34 @@ public:
 	*/
 	void killAllVoicesWithNoteNumber(int noteNumber);
 
-	/** Kills the voice that is playing for the longest time. */
-	void killLastVoice();
+	/** Kills the voice that is chosen by the current stealing policy. */
+	void killLastVoice(int noteNumber=-1);
+
+	/** Sets the policy that decides which voice is killed when the voice limit is reached. */
+	void setVoiceStealingPolicy(VoiceAllocator::StealingPolicy newPolicy) noexcept { stealingPolicy = newPolicy; }
+
+	VoiceAllocator::StealingPolicy getVoiceStealingPolicy() const noexcept { return stealingPolicy; }
+
+	/** Returns the priority group for a voice that is started with the given event.
+	*
+	*	The voices of the lowest priority group are stolen first if the policy is VoiceAllocator::StealingPolicy::LowestPriority.
+	*	By default, artificial notes (eg. layers that are added by a script) are stolen before the notes that are played by the user.
+	*/
+	virtual int getVoicePriority(const HiseEvent &e) const { return e.isArtificial() ? 0 : 1; }
+
+	VoiceAllocator& getVoiceAllocator() noexcept { return voiceAllocator; }
 
     void deleteAllVoices();
     
 	void setVoiceLimit(int newVoiceLimit);
 
+	/** Changes the amount of voices (up to NUM_MAX_POLYPHONIC_VOICES).
+	*
+	*	This kills all voices and resizes the per voice storage. It does nothing if the synth doesn't create its voices with createVoice().
+	*	The voice amount is stored as "VoiceAmount" property if it differs from NUM_POLYPHONIC_VOICES.
+	*/
+	virtual void setVoiceAmount(int newVoiceAmount);
+
 	void setKillFadeOutTime(double fadeTimeSeconds);
 
 	/** Checks if the message fits the sound, but can be overriden to implement other group start logic. */
@@ -346,6 +436,8 @@ public:
 		float *gainData = gainChain->getVoiceValues(voiceIndex);
 		if (scriptGainValue != 1.0f) FloatVectorOperations::multiply(gainData + startSample, scriptGainValue, numSamples);
 
+		if (numSamples > 0) voiceAllocator.setVoiceLevel(voiceIndex, gainData[startSample + numSamples - 1]);
+
 		return gainData;
 	};
 
@@ -384,6 +476,23 @@ public:
 
 protected:
 
+	/** Overwrite this and return a new voice of your synth if the voice amount can be changed with setVoiceAmount(). */
+	virtual ModulatorSynthVoice* createVoice() { return nullptr; }
+
+	/** Resizes all per voice storage (the voice lists and the polyphonic modulation and effect chains) to the current amount of voices.
+	*
+	*	This is called by prepareToPlay() if the voice amount has changed, but you need to call it yourself if you change
+	*	the voices of an initialised synth (eg. ModulatorSampler::setVoiceAmount()).
+	*/
+	void resizeVoiceStorage();
+
+	/** Places the per voice data of all polyphonic chains and envelopes into one ModulationArena (in the order they are rendered).
+	*
+	*	This is called by prepareToPlay() and does nothing if a voice is playing or the layout hasn't changed. If you change
+	*	the voices of an initialised synth, call it after resizeVoiceStorage().
+	*/
+	void updateModulationArena(int samplesPerBlock);
+
 	bool checkTimerCallback(int timerIndex) const noexcept
 	{
 		return nextTimerCallbackTimes[timerIndex] != 0.0 && (getMainController()->getUptime() > nextTimerCallbackTimes[timerIndex]);
@@ -396,8 +505,18 @@ private:
 
 	// ===================================================================================================================
 
+	ModulatorSynthVoice* getFreeVoiceForSound(SynthesiserSound *sound, int midiChannel, int noteNumber);
+
 	VoiceStack activeVoices;
 
+	VoiceAllocator voiceAllocator;
+	VoiceAllocator::StealingPolicy stealingPolicy = VoiceAllocator::StealingPolicy::Oldest;
+
+	ModulationArena::Ptr modulationArena;
+	Array<EnvelopeModulator*> modulationRenderOrder;
+	int modulationArenaNumSamples = 0;
+	int modulationArenaNumVoices = 0;
+
 	Colour iconColour;
 
 	ClockSpeed clockSpeed;
@@ -571,6 +690,8 @@ public:
 	{
 		//stopNote(true);
 		killThisVoice = true;	
+
+		getOwnerSynth()->getVoiceAllocator().voiceKilled(voiceIndex);
 	}
 
 	void setKillFadeFactor(float newKillFadeFactor)
@@ -93,6 +93,7 @@ void ModulatorSynthChain::renderNextBlockWithModulators(AudioSampleBuffer &buffe
 	if (isBypassed()) return;
 
 	ADD_GLITCH_DETECTOR(this, DebugLogger::Location::SynthChainRendering);
+	PROFILE_PROCESSOR(this);
 
 	ScopedLock sl(getSynthLock());
 
@@ -109,7 +109,8 @@ float Modulation::getDisplayIntensity() const noexcept
 Modulator::Modulator(MainController *mc, const String &id_) :
 	Processor(mc, id_),
 	attachedPlotter(nullptr),
-	colour(Colour(0x00000000))
+	colour(Colour(0x00000000)),
+	plotterTap(1024)
 {		
 };
 
@@ -147,10 +148,7 @@ bool Modulator::isPlotted() const
 
 void Modulator::addValueToPlotter(float v) const
 {
-	if(attachedPlotter.getComponent() != nullptr) 
-	{
-		attachedPlotter.getComponent()->addValue(this, v);
-	}
+	plotterTap.pushSample(v);
 };
 
 void TimeModulation::renderNextBlock(AudioSampleBuffer &buffer, int startSample, int numSamples)
@@ -286,6 +284,18 @@ VoiceStartModulator::VoiceStartModulator(MainController *mc, const String &id, i
 	voiceValues.insertMultiple(0, 1.0f, numVoices);
 };
 
+void VoiceStartModulator::setVoiceAmount(int newVoiceAmount)
+{
+	const int oldVoiceAmount = voiceValues.size();
+
+	if (newVoiceAmount > oldVoiceAmount)
+		voiceValues.insertMultiple(-1, 1.0f, newVoiceAmount - oldVoiceAmount);
+	else
+		voiceValues.removeRange(newVoiceAmount, oldVoiceAmount - newVoiceAmount);
+
+	VoiceModulation::setVoiceAmount(newVoiceAmount);
+}
+
 EnvelopeModulator::EnvelopeModulator(MainController *mc, const String &id, int voiceAmount_, Modulation::Mode m):
 	Modulator(mc, id),
 	Modulation(m),
@@ -296,6 +306,122 @@ EnvelopeModulator::EnvelopeModulator(MainController *mc, const String &id, int v
 	parameterNames.add("Retrigger");
 };
 
+void EnvelopeModulator::setVoiceAmount(int newVoiceAmount)
+{
+	const int oldVoiceAmount = polyManager.getVoiceAmount();
+
+	if (newVoiceAmount == oldVoiceAmount)
+		return;
+
+	// Subclasses create their states in the constructor, so only resize them if they exist
+	if (states.size() == oldVoiceAmount)
+	{
+		for (int i = oldVoiceAmount; i < newVoiceAmount; i++)
+			states.add(createSubclassedState(i));
+
+		if (newVoiceAmount < oldVoiceAmount)
+			states.removeRange(newVoiceAmount, oldVoiceAmount - newVoiceAmount);
+	}
+
+	for (int i = 0; i < getNumInternalChains(); i++)
+	{
+		ModulatorChain* c = dynamic_cast<ModulatorChain*>(getChildProcessor(i));
+
+		// Monophonic internal chains (eg. the LFO frequency chain) keep their single voice
+		if (c != nullptr && c->polyManager.getVoiceAmount() == oldVoiceAmount)
+			c->setVoiceAmount(newVoiceAmount);
+	}
+
+	VoiceModulation::setVoiceAmount(newVoiceAmount);
+}
+
+void EnvelopeModulator::addToRenderOrder(Array<EnvelopeModulator*>& renderOrder)
+{
+	for (int i = 0; i < getNumInternalChains(); i++)
+	{
+		ModulatorChain* c = dynamic_cast<ModulatorChain*>(getChildProcessor(i));
+
+		// The internal chains are rendered by the envelope, so their data comes first
+		if (c != nullptr && c->polyManager.getVoiceAmount() == polyManager.getVoiceAmount())
+			c->addToRenderOrder(renderOrder);
+	}
+
+	renderOrder.add(this);
+}
+
+size_t EnvelopeModulator::getRequiredArenaSize(int /*alignedNumSamples*/) const
+{
+	if (states.size() == 0)
+		return 0;
+
+	size_t stateSize = 0;
+
+	{
+		ModulationArena::ScopedStatePlacement measurement(nullptr);
+		ScopedPointer<ModulatorState> s = createSubclassedState(0);
+		stateSize = measurement.getLastStateSize();
+	}
+
+	return (size_t)polyManager.getVoiceAmount() * ModulationArena::getAlignedSize(stateSize);
+}
+
+void EnvelopeModulator::moveIntoArena(ModulationArena* arena, int /*alignedNumSamples*/)
+{
+	if (states.size() != 0)
+		states.createInArena(*this, arena, polyManager.getVoiceAmount());
+}
+
+void EnvelopeModulator::StateList::removeRange(int startIndex, int numberToRemove)
+{
+	for (int i = startIndex; i < jmin<int>(states.size(), startIndex + numberToRemove); i++)
+		destroy(states[i]);
+
+	states.removeRange(startIndex, numberToRemove);
+}
+
+void EnvelopeModulator::StateList::clear()
+{
+	for (int i = 0; i < states.size(); i++)
+		destroy(states[i]);
+
+	states.clear();
+	arena = nullptr;
+}
+
+void EnvelopeModulator::StateList::createInArena(const EnvelopeModulator& owner, ModulationArena* newArena, int numVoices)
+{
+	Array<ModulatorState*> newStates;
+	newStates.ensureStorageAllocated(numVoices);
+
+	{
+		ModulationArena::ScopedStatePlacement placement(newArena);
+
+		for (int i = 0; i < numVoices; i++)
+			newStates.add(owner.createSubclassedState(i));
+	}
+
+	setArenaStates(newArena, newStates);
+}
+
+void EnvelopeModulator::StateList::setArenaStates(ModulationArena* newArena, Array<ModulatorState*>& newStates)
+{
+	// Keep the new arena alive before the old one might be released
+	ModulationArena::Ptr newArenaPtr(newArena);
+
+	clear();
+
+	states.swapWith(newStates);
+	arena = newArenaPtr;
+}
+
+void EnvelopeModulator::StateList::destroy(ModulatorState* s)
+{
+	if (arena != nullptr && arena->contains(s))
+		s->~ModulatorState();
+	else
+		delete s;
+}
+
 #pragma warning( pop )
 
 Processor *VoiceStartModulatorFactoryType::createProcessor(int typeIndex, const String &id)
@@ -253,9 +253,14 @@ public:
 	bool isPlotted() const;
 
 	/** Adds a value to the plotter. It is okay to do this on a sample level, the Plotter automatically interpolates it.
+	*
+	*	The value is pushed into the plotter tap, so this does nothing if no plotter is connected.
 	*/
 	void addValueToPlotter(float v) const;
 
+	/** Returns the tap that the plotter reads the values from. */
+	AnalyserTap& getPlotterTap() const { return plotterTap; }
+
 	UpdateMerger editorUpdater;
 
 private:
@@ -266,6 +271,8 @@ private:
 	Colour colour;
 
 	Component::SafePointer<Plotter> attachedPlotter;
+
+	mutable AnalyserTap plotterTap;
 	
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Modulator)
 	
@@ -383,6 +390,13 @@ public:
 
 	void allNotesOff();
 
+	/** Changes the amount of voices that the modulator can handle.
+	*
+	*	This is called by the owner synth when its voice amount changes (before prepareToPlay()), so it can allocate.
+	*	Overwrite this method if you keep additional per voice data and call the base class method.
+	*/
+	virtual void setVoiceAmount(int newVoiceAmount) { polyManager.setVoiceAmount(newVoiceAmount); }
+
 	/** If you subclass a Modulator from this class, it can handle multiple voices. */
 	class PolyphonyManager
 	{
@@ -398,6 +412,9 @@ public:
 		/** Returns the amount of voices the Modulator can handle. */
 		int getVoiceAmount() const {return voiceAmount;};
 
+		/** Don't call this directly, but use VoiceModulation::setVoiceAmount(). */
+		void setVoiceAmount(int newVoiceAmount) noexcept { voiceAmount = newVoiceAmount; }
+
 		/** This sets the current voice. Call this before you process the modulator! 
 		*
 		*	A call to this function must always be preceded by clearCurrentVoice() or a assertion is thrown!
@@ -427,7 +444,7 @@ public:
 		int lastStartedVoice;
 
 		int currentVoice;
-		const int voiceAmount;
+		int voiceAmount;
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PolyphonyManager)
 	};
@@ -460,6 +477,8 @@ public:
 
 	VoiceStartModulator(MainController *mc, const String &id, int numVoices, Modulation::Mode m);
 	
+	void setVoiceAmount(int newVoiceAmount) override;
+
 	/** When the startNote function is called, a previously calculated value (by the handleMidiMessage function) is stored using the supplied voice index. */
 	virtual void startVoice(int voiceIndex) override
 	{
@@ -673,6 +692,21 @@ public:
 	
 	virtual ~EnvelopeModulator() {};
 
+	/** Resizes the voice states and all internal chains that have the same voice amount as the envelope. */
+	void setVoiceAmount(int newVoiceAmount) override;
+
+	/** Adds the polyphonic internal chains and this envelope to the list in the order they are rendered.
+	*
+	*	The ModulatorSynth uses this list to place the per voice data into a ModulationArena.
+	*/
+	virtual void addToRenderOrder(Array<EnvelopeModulator*>& renderOrder);
+
+	/** Returns the amount of bytes the per voice data of this envelope needs in a ModulationArena. */
+	virtual size_t getRequiredArenaSize(int alignedNumSamples) const;
+
+	/** Recreates the per voice data of this envelope in the given arena. Don't call this while a voice is playing. */
+	virtual void moveIntoArena(ModulationArena* arena, int alignedNumSamples);
+
 	static Path getSymbolPath()
 	{
 		Path path;
@@ -865,17 +899,61 @@ protected:
 
 		virtual ~ModulatorState() {};
 
+		/** Places the state into the ModulationArena of the active ModulationArena::ScopedStatePlacement. */
+		static void* operator new(size_t numBytes) { return ModulationArena::allocateState(numBytes); }
+
+		/** States that live in an arena are never deleted (the StateList only calls their destructor). */
+		static void operator delete(void* p) { ::operator delete(p); }
+
 	private:
 		int index;
 
 		JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulatorState)
 	};
 
+	/** The list of voice states. Each state either lives on the heap or in the ModulationArena of the synth. */
+	class StateList
+	{
+	public:
+
+		~StateList() { clear(); }
+
+		ModulatorState* operator[](int index) const noexcept { return states[index]; }
+
+		int size() const noexcept { return states.size(); }
+
+		/** Adds a state that was created on the heap. */
+		void add(ModulatorState* newState)
+		{
+			// States in the arena must be added with createInArena() or they would be deleted...
+			jassert(arena == nullptr || !arena->contains(newState));
+
+			states.add(newState);
+		}
+
+		void removeRange(int startIndex, int numberToRemove);
+
+		void clear();
+
+		/** Creates a state for every voice in the given arena and destroys the old states. */
+		void createInArena(const EnvelopeModulator& owner, ModulationArena* newArena, int numVoices);
+
+		/** Replaces the states with the given states that were created in the arena (the old states are destroyed). */
+		void setArenaStates(ModulationArena* newArena, Array<ModulatorState*>& newStates);
+
+	private:
+
+		void destroy(ModulatorState* s);
+
+		Array<ModulatorState*> states;
+		ModulationArena::Ptr arena;
+	};
+
 	/** Overwrite this method and return a newly created ModulatorState of the desired subclass. It will be owned by the Modulator.	*/
 	virtual ModulatorState * createSubclassedState (int /*voiceIndex*/) const = 0;
 	
 	/** Use this array to access the state. */
-	OwnedArray<ModulatorState> states;
+	StateList states;
 
 	ScopedPointer<ModulatorState> monophonicState;
 
@@ -924,6 +1002,9 @@ public:
 	void fillTypeNameList();
 
 	Processor *createProcessor(int typeIndex, const String &id) override;
+
+	/** Sets the voice amount for all modulators that are created from now on. */
+	void setNumVoices(int newNumVoices) noexcept { numVoices = newNumVoices; }
 	
 	const Array<ProcessorEntry> & getTypeNames() const override
 	{
@@ -967,6 +1048,9 @@ public:
 	void fillTypeNameList();
 
 	Processor *createProcessor(int typeIndex, const String &id) override;
+
+	/** Sets the voice amount for all modulators that are created from now on. */
+	void setNumVoices(int newNumVoices) noexcept { numVoices = newNumVoices; }
 	
 	const Array<ProcessorEntry> & getTypeNames() const override
 	{
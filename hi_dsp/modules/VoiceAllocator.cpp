@@ -0,0 +1,483 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+VoiceAllocator::VoiceAllocator()
+{
+	reset(0);
+}
+
+void VoiceAllocator::prepare(int maxNumVoices)
+{
+	jassert(maxNumVoices <= NUM_MAX_POLYPHONIC_VOICES);
+
+	capacity = jlimit<int>(0, NUM_MAX_POLYPHONIC_VOICES, maxNumVoices);
+
+	states.allocate(capacity, false);
+	freeVoices.allocate(capacity, false);
+
+	reset(capacity);
+}
+
+void VoiceAllocator::reset(int numVoicesToUse) noexcept
+{
+	numVoices = jlimit<int>(0, capacity, numVoicesToUse);
+
+	for (int i = 0; i < 128; i++)
+		noteLists[i] = List();
+
+	for (int i = 0; i < NumPriorityGroups * 2; i++)
+		groupLists[i] = List();
+
+	numFreeVoices = 0;
+
+	// The free list is a stack, so push the voices in reverse order to start with voice 0
+	for (int i = numVoices; --i >= 0;)
+	{
+		states[i] = VoiceState();
+		states[i].freeListIndex = (int16)numFreeVoices;
+		freeVoices[numFreeVoices++] = (int16)i;
+	}
+
+	numStealableVoices = 0;
+	startCounter = 0;
+}
+
+void VoiceAllocator::voiceStarted(int voiceIndex, int noteNumber, int priorityGroup) noexcept
+{
+	if (!isPositiveAndBelow(voiceIndex, numVoices))
+		return;
+
+	VoiceState& s = states[voiceIndex];
+
+	if (s.state != State::Free)
+		voiceStopped(voiceIndex);
+
+	// Swap the last free voice into the slot of the started voice
+	const int lastFreeVoice = freeVoices[--numFreeVoices];
+
+	freeVoices[s.freeListIndex] = (int16)lastFreeVoice;
+	states[lastFreeVoice].freeListIndex = s.freeListIndex;
+	s.freeListIndex = -1;
+
+	s.noteNumber = (uint8)(noteNumber & 127);
+	s.priorityGroup = (uint8)jlimit<int>(0, NumPriorityGroups - 1, priorityGroup);
+	s.level = 1.0f;
+	s.startIndex = startCounter++;
+	s.state = State::Held;
+
+	addToNoteList(voiceIndex);
+	addToGroupList(voiceIndex, false);
+
+	numStealableVoices++;
+}
+
+void VoiceAllocator::voiceReleased(int voiceIndex) noexcept
+{
+	if (!isPositiveAndBelow(voiceIndex, numVoices) || states[voiceIndex].state != State::Held)
+		return;
+
+	// The released list is also sorted by the start time, so the voice can't be appended
+	removeFromGroupList(voiceIndex);
+
+	states[voiceIndex].state = State::Released;
+
+	addToGroupList(voiceIndex, true);
+}
+
+void VoiceAllocator::voiceKilled(int voiceIndex) noexcept
+{
+	if (!isPositiveAndBelow(voiceIndex, numVoices))
+		return;
+
+	VoiceState& s = states[voiceIndex];
+
+	if (s.state == State::Held || s.state == State::Released)
+	{
+		removeFromGroupList(voiceIndex);
+		s.state = State::Killed;
+		numStealableVoices--;
+	}
+}
+
+void VoiceAllocator::voiceStopped(int voiceIndex) noexcept
+{
+	if (!isPositiveAndBelow(voiceIndex, numVoices))
+		return;
+
+	VoiceState& s = states[voiceIndex];
+
+	if (s.state == State::Free)
+		return;
+
+	if (s.state != State::Killed)
+	{
+		removeFromGroupList(voiceIndex);
+		numStealableVoices--;
+	}
+
+	removeFromNoteList(voiceIndex);
+
+	s.state = State::Free;
+	s.freeListIndex = (int16)numFreeVoices;
+	freeVoices[numFreeVoices++] = (int16)voiceIndex;
+}
+
+int VoiceAllocator::getVoiceToSteal(StealingPolicy policy, int noteNumber) const noexcept
+{
+	const int index = getStealableVoice(policy, noteNumber);
+
+	// If every voice is already fading out, the new note takes over the oldest one instead of being dropped
+	return index != -1 ? index : getOldestKilledVoice();
+}
+
+int VoiceAllocator::getStealableVoice(StealingPolicy policy, int noteNumber) const noexcept
+{
+	switch (policy)
+	{
+	case StealingPolicy::Oldest:
+	{
+		const int released = getOldestVoice(true);
+		return released != -1 ? released : getOldestVoice(false);
+	}
+	case StealingPolicy::Quietest:
+	{
+		const int released = getQuietestVoice(true);
+		return released != -1 ? released : getQuietestVoice(false);
+	}
+	case StealingPolicy::SameNoteFirst:
+	{
+		for (int i = getFirstVoiceForNote(noteNumber); i != -1; i = states[i].nextForNote)
+		{
+			if (states[i].state != State::Killed)
+				return i;
+		}
+
+		return getStealableVoice(StealingPolicy::Oldest, noteNumber);
+	}
+	case StealingPolicy::LowestPriority:
+	{
+		for (int p = 0; p < NumPriorityGroups; p++)
+		{
+			if (getGroupList(p, true).first != -1)
+				return getGroupList(p, true).first;
+
+			if (getGroupList(p, false).first != -1)
+				return getGroupList(p, false).first;
+		}
+
+		return -1;
+	}
+	case StealingPolicy::numStealingPolicies:
+		break;
+	}
+
+	jassertfalse;
+	return -1;
+}
+
+void VoiceAllocator::addToGroupList(int voiceIndex, bool released) noexcept
+{
+	VoiceState& s = states[voiceIndex];
+	List& l = getGroupList(s.priorityGroup, released);
+
+	// Walk backwards from the newest voice to keep the list sorted by start time (this is only more than one step
+	// for voices that are released out of order).
+	int16 prev = l.last;
+
+	while (prev != -1 && states[prev].startIndex > s.startIndex)
+		prev = states[prev].prevInGroup;
+
+	const int16 next = (prev == -1) ? l.first : states[prev].nextInGroup;
+
+	s.prevInGroup = prev;
+	s.nextInGroup = next;
+
+	if (prev == -1)	l.first = (int16)voiceIndex;
+	else			states[prev].nextInGroup = (int16)voiceIndex;
+
+	if (next == -1)	l.last = (int16)voiceIndex;
+	else			states[next].prevInGroup = (int16)voiceIndex;
+}
+
+void VoiceAllocator::removeFromGroupList(int voiceIndex) noexcept
+{
+	VoiceState& s = states[voiceIndex];
+	List& l = getGroupList(s.priorityGroup, s.state == State::Released);
+
+	if (s.prevInGroup == -1)	l.first = s.nextInGroup;
+	else						states[s.prevInGroup].nextInGroup = s.nextInGroup;
+
+	if (s.nextInGroup == -1)	l.last = s.prevInGroup;
+	else						states[s.nextInGroup].prevInGroup = s.prevInGroup;
+
+	s.prevInGroup = -1;
+	s.nextInGroup = -1;
+}
+
+void VoiceAllocator::addToNoteList(int voiceIndex) noexcept
+{
+	VoiceState& s = states[voiceIndex];
+	List& l = noteLists[s.noteNumber];
+
+	s.prevForNote = l.last;
+	s.nextForNote = -1;
+
+	if (l.last == -1)	l.first = (int16)voiceIndex;
+	else				states[l.last].nextForNote = (int16)voiceIndex;
+
+	l.last = (int16)voiceIndex;
+}
+
+void VoiceAllocator::removeFromNoteList(int voiceIndex) noexcept
+{
+	VoiceState& s = states[voiceIndex];
+	List& l = noteLists[s.noteNumber];
+
+	if (s.prevForNote == -1)	l.first = s.nextForNote;
+	else						states[s.prevForNote].nextForNote = s.nextForNote;
+
+	if (s.nextForNote == -1)	l.last = s.prevForNote;
+	else						states[s.nextForNote].prevForNote = s.prevForNote;
+
+	s.prevForNote = -1;
+	s.nextForNote = -1;
+}
+
+int VoiceAllocator::getOldestVoice(bool released) const noexcept
+{
+	int oldest = -1;
+
+	for (int p = 0; p < NumPriorityGroups; p++)
+	{
+		const int first = getGroupList(p, released).first;
+
+		if (first != -1 && (oldest == -1 || states[first].startIndex < states[oldest].startIndex))
+			oldest = first;
+	}
+
+	return oldest;
+}
+
+int VoiceAllocator::getOldestKilledVoice() const noexcept
+{
+	// The killed voices are not in a list, but this is only needed if the voice limit is reached while every voice fades out
+	int oldest = -1;
+
+	for (int i = 0; i < numVoices; i++)
+	{
+		if (states[i].state == State::Killed && (oldest == -1 || states[i].startIndex < states[oldest].startIndex))
+			oldest = i;
+	}
+
+	return oldest;
+}
+
+int VoiceAllocator::getQuietestVoice(bool released) const noexcept
+{
+	int quietest = -1;
+
+	for (int p = 0; p < NumPriorityGroups; p++)
+	{
+		for (int i = getGroupList(p, released).first; i != -1; i = states[i].nextInGroup)
+		{
+			if (quietest == -1 || states[i].level < states[quietest].level)
+				quietest = i;
+		}
+	}
+
+	return quietest;
+}
+
+/** ============================================================================================================================== UNIT TEST */
+
+class VoiceAllocatorTest : public UnitTest
+{
+public:
+
+	VoiceAllocatorTest() :
+		UnitTest("Testing voice allocator")
+	{
+
+	}
+
+	void runTest() override
+	{
+		beginTest("Testing free list");
+
+		VoiceAllocator a;
+
+		a.prepare(4);
+
+		expectEquals<int>(a.getFreeVoice(), 0, "First free voice");
+
+		startVoices(a);
+
+		expectEquals<int>(a.getFreeVoice(), -1, "No free voice");
+		expectEquals<int>(a.getNumStealableVoices(), 4, "Stealable voices");
+
+		a.voiceStopped(2);
+
+		expectEquals<int>(a.getFreeVoice(), 2, "Stopped voice is free");
+
+		beginTest("Testing oldest policy");
+
+		startVoices(a);
+
+		expectEquals<int>(a.getVoiceToSteal(StealingPolicy::Oldest, 64), 0, "Oldest voice");
+
+		a.voiceReleased(3);
+
+		expectEquals<int>(a.getVoiceToSteal(StealingPolicy::Oldest, 64), 3, "Released voice is preferred");
+
+		beginTest("Testing quietest policy");
+
+		startVoices(a);
+
+		a.setVoiceLevel(0, 0.8f);
+		a.setVoiceLevel(1, 0.2f);
+		a.setVoiceLevel(2, 0.5f);
+		a.setVoiceLevel(3, 0.9f);
+
+		expectEquals<int>(a.getVoiceToSteal(StealingPolicy::Quietest, 64), 1, "Quietest voice");
+
+		a.voiceReleased(3);
+
+		expectEquals<int>(a.getVoiceToSteal(StealingPolicy::Quietest, 64), 3, "Released voice is preferred");
+
+		beginTest("Testing same note policy");
+
+		startVoices(a);
+
+		expectEquals<int>(a.getVoiceToSteal(StealingPolicy::SameNoteFirst, 62), 2, "Same note");
+		expectEquals<int>(a.getVoiceToSteal(StealingPolicy::SameNoteFirst, 10), 0, "Oldest voice without same note");
+
+		a.voiceKilled(2);
+
+		expectEquals<int>(a.getVoiceToSteal(StealingPolicy::SameNoteFirst, 62), 0, "Killed voice is skipped");
+
+		beginTest("Testing priority policy");
+
+		a.reset(4);
+
+		a.voiceStarted(0, 60, 2);
+		a.voiceStarted(1, 61, 1);
+		a.voiceStarted(2, 62, 1);
+		a.voiceStarted(3, 63, 3);
+
+		expectEquals<int>(a.getVoiceToSteal(StealingPolicy::LowestPriority, 64), 1, "Oldest voice of lowest group");
+
+		a.voiceReleased(2);
+
+		expectEquals<int>(a.getVoiceToSteal(StealingPolicy::LowestPriority, 64), 2, "Released voice is preferred");
+
+		beginTest("Testing killed voices");
+
+		for (int p = 0; p < (int)StealingPolicy::numStealingPolicies; p++)
+		{
+			startVoices(a);
+
+			for (int i = 3; i >= 0; i--)
+				a.voiceKilled(i);
+
+			expectEquals<int>(a.getNumStealableVoices(), 0, "No stealable voices");
+			expectEquals<int>(a.getVoiceToSteal((StealingPolicy)p, 60), 0, "Oldest killed voice");
+		}
+
+		a.reset(4);
+
+		expectEquals<int>(a.getVoiceToSteal(StealingPolicy::Oldest, 60), -1, "No voice playing");
+
+		beginTest("Testing more than 128 voices");
+
+		a.prepare(NUM_MAX_POLYPHONIC_VOICES);
+
+		expectEquals<int>(a.getCapacity(), NUM_MAX_POLYPHONIC_VOICES, "Capacity");
+
+		for (int i = 0; i < NUM_MAX_POLYPHONIC_VOICES; i++)
+		{
+			const int index = a.getFreeVoice();
+
+			expectEquals<int>(index, i, "Free voice order");
+
+			a.voiceStarted(index, i % 128, 0);
+		}
+
+		expectEquals<int>(a.getFreeVoice(), -1, "All voices used");
+		expectEquals<int>(a.getVoiceToSteal(StealingPolicy::Oldest, 60), 0, "Oldest voice");
+
+		a.voiceReleased(NUM_MAX_POLYPHONIC_VOICES - 1);
+
+		expectEquals<int>(a.getVoiceToSteal(StealingPolicy::Oldest, 60), NUM_MAX_POLYPHONIC_VOICES - 1, "Released voice");
+
+		beginTest("Testing voice stack with more than 128 voices");
+
+		HeapBlock<uint8> dummyVoices(NUM_MAX_POLYPHONIC_VOICES, true);
+
+		VoiceStack stack;
+
+		stack.setCapacity(NUM_POLYPHONIC_VOICES);
+
+		for (int i = 0; i < NUM_MAX_POLYPHONIC_VOICES; i++)
+			stack.insert(reinterpret_cast<ModulatorSynthVoice*>(dummyVoices + i));
+
+		expectEquals<int>(stack.size(), NUM_POLYPHONIC_VOICES, "Default capacity");
+
+		stack.setCapacity(NUM_MAX_POLYPHONIC_VOICES);
+
+		expectEquals<int>(stack.size(), NUM_POLYPHONIC_VOICES, "Voices are kept after growing");
+
+		for (int i = 0; i < NUM_MAX_POLYPHONIC_VOICES; i++)
+			stack.insert(reinterpret_cast<ModulatorSynthVoice*>(dummyVoices + i));
+
+		expectEquals<int>(stack.size(), NUM_MAX_POLYPHONIC_VOICES, "Maximum capacity");
+		expect(stack[NUM_MAX_POLYPHONIC_VOICES - 1] == reinterpret_cast<ModulatorSynthVoice*>(dummyVoices + NUM_MAX_POLYPHONIC_VOICES - 1), "Last voice");
+
+		stack.setCapacity(64);
+
+		expectEquals<int>(stack.size(), 64, "Voices are clipped after shrinking");
+	}
+
+private:
+
+	typedef VoiceAllocator::StealingPolicy StealingPolicy;
+
+	/** Resets the allocator and starts the voices 0 ... 3 with the notes 60 ... 63. */
+	static void startVoices(VoiceAllocator& a)
+	{
+		a.reset(4);
+
+		for (int i = 0; i < 4; i++)
+			a.voiceStarted(i, 60 + i, 0);
+	}
+};
+
+static VoiceAllocatorTest voiceAllocatorTest;
@@ -0,0 +1,189 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+#ifndef VOICEALLOCATOR_H_INCLUDED
+#define VOICEALLOCATOR_H_INCLUDED
+
+/** Keeps track of the voices of a ModulatorSynth so that the note handling doesn't need to iterate over all voices.
+*	@ingroup modulatorSynth
+*
+*	The allocator holds a free list of voice indexes, a list of voices for every note number (in the order they
+*	were started) and a list of stealable voices for every priority group (also in the order they were started).
+*	All lists are intrusive and stored in arrays that are allocated with prepare(), so none of the other methods
+*	allocate and most of them run in constant time.
+*
+*	The ModulatorSynth notifies the allocator about every state change of its voices:
+*
+*	- voiceStarted() when the voice starts playing (it is removed from the free list)
+*	- voiceReleased() when the note off is received (it stays stealable, but is preferred by the stealing policies)
+*	- voiceKilled() when the voice is fading out (it can't be stolen anymore)
+*	- voiceStopped() when the voice is reset (it is moved back to the free list).
+*
+*	All notifications are ignored for voices that are not in the expected state, so you can call them safely for
+*	voices that were started without the allocator (eg. the child voices of a ModulatorSynthGroup).
+*/
+class VoiceAllocator
+{
+public:
+
+	/** The policy that decides which voice is killed if the voice limit is reached. */
+	enum class StealingPolicy
+	{
+		Oldest = 0, ///< the voice that was started first (released voices are preferred)
+		Quietest, ///< the voice with the lowest gain modulation value (released voices are preferred)
+		SameNoteFirst, ///< the oldest voice of the same note number or the oldest voice if there is none
+		LowestPriority, ///< the oldest voice of the lowest priority group (released voices are preferred)
+		numStealingPolicies
+	};
+
+	enum
+	{
+		NumPriorityGroups = 4
+	};
+
+	VoiceAllocator();
+
+	/** Allocates the storage for the given amount of voices. Call this whenever the voice amount of the synth changes. */
+	void prepare(int maxNumVoices);
+
+	/** Marks all voices as free and sets the number of voices that can be allocated (up to the prepared amount). */
+	void reset(int numVoicesToUse) noexcept;
+
+	/** Returns the number of voices that the allocator manages. */
+	int getNumVoices() const noexcept { return numVoices; }
+
+	/** Returns the number of voices that were allocated with prepare(). */
+	int getCapacity() const noexcept { return capacity; }
+
+	/** Returns the index of a voice that is not playing or -1 if all voices are used. */
+	int getFreeVoice() const noexcept { return numFreeVoices > 0 ? freeVoices[numFreeVoices - 1] : -1; }
+
+	/** Returns the number of voices that are playing and not being killed. */
+	int getNumStealableVoices() const noexcept { return numStealableVoices; }
+
+	/** Call this when a voice is started. The priority group will be clipped to the range 0 ... NumPriorityGroups - 1. */
+	void voiceStarted(int voiceIndex, int noteNumber, int priorityGroup) noexcept;
+
+	/** Call this when the voice receives a note off. */
+	void voiceReleased(int voiceIndex) noexcept;
+
+	/** Call this when the voice starts its kill fade out. */
+	void voiceKilled(int voiceIndex) noexcept;
+
+	/** Call this when the voice is reset. It will be available with getFreeVoice() again. */
+	void voiceStopped(int voiceIndex) noexcept;
+
+	/** Stores the current gain of the voice for the StealingPolicy::Quietest policy. */
+	void setVoiceLevel(int voiceIndex, float level) noexcept
+	{
+		if (isPositiveAndBelow(voiceIndex, numVoices))
+			states[voiceIndex].level = level;
+	}
+
+	/** Returns the first (oldest) voice that plays the given note number or -1. Use getNextVoiceForNote() to iterate.
+	*
+	*	This includes voices that are being killed.
+	*/
+	int getFirstVoiceForNote(int noteNumber) const noexcept { return noteLists[noteNumber & 127].first; }
+
+	/** Returns the voice that was started after the given voice with the same note number or -1. */
+	int getNextVoiceForNote(int voiceIndex) const noexcept { return states[voiceIndex].nextForNote; }
+
+	/** Returns the voice that should be killed to make room for a new voice with the given note number.
+	*
+	*	If all voices are being killed, it returns the oldest of them (or -1 if no voice is playing).
+	*/
+	int getVoiceToSteal(StealingPolicy policy, int noteNumber) const noexcept;
+
+private:
+
+	enum class State : uint8
+	{
+		Free = 0,
+		Held,
+		Released,
+		Killed
+	};
+
+	struct List
+	{
+		int16 first = -1;
+		int16 last = -1;
+	};
+
+	struct VoiceState
+	{
+		int16 prevForNote = -1;
+		int16 nextForNote = -1;
+		int16 prevInGroup = -1;
+		int16 nextInGroup = -1;
+		int16 freeListIndex = -1;
+		uint8 noteNumber = 0;
+		uint8 priorityGroup = 0;
+		State state = State::Free;
+		float level = 1.0f;
+		int64 startIndex = 0;
+	};
+
+	List& getGroupList(int priorityGroup, bool released) noexcept { return groupLists[priorityGroup * 2 + (released ? 1 : 0)]; }
+	const List& getGroupList(int priorityGroup, bool released) const noexcept { return groupLists[priorityGroup * 2 + (released ? 1 : 0)]; }
+
+	void addToGroupList(int voiceIndex, bool released) noexcept;
+	void removeFromGroupList(int voiceIndex) noexcept;
+
+	void addToNoteList(int voiceIndex) noexcept;
+	void removeFromNoteList(int voiceIndex) noexcept;
+
+	int getStealableVoice(StealingPolicy policy, int noteNumber) const noexcept;
+
+	int getOldestVoice(bool released) const noexcept;
+	int getOldestKilledVoice() const noexcept;
+	int getQuietestVoice(bool released) const noexcept;
+
+	HeapBlock<VoiceState> states;
+
+	HeapBlock<int16> freeVoices;
+	int numFreeVoices = 0;
+
+	int capacity = 0;
+
+	List noteLists[128];
+	List groupLists[NumPriorityGroups * 2];
+
+	int numVoices = 0;
+	int numStealableVoices = 0;
+	int64 startCounter = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(VoiceAllocator)
+};
+
+#endif  // VOICEALLOCATOR_H_INCLUDED
@@ -27,4 +27,59 @@ bool DspBaseObject::getConstant(int index, char* text, size_t& size) const noexc
 bool DspBaseObject::getConstant(int index, float** data, int &size) noexcept		{ return false; }
 bool DspBaseObject::getConstant(int index, float& value) const noexcept				{ return false; }
 
-#pragma warning( pop )
\ No newline at end of file
+#pragma warning( pop )
+
+void processBlockWithParameterEvents(DspBaseObject& object, const DspProcessData& d)
+{
+	if (d.numEvents == 0)
+	{
+		object.processBlock(d.data, d.numChannels, d.numSamples);
+		return;
+	}
+
+	float* offsetData[DspProcessData::MaxNumChannels];
+
+	const int numChannels = d.numChannels < (int)DspProcessData::MaxNumChannels ? d.numChannels : (int)DspProcessData::MaxNumChannels;
+
+	int start = 0;
+	int eventIndex = 0;
+
+	while (start < d.numSamples)
+	{
+		while (eventIndex < d.numEvents && d.events[eventIndex].sampleOffset <= start)
+		{
+			object.setParameter(d.events[eventIndex].parameterIndex, d.events[eventIndex].value);
+			eventIndex++;
+		}
+
+		int end = d.numSamples;
+
+		if (eventIndex < d.numEvents && d.events[eventIndex].sampleOffset < end)
+			end = d.events[eventIndex].sampleOffset;
+
+		for (int i = 0; i < numChannels; i++)
+			offsetData[i] = d.data[i] + start;
+
+		object.processBlock(offsetData, numChannels, end - start);
+
+		start = end;
+	}
+
+	// Events beyond the block are applied at the end
+	for (; eventIndex < d.numEvents; eventIndex++)
+		object.setParameter(d.events[eventIndex].parameterIndex, d.events[eventIndex].value);
+}
+
+#pragma warning( push )
+#pragma warning( disable : 4100 )
+
+DspBaseObjectV2::DspBaseObjectV2() {}
+DspBaseObjectV2::~DspBaseObjectV2() {}
+
+void DspBaseObjectV2::process(const DspProcessData& d)		{ processBlockWithParameterEvents(*this, d); }
+void DspBaseObjectV2::processVoice(const DspProcessData& d) { process(d); }
+
+int DspBaseObjectV2::getVoiceStateSize() const { return 0; }
+void DspBaseObjectV2::resetVoiceState(int voiceIndex, void* voiceState) {}
+
+#pragma warning( pop )
@@ -45,7 +45,7 @@ enum class LoadingErrorCode
 	Uninitialised, ///< something went wrong during initialisation
 	MissingLibrary, ///< the library could not be found in the library folder.
 	NoValidLibrary, ///< The library seems to be missing a initialise() method with the correct signature
-	NoVersionMatch, ///< The version does not match. This error code will be never thrown automatically, but it is there to communicate the problem back to the Script Engine.
+	NoVersionMatch, ///< The version does not match. This is returned if the library was built with a newer module interface than the host (see getDspApiVersion()).
 	KeyInvalid, ///< The licence key that was passed to the initialise() method didn't match the one of the library.
 	numErrorCodes
 };
@@ -241,4 +241,115 @@ public:
 };
 
 
+/** A parameter change that should be applied at a given sample position of the next processed block. 
+*
+*	This is a plain struct so that it can be passed across the library boundary.
+*/
+struct DspParameterEvent
+{
+	int sampleOffset; ///< the position within the block (events beyond the block are applied after processing it)
+	int parameterIndex; ///< the index that will be passed to setParameter()
+	float value; ///< the new value
+};
+
+/** The data that is passed into the processing methods of a DspBaseObjectV2. 
+*
+*	The channel pointers point directly into the buffer of the engine, so there is no wrapping or copying involved.
+*/
+struct DspProcessData
+{
+	enum
+	{
+		MaxNumChannels = 16 ///< The maximum channel amount that can be passed into a module.
+	};
+
+	float** data; ///< a 'numChannels' sized-array of 'numSamples'-sized float arrays
+	int numChannels; ///< the channel amount (can be anything from 1 to MaxNumChannels).
+	int numSamples; ///< the sample amount: this will be max. the amount specified in the last prepareToPlay() call.
+	
+	const DspParameterEvent* events; ///< the parameter changes for this block sorted by their sample offset
+	int numEvents; ///< the amount of parameter events
+
+	int voiceIndex; ///< the index of the voice or -1 if the block is not rendered for a voice
+	void* voiceState; ///< the state of the voice (allocated by the engine) or nullptr
+};
+
+/** Splits the block at the positions of the parameter events and calls setParameter() before processing each part with processBlock(). 
+*
+*	This is used as default implementation for modules that can't handle the events themselves.
+*/
+void processBlockWithParameterEvents(DspBaseObject& object, const DspProcessData& d);
+
+/** This is the second version of the DSP module interface.
+*
+*	It extends the DspBaseObject with:
+*
+*	- an arbitrary amount of channels
+*	- sample accurate parameter changes
+*	- polyphonic processing with a state per voice that is owned by the engine
+*
+*	In order to keep existing libraries working, the new methods are added in this subclass instead of the DspBaseObject.
+*	The engine checks the version of each module (using the exported getDspObjectV2() function) and uses the old
+*	processBlock() method for modules that don't implement this interface.
+*
+*	Every method has a default implementation, so you can start with a DspBaseObject and override only what you need.
+*	If you want to write a polyphonic module, return the size of your voice state with getVoiceStateSize() and override
+*	processVoice():
+*
+*	@code
+*	class MyEnvelopeFollower: public DspBaseObjectV2
+*	{
+*		struct VoiceState { float lastValue; };
+*
+*		int getVoiceStateSize() const override { return sizeof(VoiceState); }
+*
+*		void processVoice(const DspProcessData& d) override
+*		{
+*			VoiceState* state = static_cast<VoiceState*>(d.voiceState);
+*			// ...
+*		}
+*	};
+*	@endcode
+*/
+class DspBaseObjectV2 : public DspBaseObject
+{
+public:
+
+	enum
+	{
+		ApiVersion = 2 ///< the version that is returned by the exported getDspApiVersion() function
+	};
+
+	DspBaseObjectV2();
+	virtual ~DspBaseObjectV2();
+
+	/** Overwrite this method and process the given data. 
+	*
+	*	The default implementation splits the block at the parameter events and calls processBlock() for each part.
+	*/
+	virtual void process(const DspProcessData& d);
+
+	/** Overwrite this method if your module can process voices.
+	*
+	*	The voice state of the DspProcessData points to getVoiceStateSize() bytes which are owned by the engine. 
+	*	The default implementation just calls process().
+	*/
+	virtual void processVoice(const DspProcessData& d);
+
+	/** Return the amount of bytes that you need for a single voice. 
+	*
+	*	The engine allocates the memory for all voices in prepareToPlay() (aligned to 16 bytes), so you don't need to 
+	*	allocate anything yourself. The default implementation returns 0 (no voice state).
+	*/
+	virtual int getVoiceStateSize() const;
+
+	/** This will be called whenever a voice is started. The state will be cleared before this call, so you only need to
+	*	overwrite this if zero is not a valid start value.
+	*/
+	virtual void resetVoiceState(int voiceIndex, void* voiceState);
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DspBaseObjectV2)
+};
+
+
 #endif  // DSPBASEMODULE_H_INCLUDED
@@ -67,6 +67,12 @@ public:
 	/** This method is called by the DspInstance object's destructor to delete the module. */
 	virtual void destroyDspBaseObject(DspBaseObject *object) const = 0;
 
+	/** Returns the module as DspBaseObjectV2 if it implements the second version of the interface. 
+	*
+	*	The default implementation returns a nullptr so the module is processed with the old interface.
+	*/
+	virtual DspBaseObjectV2* getDspObjectV2(DspBaseObject* /*object*/) const { return nullptr; }
+
 	/** This method must return an array with all module names that can be created. */
 	virtual var getModuleList() const = 0;
 
@@ -104,6 +110,7 @@ public:
 
 	DspBaseObject *createDspBaseObject(const String &moduleName) const override;
 	void destroyDspBaseObject(DspBaseObject* handle) const override;
+	DspBaseObjectV2* getDspObjectV2(DspBaseObject* object) const override { return dynamic_cast<DspBaseObjectV2*>(object); }
 
 	/** Overwrite this method and register every module you want to create with this factory using registerDspModule<Type>(). */
 	virtual void registerModules() = 0;
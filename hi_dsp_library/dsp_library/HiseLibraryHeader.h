@@ -140,6 +140,20 @@ Notice the const keyword when assigning a module. This allows faster code becaus
 
 That's it. Take a look at the DspBaseObject documentation on how to use the modules in Javascript.
 
+### Multichannel & polyphonic modules
+
+If you subclass DspBaseObjectV2 instead of DspBaseObject, your module can process any amount of channels, receive
+parameter changes with a sample offset and render voices with a state that is allocated by the engine:
+
+@code{.js}
+module.setNumVoices(16);				 // allocates the voice states (call this before prepareToPlay)
+module.addParameterEvent(module.Gain, 0.5, 32); // sets the gain at sample 32 of the next block
+module.startVoice(voiceIndex);			 // clears the state of the voice
+module.processVoice(voiceIndex, channels);
+@endcode
+
+Libraries compiled with the old header keep working, their modules are processed with DspBaseObject::processBlock().
+
 ## Copyright
 
 This header (and its included files) are less restrictively licenced than the rest of the HISE codebase.
@@ -227,6 +241,19 @@ namespace InternalLibraryFunctions
 
 	/** Destroys the given module that was created using createDspObject(). */
 	DLL_EXPORT void destroyDspObject(DspBaseObject* handle);
+
+	/** Returns the version of the module interface this library was built with. 
+	*
+	*	Libraries that don't export this function were built with the first version. The host refuses to load 
+	*	libraries that were built with a newer version than its own.
+	*/
+	DLL_EXPORT int getDspApiVersion();
+
+	/** Returns the module as DspBaseObjectV2 if it implements the second version of the interface or a nullptr.
+	*
+	*	The cast is performed within the library so the type information of the library and the host never get mixed.
+	*/
+	DLL_EXPORT DspBaseObjectV2* getDspObjectV2(DspBaseObject* handle);
 }
 
 
@@ -240,6 +267,10 @@ DLL_EXPORT DspBaseObject* InternalLibraryFunctions::createDspObject(const char *
 
 DLL_EXPORT void InternalLibraryFunctions::destroyDspObject(DspBaseObject* handle) {	delete handle; }
 
+DLL_EXPORT int InternalLibraryFunctions::getDspApiVersion() { return DspBaseObjectV2::ApiVersion; }
+
+DLL_EXPORT DspBaseObjectV2* InternalLibraryFunctions::getDspObjectV2(DspBaseObject* handle) { return dynamic_cast<DspBaseObjectV2*>(handle); }
+
 
 /** Overwrite this method and register all modules that you want to create with this library
 *
@@ -0,0 +1,428 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+
+#define BINARY_PLUGIN_STATE_MAGIC 0x42545348 // "HSTB"
+#define BINARY_PLUGIN_STATE_VERSION 2
+
+BinaryPluginState::BinaryPluginState(MainController* mc_):
+	mc(mc_)
+{
+	mc->getMacroManager().getMidiControlAutomationHandler()->addChangeListener(this);
+}
+
+BinaryPluginState::~BinaryPluginState()
+{
+	mc->getMacroManager().getMidiControlAutomationHandler()->removeChangeListener(this);
+}
+
+void BinaryPluginState::changeListenerCallback(SafeChangeBroadcaster* /*b*/)
+{
+	automationDirty.store(true);
+}
+
+void BinaryPluginState::writeState(MemoryBlock& destData, int currentProgram)
+{
+	ScopedLock sl(lock);
+
+	const bool headerChanged = updateHeader(currentProgram);
+	const bool controlsChanged = updateEntries();
+
+	if (dirty || headerChanged || controlsChanged)
+		rebuild();
+
+	destData.replaceWith(cachedState.getData(), cachedState.getSize());
+}
+
+void BinaryPluginState::invalidate()
+{
+	ScopedLock sl(lock);
+
+	entries.clear();
+	automationDirty.store(true);
+	dirty = true;
+}
+
+bool BinaryPluginState::updateHeader(int currentProgram)
+{
+	bool changed = false;
+
+	const int newChannelData = mc->getMainSynthChain()->getActiveChannelData()->exportData();
+	const String newUserPreset = mc->getUserPresetHandler().getCurrentlyLoadedFile().getFullPathName();
+
+	if (currentProgram != program || newChannelData != channelData || newUserPreset != userPreset)
+	{
+		program = currentProgram;
+		channelData = newChannelData;
+		userPreset = newUserPreset;
+		changed = true;
+	}
+
+	const MidiControllerAutomationHandler* handler = mc->getMacroManager().getMidiControlAutomationHandler();
+
+	// The message might not have been delivered yet if the assignment has changed just now
+	const bool automationChanged = automationDirty.exchange(false) || handler->hasPendingChangeMessage();
+
+	if (automationChanged)
+	{
+		MemoryOutputStream mos;
+		writeValueTree(mos, handler->exportAsValueTree());
+
+		if (!(mos.getMemoryBlock() == automationData))
+		{
+			automationData = mos.getMemoryBlock();
+			changed = true;
+		}
+	}
+
+	return changed;
+}
+
+bool BinaryPluginState::updateEntries()
+{
+	ModulatorSynthChain* chain = mc->getMainSynthChain();
+	Processor* midiChain = chain->getChildProcessor(ModulatorSynthChain::MidiProcessor);
+
+	bool schemaChanged = false;
+	bool valueChanged = false;
+	int index = 0;
+
+	// First pass: compare the interface controls with the cached entries
+	for (int i = 0; i < midiChain->getNumChildProcessors() && !schemaChanged; i++)
+	{
+		JavascriptMidiProcessor *sp = dynamic_cast<JavascriptMidiProcessor*>(midiChain->getChildProcessor(i));
+
+		if (sp == nullptr || !sp->isFront())
+			continue;
+
+		ScriptingApi::Content* content = sp->getScriptingContent();
+
+		for (int j = 0; j < content->getNumComponents(); j++)
+		{
+			ScriptingApi::Content::ScriptComponent* c = content->getComponent(j);
+
+			if (!c->getScriptObjectProperty(ScriptingApi::Content::ScriptComponent::Properties::saveInPreset))
+				continue;
+
+			if (index >= entries.size() || entries.getReference(index).component.get() != c || entries.getReference(index).processor != sp)
+			{
+				schemaChanged = true;
+				break;
+			}
+
+			ControlEntry& e = entries.getReference(index++);
+
+			if (!c->checkAndResetValueChangedFlag())
+				continue;
+
+			if (e.type != ValueType::ComplexValue)
+			{
+				const var v = c->getValue();
+
+				if (getValueType(v) != e.type)
+				{
+					schemaChanged = true;
+					break;
+				}
+
+				const bool equal = e.type == ValueType::StringValue ? (v.toString() == e.value.toString()) :
+																	  ((double)v == (double)e.value);
+
+				if (!equal)
+				{
+					e.value = v;
+					valueChanged = true;
+				}
+			}
+			else
+			{
+				MemoryOutputStream mos;
+				writeValueTree(mos, c->exportAsValueTree());
+
+				if (!(mos.getMemoryBlock() == e.data))
+				{
+					e.data = mos.getMemoryBlock();
+					valueChanged = true;
+				}
+			}
+		}
+	}
+
+	if (!schemaChanged && index == entries.size())
+		return valueChanged;
+
+	// The interface has changed (or this is the first call), so the schema is created from scratch
+	entries.clearQuick();
+
+	for (int i = 0; i < midiChain->getNumChildProcessors(); i++)
+	{
+		JavascriptMidiProcessor *sp = dynamic_cast<JavascriptMidiProcessor*>(midiChain->getChildProcessor(i));
+
+		if (sp == nullptr || !sp->isFront())
+			continue;
+
+		ScriptingApi::Content* content = sp->getScriptingContent();
+
+		for (int j = 0; j < content->getNumComponents(); j++)
+		{
+			ScriptingApi::Content::ScriptComponent* c = content->getComponent(j);
+
+			if (!c->getScriptObjectProperty(ScriptingApi::Content::ScriptComponent::Properties::saveInPreset))
+				continue;
+
+			ControlEntry e;
+
+			e.processor = sp;
+			e.processorId = sp->getId();
+			e.component = c;
+
+			// Everything is exported now, so the pending changes are consumed
+			c->checkAndResetValueChangedFlag();
+
+			const ValueTree exported = c->exportAsValueTree();
+
+			// Only type, id and value: the value can be stored directly
+			const bool onlyValue = exported.getNumProperties() == 3 && exported.getNumChildren() == 0;
+
+			e.type = onlyValue ? getValueType(c->getValue()) : ValueType::ComplexValue;
+
+			if (e.type != ValueType::ComplexValue)
+				e.value = c->getValue();
+			else
+			{
+				MemoryOutputStream mos;
+				writeValueTree(mos, exported);
+				e.data = mos.getMemoryBlock();
+			}
+
+			entries.add(e);
+		}
+	}
+
+	return true;
+}
+
+void BinaryPluginState::rebuild()
+{
+	MemoryOutputStream output(cachedState, false);
+
+	output.writeInt(BINARY_PLUGIN_STATE_MAGIC);
+	output.writeInt(BINARY_PLUGIN_STATE_VERSION);
+	output.writeInt(program);
+	output.writeInt(channelData);
+	output.writeString(userPreset);
+
+	// The automation data and the complex controls are already stored with their size
+	output.write(automationData.getData(), automationData.getSize());
+
+	// The schema table: every processor ID followed by the IDs and types of its controls
+	int numProcessors = 0;
+
+	for (int i = 0; i < entries.size(); i++)
+	{
+		if (i == 0 || entries.getReference(i).processor != entries.getReference(i - 1).processor)
+			numProcessors++;
+	}
+
+	output.writeInt(numProcessors);
+
+	for (int i = 0; i < entries.size();)
+	{
+		const Processor* p = entries.getReference(i).processor;
+
+		int numControls = 0;
+
+		while (i + numControls < entries.size() && entries.getReference(i + numControls).processor == p)
+			numControls++;
+
+		output.writeString(entries.getReference(i).processorId);
+		output.writeInt(numControls);
+
+		for (int j = i; j < i + numControls; j++)
+		{
+			output.writeString(entries.getReference(j).component->getName().toString());
+			output.writeString(entries.getReference(j).component->getObjectName().toString());
+		}
+
+		i += numControls;
+	}
+
+	// The values in the order of the schema table
+	for (int i = 0; i < entries.size(); i++)
+	{
+		const ControlEntry& e = entries.getReference(i);
+
+		output.writeByte((char)e.type);
+
+		switch (e.type)
+		{
+		case ValueType::DoubleValue:	output.writeDouble((double)e.value); break;
+		case ValueType::StringValue:	output.writeString(e.value.toString()); break;
+		case ValueType::ComplexValue:	output.write(e.data.getData(), e.data.getSize()); break;
+		}
+	}
+
+	output.flush();
+	cachedState.setSize(output.getDataSize());
+
+	dirty = false;
+}
+
+bool BinaryPluginState::isBinaryState(const void* data, int sizeInBytes)
+{
+	if (sizeInBytes < 8)
+		return false;
+
+	MemoryInputStream mis(data, (size_t)sizeInBytes, false);
+
+	return mis.readInt() == BINARY_PLUGIN_STATE_MAGIC;
+}
+
+ValueTree BinaryPluginState::readFromData(const void* data, int sizeInBytes)
+{
+	if (!isBinaryState(data, sizeInBytes))
+		return ValueTree::readFromData(data, (size_t)sizeInBytes);
+
+	MemoryInputStream input(data, (size_t)sizeInBytes, false);
+
+	input.readInt();
+
+	if (input.readInt() > BINARY_PLUGIN_STATE_VERSION)
+	{
+		// This state was saved with a newer version of the plugin...
+		jassertfalse;
+		return ValueTree();
+	}
+
+	ValueTree v("ControlData");
+
+	v.setProperty("Program", input.readInt(), nullptr);
+	v.setProperty("MidiChannelFilterData", input.readInt(), nullptr);
+	v.setProperty("UserPreset", input.readString(), nullptr);
+
+	ValueTree automation = readValueTree(input);
+
+	if (automation.isValid())
+		v.addChild(automation, -1, nullptr);
+
+	ValueTree interfaceData("InterfaceData");
+
+	Array<ValueTree> controls;
+
+	const int numProcessors = input.readInt();
+
+	for (int i = 0; i < numProcessors && !input.isExhausted(); i++)
+	{
+		ValueTree content("Content");
+		content.setProperty("Processor", input.readString(), nullptr);
+
+		const int numControls = input.readInt();
+
+		for (int j = 0; j < numControls && !input.isExhausted(); j++)
+		{
+			ValueTree control("Control");
+
+			control.setProperty("id", input.readString(), nullptr);
+			control.setProperty("type", input.readString(), nullptr);
+
+			content.addChild(control, -1, nullptr);
+			controls.add(control);
+		}
+
+		interfaceData.addChild(content, -1, nullptr);
+	}
+
+	for (int i = 0; i < controls.size() && !input.isExhausted(); i++)
+	{
+		switch ((ValueType)input.readByte())
+		{
+		case ValueType::DoubleValue:
+			controls.getReference(i).setProperty("value", input.readDouble(), nullptr);
+			break;
+		case ValueType::StringValue:
+			controls.getReference(i).setProperty("value", input.readString(), nullptr);
+			break;
+		case ValueType::ComplexValue:
+		{
+			ValueTree exported = readValueTree(input);
+
+			if (exported.isValid())
+				controls.getReference(i).copyPropertiesFrom(exported, nullptr);
+
+			break;
+		}
+		default:
+			// Unknown value type, the rest of the data can't be parsed...
+			jassertfalse;
+			i = controls.size();
+			break;
+		}
+	}
+
+	v.addChild(interfaceData, -1, nullptr);
+
+	return v;
+}
+
+BinaryPluginState::ValueType BinaryPluginState::getValueType(const var& value)
+{
+	if (value.isInt() || value.isInt64() || value.isDouble() || value.isBool())
+		return ValueType::DoubleValue;
+
+	if (value.isString())
+		return ValueType::StringValue;
+
+	return ValueType::ComplexValue;
+}
+
+void BinaryPluginState::writeValueTree(OutputStream& output, const ValueTree& v)
+{
+	MemoryOutputStream mos;
+	v.writeToStream(mos);
+
+	output.writeInt((int)mos.getDataSize());
+	output.write(mos.getData(), mos.getDataSize());
+}
+
+ValueTree BinaryPluginState::readValueTree(InputStream& input)
+{
+	const int numBytes = input.readInt();
+
+	if (numBytes <= 0 || numBytes > input.getNumBytesRemaining())
+		return ValueTree();
+
+	MemoryBlock mb;
+	input.readIntoMemoryBlock(mb, numBytes);
+
+	return ValueTree::readFromData(mb.getData(), mb.getSize());
+}
@@ -0,0 +1,126 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+
+#ifndef BINARYPLUGINSTATE_H_INCLUDED
+#define BINARYPLUGINSTATE_H_INCLUDED
+
+/** A compact binary format for the state of a compiled plugin.
+*
+*	The ValueTree format stores the property names and the ID of every control next to its value. This format
+*	writes a schema table (the IDs of the interface processors and their controls) once and then the values
+*	in the same order as raw doubles (or strings for labels). Controls with more data than a single value (tables, slider packs,
+*	range sliders) are stored as binary ValueTree.
+*
+*	The last serialised state is cached. writeState() only looks at the controls whose value changed flag is set
+*	(see ScriptComponent::checkAndResetValueChangedFlag()) and only exports the MIDI automation data after the
+*	automation handler has sent a change message. The state itself is only rebuilt if one of these values is
+*	actually different from the cached one.
+*
+*	readFromData() accepts both this format and the old ValueTree format and always returns a ValueTree, so that
+*	the state can be restored with the existing code.
+*/
+class BinaryPluginState : public SafeChangeListener
+{
+public:
+
+	BinaryPluginState(MainController* mc_);
+
+	~BinaryPluginState();
+
+	/** Marks the MIDI automation data as changed. */
+	void changeListenerCallback(SafeChangeBroadcaster* b) override;
+
+	/** Writes the current state into destData. The state is only rebuilt if something has changed since the last call. */
+	void writeState(MemoryBlock& destData, int currentProgram);
+
+	/** Forces a rebuild at the next call to writeState(). Call this whenever you restore a state. */
+	void invalidate();
+
+	/** Reads a state in the binary or the old ValueTree format and returns the ValueTree ("ControlData"). */
+	static ValueTree readFromData(const void* data, int sizeInBytes);
+
+	/** Checks the magic number of the data. */
+	static bool isBinaryState(const void* data, int sizeInBytes);
+
+private:
+
+	/** The type tag that is written before each value. */
+	enum class ValueType
+	{
+		ComplexValue = 0,
+		DoubleValue,
+		StringValue
+	};
+
+	struct ControlEntry
+	{
+		const Processor* processor;
+		String processorId;
+		ReferenceCountedObjectPtr<ScriptingApi::Content::ScriptComponent> component;
+		ValueType type;
+		var value;
+		MemoryBlock data;
+	};
+
+	static ValueType getValueType(const var& value);
+
+	bool updateEntries();
+
+	bool updateHeader(int currentProgram);
+
+	void rebuild();
+
+	static void writeValueTree(OutputStream& output, const ValueTree& v);
+
+	static ValueTree readValueTree(InputStream& input);
+
+	MainController* mc;
+
+	CriticalSection lock;
+
+	Array<ControlEntry> entries;
+
+	int program = -1;
+	int channelData = -1;
+	String userPreset;
+	MemoryBlock automationData;
+	std::atomic<bool> automationDirty { true };
+
+	MemoryBlock cachedState;
+	bool dirty = true;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BinaryPluginState)
+};
+
+#endif  // BINARYPLUGINSTATE_H_INCLUDED
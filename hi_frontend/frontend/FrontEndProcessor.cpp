@@ -88,6 +88,7 @@ AudioProcessorDriver(manager, callback_),
 synthChain(new ModulatorSynthChain(this, "Master Chain", NUM_POLYPHONIC_VOICES)),
 keyFileCorrectlyLoaded(true),
 currentlyLoadedProgram(0),
+binaryState(this),
 #if USE_TURBO_ACTIVATE
 unlockCounter(0),
 unlocker(TURBOACTIVATE_FILE_PATH)
@@ -165,6 +165,9 @@ public:
 
 	void getStateInformation	(MemoryBlock &destData) override
 	{
+#if USE_BINARY_PLUGIN_STATE
+		binaryState.writeState(destData, currentlyLoadedProgram);
+#else
 		MemoryOutputStream output(destData, false);
 
 		
@@ -183,11 +186,13 @@ public:
 		v.setProperty("UserPreset", getUserPresetHandler().getCurrentlyLoadedFile().getFullPathName(), nullptr);
 
 		v.writeToStream(output);
+#endif
 	};
     
     void setStateInformation(const void *data,int sizeInBytes) override
 	{
-		ValueTree v = ValueTree::readFromData(data, sizeInBytes);
+		// This also reads states that were saved with the old ValueTree format
+		ValueTree v = BinaryPluginState::readFromData(data, sizeInBytes);
 
 		currentlyLoadedProgram = v.getProperty("Program");
 
@@ -205,6 +210,8 @@ public:
 		}
 
 		synthChain->restoreInterfaceValues(v.getChildWithName("InterfaceData"));
+
+		binaryState.invalidate();
 	}
 
 	
@@ -325,6 +332,8 @@ private:
 	ScopedPointer<AudioSampleBufferPool> audioSampleBufferPool;
 
 	int currentlyLoadedProgram;
+
+	BinaryPluginState binaryState;
 	
 	int unlockCounter;
 
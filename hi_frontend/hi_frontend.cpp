@@ -34,6 +34,7 @@
 
 #include "JuceHeader.h"
 
+#include "frontend/BinaryPluginState.cpp"
 #include "frontend/FrontEndProcessor.cpp"
 #include "frontend/FrontendProcessorEditor.cpp"
 
@@ -77,6 +77,7 @@ AudioProcessor* createPlugin(ValueTree &presetData, ValueTree &imageData, ValueT
 
 using namespace juce;
 
+#include "frontend/BinaryPluginState.h"
 #include "frontend/FrontEndProcessor.h"
 #include "frontend/FrontendProcessorEditor.h"
 
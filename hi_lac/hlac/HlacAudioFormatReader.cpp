@@ -357,6 +357,21 @@ bool HlacMemoryMappedAudioFormatReader::readSamples(int** destSamples, int numDe
 }
 
 
+const int16* HlacMemoryMappedAudioFormatReader::getMappedMonolithData(int64 startSample, int numSamples) const
+{
+	if (!isMonolith || map == nullptr || !mappedSection.contains(Range<int64>(startSample, startSample + numSamples)))
+		return nullptr;
+
+	auto data = sampleToPointer(startSample);
+
+	// The sample data of a monolith starts after the one byte header, so the view
+	// might not be aligned for int16 access.
+	if ((reinterpret_cast<pointer_sized_uint>(data) & (alignof(int16) - 1)) != 0)
+		return nullptr;
+
+	return static_cast<const int16*>(data);
+}
+
 bool HlacMemoryMappedAudioFormatReader::mapSectionOfFile(Range<int64> samplesToMap)
 {
 	if (isMonolith)
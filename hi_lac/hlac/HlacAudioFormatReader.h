@@ -184,6 +184,13 @@ public:
 
 	void setTargetAudioDataType(AudioDataConverters::DataFormat dataType);
 
+	/** Returns a pointer to the mapped sample data if the file is an uncompressed monolith and the range is mapped (or nullptr otherwise).
+	*
+	*	The data of stereo files is interleaved. It also returns nullptr if the data is not aligned to a 16 bit boundary
+	*	(the sample data of a monolith starts after a one byte header, so this depends on the file offset of the mapping).
+	*/
+	const int16* getMappedMonolithData(int64 startSample, int numSamples) const;
+
 private:
 	
 	friend class HlacSubSectionReader;
@@ -84,6 +84,20 @@ public:
 		return *this;
 	}
 
+	/** Creates a read only buffer that refers to the given 16 bit data without copying it.
+	*
+	*	The data must stay valid as long as this buffer exists. Pass nullptr as rightData to create a mono buffer.
+	*/
+	HiseSampleBuffer(const int16* leftData, const int16* rightData, int numSamples) :
+		isFloat(false),
+		leftIntBuffer(leftData, numSamples),
+		rightIntBuffer(rightData, rightData != nullptr ? numSamples : 0),
+		numChannels(rightData != nullptr ? 2 : 1),
+		size(numSamples)
+	{
+
+	}
+
 	/** Creates a HiseSampleBuffer from an existing AudioSampleBuffer. */
 	HiseSampleBuffer(AudioSampleBuffer& floatBuffer_):
 		isFloat(true),
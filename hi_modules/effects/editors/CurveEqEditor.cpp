@@ -223,17 +223,8 @@ void CurveEqEditor::buttonClicked (Button* buttonThatWasClicked)
 	{
 		const bool on = fftEnableButton->getToggleState();
 
-		if(on)
-		{
-			dragOverlay->startTimer(30);
-			fftRangeSlider->setEnabled(true);
-		}
-		else
-		{
-			dragOverlay->stopTimer();
-			fftRangeSlider->setEnabled(false);
-			dragOverlay->clearFFTDisplay();
-		}
+		dragOverlay->setFFTEnabled(on);
+		fftRangeSlider->setEnabled(on);
 
 		fftEnableButton->setColours(Colours::white.withAlpha(on ? 1.0f : 0.5f), Colours::white.withAlpha(0.7f), Colours::white.withAlpha(0.7f));
 
@@ -436,13 +427,46 @@ void FilterDragOverlay::selectDragger(int index)
 
 }
 
+void FilterDragOverlay::setFFTEnabled(bool shouldBeEnabled)
+{
+	if (shouldBeEnabled && eq != nullptr)
+	{
+		FloatVectorOperations::clear(analysisBuffer, FFT_SIZE_FOR_EQ);
+		fftReader = new AnalyserTap::Reader(eq->getFFTTap());
+		startTimer(30);
+	}
+	else
+	{
+		stopTimer();
+		fftReader = nullptr;
+		clearFFTDisplay();
+	}
+}
+
 void FilterDragOverlay::timerCallback()
 {
-	const double *d = eq->getExternalData();
+	if (fftReader == nullptr || fftReader->getTap() == nullptr)
+		return;
+
+	AnalyserTap& tap = *fftReader->getTap();
+
+	const int numNewSamples = tap.getNumAvailableSamples();
+
+	if (numNewSamples >= FFT_SIZE_FOR_EQ)
+	{
+		// Skip everything that doesn't fit into the analysis window
+		tap.popSamples(analysisBuffer, numNewSamples - FFT_SIZE_FOR_EQ);
+		tap.popSamples(analysisBuffer, FFT_SIZE_FOR_EQ);
+	}
+	else if (numNewSamples > 0)
+	{
+		memmove(analysisBuffer, analysisBuffer + numNewSamples, sizeof(float) * (FFT_SIZE_FOR_EQ - numNewSamples));
+		tap.popSamples(analysisBuffer + FFT_SIZE_FOR_EQ - numNewSamples, numNewSamples);
+	}
 
-	const double max = FloatVectorOperations::findMaximum(d, FFT_SIZE_FOR_EQ);
+	const Range<float> range = FloatVectorOperations::findMinAndMax(analysisBuffer, FFT_SIZE_FOR_EQ);
 
-	if(max == 0)
+	if(numNewSamples == 0 || (range.getStart() == 0.0f && range.getEnd() == 0.0f))
 	{
 		FloatVectorOperations::clear(gainValues, FFT_SIZE_FOR_EQ);
 
@@ -467,12 +491,12 @@ void FilterDragOverlay::timerCallback()
 
 	for(int i = 0; i < half; i++)
 	{
-		fftData[i] = std::complex<double>(d[i] * (double)i / (double)(half), 0.0);
+		fftData[i] = std::complex<double>((double)analysisBuffer[i] * (double)i / (double)(half), 0.0);
 	}
 
 	for(int i = half; i < size; i++)
 	{
-		fftData[i] = std::complex<double>(d[i] * (1.0 - (double)(i - half) / (double)half), 0.0);
+		fftData[i] = std::complex<double>((double)analysisBuffer[i] * (1.0 - (double)(i - half) / (double)half), 0.0);
 	}
 
 	DustFFT_fwdD(reinterpret_cast<double*>(fftData), size);
@@ -256,6 +256,7 @@ class FilterDragOverlay: public Component,
 public:
 
 	FilterDragOverlay():
+		eq(nullptr),
 		fftRange(-80)
 	{
 		constrainer = new ComponentBoundsConstrainer();
@@ -273,6 +274,7 @@ public:
 	~FilterDragOverlay()
 	{
 		stopTimer();
+		fftReader = nullptr;
 	}
 
 	void clearFFTDisplay()
@@ -281,6 +283,9 @@ public:
 		repaint();
 	}
 
+	/** Connects to the FFT tap of the EQ and starts the analysis of its output signal. */
+	void setFFTEnabled(bool shouldBeEnabled);
+
 	void timerCallback() override;
 
 	void paint(Graphics &g);
@@ -451,6 +456,10 @@ private:
 
 	double fftRange;
 
+	ScopedPointer<AnalyserTap::Reader> fftReader;
+
+	float analysisBuffer[FFT_SIZE_FOR_EQ];
+
 	std::complex<double> fftData[FFT_SIZE_FOR_EQ];
 
 	double fftAmpData[FFT_SIZE_FOR_EQ];
@@ -205,7 +205,7 @@ public:
 
 	CurveEq(MainController *mc, const String &id):
 		MasterEffectProcessor(mc, id),
-		fftBufferIndex(0)
+		fftTap(FFT_SIZE_FOR_EQ * 2)
 	{
 		parameterNames.add("Gain");
 		parameterNames.add("Freq");
@@ -213,8 +213,6 @@ public:
 		parameterNames.add("Enabled");
 		parameterNames.add("Type");
 		parameterNames.add("BandOffset");
-
-		FloatVectorOperations::fill(fftData, 0.0f, 256);
 	};
 
 	int getParameterIndex(int filterIndex, int parameterType) const
@@ -233,16 +231,7 @@ public:
 			filterBands[i]->process(buffer, startSample, numSamples);
 		}
 
-		if(fftBufferIndex < FFT_SIZE_FOR_EQ)
-		{
-			const int numSamplesToCopy = jmin<int>(numSamples, FFT_SIZE_FOR_EQ - fftBufferIndex);
-
-			FloatVectorOperations::copyWithMultiply(fftData + fftBufferIndex, buffer.getReadPointer(0, startSample), 0.5f, numSamplesToCopy);
-			FloatVectorOperations::addWithMultiply(fftData + fftBufferIndex, buffer.getReadPointer(1, startSample), 0.5f, numSamplesToCopy);
-
-			fftBufferIndex += numSamplesToCopy;
-
-		}
+		fftTap.pushStereoSamples(buffer.getReadPointer(0, startSample), buffer.getReadPointer(1, startSample), numSamples);
 	};
 
 	IIRCoefficients getCoefficients(int filterIndex)
@@ -362,19 +351,8 @@ public:
 		double padding;
 	};
 
-	const double *getExternalData()
-	{
-		ScopedLock sl(getLock());
-
-		for(int i = 0; i < FFT_SIZE_FOR_EQ; i++)
-		{
-			externalFftData[i] = (float)fftData[i];
-		}
-
-		fftBufferIndex = 0;
-
-		return externalFftData;
-	};
+	/** Returns the tap that sends the output signal to the FFT display. The FFT is calculated by the editor. */
+	AnalyserTap& getFFTTap() { return fftTap; }
 
 	bool hasTail() const override {return false;};
 
@@ -390,11 +368,7 @@ private:
 
 	const CriticalSection& getLock() const { return getMainController()->getLock(); }
 
-	float fftData[FFT_SIZE_FOR_EQ];
-
-	double externalFftData[FFT_SIZE_FOR_EQ];
-
-	int fftBufferIndex;
+	AnalyserTap fftTap;
 
 	OwnedArray<StereoFilter> filterBands;
 
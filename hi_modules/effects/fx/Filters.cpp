@@ -504,6 +504,29 @@ void PolyFilterEffect::prepareToPlay(double sampleRate, int samplesPerBlock)
 	}
 }
 
+void PolyFilterEffect::setVoiceAmount(int newVoiceAmount)
+{
+	VoiceEffectProcessor::setVoiceAmount(newVoiceAmount);
+
+	for (int i = voiceFilters.size(); i < newVoiceAmount; i++)
+	{
+		MonoFilterEffect* newFilter = new MonoFilterEffect(getMainController(), getId() + String(i));
+
+		newFilter->setUseInternalChains(false);
+		newFilter->setMode((int)mode);
+
+		if (getSampleRate() > 0)
+			newFilter->prepareToPlay(getSampleRate(), getBlockSize());
+
+		voiceFilters.add(newFilter);
+	}
+
+	if (newVoiceAmount < voiceFilters.size())
+		voiceFilters.removeRange(newVoiceAmount, voiceFilters.size() - newVoiceAmount);
+
+	changeFlag = true;
+}
+
 ProcessorEditorBody *PolyFilterEffect::createEditor(ProcessorEditor *parentEditor)
 {
 #if USE_BACKEND
@@ -1049,6 +1049,8 @@ public:
 	AudioSampleBuffer & getBufferForChain(int index);;
 
 	void prepareToPlay(double sampleRate, int samplesPerBlock) override;;
+	/** Creates or removes the filters for the voices. */
+	void setVoiceAmount(int newVoiceAmount) override;
 	void renderNextBlock(AudioSampleBuffer &/*b*/, int /*startSample*/, int /*numSample*/) { }
 	/** Calculates the frequency chain and sets the q to the current value. */
 	void preVoiceRendering(int voiceIndex, int startSample, int numSamples);
@@ -163,6 +163,25 @@ void HarmonicFilter::setSemitoneTranspose(float newValue)
 	semiToneTranspose = (int)newValue;	
 }
 
+void HarmonicFilter::setVoiceAmount(int newVoiceAmount)
+{
+	VoiceEffectProcessor::setVoiceAmount(newVoiceAmount);
+
+	numVoices = newVoiceAmount;
+
+	for (int i = 0; i < harmonicFilters.size(); i++)
+	{
+		PolyFilterEffect *poly = harmonicFilters[i];
+
+		poly->setVoiceAmount(newVoiceAmount);
+
+		for (int j = 0; j < numVoices; j++)
+		{
+			poly->voiceFilters[j]->setUseFixedFrequency(true);
+		}
+	}
+}
+
 void HarmonicFilter::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
 	VoiceEffectProcessor::prepareToPlay(sampleRate, samplesPerBlock);
@@ -114,6 +114,7 @@ public:
 
 	bool hasTail() const override { return true; };
 	void prepareToPlay(double sampleRate, int samplesPerBlock) override;;
+	void setVoiceAmount(int newVoiceAmount) override;
 	void renderNextBlock(AudioSampleBuffer &/*b*/, int /*startSample*/, int /*numSample*/) {}
 	/** Calculates the frequency chain and sets the q to the current value. */
 	void preVoiceRendering(int voiceIndex, int startSample, int numSamples);
@@ -134,7 +135,7 @@ private:
 	int filterBandIndex;
 	float currentCrossfadeValue;
 	int semiToneTranspose;
-	const int numVoices;
+	int numVoices;
 	float q;
 
 	ScopedPointer<SliderPackData> dataA;
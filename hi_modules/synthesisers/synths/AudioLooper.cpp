@@ -171,13 +171,18 @@ rootNote(64)
 
 	for (int i = 0; i < numVoices; i++)
 	{
-		addVoice(new AudioLooperVoice(this));
+		addVoice(createVoice());
 
 	}
 
 	addSound(new AudioLooperSound());
 }
 
+ModulatorSynthVoice* AudioLooper::createVoice()
+{
+	return new AudioLooperVoice(this);
+}
+
 void AudioLooper::restoreFromValueTree(const ValueTree &v)
 {
 	ModulatorSynth::restoreFromValueTree(v);
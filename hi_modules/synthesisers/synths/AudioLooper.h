@@ -93,6 +93,8 @@ public:
 
 	ValueTree exportAsValueTree() const override;
 
+	ModulatorSynthVoice* createVoice() override;
+
 	void tempoChanged(double /*newTempo*/) override
 	{
 		setSyncMode(syncMode);
@@ -108,9 +108,11 @@ public:
 	NoiseSynth(MainController *mc, const String &id, int numVoices):
 		ModulatorSynth(mc, id, numVoices)
 	{
-		for(int i = 0; i < numVoices; i++) addVoice(new NoiseVoice(this));
+		for(int i = 0; i < numVoices; i++) addVoice(createVoice());
 		addSound (new NoiseSound());	
 	};
 
+	ModulatorSynthVoice* createVoice() override { return new NoiseVoice(this); }
+
 	ProcessorEditorBody* createEditor(ProcessorEditor *parentEditor) override;
 };
\ No newline at end of file
@@ -132,10 +132,12 @@ public:
 		parameterNames.add("FineFreqRatio");
 		parameterNames.add("SaturationAmount");
 
-		for(int i = 0; i < numVoices; i++) addVoice(new SineSynthVoice(this));
+		for(int i = 0; i < numVoices; i++) addVoice(createVoice());
 		addSound (new SineWaveSound());	
 	};
 
+	ModulatorSynthVoice* createVoice() override { return new SineSynthVoice(this); }
+
 	void restoreFromValueTree(const ValueTree &v) override
 	{
 		ModulatorSynth::restoreFromValueTree(v);
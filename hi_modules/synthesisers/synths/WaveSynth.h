@@ -331,10 +331,12 @@ public:
 
 		mixChain->setColour(Colour(0xff4D54B3));
 
-		for(int i = 0; i < numVoices; i++) addVoice(new WaveSynthVoice(this));
+		for(int i = 0; i < numVoices; i++) addVoice(createVoice());
 		addSound (new WaveSound());	
 	};
 
+	ModulatorSynthVoice* createVoice() override { return new WaveSynthVoice(this); }
+
 	void restoreFromValueTree(const ValueTree &v) override
 	{
 		ModulatorSynth::restoreFromValueTree(v);
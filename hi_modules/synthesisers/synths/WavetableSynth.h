@@ -680,7 +680,7 @@ public:
 		parameterNames.add("HqMode");
 		editorStateIdentifiers.add("TableIndexChainShown");
 
-		for(int i = 0; i < numVoices; i++) addVoice(new WavetableSynthVoice(this));
+		for(int i = 0; i < numVoices; i++) addVoice(createVoice());
 		
 		tableIndexChain->setColour(Colour(0xff4D54B3));
 
@@ -694,6 +694,8 @@ public:
 
 	};
 
+	ModulatorSynthVoice* createVoice() override { return new WavetableSynthVoice(this); }
+
 	void loadWaveTable()
 	{
 		clearSounds();
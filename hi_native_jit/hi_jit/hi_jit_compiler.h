@@ -12,6 +12,6 @@
 #define HI_NATIVE_JIT_H_INCLUDED
 
 
-#include "hi_native_jit_public.h"
+#include "../hi_native_jit_public.h"
 
 #endif  // HI_NATIVE_JIT_H_INCLUDED
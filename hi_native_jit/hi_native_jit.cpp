@@ -1,3 +1,8 @@
+#include "AppConfig.h"
+
+// HISE projects only need this module if the scripting engine uses NativeJIT (see INCLUDE_NATIVE_JIT in hi_scripting.h)
+#if ! JUCE_MODULE_AVAILABLE_hi_scripting || INCLUDE_NATIVE_JIT
+
 
 #ifndef HI_NATIVEJIT_INCLUDED
 #define HI_NATIVEJIT_INCLUDED
@@ -108,4 +113,6 @@ namespace juce
 
 #ifdef HI_CORE_INCLUDED
 #error "Don't include hi_core"
-#endif
\ No newline at end of file
+#endif
+
+#endif // ! JUCE_MODULE_AVAILABLE_hi_scripting || INCLUDE_NATIVE_JIT
@@ -232,14 +232,15 @@ public:
 
 	void enableOverflowCheck(bool shouldCheckForOverflow);
 
+	/** Returns true if the code was compiled and defines all functions. */
+	bool allOK() const;
+
 private:
 
 	typedef float(*processFunction)(float);
 	typedef int(*initFunction)();
 	typedef int(*prepareFunction)(double, int);
 
-	bool allOK() const;
-
 	NativeJITScope::Ptr scope;
 
 	processFunction pf = nullptr;
@@ -34,6 +34,12 @@
 
 #include "JuceHeader.h"
 
+#if JUCE_LINUX || JUCE_MAC || JUCE_IOS
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "sampler/MonolithPeakCache.cpp"
 #include "sampler/MonolithAudioFormat.cpp"
 #include "sampler/StreamingSampler.cpp"
 
@@ -54,6 +54,7 @@ END_JUCE_MODULE_DECLARATION
 #include "../hi_components/hi_components.h"
 #include "../hi_dsp_library/hi_dsp_library.h"
 
+#include "sampler/MonolithPeakCache.h"
 #include "sampler/MonolithAudioFormat.h"
 
 #include "sampler/StreamingSampler.h"
@@ -40,6 +40,7 @@ soundCache(new AudioThumbnailCache(512)),
 sampleStartChain(new ModulatorChain(mc, "Sample Start", numVoices, Modulation::GainMode, this)),
 crossFadeChain(new ModulatorChain(mc, "Group Fade", numVoices, Modulation::GainMode, this)),
 sampleMap(new SampleMap(this)),
+soundIndex(this),
 rrGroupAmount(1),
 bufferSize(4096),
 preloadScaleFactor(1),
@@ -59,6 +60,10 @@ temporaryVoiceBuffer(true, 2, 0)
 	sampleEditHandler = new SampleEditHandler(this);
 #endif
 
+#if ENABLE_LAZY_SAMPLE_PRELOADING
+	warmUpThread = new SampleWarmUpThread(this);
+#endif
+
 	crossfadeBuffer = AudioSampleBuffer(1, 0);
 	
 
@@ -448,6 +453,10 @@ void ModulatorSampler::refreshStreamingBuffers()
 
 void ModulatorSampler::deleteSound(ModulatorSamplerSound *s)
 {
+#if ENABLE_LAZY_SAMPLE_PRELOADING
+	warmUpThread->cancelWarmUp();
+#endif
+
 	ScopedLock sl(getMainController()->getLock());
 
 	allNotesOff(1, false);
@@ -476,6 +485,10 @@ void ModulatorSampler::deleteSound(ModulatorSamplerSound *s)
     {
         static_cast<ModulatorSamplerSound*>(sounds[i].get())->setNewIndex(i);
     }
+
+#if ENABLE_LAZY_SAMPLE_PRELOADING
+	warmUpThread->resumeWarmUp();
+#endif
     
 	sendChangeMessage();
 }
@@ -484,6 +497,10 @@ void ModulatorSampler::deleteAllSounds()
 {
 	//ReferenceCountedArray<ModulatorSamplerSound> savedSounds(sounds);
 
+#if ENABLE_LAZY_SAMPLE_PRELOADING
+	warmUpThread->cancelWarmUp();
+#endif
+
 	ScopedLock sl(getMainController()->getLock());
 
 	for (int i = 0; i < voices.size(); i++)
@@ -516,10 +533,29 @@ void ModulatorSampler::refreshPreloadSizes()
 {
 	if (!getMainController()->getSampleManager().shouldSkipPreloading() &&  getNumSounds() != 0)
 	{
+#if ENABLE_LAZY_SAMPLE_PRELOADING
+
+		// Reversing needs the entire sample, so this still has to block
+		if (!reversed && !purged)
+		{
+			warmUpThread->startWarmUp();
+			return;
+		}
+#endif
+
 		new SoundPreloadThread(this);
 	}
 }
 
+void ModulatorSampler::requestWarmUp(ModulatorSamplerSound* s) noexcept
+{
+#if ENABLE_LAZY_SAMPLE_PRELOADING
+	warmUpThread->requestWarmUp(s);
+#else
+	ignoreUnused(s);
+#endif
+}
+
 double ModulatorSampler::getDiskUsage()
 {
     double diskUsage = 0.0;
@@ -554,11 +590,14 @@ void ModulatorSampler::refreshMemoryUsage()
 
 	int64 actualPreloadSize = 0;
 
+	// Shared preload buffers must only be counted once
+	SortedSet<const SharedPreloadBuffer*> countedBuffers;
+
 	for (int i = 0; i < getNumSounds(); i++)
 	{
 		for (int j = 0; j < numChannels; j++)
 		{
-			actualPreloadSize += getSound(i)->getReferenceToSound(j)->getActualPreloadSize();
+			actualPreloadSize += getSound(i)->getReferenceToSound(j)->getActualPreloadSize(countedBuffers);
 		}
 		
 	}
@@ -585,7 +624,7 @@ void ModulatorSampler::setVoiceAmount(int newVoiceAmount)
 	{
 		ScopedLock sl(isOnAir() ? getSynthLock() : getDummyLockWhenNotOnAir());
 
-		voiceAmount = jmin<int>(NUM_POLYPHONIC_VOICES, newVoiceAmount);
+		voiceAmount = jmin<int>(NUM_MAX_POLYPHONIC_VOICES, newVoiceAmount);
 
 		if (getAttribute(ModulatorSynth::VoiceLimit) > voiceAmount)
 		{
@@ -615,6 +654,12 @@ void ModulatorSampler::setVoiceAmount(int newVoiceAmount)
 			}
 		};
 
+		resizeVoiceStorage();
+
+		// All voices were killed, so the per voice modulation data can be rebuilt with the new voice amount
+		if (Processor::getSampleRate() != -1.0)
+			updateModulationArena(getBlockSize());
+
 		setKillFadeOutTime((int)getAttribute(ModulatorSynth::KillFadeTime)); 
 
 		refreshMemoryUsage();
@@ -718,6 +763,27 @@ void ModulatorSampler::addSamplerSounds(OwnedArray<ModulatorSamplerSound>& monol
 	sendChangeMessage();
 }
 
+void ModulatorSampler::addCreatedSamplerSound(ModulatorSamplerSound* newSound, const StreamingSamplerSoundArray& newSamples)
+{
+	ModulatorSamplerSoundPool *pool = getMainController()->getSampleManager().getModulatorSamplerSoundPool();
+
+	newSound->setUndoManager(getMainController()->getControlUndoManager());
+	newSound->setMaxRRGroupIndex(rrGroupAmount);
+
+	{
+		ScopedLock sl(getMainController()->getLock());
+
+		newSound->setNewIndex(sounds.size());
+
+		pool->addSamplesToPool(newSamples);
+		sounds.add(newSound);
+	}
+
+	newSound->addChangeListener(sampleMap);
+
+	sendChangeMessage();
+}
+
 SampleThreadPool * ModulatorSampler::getBackgroundThreadPool()
 {
 	return getMainController()->getSampleManager().getGlobalSampleThreadPool();
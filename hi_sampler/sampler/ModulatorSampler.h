@@ -71,7 +71,7 @@ public:
 	{
 		PreloadSize = ModulatorSynth::numModulatorSynthParameters, ///< -1 ... **11000** ... | The preload size in samples for all samples that are loaded into the sampler. If the preload size is `-1`, then the whole sample will be loaded into memory.
 		BufferSize, ///< 0 ... **4096** ... | The buffer size of the streaming buffers (2 per voice) in samples. The sampler uses two buffers which are swapped (one is used for reading from disk and one is used to supply the sampler with the audio data)
-		VoiceAmount, ///< 0 ... **64** | The amount of voices that the sampler can play. This is not the same as voice limit.
+		VoiceAmount, ///< 0 ... **64** ... 512 | The amount of voices that the sampler can play. This is not the same as voice limit.
 		RRGroupAmount, ///< **0** ... x | The number of groups that are cycled in a round robin manier.
 		SamplerRepeatMode, ///< **Kill Note**, Note off, Do nothing | determines how the sampler treats repeated notes.
 		PitchTracking, ///< **On**, Off | Enables pitch ratio modification for different notes than the root note. Disable this for drum samples.
@@ -129,6 +129,9 @@ public:
 	const ModulatorSamplerSound *getSound(int soundIndex) const;
 	ModulatorSamplerSound *getSound(int soundIndex);
 
+	/** Returns the index that can be used to select sounds based on their mapping and file name. */
+	SamplerSoundIndex& getSoundIndex() { return soundIndex; }
+
 	Processor *getChildProcessor(int processorIndex) override;;
 	const Processor *getChildProcessor(int processorIndex) const override;;
 	int getNumChildProcessors() const override { return numInternalChains;	};
@@ -162,6 +165,12 @@ public:
 	*	This is the actual loading process, so it is put into a seperate thread with a progress window. */
 	void refreshPreloadSizes();
 
+	/** Moves the sound to the front of the lazy preloading queue.
+	*
+	*	This is called by the voices when they start a sound that isn't preloaded yet. It does nothing if ENABLE_LAZY_SAMPLE_PRELOADING is disabled.
+	*/
+	void requestWarmUp(ModulatorSamplerSound* s) noexcept;
+
 	/** Returns the time spent reading samples from disk. */
 	double getDiskUsage();
 
@@ -187,10 +196,10 @@ public:
 
 	/** Allows dynamically changing the voice amount.
 	*
-	*	This is a ModulatorSampler specific function, because all other synths can have the full voice amount with almost no overhead,
-	*	but since every ModulatorSamplerVoice has two streaming buffers, it could add up wasting unnecessary memory.
+	*	The sampler overwrites this because its voices depend on the mic positions and need streaming buffers. 
+	*	Every ModulatorSamplerVoice has two streaming buffers, so unused voices could add up wasting memory.
 	*/
-	void setVoiceAmount(int newVoiceAmount);
+	void setVoiceAmount(int newVoiceAmount) override;
 
 	
 
@@ -213,6 +222,12 @@ public:
 
 	void addSamplerSounds(OwnedArray<ModulatorSamplerSound>& monolithicSounds);
 
+	/** Adds a sound that was created with ModulatorSamplerSoundPool::createSoundWithoutPool() after the last sound.
+	*
+	*	The sound should be fully initialised, because only the insertion is done under the lock.
+	*/
+	void addCreatedSamplerSound(ModulatorSamplerSound* newSound, const StreamingSamplerSoundArray& newSamples);
+
 	void renderNextBlockWithModulators(AudioSampleBuffer& outputAudio, const HiseEventBuffer& inputMidi) override
 	{
 		if (purged)
@@ -575,6 +590,8 @@ private:
 
 	RoundRobinMap roundRobinMap;
 
+	SamplerSoundIndex soundIndex;
+
 	bool reversed;
 
 	bool useGlobalFolder;
@@ -615,6 +632,10 @@ private:
 	ScopedPointer<ModulatorChain> sampleStartChain;
 	ScopedPointer<ModulatorChain> crossFadeChain;
 	ScopedPointer<AudioThumbnailCache> soundCache;
+
+#if ENABLE_LAZY_SAMPLE_PRELOADING
+	ScopedPointer<SampleWarmUpThread> warmUpThread;
+#endif
 	
 #if USE_BACKEND
 	ScopedPointer<SampleEditHandler> sampleEditHandler;
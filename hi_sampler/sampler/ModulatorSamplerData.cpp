@@ -30,6 +30,7 @@
 *   ===========================================================================
 */
 
+#include <regex>
 
 SoundPreloadThread::SoundPreloadThread(ModulatorSampler *s) :
 ThreadWithQuasiModalProgressWindow("Loading Sample Data", true, true, s->getMainController(), 10000, "Abort loading"),
@@ -169,6 +170,192 @@ void SoundPreloadThread::preloadSample(StreamingSamplerSound * s, const int prel
 	}
 }
 
+SampleWarmUpThread::SampleWarmUpThread(ModulatorSampler* s) :
+	Thread("Sample Warm Up Thread"),
+	sampler(s),
+	requestQueue(512)
+{
+
+}
+
+SampleWarmUpThread::~SampleWarmUpThread()
+{
+	cancelWarmUp();
+}
+
+void SampleWarmUpThread::startWarmUp()
+{
+	cancelWarmUp();
+
+	{
+		// The playing voices keep a reference to the old preload buffers, so they don't need to be stopped
+		ScopedLock sl(sampler->getMainController()->getLock());
+
+		for (int i = 0; i < sampler->getNumSounds(); i++)
+		{
+			ModulatorSamplerSound* s = sampler->getSound(i);
+
+			for (int j = 0; j < sampler->getNumMicPositions(); j++)
+			{
+				if (StreamingSamplerSound* ss = s->getReferenceToSound(j))
+					ss->markAsNotPreloaded();
+			}
+		}
+	}
+
+	resumeWarmUp();
+}
+
+void SampleWarmUpThread::resumeWarmUp()
+{
+	cancelWarmUp();
+
+	{
+		ScopedLock sl(sampler->getMainController()->getLock());
+
+		for (int i = 0; i < sampler->getNumSounds(); i++)
+		{
+			ModulatorSamplerSound* s = sampler->getSound(i);
+
+			if (s != nullptr && !isWarm(s))
+				soundsToWarmUp.add(s);
+		}
+	}
+
+	if (soundsToWarmUp.size() == 0)
+		return;
+
+	PlayProbabilitySorter sorter;
+	soundsToWarmUp.sort(sorter, true);
+
+	ModulatorSamplerSound* staleRequest;
+
+	while (requestQueue.try_dequeue(staleRequest))
+		;
+
+	startThread(3);
+}
+
+void SampleWarmUpThread::cancelWarmUp()
+{
+	stopThread(5000);
+
+	soundsToWarmUp.clear();
+}
+
+void SampleWarmUpThread::requestWarmUp(ModulatorSamplerSound* s) noexcept
+{
+	if (isThreadRunning())
+		requestQueue.try_enqueue(s);
+}
+
+void SampleWarmUpThread::run()
+{
+	const int preloadSize = (int)sampler->getAttribute(ModulatorSampler::PreloadSize) * sampler->getPreloadScaleFactor();
+
+	int nextIndex = 0;
+
+	while (!threadShouldExit())
+	{
+		ModulatorSamplerSound* s = nullptr;
+
+		if (!requestQueue.try_dequeue(s))
+		{
+			if (nextIndex >= soundsToWarmUp.size())
+				break;
+
+			s = soundsToWarmUp.getUnchecked(nextIndex++).get();
+		}
+
+		if (!isWarm(s))
+			warmUpSound(s, preloadSize);
+	}
+
+	if (!threadShouldExit())
+	{
+		// Delete the buffers that were still used by a voice when they were replaced
+		for (int i = 0; i < soundsToWarmUp.size(); i++)
+		{
+			for (int j = 0; j < sampler->getNumMicPositions(); j++)
+			{
+				if (StreamingSamplerSound* ss = soundsToWarmUp[i]->getReferenceToSound(j))
+					ss->releaseRetiredPreloadBuffers();
+			}
+		}
+
+		sampler->refreshMemoryUsage();
+		soundsToWarmUp.clear();
+	}
+}
+
+bool SampleWarmUpThread::isWarm(const ModulatorSamplerSound* s) const
+{
+	for (int j = 0; j < sampler->getNumMicPositions(); j++)
+	{
+		const StreamingSamplerSound* ss = s->getReferenceToSound(j);
+
+		const bool isEnabled = sampler->getNumMicPositions() == 1 || sampler->getChannelData(j).enabled;
+
+		if (ss != nullptr && isEnabled && !ss->isPreloaded())
+			return false;
+	}
+
+	return true;
+}
+
+void SampleWarmUpThread::warmUpSound(ModulatorSamplerSound* s, int preloadSize)
+{
+	s->checkFileReference();
+
+	for (int j = 0; j < sampler->getNumMicPositions(); j++)
+	{
+		StreamingSamplerSound* ss = s->getReferenceToSound(j);
+
+		if (ss == nullptr)
+			continue;
+
+		const bool isEnabled = sampler->getNumMicPositions() == 1 || sampler->getChannelData(j).enabled;
+
+		if (!isEnabled)
+		{
+			ss->setPurged(true);
+			continue;
+		}
+
+		try
+		{
+			// The sound is loaded in the background, but the new buffer is swapped in under the audio lock
+			// (like the sampler does when it changes the preload size), so no voice starts in between.
+			ss->setPreloadSize(ss->hasActiveState() ? preloadSize : 0, true, &sampler->getMainController()->getLock());
+			ss->closeFileHandle();
+		}
+		catch (StreamingSamplerSound::LoadingError l)
+		{
+			String x;
+			x << "Error at preloading sample " << l.fileName << ": " << l.errorDescription;
+			sampler->getMainController()->getDebugLogger().logMessage(x);
+
+			debugError(sampler, x);
+		}
+	}
+}
+
+int SampleWarmUpThread::PlayProbabilitySorter::compareElements(ModulatorSamplerSound* first, ModulatorSamplerSound* second) const
+{
+	return getScore(first) - getScore(second);
+}
+
+int SampleWarmUpThread::PlayProbabilitySorter::getScore(const ModulatorSamplerSound* s)
+{
+	const int keyCenter = ((int)s->getProperty(ModulatorSamplerSound::KeyLow) + (int)s->getProperty(ModulatorSamplerSound::KeyHigh)) / 2;
+	const int veloCenter = ((int)s->getProperty(ModulatorSamplerSound::VeloLow) + (int)s->getProperty(ModulatorSamplerSound::VeloHigh)) / 2;
+	const int rrGroup = jmax<int>(1, (int)s->getProperty(ModulatorSamplerSound::RRGroup));
+
+	// The distance to the middle of the keyboard is the most important factor,
+	// then the round robin group and then the distance to a medium-loud velocity
+	return std::abs(keyCenter - 60) * 64 + jmin<int>(rrGroup - 1, 7) * 8 + std::abs(veloCenter - 96) / 16;
+}
+
 ThumbnailHandler::ThumbnailHandler(const File &directoryToLoad, const StringArray &fileNames, ModulatorSampler *s) :
 ThreadWithQuasiModalProgressWindow("Generating Audio Thumbnails for " + String(fileNames.size()) + " files.", true, true, s->getMainController()),
 fileNamesToLoad(fileNames),
@@ -898,6 +1085,257 @@ int RoundRobinMap::getRRGroupsForMessage(int noteNumber, int velocity)
 	
 }
 
+SamplerSoundIndex::Query::Query():
+	keyRange(0, 128),
+	velocityRange(0, 128),
+	rrGroup(-1)
+{
+
+}
+
+SamplerSoundIndex::Query SamplerSoundIndex::Query::fromVar(const var& queryObject)
+{
+	Query q;
+
+	const var keyRange = queryObject.getProperty("KeyRange", var());
+
+	if (keyRange.isArray() && keyRange.size() == 2)
+		q.keyRange = Range<int>((int)keyRange[0], (int)keyRange[1] + 1);
+
+	const var velocityRange = queryObject.getProperty("VelocityRange", var());
+
+	if (velocityRange.isArray() && velocityRange.size() == 2)
+		q.velocityRange = Range<int>((int)velocityRange[0], (int)velocityRange[1] + 1);
+
+	q.rrGroup = (int)queryObject.getProperty("RRGroup", -1);
+
+	const var tokens = queryObject.getProperty("Tokens", var());
+
+	if (tokens.isArray())
+	{
+		for (int i = 0; i < tokens.size(); i++)
+			q.tokens.add(tokens[i].toString().toLowerCase());
+	}
+	else if (tokens.isString())
+	{
+		tokenise(tokens.toString(), q.tokens);
+	}
+
+	q.mic = queryObject.getProperty("Mic", "").toString();
+
+	q.tokens.removeDuplicates(false);
+
+	return q;
+}
+
+SamplerSoundIndex::SamplerSoundIndex(ModulatorSampler* sampler_) :
+	sampler(sampler_),
+	version(-1)
+{
+
+}
+
+void SamplerSoundIndex::query(const Query& q, Array<ModulatorSamplerSound*>& result)
+{
+	ScopedLock sl(lock);
+
+	rebuildIfNecessary();
+
+	int micIndex = -1;
+
+	if (q.mic.isNotEmpty())
+	{
+		micIndex = getMicIndex(q.mic);
+
+		if (micIndex == -1)
+			return;
+	}
+
+	if (q.tokens.size() == 0)
+	{
+		for (int i = 0; i < entries.size(); i++)
+		{
+			const Entry& e = entries.getReference(i);
+
+			if (matches(e, q, micIndex))
+				result.add(e.sound);
+		}
+
+		return;
+	}
+
+	// Start with the shortest list of sounds and check the other tokens using a binary search
+
+	Array<const Array<int>*> lists;
+
+	for (int i = 0; i < q.tokens.size(); i++)
+	{
+		if (!tokenIndexes.contains(q.tokens[i]))
+			return;
+
+		const Array<int>* list = &soundsForToken.getReference(tokenIndexes[q.tokens[i]]);
+
+		if (lists.size() > 0 && list->size() < lists.getFirst()->size())
+			lists.insert(0, list);
+		else
+			lists.add(list);
+	}
+
+	const Array<int>& shortestList = *lists.getFirst();
+
+	DefaultElementComparator<int> comparator;
+
+	for (int i = 0; i < shortestList.size(); i++)
+	{
+		const int index = shortestList.getUnchecked(i);
+
+		bool containsAllTokens = true;
+
+		for (int j = 1; j < lists.size(); j++)
+		{
+			if (lists[j]->indexOfSorted(comparator, index) == -1)
+			{
+				containsAllTokens = false;
+				break;
+			}
+		}
+
+		const Entry& e = entries.getReference(index);
+
+		if (containsAllTokens && matches(e, q, micIndex))
+			result.add(e.sound);
+	}
+}
+
+Result SamplerSoundIndex::queryRegex(const String& regex, Array<ModulatorSamplerSound*>& result)
+{
+	ScopedLock sl(lock);
+
+	rebuildIfNecessary();
+
+	try
+	{
+		std::regex reg(regex.toStdString());
+
+		for (size_t i = 0; i < fileNames.size(); i++)
+		{
+			if (std::regex_search(fileNames[i], reg))
+				result.add(entries.getReference((int)i).sound);
+		}
+	}
+	catch (std::regex_error e)
+	{
+		return Result::fail(e.what());
+	}
+
+	return Result::ok();
+}
+
+void SamplerSoundIndex::tokenise(const String& fileName, StringArray& tokens)
+{
+	String::CharPointerType p = fileName.getCharPointer();
+
+	String currentToken;
+
+	while (!p.isEmpty())
+	{
+		const juce_wchar c = p.getAndAdvance();
+
+		if (CharacterFunctions::isLetterOrDigit(c))
+		{
+			currentToken += CharacterFunctions::toLowerCase(c);
+		}
+		else if (currentToken.isNotEmpty())
+		{
+			tokens.addIfNotAlreadyThere(currentToken);
+			currentToken = String();
+		}
+	}
+
+	if (currentToken.isNotEmpty())
+		tokens.addIfNotAlreadyThere(currentToken);
+}
+
+void SamplerSoundIndex::rebuildIfNecessary()
+{
+	const int currentVersion = ModulatorSamplerSound::getMappingVersion();
+
+	if (version == currentVersion && entries.size() == sampler->getNumSounds())
+		return;
+
+	version = currentVersion;
+
+	entries.clearQuick();
+	fileNames.clear();
+	tokenIndexes.clear();
+	soundsForToken.clearQuick();
+
+	const int numSounds = sampler->getNumSounds();
+
+	entries.ensureStorageAllocated(numSounds);
+	fileNames.reserve(numSounds);
+
+	StringArray tokens;
+
+	for (int i = 0; i < numSounds; i++)
+	{
+		ModulatorSamplerSound* sound = sampler->getSound(i);
+
+		const Range<int> noteRange = sound->getNoteRange();
+		const Range<int> velocityRange = sound->getVelocityRange();
+
+		Entry e;
+
+		e.sound = sound;
+		e.loKey = (uint8)jlimit<int>(0, 127, noteRange.getStart());
+		e.hiKey = (uint8)jlimit<int>(0, 127, noteRange.getEnd() - 1);
+		e.loVelo = (uint8)jlimit<int>(0, 127, velocityRange.getStart());
+		e.hiVelo = (uint8)jlimit<int>(0, 127, velocityRange.getEnd() - 1);
+		e.rrGroup = sound->getRRGroup();
+		e.numMicSamples = sound->getNumMultiMicSamples();
+
+		entries.add(e);
+
+		const String fileName = sound->getPropertyAsString(ModulatorSamplerSound::FileName);
+
+		fileNames.push_back(fileName.toStdString());
+
+		tokens.clearQuick();
+		tokenise(fileName, tokens);
+
+		// The sounds are added in ascending order, so the lists stay sorted
+		for (int j = 0; j < tokens.size(); j++)
+		{
+			if (!tokenIndexes.contains(tokens[j]))
+			{
+				tokenIndexes.set(tokens[j], soundsForToken.size());
+				soundsForToken.add(Array<int>());
+			}
+
+			soundsForToken.getReference(tokenIndexes[tokens[j]]).add(i);
+		}
+	}
+}
+
+int SamplerSoundIndex::getMicIndex(const String& micName) const
+{
+	for (int i = 0; i < sampler->getNumMicPositions(); i++)
+	{
+		if (sampler->getChannelData(i).suffix.equalsIgnoreCase(micName))
+			return i;
+	}
+
+	return -1;
+}
+
+bool SamplerSoundIndex::matches(const Entry& e, const Query& q, int micIndex) const noexcept
+{
+	return (q.rrGroup == -1 || e.rrGroup == q.rrGroup) &&
+		   (micIndex == -1 || micIndex < e.numMicSamples) &&
+		   (int)e.loKey < q.keyRange.getEnd() && (int)e.hiKey >= q.keyRange.getStart() &&
+		   (int)e.loVelo < q.velocityRange.getEnd() && (int)e.hiVelo >= q.velocityRange.getStart();
+}
+
 MonolithExporter::MonolithExporter(SampleMap* sampleMap_) :
 	ThreadWithAsyncProgressWindow("Exporting samples as monolith"),
 	AudioFormatWriter(nullptr, "", 0.0, 0, 1),
@@ -1094,9 +1532,14 @@ void MonolithExporter::writeFiles(int channelIndex, bool overwriteExistingData)
 
 		writer->flush();
 		writer = nullptr;
+	}
 
+	if (MonolithPeakCache::Ptr existingCache = MonolithPeakCache::loadForMonolith(outputFile))
 		return;
-	}
+
+	showStatusMessage("Writing peak file for " + channelFileName);
+
+	MonolithPeakCache::writePeakFile(outputFile, &progress);
 }
 
 void MonolithExporter::updateSampleMap()
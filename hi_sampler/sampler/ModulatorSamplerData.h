@@ -68,6 +68,61 @@ private:
 	ModulatorSampler *sampler;
 };
 
+/** A background thread that preloads the sounds of a sampler while it is already playable.
+*	@ingroup sampler
+*
+*	This is used instead of the SoundPreloadThread if ENABLE_LAZY_SAMPLE_PRELOADING is enabled. The sounds are loaded
+*	in the order of their likelihood to be played (key ranges around the middle of the keyboard and the first round robin
+*	group come first) and a voice that starts a sound that isn't preloaded yet moves it to the front of the queue.
+*
+*	The audio keeps running while the sounds are loaded. Every sound publishes its new preload buffer with a short spin
+*	lock and keeps the replaced buffer alive until the voices that still read from it are reset (see
+*	StreamingSamplerSound::getPreloadBufferReference()).
+*/
+class SampleWarmUpThread : public Thread
+{
+public:
+
+	SampleWarmUpThread(ModulatorSampler* s);
+
+	~SampleWarmUpThread();
+
+	/** Marks all sounds of the sampler as not preloaded and starts loading them in the background. */
+	void startWarmUp();
+
+	/** Starts loading the sounds which are not preloaded yet (without touching the others). */
+	void resumeWarmUp();
+
+	/** Stops the background loading. Call this before you delete sounds from the sampler. */
+	void cancelWarmUp();
+
+	/** Moves the sound to the front of the queue. This is called from the audio thread, so it doesn't allocate or lock. */
+	void requestWarmUp(ModulatorSamplerSound* s) noexcept;
+
+	void run() override;
+
+private:
+
+	struct PlayProbabilitySorter
+	{
+		int compareElements(ModulatorSamplerSound* first, ModulatorSamplerSound* second) const;
+
+		static int getScore(const ModulatorSamplerSound* s);
+	};
+
+	bool isWarm(const ModulatorSamplerSound* s) const;
+
+	void warmUpSound(ModulatorSamplerSound* s, int preloadSize);
+
+	ModulatorSampler* sampler;
+
+	ReferenceCountedArray<ModulatorSamplerSound> soundsToWarmUp;
+
+	moodycamel::ReaderWriterQueue<ModulatorSamplerSound*> requestQueue;
+
+	JUCE_DECLARE_NON_COPYABLE(SampleWarmUpThread)
+};
+
 /** Handles all thumbnail related stuff
 *	@ingroup sampler
 *
@@ -337,6 +392,87 @@ private:
 
 };
 
+/** A lookup structure for selecting the sounds of a sampler based on their mapping data and file names.
+*
+*	The regex based selection needs to convert and search the file name of every sound, which gets slow for big sample maps.
+*	This index stores the mapping of every sound in a compact array and splits the file names into tokens (at every
+*	non-alphanumeric character), so that a query only has to check the sounds that contain all tokens.
+*
+*	The index is rebuilt lazily whenever a sound of any sampler was added, deleted or remapped (see ModulatorSamplerSound::getMappingVersion()).
+*	Each ModulatorSampler owns an index that you can access with ModulatorSampler::getSoundIndex(). It is used from the
+*	message thread and the scripting thread, so the queries (and the rebuild) are guarded by a lock.
+*/
+class SamplerSoundIndex
+{
+public:
+
+	/** The conditions for a query. All conditions must match. */
+	struct Query
+	{
+		Query();
+
+		/** Creates a query from a JSON object with the optional properties `KeyRange`, `VelocityRange` (arrays with two inclusive limits),
+		*	`RRGroup`, `Tokens` (a string or an array of strings) and `Mic` (the name of a mic position of the sampler).
+		*/
+		static Query fromVar(const var& queryObject);
+
+		Range<int> keyRange; ///< the sound must overlap this range of notes
+		Range<int> velocityRange; ///< the sound must overlap this range of velocities
+		int rrGroup; ///< the group of the sound or -1 for every group
+		StringArray tokens; ///< every token must be part of the file name
+		String mic; ///< the sound must have a sample for the mic position with this name (or an empty string for every sound)
+	};
+
+	SamplerSoundIndex(ModulatorSampler* sampler);
+
+	/** Adds all sounds that match the query to the given list. */
+	void query(const Query& q, Array<ModulatorSamplerSound*>& result);
+
+	/** Adds all sounds whose file name matches the regex to the given list. */
+	Result queryRegex(const String& regex, Array<ModulatorSamplerSound*>& result);
+
+	/** Splits the file name into lowercase tokens. */
+	static void tokenise(const String& fileName, StringArray& tokens);
+
+private:
+
+	struct Entry
+	{
+		ModulatorSamplerSound* sound;
+
+		uint8 loKey;
+		uint8 hiKey;
+		uint8 loVelo;
+		uint8 hiVelo;
+
+		int rrGroup;
+		int numMicSamples;
+	};
+
+	/** Call this with the lock held. */
+	void rebuildIfNecessary();
+
+	/** Returns the index of the mic position with the given name or -1. */
+	int getMicIndex(const String& micName) const;
+
+	bool matches(const Entry& e, const Query& q, int micIndex) const noexcept;
+
+	ModulatorSampler* sampler;
+
+	Array<Entry> entries;
+
+	std::vector<std::string> fileNames;
+
+	HashMap<String, int> tokenIndexes;
+	Array<Array<int>> soundsForToken;
+
+	int version;
+
+	CriticalSection lock;
+
+	JUCE_DECLARE_NON_COPYABLE(SamplerSoundIndex)
+};
+
 
 class MonolithExporter : public ThreadWithAsyncProgressWindow,
 						 public AudioFormatWriter
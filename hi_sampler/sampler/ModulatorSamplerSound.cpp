@@ -32,6 +32,8 @@
 
 #include <regex>
 
+Atomic<int> ModulatorSamplerSound::mappingVersion;
+
 
 ModulatorSamplerSound::ModulatorSamplerSound(StreamingSamplerSound *sound, int index_) :
 index(index_),
@@ -52,7 +54,7 @@ purgeChannels(0)
 {
 	soundList.add(wrappedSound.get());
 
-	
+	++mappingVersion;
 
 	setProperty(Pan, 0);
 }
@@ -83,7 +85,8 @@ purgeChannels(0)
 		soundList.add(soundArray[i].get());
 	}
 
-	
+	++mappingVersion;
+
 	setProperty(Pan, 0);
 }
 
@@ -92,6 +95,8 @@ ModulatorSamplerSound::~ModulatorSamplerSound()
 	masterReference.clear();
 	soundList.clear();
 	removeAllChangeListeners();
+
+	++mappingVersion;
 }
 
 String ModulatorSamplerSound::getPropertyName(Property p)
@@ -283,6 +288,9 @@ void ModulatorSamplerSound::setProperty(Property p, int newValue, NotificationTy
 	default:			jassertfalse; break;
 	}
 
+	if (p == KeyLow || p == KeyHigh || p == VeloLow || p == VeloHigh || p == RRGroup)
+		++mappingVersion;
+
 	if(notifyEditor) sendChangeMessage();
 }
 
@@ -419,6 +427,8 @@ void ModulatorSamplerSound::setMaxRRGroupIndex(int newGroupLimit)
 {
 	maxRRGroup = newGroupLimit;
 	rrGroup = jmin(rrGroup, newGroupLimit);
+
+	++mappingVersion;
 }
 
 void ModulatorSamplerSound::setMappingData(MappingData newData)
@@ -429,6 +439,8 @@ void ModulatorSamplerSound::setMappingData(MappingData newData)
 	midiNotes.clear();
 	midiNotes.setRange(newData.loKey, newData.hiKey - newData.loKey + 1, true);
 	rrGroup = newData.rrGroup;
+
+	++mappingVersion;
 }
 
 void ModulatorSamplerSound::calculateNormalizedPeak(bool forceScan /*= false*/)
@@ -567,33 +579,26 @@ void ModulatorSamplerSound::selectSoundsBasedOnRegex(const String &regexWildcard
 	}
 
 
-    try
-    {
-		std::regex reg(wildcard.toStdString());
-
-		for (int i = 0; i < sampler->getNumSounds(); i++)
-		{
-			const String name = sampler->getSound(i)->getPropertyAsString(Property::FileName);
-
-			if (std::regex_search(name.toStdString(), reg))
-			{
-				if (subtractMode)
-				{
-					set.deselect(sampler->getSound(i));
-				}
-				else
-				{
-					set.addToSelection(sampler->getSound(i));
-				}
-
+	Array<ModulatorSamplerSound*> matches;
 
-			}
+	Result r = sampler->getSoundIndex().queryRegex(wildcard, matches);
 
-		}
+	if (r.failed())
+	{
+		debugError(sampler, r.getErrorMessage());
+		return;
 	}
-	catch (std::regex_error e)
+
+	for (int i = 0; i < matches.size(); i++)
 	{
-		debugError(sampler, e.what());
+		if (subtractMode)
+		{
+			set.deselect(matches[i]);
+		}
+		else
+		{
+			set.addToSelection(matches[i]);
+		}
 	}
 }
 
@@ -665,6 +670,55 @@ ModulatorSamplerSound * ModulatorSamplerSoundPool::addSound(const ValueTree &sou
 	}
 }
 
+ModulatorSamplerSound * ModulatorSamplerSoundPool::createSoundWithoutPool(const ValueTree &soundDescription, int index, StreamingSamplerSoundArray &newSamples)
+{
+	static Identifier duplicate("Duplicate");
+
+	const bool searchThisSampleInPool = forcePoolSearch || (bool)soundDescription.getProperty(duplicate, true);
+
+	const int numFiles = jmax<int>(1, soundDescription.getNumChildren());
+
+	StreamingSamplerSoundArray samples;
+
+	for (int i = 0; i < numFiles; i++)
+	{
+		const ValueTree fileData = soundDescription.getNumChildren() == 0 ? soundDescription : soundDescription.getChild(i);
+
+		const String fileName = GET_PROJECT_HANDLER(mc->getMainSynthChain()).getFilePath(fileData.getProperty(ModulatorSamplerSound::getPropertyName(ModulatorSamplerSound::FileName)).toString(),
+																		   ProjectHandler::SubDirectories::Samples);
+
+		if (searchThisSampleInPool)
+		{
+			ScopedLock sl(mc->getLock());
+
+			const int j = getSoundIndexFromPool(fileName.hashCode64());
+
+			if (j != -1)
+			{
+				samples.add(pool[j]);
+				continue;
+			}
+		}
+
+		StreamingSamplerSound *s = new StreamingSamplerSound(fileName, this);
+
+		samples.add(s);
+		newSamples.add(s);
+	}
+
+	if (samples.size() == 1)
+		return new ModulatorSamplerSound(samples.getFirst(), index);
+	
+	return new ModulatorSamplerSound(samples, index);
+}
+
+void ModulatorSamplerSoundPool::addSamplesToPool(const StreamingSamplerSoundArray &newSamples)
+{
+	pool.addArray(newSamples);
+
+	if (updatePool) sendChangeMessage();
+}
+
 void ModulatorSamplerSoundPool::deleteSound(ModulatorSamplerSound *soundToDelete)
 {
 	for (int i = 0; i < soundToDelete->getNumMultiMicSamples(); i++)
@@ -692,13 +746,19 @@ bool ModulatorSamplerSoundPool::loadMonolithicData(const ValueTree &sampleMap, c
 {
 	clearUnreferencedMonoliths();
 
-	loadedMonoliths.add(new MonolithInfoToUse(monolithicFiles));
-
-	MonolithInfoToUse* hmaf = loadedMonoliths.getLast();
+	// Hold a reference so that the shared cache can't delete the info until it's used by the sounds
+	ReferenceCountedObjectPtr<MonolithInfoToUse> hmaf;
 
 	try
 	{
+#if ENABLE_SHARED_SAMPLE_CACHE
+		hmaf = sharedCache->getMonolith(monolithicFiles, sampleMap);
+		loadedMonoliths.addIfNotAlreadyThere(hmaf);
+#else
+		loadedMonoliths.add(new MonolithInfoToUse(monolithicFiles));
+		hmaf = loadedMonoliths.getLast();
 		hmaf->fillMetadataInfo(sampleMap);
+#endif
 	}
 	catch (StreamingSamplerSound::LoadingError l)
 	{
@@ -713,6 +773,19 @@ bool ModulatorSamplerSoundPool::loadMonolithicData(const ValueTree &sampleMap, c
 #endif
 	}
 
+	if (hmaf == nullptr)
+	{
+		// The shared cache doesn't store monoliths with invalid metadata, so use an unshared one
+		loadedMonoliths.add(new MonolithInfoToUse(monolithicFiles));
+		hmaf = loadedMonoliths.getLast();
+	}
+
+#if ENABLE_SHARED_SAMPLE_CACHE
+	SharedSampleCache* cache = &sharedCache.getObject();
+#else
+	SharedSampleCache* cache = nullptr;
+#endif
+
 	for (int i = 0; i < sampleMap.getNumChildren(); i++)
 	{
 		ValueTree sample = sampleMap.getChild(i);
@@ -720,7 +793,7 @@ bool ModulatorSamplerSoundPool::loadMonolithicData(const ValueTree &sampleMap, c
 		if (sample.getNumChildren() == 0)
 		{
 			String fileName = sample.getProperty("FileName").toString().fromFirstOccurrenceOf("{PROJECT_FOLDER}", false, false);
-			StreamingSamplerSound* sound = new StreamingSamplerSound(hmaf, 0, i);
+			StreamingSamplerSound* sound = new StreamingSamplerSound(hmaf, 0, i, cache);
 			pool.add(sound);
 			sounds.add(new ModulatorSamplerSound(sound, i));
 		}
@@ -730,7 +803,7 @@ bool ModulatorSamplerSoundPool::loadMonolithicData(const ValueTree &sampleMap, c
 
 			for (int j = 0; j < sample.getNumChildren(); j++)
 			{
-				StreamingSamplerSound* sound = new StreamingSamplerSound(hmaf, j, i);
+				StreamingSamplerSound* sound = new StreamingSamplerSound(hmaf, j, i, cache);
 				pool.add(sound);
 				multiMicArray.add(sound);
 			}
@@ -757,6 +830,10 @@ void ModulatorSamplerSoundPool::clearUnreferencedSamples()
 		}
 	}
 
+#if ENABLE_SHARED_SAMPLE_CACHE
+	sharedCache->clearUnreferencedEntries();
+#endif
+
 	sendChangeMessage();
 }
 
@@ -1026,9 +1103,11 @@ size_t ModulatorSamplerSoundPool::getMemoryUsageForAllSamples() const noexcept
 {
 	size_t memoryUsage = 0;
 
+	SortedSet<const SharedPreloadBuffer*> countedBuffers;
+
 	for (int i = 0; i < pool.size(); i++)
 	{
-		memoryUsage += pool.getUnchecked(i)->getActualPreloadSize();
+		memoryUsage += pool.getUnchecked(i)->getActualPreloadSize(countedBuffers);
 	}
 
 	return memoryUsage;
@@ -1224,11 +1303,27 @@ void ModulatorSamplerSoundPool::clearUnreferencedMonoliths()
 {
 	for (int i = 0; i < loadedMonoliths.size(); i++)
 	{
-		if (loadedMonoliths[i]->getReferenceCount() == 2)
+		// The reference count can't be used here because the monolith might be shared with other instances
+		if (!isMonolithReferenced(loadedMonoliths[i].get()))
 		{
 			loadedMonoliths.remove(i--);
 		}
 	}
 
+#if ENABLE_SHARED_SAMPLE_CACHE
+	sharedCache->clearUnreferencedEntries();
+#endif
+
 	sendChangeMessage();
 }
+
+bool ModulatorSamplerSoundPool::isMonolithReferenced(const MonolithInfoToUse* info) const
+{
+	for (int i = 0; i < pool.size(); i++)
+	{
+		if (pool.getUnchecked(i)->usesMonolith(info))
+			return true;
+	}
+
+	return false;
+}
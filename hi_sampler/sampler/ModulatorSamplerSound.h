@@ -323,8 +323,13 @@ public:
 
 	static void selectSoundsBasedOnRegex(const String &regexWildcard, ModulatorSampler *sampler, SelectedItemSet<WeakReference<ModulatorSamplerSound>> &set);
 
+	/** Returns a number that changes whenever a sound was created, deleted or remapped. The SamplerSoundIndex uses this to check if it needs to be rebuilt. */
+	static int getMappingVersion() noexcept { return mappingVersion.get(); }
+
 private:
 
+	static Atomic<int> mappingVersion;
+
 	// ================================================================================================================
 
 	/** A PropertyChange is a undoable modification of one of the properties of the sound */
@@ -445,6 +450,17 @@ public:
 	*/
 	ModulatorSamplerSound *addSound(const ValueTree &soundDescription, int index, bool forceReuse = false);;
 
+	/** Creates a sound like addSound(), but doesn't add the new samples to the pool.
+	*
+	*	Only the lookup of already loaded samples is done under the global lock, so this can be called from a background
+	*	thread. The samples that were not found in the pool are added to newSamples and must be passed to 
+	*	addSamplesToPool() when the sound is added to a sampler.
+	*/
+	ModulatorSamplerSound *createSoundWithoutPool(const ValueTree &soundDescription, int index, StreamingSamplerSoundArray &newSamples);
+
+	/** Adds the samples that were created by createSoundWithoutPool() to the pool. */
+	void addSamplesToPool(const StreamingSamplerSoundArray &newSamples);
+
 	/** Decreases the reference count of the wrapped sound in the pool and deletes it if no references are left. */
 	void deleteSound(ModulatorSamplerSound *soundToDelete);;
 
@@ -513,6 +529,12 @@ private:
 
 	ReferenceCountedArray<MonolithInfoToUse> loadedMonoliths;
 
+	bool isMonolithReferenced(const MonolithInfoToUse* info) const;
+
+#if ENABLE_SHARED_SAMPLE_CACHE
+	SharedResourcePointer<SharedSampleCache> sharedCache;
+#endif
+
 	int getSoundIndexFromPool(int64 hashCode);
 
 	ModulatorSamplerSound *addSoundWithSingleMic(const ValueTree &soundDescription, int index, bool forceReuse = false);
@@ -55,6 +55,9 @@ void ModulatorSamplerVoice::startNote(int midiNoteNumber,
 	wrappedVoice.setSampleStartModValue(sampleStartModulationDelta);
 	wrappedVoice.startNote(midiNoteNumber, velocity, sound, -1);
 
+	if (!sound->isPreloaded())
+		static_cast<ModulatorSampler*>(getOwnerSynth())->requestWarmUp(currentlyPlayingSamplerSound);
+
 	voiceUptime = wrappedVoice.voiceUptime;
 	uptimeDelta = wrappedVoice.uptimeDelta;
     isActive = true;
@@ -296,6 +299,8 @@ void MultiMicModulatorSamplerVoice::startNote(int midiNoteNumber, float velocity
 	const int sampleStartModulationDelta = (int)(sampleStartModValue * currentlyPlayingSamplerSound->getReferenceToSound()->getSampleStartModulation());
 
 	const double globalPitchFactor = getOwnerSynth()->getMainController()->getGlobalPitchFactor();
+
+	bool needsWarmUp = false;
     
 	for (int i = 0; i < wrappedVoices.size(); i++)
 	{
@@ -315,10 +320,15 @@ void MultiMicModulatorSamplerVoice::startNote(int midiNoteNumber, float velocity
 		voiceToUse->setSampleStartModValue(sampleStartModulationDelta);
 		voiceToUse->startNote(midiNoteNumber, velocity, sound, -1);
 
+		needsWarmUp |= !sound->isPreloaded();
+
 		voiceUptime = wrappedVoices[i]->voiceUptime;
 		uptimeDelta = wrappedVoices[i]->uptimeDelta;
         isActive = true;
 	}
+
+	if (needsWarmUp)
+		sampler->requestWarmUp(currentlyPlayingSamplerSound);
 }
 
 void MultiMicModulatorSamplerVoice::calculateBlock(int startSample, int numSamples)
@@ -192,4 +192,24 @@ void HlacMonolithInfo::fillMetadataInfo(const ValueTree& sampleMap)
 	}
 }
 
+MonolithPeakCache* HlacMonolithInfo::getPeakCache(int channelIndex)
+{
+	if (!isPositiveAndBelow(channelIndex, (int)monolithicFiles.size()))
+		return nullptr;
+
+	ScopedLock sl(peakCacheLock);
+
+	if (peakCaches[channelIndex] == nullptr)
+	{
+		const File& monolithFile = monolithicFiles[channelIndex];
+
+		if (MonolithPeakCache* cache = MonolithPeakCache::loadForMonolith(monolithFile))
+			peakCaches.set(channelIndex, cache);
+		else
+			peakFileWriter->addMonolith(monolithFile);
+	}
+
+	return peakCaches[channelIndex];
+}
+
 #endif
@@ -296,6 +296,13 @@ public:
 		return nullptr;
 	}
 
+	/** Returns true if the metadata of the given sample was loaded from the sample map. */
+	bool hasSampleInfo(int channelIndex, int sampleIndex) const
+	{
+		return isPositiveAndBelow(channelIndex, (int)multiChannelSampleInformation.size()) &&
+			   isPositiveAndBelow(sampleIndex, (int)multiChannelSampleInformation[channelIndex].size());
+	}
+
 	String getFileName(int channelIndex, int sampleIndex) const
 	{
 		return multiChannelSampleInformation[channelIndex][sampleIndex].fileName;
@@ -377,6 +384,10 @@ public:
 			ScopedPointer<FileInputStream> fallbackStream = new FileInputStream(monolithicFiles_[i]);
 			fallbackReaders.add(new hlac::HiseLosslessAudioFormatReader(fallbackStream.release()));
 			isMonoChannel[i] = fallbackReaders.getLast()->numChannels == 1;
+
+			cacheKeys.push_back(getCacheKey(monolithicFiles_[i]));
+
+			peakCaches.add(nullptr);
 		}
 
 		dummyReader.numChannels = 2;
@@ -385,6 +396,13 @@ public:
 
 	void fillMetadataInfo(const ValueTree& sampleMap);
 
+	/** Returns true if the metadata of the given sample was loaded from the sample map. */
+	bool hasSampleInfo(int channelIndex, int sampleIndex) const
+	{
+		return isPositiveAndBelow(channelIndex, (int)multiChannelSampleInformation.size()) &&
+			   isPositiveAndBelow(sampleIndex, (int)multiChannelSampleInformation[channelIndex].size());
+	}
+
 	String getFileName(int channelIndex, int sampleIndex) const
 	{
 		return multiChannelSampleInformation[channelIndex][sampleIndex].fileName;
@@ -405,6 +423,45 @@ public:
 		return multiChannelSampleInformation[0][sampleIndex].sampleRate;
 	}
 
+	/** Returns a key that identifies the monolith file of the given channel (its path, size and modification time). */
+	int64 getCacheKey(int channelIndex) const
+	{
+		return isPositiveAndBelow(channelIndex, (int)cacheKeys.size()) ? cacheKeys[channelIndex] : 0;
+	}
+
+	/** Creates a key from the path, size and modification time of the file. */
+	static int64 getCacheKey(const File& f)
+	{
+		return (f.getFullPathName() + String(f.getSize()) + String(f.getLastModificationTime().toMilliseconds())).hashCode64();
+	}
+
+	/** Returns a pointer to the memory mapped data of the given sample if it can be used without conversion (or nullptr).
+	*
+	*	This is only possible for uncompressed mono files, because the data of stereo files is interleaved.
+	*/
+	const int16* getMappedSampleData(int sampleIndex, int channelIndex, int64 startSample, int numSamples) const
+	{
+#if USE_FALLBACK_READERS_FOR_MONOLITH
+		ignoreUnused(sampleIndex, channelIndex, startSample, numSamples);
+		return nullptr;
+#else
+		const int sizeOfFirstChannelList = (int)multiChannelSampleInformation[0].size();
+		const int sizeOfChannelList = (int)multiChannelSampleInformation.size();
+
+		if (channelIndex < sizeOfChannelList && channelIndex < memoryReaders.size() && sampleIndex < sizeOfFirstChannelList && isMonoChannel[channelIndex])
+		{
+			auto info = &multiChannelSampleInformation[channelIndex][sampleIndex];
+
+			if (startSample < 0 || startSample + numSamples > info->length)
+				return nullptr;
+
+			return memoryReaders[channelIndex]->getMappedMonolithData(info->start + startSample, numSamples);
+		}
+
+		return nullptr;
+#endif
+	}
+
 	AudioFormatReader* createMonolithicReader(int sampleIndex, int channelIndex)
 	{
 		const int sizeOfFirstChannelList = (int)multiChannelSampleInformation[0].size();
@@ -443,6 +500,12 @@ public:
 		return nullptr;
 	}
 
+	/** Returns the peak cache for the monolith of the given channel.
+	*
+	*	If the peak file doesn't exist yet, it returns nullptr and starts writing the file on a background thread.
+	*/
+	MonolithPeakCache* getPeakCache(int channelIndex);
+
 	/** Use this for UI rendering stuff to avoid multithreading issues. */
 	AudioFormatReader* createThumbnailReader(int sampleIndex, int channelIndex)
 	{
@@ -504,6 +567,12 @@ private:
 
 	std::vector<File> monolithicFiles;
 
+	std::vector<int64> cacheKeys;
+
+	CriticalSection peakCacheLock;
+	ReferenceCountedArray<MonolithPeakCache> peakCaches;
+	SharedResourcePointer<MonolithPeakCache::AsyncWriter> peakFileWriter;
+
 	bool isMonoChannel[6];
 
 	OwnedArray<hlac::HiseLosslessAudioFormatReader> fallbackReaders;
@@ -0,0 +1,466 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+#define PEAK_FILE_MAGIC_NUMBER ByteOrder::littleEndianInt("HPK1")
+#define PEAK_FILE_VERSION 1
+
+namespace PeakHelpers
+{
+	static int8 toInt8(float value) noexcept
+	{
+		return (int8)jlimit<int>(-128, 127, roundFloatToInt(value * 127.0f));
+	}
+
+	static int getHeaderSize(int numLevels) noexcept
+	{
+		// magic, version, monolith size + time, channels, samples, levels + (binSize, numBins, offset) per level
+		return 4 + 4 + 8 + 8 + 4 + 8 + 4 + numLevels * (4 + 8 + 8);
+	}
+}
+
+File MonolithPeakCache::getPeakFile(const File& monolithFile)
+{
+	return monolithFile.getSiblingFile(monolithFile.getFileName() + ".peaks");
+}
+
+MonolithPeakCache* MonolithPeakCache::loadForMonolith(const File& monolithFile)
+{
+	File peakFile = getPeakFile(monolithFile);
+
+	if (!peakFile.existsAsFile() || !monolithFile.existsAsFile())
+		return nullptr;
+
+	ScopedPointer<MemoryMappedFile> mappedFile = new MemoryMappedFile(peakFile, MemoryMappedFile::readOnly);
+
+	if (mappedFile->getData() == nullptr)
+		return nullptr;
+
+	ScopedPointer<MonolithPeakCache> cache = new MonolithPeakCache(mappedFile.release(), monolithFile);
+
+	return cache->isValid() ? cache.release() : nullptr;
+}
+
+MonolithPeakCache::MonolithPeakCache(MemoryMappedFile* mappedFile, const File& monolithFile) :
+	map(mappedFile),
+	numChannels(0),
+	numSamples(0)
+{
+	const size_t size = map->getSize();
+
+	MemoryInputStream mis(map->getData(), size, false);
+
+	if (size < (size_t)PeakHelpers::getHeaderSize(0) || mis.readInt() != (int)PEAK_FILE_MAGIC_NUMBER || mis.readInt() != PEAK_FILE_VERSION)
+		return;
+
+	const int64 monolithSize = mis.readInt64();
+	const int64 monolithTime = mis.readInt64();
+
+	if (monolithSize != monolithFile.getSize() || monolithTime != monolithFile.getLastModificationTime().toMilliseconds())
+		return; // The monolith was changed after the peak file was written
+
+	numChannels = mis.readInt();
+	numSamples = mis.readInt64();
+
+	const int numLevels = mis.readInt();
+
+	if (numChannels <= 0 || numLevels <= 0 || size < (size_t)PeakHelpers::getHeaderSize(numLevels))
+		return;
+
+	Array<Level> newLevels;
+
+	for (int i = 0; i < numLevels; i++)
+	{
+		Level l;
+
+		l.binSize = mis.readInt();
+		l.numBins = mis.readInt64();
+
+		const int64 dataOffset = mis.readInt64();
+
+		if (l.binSize <= 0 || dataOffset + l.numBins * numChannels * 2 > (int64)size)
+			return;
+
+		l.data = static_cast<const int8*>(map->getData()) + dataOffset;
+
+		newLevels.add(l);
+	}
+
+	levels.swapWith(newLevels);
+}
+
+void MonolithPeakCache::writeHeader(OutputStream& output, const File& monolithFile, int numChannels, int64 numSamples, const Array<int64>& numBinsPerLevel)
+{
+	output.writeInt((int)PEAK_FILE_MAGIC_NUMBER);
+	output.writeInt(PEAK_FILE_VERSION);
+	output.writeInt64(monolithFile.getSize());
+	output.writeInt64(monolithFile.getLastModificationTime().toMilliseconds());
+	output.writeInt(numChannels);
+	output.writeInt64(numSamples);
+	output.writeInt(numBinsPerLevel.size());
+
+	int64 dataOffset = PeakHelpers::getHeaderSize(numBinsPerLevel.size());
+	int binSize = BASE_BIN_SIZE;
+
+	for (int i = 0; i < numBinsPerLevel.size(); i++)
+	{
+		output.writeInt(binSize);
+		output.writeInt64(numBinsPerLevel[i]);
+		output.writeInt64(dataOffset);
+
+		dataOffset += numBinsPerLevel[i] * numChannels * 2;
+		binSize *= LEVEL_FACTOR;
+	}
+}
+
+bool MonolithPeakCache::writePeakFile(const File& monolithFile, double* progress, ThreadPoolJob* job)
+{
+	ScopedPointer<hlac::HiseLosslessAudioFormatReader> reader = new hlac::HiseLosslessAudioFormatReader(new FileInputStream(monolithFile));
+
+	const int numChannels = (int)reader->numChannels;
+	const int64 numSamples = reader->lengthInSamples;
+
+	if (numChannels <= 0 || numSamples <= 0)
+		return false;
+
+	OwnedArray<MemoryBlock> levelData;
+	Array<int64> numBinsPerLevel;
+
+	// Read the monolith once and create the lowest level
+
+	const int64 numBaseBins = (numSamples + BASE_BIN_SIZE - 1) / BASE_BIN_SIZE;
+
+	MemoryBlock* baseLevel = levelData.add(new MemoryBlock((size_t)(numBaseBins * numChannels * 2)));
+	numBinsPerLevel.add(numBaseBins);
+
+	int8* baseData = static_cast<int8*>(baseLevel->getData());
+
+	const int numSamplesPerChunk = BASE_BIN_SIZE * 256;
+
+	AudioSampleBuffer buffer(numChannels, numSamplesPerChunk);
+
+	for (int64 chunkStart = 0; chunkStart < numSamples; chunkStart += numSamplesPerChunk)
+	{
+		if (Thread::currentThreadShouldExit() || (job != nullptr && job->shouldExit()))
+			return false;
+
+		const int numThisTime = (int)jmin<int64>(numSamplesPerChunk, numSamples - chunkStart);
+
+		reader->read(&buffer, 0, numThisTime, chunkStart, true, numChannels > 1);
+
+		for (int binStart = 0; binStart < numThisTime; binStart += BASE_BIN_SIZE)
+		{
+			const int binLength = jmin<int>(BASE_BIN_SIZE, numThisTime - binStart);
+
+			for (int c = 0; c < numChannels; c++)
+			{
+				const Range<float> r = FloatVectorOperations::findMinAndMax(buffer.getReadPointer(c, binStart), binLength);
+
+				*baseData++ = PeakHelpers::toInt8(r.getStart());
+				*baseData++ = PeakHelpers::toInt8(r.getEnd());
+			}
+		}
+
+		if (progress != nullptr)
+			*progress = (double)chunkStart / (double)numSamples;
+	}
+
+	// Every other level combines the bins of the previous level
+
+	while (numBinsPerLevel.getLast() > MIN_BINS_PER_LEVEL)
+	{
+		const int64 numSourceBins = numBinsPerLevel.getLast();
+		const int64 numBins = (numSourceBins + LEVEL_FACTOR - 1) / LEVEL_FACTOR;
+
+		const int8* source = static_cast<const int8*>(levelData.getLast()->getData());
+
+		MemoryBlock* level = levelData.add(new MemoryBlock((size_t)(numBins * numChannels * 2)));
+		numBinsPerLevel.add(numBins);
+
+		int8* data = static_cast<int8*>(level->getData());
+
+		for (int64 i = 0; i < numBins; i++)
+		{
+			const int64 firstSourceBin = i * LEVEL_FACTOR;
+			const int64 lastSourceBin = jmin<int64>(firstSourceBin + LEVEL_FACTOR, numSourceBins);
+
+			for (int c = 0; c < numChannels; c++)
+			{
+				int8 minValue = 127;
+				int8 maxValue = -128;
+
+				for (int64 j = firstSourceBin; j < lastSourceBin; j++)
+				{
+					const int8* sourceBin = source + (j * numChannels + c) * 2;
+
+					minValue = jmin<int8>(minValue, sourceBin[0]);
+					maxValue = jmax<int8>(maxValue, sourceBin[1]);
+				}
+
+				*data++ = minValue;
+				*data++ = maxValue;
+			}
+		}
+	}
+
+	reader = nullptr;
+
+	TemporaryFile tempFile(getPeakFile(monolithFile));
+
+	{
+		ScopedPointer<FileOutputStream> output = tempFile.getFile().createOutputStream();
+
+		if (output == nullptr)
+			return false;
+
+		writeHeader(*output, monolithFile, numChannels, numSamples, numBinsPerLevel);
+
+		for (int i = 0; i < levelData.size(); i++)
+			output->write(levelData[i]->getData(), levelData[i]->getSize());
+
+		output->flush();
+	}
+
+	return tempFile.overwriteTargetFileWithTemporary();
+}
+
+void MonolithPeakCache::getMinMax(int channelIndex, int64 startSample, int64 numSamplesToCheck, float& minValue, float& maxValue) const noexcept
+{
+	minValue = 0.0f;
+	maxValue = 0.0f;
+
+	if (!isPositiveAndBelow(channelIndex, numChannels) || levels.size() == 0)
+		return;
+
+	startSample = jlimit<int64>(0, numSamples, startSample);
+	numSamplesToCheck = jmin<int64>(numSamplesToCheck, numSamples - startSample);
+
+	if (numSamplesToCheck <= 0)
+		return;
+
+	int levelIndex = 0;
+
+	while (levelIndex < levels.size() - 1 && levels.getReference(levelIndex + 1).binSize <= numSamplesToCheck)
+		levelIndex++;
+
+	int8 minInt = 127;
+	int8 maxInt = -128;
+
+	scanRange(levelIndex, channelIndex, startSample, startSample + numSamplesToCheck, minInt, maxInt);
+
+	if (minInt > maxInt)
+		return;
+
+	minValue = (float)minInt / 127.0f;
+	maxValue = (float)maxInt / 127.0f;
+}
+
+void MonolithPeakCache::scanRange(int levelIndex, int channelIndex, int64 start, int64 end, int8& minInt, int8& maxInt) const noexcept
+{
+	if (end <= start)
+		return;
+
+	const Level& l = levels.getReference(levelIndex);
+
+	// Use the bins that are completely inside the range and scan the edges with the finer levels
+	const int64 firstBin = levelIndex == 0 ? start / l.binSize : (start + l.binSize - 1) / l.binSize;
+	const int64 endBin = levelIndex == 0 ? (end + l.binSize - 1) / l.binSize : end / l.binSize;
+
+	if (firstBin >= endBin)
+	{
+		scanRange(levelIndex - 1, channelIndex, start, end, minInt, maxInt);
+		return;
+	}
+
+	for (int64 i = firstBin; i < jmin<int64>(endBin, l.numBins); i++)
+	{
+		const int8* bin = l.data + (i * numChannels + channelIndex) * 2;
+
+		minInt = jmin<int8>(minInt, bin[0]);
+		maxInt = jmax<int8>(maxInt, bin[1]);
+	}
+
+	if (levelIndex > 0)
+	{
+		scanRange(levelIndex - 1, channelIndex, start, firstBin * l.binSize, minInt, maxInt);
+		scanRange(levelIndex - 1, channelIndex, endBin * l.binSize, end, minInt, maxInt);
+	}
+}
+
+// ==================================================================================================================== AsyncWriter
+
+class MonolithPeakCache::AsyncWriter::Job : public ThreadPoolJob
+{
+public:
+
+	Job(AsyncWriter& parent_, const File& monolithFile_) :
+		ThreadPoolJob("Write peak file"),
+		parent(parent_),
+		monolithFile(monolithFile_)
+	{};
+
+	JobStatus runJob() override
+	{
+		MonolithPeakCache::writePeakFile(monolithFile, nullptr, this);
+
+		ScopedLock sl(parent.lock);
+		parent.pendingFiles.removeFirstMatchingValue(monolithFile);
+
+		return jobHasFinished;
+	}
+
+private:
+
+	AsyncWriter& parent;
+	const File monolithFile;
+};
+
+void MonolithPeakCache::AsyncWriter::addMonolith(const File& monolithFile)
+{
+	ScopedLock sl(lock);
+
+	if (pendingFiles.contains(monolithFile))
+		return;
+
+	pendingFiles.add(monolithFile);
+	addJob(new Job(*this, monolithFile), true);
+}
+
+// ==================================================================================================================== Thumbnail
+
+MonolithPeakCache::Thumbnail::Thumbnail(MonolithPeakCache* cache_, int64 offset_, int64 length_, double sampleRate_, int64 hashCode_) :
+	cache(cache_),
+	offset(offset_),
+	length(length_),
+	sampleRate(sampleRate_),
+	hashCode(hashCode_)
+{
+	jassert(cache != nullptr);
+}
+
+bool MonolithPeakCache::Thumbnail::setSource(InputSource* newSource)
+{
+	// The data is read from the peak cache...
+	ScopedPointer<InputSource> ownedSource = newSource;
+	return false;
+}
+
+void MonolithPeakCache::Thumbnail::setReader(AudioFormatReader* newReader, int64 /*newHashCode*/)
+{
+	// The data is read from the peak cache...
+	ScopedPointer<AudioFormatReader> ownedReader = newReader;
+}
+
+double MonolithPeakCache::Thumbnail::getTotalLength() const noexcept
+{
+	return sampleRate > 0.0 ? (double)length / sampleRate : 0.0;
+}
+
+void MonolithPeakCache::Thumbnail::drawChannel(Graphics& g, const Rectangle<int>& area, double startTimeSeconds, double endTimeSeconds, int channelNum, float verticalZoomFactor)
+{
+	const Rectangle<int> clip = g.getClipBounds().getIntersection(area);
+
+	if (clip.isEmpty() || length == 0 || endTimeSeconds <= startTimeSeconds)
+		return;
+
+	const double samplesPerPixel = (endTimeSeconds - startTimeSeconds) * sampleRate / (double)area.getWidth();
+	const double startSample = startTimeSeconds * sampleRate;
+
+	const float topY = (float)area.getY();
+	const float bottomY = (float)area.getBottom();
+	const float midY = (topY + bottomY) * 0.5f;
+	const float vscale = verticalZoomFactor * (bottomY - topY) * 0.5f;
+
+	RectangleList<float> waveform;
+	waveform.ensureStorageAllocated(clip.getWidth());
+
+	for (int x = clip.getX(); x < clip.getRight(); x++)
+	{
+		const int64 pixelStart = (int64)(startSample + (double)(x - area.getX()) * samplesPerPixel);
+		const int64 pixelEnd = jmin<int64>(length, (int64)(startSample + (double)(x - area.getX() + 1) * samplesPerPixel));
+
+		if (pixelEnd <= pixelStart)
+			continue;
+
+		float minValue, maxValue;
+
+		cache->getMinMax(channelNum, offset + pixelStart, pixelEnd - pixelStart, minValue, maxValue);
+
+		if (minValue == 0.0f && maxValue == 0.0f)
+			continue;
+
+		const float top = jmax<float>(midY - maxValue * vscale - 0.3f, topY);
+		const float bottom = jmin<float>(midY - minValue * vscale + 0.3f, bottomY);
+
+		waveform.addWithoutMerging(Rectangle<float>((float)x, top, 1.0f, bottom - top));
+	}
+
+	g.fillRectList(waveform);
+}
+
+void MonolithPeakCache::Thumbnail::drawChannels(Graphics& g, const Rectangle<int>& area, double startTimeSeconds, double endTimeSeconds, float verticalZoomFactor)
+{
+	const int numChannels = getNumChannels();
+
+	for (int i = 0; i < numChannels; i++)
+	{
+		const int y1 = roundToInt((i * area.getHeight()) / numChannels);
+		const int y2 = roundToInt(((i + 1) * area.getHeight()) / numChannels);
+
+		drawChannel(g, Rectangle<int>(area.getX(), area.getY() + y1, area.getWidth(), y2 - y1), startTimeSeconds, endTimeSeconds, i, verticalZoomFactor);
+	}
+}
+
+float MonolithPeakCache::Thumbnail::getApproximatePeak() const
+{
+	float peak = 0.0f;
+
+	for (int i = 0; i < getNumChannels(); i++)
+	{
+		float minValue, maxValue;
+		cache->getMinMax(i, offset, length, minValue, maxValue);
+
+		peak = jmax<float>(peak, std::abs(minValue), std::abs(maxValue));
+	}
+
+	return peak;
+}
+
+void MonolithPeakCache::Thumbnail::getApproximateMinMax(double startTime, double endTime, int channelIndex, float& minValue, float& maxValue) const noexcept
+{
+	const int64 startSample = (int64)(startTime * sampleRate);
+	const int64 endSample = jmin<int64>(length, (int64)(endTime * sampleRate));
+
+	cache->getMinMax(channelIndex, offset + startSample, endSample - startSample, minValue, maxValue);
+}
+
+#undef PEAK_FILE_MAGIC_NUMBER
+#undef PEAK_FILE_VERSION
@@ -0,0 +1,185 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+
+#ifndef MONOLITHPEAKCACHE_H_INCLUDED
+#define MONOLITHPEAKCACHE_H_INCLUDED
+
+/** A multi resolution min / max peak pyramid of a monolith file.
+*
+*	Drawing the waveform of a sample that lives in a monolith would require decoding the whole sample, which is
+*	pretty slow for large monoliths. This class stores the peaks of the monolith in multiple resolutions in a file 
+*	next to the monolith (eg. `MySampleMap.ch1.peaks`), so that a waveform can be drawn with a few reads per pixel 
+*	regardless of the zoom level.
+*
+*	The lowest level stores one min / max pair per channel for every BASE_BIN_SIZE samples, and every following 
+*	level combines LEVEL_FACTOR bins of the previous level. The values are stored as 8 bit integers (just like 
+*	the AudioThumbnail data). The file is memory mapped, so loading the cache is instant.
+*
+*	The peak file is written by the MonolithExporter. If a monolith doesn't have a (valid) peak file, it is created
+*	on a background thread the first time it is requested by HlacMonolithInfo::getPeakCache().
+*/
+class MonolithPeakCache : public ReferenceCountedObject
+{
+public:
+
+	typedef ReferenceCountedObjectPtr<MonolithPeakCache> Ptr;
+
+	enum
+	{
+		BASE_BIN_SIZE = 256,
+		LEVEL_FACTOR = 4,
+		MIN_BINS_PER_LEVEL = 64
+	};
+
+	/** Returns the file that stores the peaks of the given monolith. */
+	static File getPeakFile(const File& monolithFile);
+
+	/** Loads the peak file of the given monolith. Returns nullptr if there is no peak file or if it is outdated. */
+	static MonolithPeakCache* loadForMonolith(const File& monolithFile);
+
+	/** Reads the whole monolith and writes the peak file.
+	*
+	*	This can take a while for big monoliths. If you pass in a progress value it will be updated during the process.
+	*	If the current thread (or the given job) should exit, it stops without writing the file.
+	*/
+	static bool writePeakFile(const File& monolithFile, double* progress=nullptr, ThreadPoolJob* job=nullptr);
+
+	int getNumChannels() const noexcept { return numChannels; }
+
+	int64 getNumSamples() const noexcept { return numSamples; }
+
+	/** Calculates the min and max values of the given range of the monolith.
+	*
+	*	It starts with the coarsest level that has a bin size smaller than the range and only reads the edges of 
+	*	the range from the finer levels, so the amount of data that is read doesn't depend on the length of the range.
+	*/
+	void getMinMax(int channelIndex, int64 startSample, int64 numSamplesToCheck, float& minValue, float& maxValue) const noexcept;
+
+	/** An AudioThumbnailBase that draws a section of a monolith using the peak cache.
+	*
+	*	Use this instead of an AudioThumbnail for monolithic samples. It ignores every method that would feed 
+	*	it with audio data.
+	*/
+	class Thumbnail : public AudioThumbnailBase
+	{
+	public:
+
+		Thumbnail(MonolithPeakCache* cache_, int64 offset_, int64 length_, double sampleRate_, int64 hashCode_);
+
+		void clear() override { length = 0; sendChangeMessage(); }
+		bool setSource(InputSource* newSource) override;
+		void setReader(AudioFormatReader* newReader, int64 newHashCode) override;
+		bool loadFrom(InputStream&) override { return false; }
+		void saveTo(OutputStream&) const override {}
+
+		int getNumChannels() const noexcept override { return cache->getNumChannels(); }
+		double getTotalLength() const noexcept override;
+
+		void drawChannel(Graphics& g, const Rectangle<int>& area, double startTimeSeconds, double endTimeSeconds, int channelNum, float verticalZoomFactor) override;
+		void drawChannels(Graphics& g, const Rectangle<int>& area, double startTimeSeconds, double endTimeSeconds, float verticalZoomFactor) override;
+
+		bool isFullyLoaded() const noexcept override { return true; }
+		int64 getNumSamplesFinished() const noexcept override { return length; }
+
+		float getApproximatePeak() const override;
+		void getApproximateMinMax(double startTime, double endTime, int channelIndex, float& minValue, float& maxValue) const noexcept override;
+
+		int64 getHashCode() const override { return hashCode; }
+
+		void reset(int, double, int64) override {}
+		void addBlock(int64, const AudioSampleBuffer&, int, int) override {}
+
+	private:
+
+		MonolithPeakCache::Ptr cache;
+
+		const int64 offset;
+		int64 length;
+		const double sampleRate;
+		const int64 hashCode;
+
+		JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Thumbnail);
+	};
+
+	/** Writes peak files on a background thread. Use this with a SharedResourcePointer. */
+	class AsyncWriter : public ThreadPool
+	{
+	public:
+
+		AsyncWriter() : ThreadPool(1) {};
+
+		~AsyncWriter() { removeAllJobs(true, 2000); }
+
+		/** Adds a job that writes the peak file of the given monolith (unless it's already pending). */
+		void addMonolith(const File& monolithFile);
+
+	private:
+
+		class Job;
+
+		CriticalSection lock;
+		Array<File> pendingFiles;
+
+		JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AsyncWriter);
+	};
+
+private:
+
+	struct Level
+	{
+		int binSize;
+		int64 numBins;
+		const int8* data;
+	};
+
+	MonolithPeakCache(MemoryMappedFile* mappedFile, const File& monolithFile);
+
+	bool isValid() const noexcept { return levels.size() > 0; }
+
+	/** Adds the bins of the level that are inside the range and uses the lower levels for the rest. */
+	void scanRange(int levelIndex, int channelIndex, int64 start, int64 end, int8& minInt, int8& maxInt) const noexcept;
+
+	static void writeHeader(OutputStream& output, const File& monolithFile, int numChannels, int64 numSamples, const Array<int64>& numBinsPerLevel);
+
+	ScopedPointer<MemoryMappedFile> map;
+
+	int numChannels;
+	int64 numSamples;
+
+	Array<Level> levels;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MonolithPeakCache);
+};
+
+#endif  // MONOLITHPEAKCACHE_H_INCLUDED
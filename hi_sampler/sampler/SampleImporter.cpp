@@ -97,7 +97,7 @@ void SampleImporter::closeGaps(Array<ModulatorSamplerSound*> &selection, bool cl
 
 #define SET(x, y) (v.setProperty(ModulatorSamplerSound::getPropertyName(x), y, nullptr));
 
-bool SampleImporter::createSoundAndAddToSampler(ModulatorSampler *sampler, const SamplerSoundBasicData &basicData)
+ValueTree SampleImporter::createSoundDescription(ModulatorSampler *sampler, const SamplerSoundBasicData &basicData)
 {
 	ValueTree v("sample");
 
@@ -109,6 +109,9 @@ bool SampleImporter::createSoundAndAddToSampler(ModulatorSampler *sampler, const
 	SET(ModulatorSamplerSound::VeloHigh, basicData.hiVelocity);
 	SET(ModulatorSamplerSound::RRGroup, basicData.group);
 
+	if (basicData.normalizedPeak > 0.0f)
+		v.setProperty("NormalizedPeak", basicData.normalizedPeak, nullptr);
+
 	String allowedWildcards = sampler->getMainController()->getSampleManager().getModulatorSamplerSoundPool()->afm.getWildcardForAllFormats();
 
 	for (int i = 0; i < basicData.fileNames.size(); i++)
@@ -124,6 +127,13 @@ bool SampleImporter::createSoundAndAddToSampler(ModulatorSampler *sampler, const
 		v.addChild(fileChild, -1, nullptr);
 	}
 
+	return v;
+}
+
+bool SampleImporter::createSoundAndAddToSampler(ModulatorSampler *sampler, const SamplerSoundBasicData &basicData)
+{
+	ValueTree v = createSoundDescription(sampler, basicData);
+
 	try
 	{
 		sampler->addSamplerSound(v, basicData.index);
@@ -188,28 +198,21 @@ void SampleImporter::importNewAudioFiles(Component *childComponentOfMainEditor,
 												SampleImporter::loadAudioFilesUsingDropPoint(childComponentOfMainEditor,
 																								sampler,
 																								fileNames,
-																								draggedRootNotes);
+																								draggedRootNotes,
+																								fid->useMetadata());
 												break;
         case FileImportDialog::numImportModes:  break;
 
 		}
-
-		if (fid->useMetadata())
-		{
-			SamplerBody* body = childComponentOfMainEditor->findParentComponentOfClass<SamplerBody>();
-
-			if (body != nullptr)
-			{
-				SampleEditHandler::SampleEditingActions::automapUsingMetadata(sampler);
-			}
-		}
 	}
 }
 
-void SampleImporter::loadAudioFilesUsingDropPoint(Component* /*childComponentOfMainEditor*/, ModulatorSampler *sampler, const StringArray &fileNames, BigInteger rootNotes)
+void SampleImporter::loadAudioFilesUsingDropPoint(Component* childComponentOfMainEditor, ModulatorSampler *sampler, const StringArray &fileNames, BigInteger rootNotes, bool useMetadata)
 {
 	const int startIndex = sampler->getNumSounds();
 
+	Array<SamplerSoundBasicData> dataList;
+
 	const bool mapToVelocity = fileNames.size() > 1 && rootNotes.countNumberOfSetBits() == 1;
 
 	const float velocityDelta = 127.0f / (float)fileNames.size();
@@ -252,21 +255,21 @@ void SampleImporter::loadAudioFilesUsingDropPoint(Component* /*childComponentOfM
 			noteNumber += delta;
 		}
 
-		createSoundAndAddToSampler(sampler, data);		
+		dataList.add(data);
 	}
 
-	ThumbnailHandler::saveNewThumbNails(sampler, fileNames);
+	const int flags = SampleImportBatch::CalculatePeak | (useMetadata ? SampleImportBatch::ReadMetadata : 0);
 
-	sampler->refreshPreloadSizes();
-	sampler->refreshMemoryUsage();
+	SampleImportWindow* window = new SampleImportWindow(sampler, new SampleImportBatch(sampler, dataList, flags));
 
-	
+	window->setModalBaseWindowComponent(childComponentOfMainEditor);
+	window->runThread();
 }
 
-void SampleImporter::loadAudioFilesUsingFileName(Component *childComponentOfMainEditor, ModulatorSampler *sampler, const StringArray &fileNames, bool /*useVelocityAutomap*/)
+void SampleImporter::loadAudioFilesUsingFileName(Component *childComponentOfMainEditor, ModulatorSampler *sampler, const StringArray &fileNames, bool useMetadata)
 {
 	
-	FileImportDialogWindow *dialogWindow = new FileImportDialogWindow(sampler, fileNames);
+	FileImportDialogWindow *dialogWindow = new FileImportDialogWindow(sampler, fileNames, useMetadata);
 
 	dialogWindow->setModalBaseWindowComponent(childComponentOfMainEditor);
 
@@ -276,63 +279,31 @@ void SampleImporter::loadAudioFilesUsingFileName(Component *childComponentOfMain
 
 }
 
-void SampleImporter::loadAudioFilesUsingPitchDetection(Component* /*childComponentOfMainEditor*/, ModulatorSampler *sampler, const StringArray &fileNames, bool /*useVelocityAutomap*/)
+void SampleImporter::loadAudioFilesUsingPitchDetection(Component* childComponentOfMainEditor, ModulatorSampler *sampler, const StringArray &fileNames, bool useMetadata)
 {
-	Array<Range<double>> freqRanges;
-
-	freqRanges.add(Range<double>(0, MidiMessage::getMidiNoteInHertz(1)/2));
-
-	for(int i = 1; i < 126; i++)
-	{
-		const double thisPitch = MidiMessage::getMidiNoteInHertz(i);
-		const double nextPitch = MidiMessage::getMidiNoteInHertz(i+1);
-		const double prevPitch = MidiMessage::getMidiNoteInHertz(i-1);
-
-		const double lowerLimit = thisPitch - (thisPitch-prevPitch) * 0.5;
-		const double upperLimit = thisPitch + (nextPitch - thisPitch) * 0.5;
-
-		freqRanges.add(Range<double>(lowerLimit, upperLimit));		
-	}
-
-	const int numSamplesPerDetection = PitchDetection::getNumSamplesNeeded(sampler->Processor::getSampleRate());
-	AudioSampleBuffer pitchDetectionBuffer(2, numSamplesPerDetection);
-
 	const int startIndex = sampler->getNumSounds();
 
+	Array<SamplerSoundBasicData> dataList;
+
 	for(int i = 0; i < fileNames.size(); i++)
 	{
-		const double pitch = PitchDetection::detectPitch(File(fileNames[i]), pitchDetectionBuffer, sampler->Processor::getSampleRate());
-		int rootNote = -1;
-
-		for(int j = 0; j <freqRanges.size(); j++)
-		{
-			if(freqRanges[j].contains(pitch))
-			{
-				debugToConsole(sampler, "Detected Root Note: " + MidiMessage::getMidiNoteName(j, true, true, 3));
-				rootNote = j;
-				break;
-			}
-		}
-
-		if(rootNote == -1) debugError(sampler, "Root note cannot be detected, skipping sample " + fileNames[i]);
-		
 		SamplerSoundBasicData data;
 
+		// The root note will be set after the pitch detection
 		data.fileNames.add(fileNames[i]);
 		data.index = startIndex + i;
-		data.rootNote = rootNote;
-		data.lowKey = rootNote;
-		data.hiKey = rootNote;
 		data.lowVelocity = 0;
 		data.hiVelocity = 127;
 
-		createSoundAndAddToSampler(sampler, data);
+		dataList.add(data);
 	}
 
-	ThumbnailHandler::saveNewThumbNails(sampler, fileNames);
+	const int flags = SampleImportBatch::CalculatePeak | SampleImportBatch::DetectPitch | (useMetadata ? SampleImportBatch::ReadMetadata : 0);
 
-	sampler->refreshPreloadSizes();
-	sampler->refreshMemoryUsage();
+	SampleImportWindow* window = new SampleImportWindow(sampler, new SampleImportBatch(sampler, dataList, flags));
+
+	window->setModalBaseWindowComponent(childComponentOfMainEditor);
+	window->runThread();
 }
 
 void SampleImporter::loadAudioFilesRaw(Component* /*childComponentOfMainEditor*/, ModulatorSampler* sampler, const StringArray& fileNames)
@@ -502,10 +473,11 @@ int SampleImporter::SampleCollection::getIndexOfSameMicSample(int currentIndex)
 	return -1;
 }
 
-FileImportDialogWindow::FileImportDialogWindow(ModulatorSampler *sampler_, const StringArray &files_):
+FileImportDialogWindow::FileImportDialogWindow(ModulatorSampler *sampler_, const StringArray &files_, bool useMetadata_):
 	ThreadWithAsyncProgressWindow("File Name Pattern Settings"),
 	sampler(sampler_),
-	files(files_)
+	files(files_),
+	useMetadata(useMetadata_)
 {
 	fid = new FileNameImporterDialog(sampler, files);
 
@@ -588,37 +560,24 @@ void FileImportDialogWindow::run()
 
 	sampler->setNumMicPositions(collection.multiMicTokens);
 
-	for (int i = 0; i < collection.dataList.size(); i++)
-	{
-		showStatusMessage("Loading sample " + collection.dataList[i].fileNames[0]);
+	const int flags = SampleImportBatch::CalculatePeak | (useMetadata ? SampleImportBatch::ReadMetadata : 0);
 
-		setProgress((double)i / (double)collection.dataList.size());
+	batch = new SampleImportBatch(sampler, collection.dataList, flags);
 
-		SampleImporter::createSoundAndAddToSampler(sampler, collection.dataList[i]);
-
-		if (threadShouldExit())
-		{
-			sampler->setShouldUpdateUI(true);
-			pool->setUpdatePool(true);
-			pool->setDeactivatePoolSearch(false);
-			return;
-		}
-	}
+	if (batch->analyseFiles(this))
+		batch->addSoundsToSampler(this);
 
 	sampler->setShouldUpdateUI(true);
 	pool->setUpdatePool(true);
 	pool->setDeactivatePoolSearch(false);
-
-	sampler->getMainController()->getSampleManager().getModulatorSamplerSoundPool()->sendChangeMessage();
-	sampler->sendChangeMessage();
 }
 
 
 
 void FileImportDialogWindow::threadFinished()
 {
-	sampler->refreshPreloadSizes();
-	sampler->refreshMemoryUsage();
+	if (batch != nullptr)
+		batch->finishImport();
 
 	int currentRRAmount = (int)sampler->getAttribute(ModulatorSampler::Parameters::RRGroupAmount);
 	int maxRRIndex = 0;
@@ -638,4 +597,401 @@ void FileImportDialogWindow::threadFinished()
 		}
 	}
 
-}
\ No newline at end of file
+}
+// ==================================================================================================================== SampleImportBatch
+
+class SampleImportBatch::AnalysisJob : public ThreadPoolJob
+{
+public:
+
+	AnalysisJob(SampleImportBatch& parent_, int index_) :
+		ThreadPoolJob("Analyse sample"),
+		parent(parent_),
+		index(index_)
+	{};
+
+	JobStatus runJob() override
+	{
+		const SampleImporter::SamplerSoundBasicData& data = parent.dataList.getReference(index);
+		AnalysisResult& r = *parent.results[index];
+
+		AudioFormatManager afm;
+		afm.registerBasicFormats();
+
+		const bool calculatePeak = (parent.analysisFlags & CalculatePeak) != 0;
+
+		// The pitch and the metadata is taken from the first mic position, the peak from all of them
+		for (int i = 0; i < data.fileNames.size(); i++)
+		{
+			ScopedPointer<AudioFormatReader> reader = afm.createReaderFor(File(data.fileNames[i]));
+
+			if (reader == nullptr)
+				continue;
+
+			r.fileWasRead = true;
+
+			if (i == 0 && (parent.analysisFlags & ReadMetadata) != 0)
+				r.metadata = reader->metadataValues;
+
+			bool pitchFound = i != 0 || (parent.analysisFlags & DetectPitch) == 0;
+
+			if (pitchFound && !calculatePeak)
+				continue;
+
+			const int numSamplesPerDetection = PitchDetection::getNumSamplesNeeded(reader->sampleRate);
+			const int numSamplesPerChunk = numSamplesPerDetection * 16;
+
+			AudioSampleBuffer buffer(2, numSamplesPerChunk);
+
+			for (int64 chunkStart = 0; chunkStart < reader->lengthInSamples; chunkStart += numSamplesPerChunk)
+			{
+				if (shouldExit())
+					return jobHasFinished;
+
+				const int numThisTime = (int)jmin<int64>(numSamplesPerChunk, reader->lengthInSamples - chunkStart);
+
+				reader->read(&buffer, 0, numThisTime, chunkStart, true, true);
+
+				if (calculatePeak)
+					r.peak = jmax<float>(r.peak, buffer.getMagnitude(0, numThisTime));
+
+				for (int start = 0; !pitchFound && start + numSamplesPerDetection <= numThisTime; start += numSamplesPerDetection)
+				{
+					if (chunkStart + start + numSamplesPerDetection >= reader->lengthInSamples)
+						break;
+
+					r.pitch = PitchDetection::detectPitch(buffer, start, numSamplesPerDetection, reader->sampleRate);
+					pitchFound = r.pitch != 0.0;
+				}
+
+				if (pitchFound && !calculatePeak)
+					break;
+			}
+		}
+
+		if (r.fileWasRead)
+			createSound(data, r);
+
+		++parent.numAnalysedFiles;
+
+		return jobHasFinished;
+	}
+
+private:
+
+	/** Creates the sound from the analysis results. Everything except the insertion into the sampler is done here. */
+	void createSound(SampleImporter::SamplerSoundBasicData data, AnalysisResult& r)
+	{
+		if ((parent.analysisFlags & DetectPitch) != 0)
+		{
+			const int rootNote = getRootNoteForPitch(r.pitch);
+
+			// addSoundsToSampler() reports the skipped sample
+			if (rootNote == -1)
+				return;
+
+			data.rootNote = rootNote;
+			data.lowKey = rootNote;
+			data.hiKey = rootNote;
+		}
+
+		if (r.peak > 0.0f)
+			data.normalizedPeak = 1.0f / r.peak;
+
+		ModulatorSamplerSoundPool *pool = parent.sampler->getMainController()->getSampleManager().getModulatorSamplerSoundPool();
+
+		const ValueTree v = SampleImporter::createSoundDescription(parent.sampler, data);
+
+		try
+		{
+			r.sound = pool->createSoundWithoutPool(v, data.index, r.newSamples);
+			r.sound->restoreFromValueTree(v);
+
+			if (r.metadata.size() > 0)
+				r.metadataWasFound = SampleEditHandler::SampleEditingActions::setSoundPropertiesFromMetadata(r.sound, r.metadata);
+		}
+		catch (StreamingSamplerSound::LoadingError l)
+		{
+			r.errorMessage << "Error at preloading sample " << l.fileName << ": " << l.errorDescription;
+			r.sound = nullptr;
+			r.newSamples.clear();
+		}
+	}
+
+	SampleImportBatch& parent;
+	const int index;
+};
+
+/** Removes the imported sounds on undo and adds them again on redo. 
+*
+*	The sounds are already added when this action is performed the first time, so this does nothing.
+*/
+class SampleImportBatch::ImportAction : public UndoableAction
+{
+public:
+
+	ImportAction(ModulatorSampler* sampler_, const Array<WeakReference<ModulatorSamplerSound>>& addedSounds_) :
+		sampler(sampler_),
+		addedSounds(addedSounds_),
+		soundsAreAdded(true)
+	{};
+
+	bool perform() override
+	{
+		ModulatorSampler* s = dynamic_cast<ModulatorSampler*>(sampler.get());
+
+		if (s == nullptr)
+			return false;
+
+		if (!soundsAreAdded)
+		{
+			addedSounds.clear();
+
+			for (int i = 0; i < removedSounds.size(); i++)
+			{
+				const int index = s->getNumSounds();
+
+				try
+				{
+					s->addSamplerSound(removedSounds[i], index);
+					addedSounds.add(s->getSound(index));
+				}
+				catch (StreamingSamplerSound::LoadingError l)
+				{
+					debugError(s, "Error at preloading sample " + l.fileName + ": " + l.errorDescription);
+				}
+			}
+
+			removedSounds.clear();
+			soundsAreAdded = true;
+
+			refresh(s);
+		}
+
+		return true;
+	}
+
+	bool undo() override
+	{
+		ModulatorSampler* s = dynamic_cast<ModulatorSampler*>(sampler.get());
+
+		if (s == nullptr || !soundsAreAdded)
+			return false;
+
+		removedSounds.clear();
+
+		for (int i = 0; i < addedSounds.size(); i++)
+		{
+			if (addedSounds[i].get() != nullptr)
+				removedSounds.add(addedSounds[i]->exportAsValueTree());
+		}
+
+		for (int i = addedSounds.size() - 1; i >= 0; i--)
+		{
+			if (addedSounds[i].get() != nullptr)
+				s->deleteSound(addedSounds[i].get());
+		}
+
+		addedSounds.clear();
+		soundsAreAdded = false;
+
+		refresh(s);
+
+		return true;
+	}
+
+private:
+
+	static void refresh(ModulatorSampler* s)
+	{
+		s->refreshPreloadSizes();
+		s->refreshMemoryUsage();
+		s->getMainController()->getSampleManager().getModulatorSamplerSoundPool()->sendChangeMessage();
+	}
+
+	WeakReference<Processor> sampler;
+
+	Array<WeakReference<ModulatorSamplerSound>> addedSounds;
+	Array<ValueTree> removedSounds;
+
+	bool soundsAreAdded;
+};
+
+SampleImportBatch::SampleImportBatch(ModulatorSampler* sampler_, const Array<SampleImporter::SamplerSoundBasicData>& dataList_, int analysisFlags_) :
+	sampler(sampler_),
+	dataList(dataList_),
+	analysisFlags(analysisFlags_),
+	numAnalysedFiles(0)
+{
+	for (int i = 0; i < dataList.size(); i++)
+		results.add(new AnalysisResult());
+}
+
+SampleImportBatch::~SampleImportBatch()
+{
+
+}
+
+bool SampleImportBatch::analyseFiles(ThreadWithAsyncProgressWindow* window)
+{
+	if (dataList.size() == 0)
+		return true;
+
+	window->showStatusMessage("Analysing " + String(dataList.size()) + " files");
+
+	ThreadPool pool(jmax<int>(1, SystemStats::getNumCpus() - 1));
+
+	for (int i = 0; i < dataList.size(); i++)
+		pool.addJob(new AnalysisJob(*this, i), true);
+
+	while (pool.getNumJobs() > 0)
+	{
+		if (window->threadShouldExit())
+		{
+			pool.removeAllJobs(true, 5000);
+			return false;
+		}
+
+		window->setProgress((double)numAnalysedFiles.get() / (double)dataList.size());
+
+		Thread::sleep(50);
+	}
+
+	return true;
+}
+
+bool SampleImportBatch::addSoundsToSampler(ThreadWithAsyncProgressWindow* window)
+{
+	ModulatorSamplerSoundPool *pool = sampler->getMainController()->getSampleManager().getModulatorSamplerSoundPool();
+
+	sampler->setShouldUpdateUI(false);
+	pool->setUpdatePool(false);
+
+	window->showStatusMessage("Adding " + String(dataList.size()) + " samples");
+
+	bool metadataWasFound = false;
+	bool wasCancelled = false;
+
+	for (int i = 0; i < dataList.size(); i++)
+	{
+		if (window->threadShouldExit())
+		{
+			wasCancelled = true;
+			break;
+		}
+
+		window->setProgress((double)i / (double)dataList.size());
+
+		const String firstFileName = dataList.getReference(i).fileNames[0];
+		AnalysisResult& r = *results[i];
+
+		if (!r.fileWasRead)
+		{
+			debugError(sampler, "Can't read " + firstFileName + ", skipping sample");
+			continue;
+		}
+
+		if (r.errorMessage.isNotEmpty())
+		{
+			sampler->getMainController()->getDebugLogger().logMessage(r.errorMessage);
+			debugError(sampler, r.errorMessage);
+			continue;
+		}
+
+		if (r.sound == nullptr)
+		{
+			debugError(sampler, "Root note cannot be detected, skipping sample " + firstFileName);
+			continue;
+		}
+
+		// Skipped samples would leave a gap, so the sound gets the next free index when it's added
+		sampler->addCreatedSamplerSound(r.sound, r.newSamples);
+
+		if (r.metadataWasFound)
+			metadataWasFound = true;
+
+		addedSounds.add(r.sound.get());
+
+		r.sound = nullptr;
+		r.newSamples.clear();
+	}
+
+	if (metadataWasFound) debugToConsole(sampler, "Metadata was found for imported samples");
+
+	sampler->setShouldUpdateUI(true);
+	pool->setUpdatePool(true);
+
+	pool->sendChangeMessage();
+	sampler->sendChangeMessage();
+
+	return !wasCancelled;
+}
+
+void SampleImportBatch::finishImport()
+{
+	if (addedSounds.size() > 0)
+	{
+		sampler->getUndoManager()->beginNewTransaction("Import " + String(addedSounds.size()) + " samples");
+		sampler->getUndoManager()->perform(new ImportAction(sampler, addedSounds));
+	}
+
+	sampler->refreshPreloadSizes();
+	sampler->refreshMemoryUsage();
+}
+
+StringArray SampleImportBatch::getImportedFileNames() const
+{
+	StringArray fileNames;
+
+	for (int i = 0; i < addedSounds.size(); i++)
+	{
+		if (addedSounds[i].get() != nullptr)
+			fileNames.add(addedSounds[i]->getProperty(ModulatorSamplerSound::FileName).toString());
+	}
+
+	return fileNames;
+}
+
+int SampleImportBatch::getRootNoteForPitch(double pitch)
+{
+	if (pitch <= 0.0)
+		return -1;
+
+	for (int i = 0; i < 126; i++)
+	{
+		const double thisPitch = MidiMessage::getMidiNoteInHertz(i);
+		const double lowerLimit = i == 0 ? 0.0 : thisPitch - (thisPitch - MidiMessage::getMidiNoteInHertz(i - 1)) * 0.5;
+		const double upperLimit = i == 0 ? MidiMessage::getMidiNoteInHertz(1) / 2 : thisPitch + (MidiMessage::getMidiNoteInHertz(i + 1) - thisPitch) * 0.5;
+
+		if (Range<double>(lowerLimit, upperLimit).contains(pitch))
+			return i;
+	}
+
+	return -1;
+}
+
+// ==================================================================================================================== SampleImportWindow
+
+SampleImportWindow::SampleImportWindow(ModulatorSampler* sampler_, SampleImportBatch* batch_) :
+	ThreadWithAsyncProgressWindow("Importing samples"),
+	sampler(sampler_),
+	batch(batch_)
+{
+	addBasicComponents(false);
+}
+
+void SampleImportWindow::run()
+{
+	if (batch->analyseFiles(this))
+		batch->addSoundsToSampler(this);
+}
+
+void SampleImportWindow::threadFinished()
+{
+	batch->finishImport();
+
+	const StringArray importedFiles = batch->getImportedFileNames();
+
+	if (importedFiles.size() > 0)
+		ThumbnailHandler::saveNewThumbNails(sampler, importedFiles);
+}
@@ -34,12 +34,13 @@
 #define SAMPLEIMPORTER_H_INCLUDED
 
 class FileNameImporterDialog;
+class SampleImportBatch;
 
 class FileImportDialogWindow : public ThreadWithAsyncProgressWindow
 {
 public:
 
-	FileImportDialogWindow(ModulatorSampler *sampler, const StringArray &files);
+	FileImportDialogWindow(ModulatorSampler *sampler, const StringArray &files, bool useMetadata);
 
 	~FileImportDialogWindow();
 
@@ -50,8 +51,10 @@ public:
 private:
 	
 	ScopedPointer<FileNameImporterDialog> fid;
+	ScopedPointer<SampleImportBatch> batch;
 	ModulatorSampler *sampler;
 	const StringArray &files;
+	const bool useMetadata;
 };
 
 
@@ -75,16 +78,16 @@ public:
 	static void closeGaps(Array<ModulatorSamplerSound*> &selection, bool closeNoteGaps, bool increaseUpperLimit=true);
 
 	/** Loads audio files into the sampler by searching the file name for root note information. */
-	static void loadAudioFilesUsingFileName(Component *childComponentOfMainEditor, ModulatorSampler *sampler, const StringArray &fileNames, bool useVelocityAutomap);
+	static void loadAudioFilesUsingFileName(Component *childComponentOfMainEditor, ModulatorSampler *sampler, const StringArray &fileNames, bool useMetadata);
 
 	/** Loads audio files into the sampler by using the drop point to specify the root notes. 
 	*
 	*	Since all samples are mapped along the note scale, the velocity automap is not possible.
 	*/
-	static void loadAudioFilesUsingDropPoint(Component *childComponentOfMainEditor, ModulatorSampler *sampler, const StringArray &fileNames, BigInteger rootNotes);
+	static void loadAudioFilesUsingDropPoint(Component *childComponentOfMainEditor, ModulatorSampler *sampler, const StringArray &fileNames, BigInteger rootNotes, bool useMetadata=false);
 
 	/** Loads audio files into the sampler by using a pitch detection algorithm that sets the root note automatically. */
-	static void loadAudioFilesUsingPitchDetection(Component *childComponentOfMainEditor, ModulatorSampler *sampler, const StringArray &fileNames, bool useVelocityAutomap);
+	static void loadAudioFilesUsingPitchDetection(Component *childComponentOfMainEditor, ModulatorSampler *sampler, const StringArray &fileNames, bool useMetadata);
 
 	/** Loads audio files without any mapping. */
 	static void loadAudioFilesRaw(Component* childComponentOfMainEditor, ModulatorSampler* sampler, const StringArray& fileNames);
@@ -109,7 +112,8 @@ public:
 			lowVelocity(0),
 			hiVelocity(127),
 			group(1),
-			multiMic(1)
+			multiMic(1),
+			normalizedPeak(-1.0f)
 		{};
 
 		int index;
@@ -121,6 +125,7 @@ public:
 		int hiVelocity;
 		int group;
 		int multiMic;
+		float normalizedPeak;
 
 		String toString()
 		{
@@ -152,6 +157,9 @@ public:
 
 	static bool createSoundAndAddToSampler(ModulatorSampler *sampler, const SamplerSoundBasicData &basicData);
 
+	/** Creates the ValueTree that describes the sound (the sampler is only used to check the file formats). */
+	static ValueTree createSoundDescription(ModulatorSampler *sampler, const SamplerSoundBasicData &basicData);
+
 private:
 
 	/** Creates a xml element from the filename with the most basic sound properties.
@@ -163,4 +171,98 @@ private:
 };
 
 
+/** Imports a list of samples into a sampler and analyses the files on multiple threads.
+*	@ingroup sampler
+*
+*	Every file is read by a worker thread of a ThreadPool that calculates the peak level, detects the pitch and
+*	reads the metadata (depending on the analysis flags) and then creates the sound. The sounds are then added 
+*	to the sampler in one batch and the whole import is registered as a single undoable action.
+*
+*	This class doesn't create any UI, so you need to use it within a ThreadWithAsyncProgressWindow:
+*
+*	1. call analyseFiles() and addSoundsToSampler() in the run() method.
+*	2. call finishImport() in the threadFinished() method.
+*/
+class SampleImportBatch
+{
+public:
+
+	enum AnalysisFlags
+	{
+		CalculatePeak = 1,
+		DetectPitch = 2,
+		ReadMetadata = 4
+	};
+
+	SampleImportBatch(ModulatorSampler* sampler, const Array<SampleImporter::SamplerSoundBasicData>& dataList, int analysisFlags);
+
+	~SampleImportBatch();
+
+	/** Analyses all files and creates the sounds on a thread pool. Returns false if the import was cancelled. */
+	bool analyseFiles(ThreadWithAsyncProgressWindow* window);
+
+	/** Adds the sounds that were created by analyseFiles() to the sampler. Returns false if the import was cancelled. 
+	*
+	*	The sounds that were added before the cancellation stay in the sampler (and can be removed with undo).
+	*/
+	bool addSoundsToSampler(ThreadWithAsyncProgressWindow* window);
+
+	/** Registers the import as undoable action and refreshes the sampler. Call this on the message thread. */
+	void finishImport();
+
+	/** Returns the (first) file names of all sounds that were added to the sampler. */
+	StringArray getImportedFileNames() const;
+
+	/** Returns the MIDI note that matches the given frequency (or -1 if it can't be found). */
+	static int getRootNoteForPitch(double pitch);
+
+private:
+
+	struct AnalysisResult
+	{
+		bool fileWasRead = false;
+		double pitch = 0.0;
+		float peak = 0.0f;
+		StringPairArray metadata;
+
+		ReferenceCountedObjectPtr<ModulatorSamplerSound> sound;
+		StreamingSamplerSoundArray newSamples;
+		bool metadataWasFound = false;
+		String errorMessage;
+	};
+
+	class AnalysisJob;
+	class ImportAction;
+
+	ModulatorSampler* sampler;
+
+	Array<SampleImporter::SamplerSoundBasicData> dataList;
+	const int analysisFlags;
+
+	OwnedArray<AnalysisResult> results;
+	Atomic<int> numAnalysedFiles;
+
+	Array<WeakReference<ModulatorSamplerSound>> addedSounds;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleImportBatch);
+};
+
+/** A progress window that runs a SampleImportBatch and creates the thumbnails of the new samples. */
+class SampleImportWindow : public ThreadWithAsyncProgressWindow
+{
+public:
+
+	SampleImportWindow(ModulatorSampler* sampler, SampleImportBatch* batch);
+
+	void run() override;
+
+	void threadFinished() override;
+
+private:
+
+	ModulatorSampler* sampler;
+	ScopedPointer<SampleImportBatch> batch;
+};
+
+
 #endif  // SAMPLEIMPORTER_H_INCLUDED
@@ -53,6 +53,18 @@ static const char * sfz_opcodeNames[SfzImporter::numSupportedOpcodes] =
 		"key"
 };
 
+/** Alternative spellings of supported opcodes (SFZ v1 / v2). */
+static const struct SfzOpcodeAlias
+{
+	const char *name;
+	SfzImporter::Opcode opcode;
+} sfz_opcodeAliases[] =
+{
+	{ "loop_start", SfzImporter::loopstart },
+	{ "loop_end", SfzImporter::loopend },
+	{ "loopmode", SfzImporter::loop_mode }
+};
+
 ModulatorSamplerSound::Property SfzImporter::getSamplerProperty(Opcode opcode)
 {
 	switch(opcode)
@@ -77,204 +89,516 @@ ModulatorSamplerSound::Property SfzImporter::getSamplerProperty(Opcode opcode)
 	};
 }
 
-int getNoteNumberFromNameOrNumber(const String &data)
+const char **SfzImporter::opcodeNames = sfz_opcodeNames;
+
+bool SfzImporter::TextRange::equals(const char *text) const noexcept
 {
-    if(RegexFunctions::matchesWildcard("[A-Ga-g]#?-?[0-9]", data))
-    {
-        const String noteName = data.toUpperCase();
-        
-        for(int i = 0; i < 127; i++)
-        {
-            if(noteName.contains(MidiMessage::getMidiNoteName(i, true, true, 3)))
-            {
-                return i;
-            }
-        }
-        return -1;
-    }
-    
-    return data.getIntValue();
+	const int numChars = (int)strlen(text);
+
+	return numChars == length() && memcmp(start, text, numChars) == 0;
 }
 
-var SfzImporter::getOpcodeValue(Opcode o, const String &valueString) const
+bool SfzImporter::TextRange::contains(char c) const noexcept
 {
-	switch(o)
+	for (const char *p = start; p < end; p++)
 	{
-	case sample:		return var(fileToImport.getParentDirectory().getFullPathName() + "/" + valueString);
-	case loop_mode:		return (valueString == "loop_continuous") ? var(1) : var(0);
-    case lokey:
-    case hikey:
-    case pitch_keycenter: return var(getNoteNumberFromNameOrNumber(valueString));
-	default:			return var(valueString.getIntValue());
+		if (*p == c) return true;
 	}
+
+	return false;
 }
 
-const char **SfzImporter::opcodeNames = sfz_opcodeNames;
+static bool isSfzWhitespace(char c) noexcept { return c == ' ' || c == '\t'; }
 
+static bool isSfzNameCharacter(char c) noexcept 
+{ 
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '$';
+}
 
-void SfzImporter::parseTagLine(const String &restOfLine)
+SfzImporter::Tokeniser::Tokeniser(const char *data, size_t numBytes):
+	lineNumber(1),
+	p(data),
+	end(data + numBytes)
 {
-	StringArray sa = getOpcodeTokens(restOfLine);
-
-	for (int i = 0; i < sa.size(); i++)
-	{
-		parseOpcode(sa[i]);
-	}
+	// Skip the UTF-8 byte order mark
+	if (numBytes >= 3 && (uint8)p[0] == 0xEF && (uint8)p[1] == 0xBB && (uint8)p[2] == 0xBF)
+		p += 3;
 }
 
-StringArray SfzImporter::getOpcodeTokens(const String &line) const
+SfzImporter::Tokeniser::TokenType SfzImporter::Tokeniser::next()
 {
-	String stringToTokenise = line.contains(">") ? line.fromFirstOccurrenceOf(">", false, false) : line; // skip tags
+	skipWhitespaceAndComments();
 
-	StringArray tokens = StringArray::fromTokens(stringToTokenise, " ", "");
+	name = TextRange();
+	value = TextRange();
 
-	tokens.removeEmptyStrings();
+	if (p >= end) return EndOfFile;
 
-	for (int i = 0; i < tokens.size(); i++)
+	if (*p == '<')
 	{
-		if (!tokens[i].contains("="))
+		const char *nameStart = ++p;
+
+		while (p < end && *p != '>' && *p != '\n')
+			p++;
+
+		if (p >= end || *p != '>') throw SfzParsingError(lineNumber, "Missing '>' in header");
+
+		name = TextRange(nameStart, p++);
+		
+		return Header;
+	}
+
+	if (*p == '#')
+	{
+		const TextRange directive = readWord();
+
+		if (directive.equals("#define"))
 		{
-			if (i == 0) throw SfzParsingError(currentParseNumber, "Invalid token!");
+			skipSpaces();
+			name = readWord();
+			skipSpaces();
+			value = readWord();
+
+			if (name.length() < 2 || *name.start != '$') throw SfzParsingError(lineNumber, "Invalid macro name");
+
+			return Define;
+		}
+		else if (directive.equals("#include"))
+		{
+			skipSpaces();
+
+			if (p >= end || *p != '"') throw SfzParsingError(lineNumber, "Missing quotes for #include");
+
+			const char *pathStart = ++p;
+
+			while (p < end && *p != '"' && *p != '\n')
+				p++;
 
-			tokens.set(i - 1, tokens[i - 1] + " " + tokens[i]);
+			if (p >= end || *p != '"') throw SfzParsingError(lineNumber, "Missing quotes for #include");
 
-			tokens.remove(i--);
+			value = TextRange(pathStart, p++);
 
-			continue;
+			return Include;
 		}
+		
+		throw SfzParsingError(lineNumber, "Unknown directive " + directive.toString());
 	}
 
-	return tokens;
+	const char *nameStart = p;
+
+	while (p < end && isSfzNameCharacter(*p))
+		p++;
+
+	if (p >= end || *p != '=' || p == nameStart) throw SfzParsingError(lineNumber, "Invalid token!");
+
+	name = TextRange(nameStart, p++);
+	value = readValue();
+
+	return OpcodeToken;
 }
 
-void SfzImporter::parseOpcode(const String &opcode)
+void SfzImporter::Tokeniser::skipWhitespaceAndComments()
 {
-	StringArray opcodeTokens = StringArray::fromTokens(opcode, "=", "");
-
-	if(opcodeTokens.size() == 2)
+	while (p < end)
 	{
-		const int opcodeIndex = getOpcode(opcodeTokens[0]);
+		const char c = *p;
 
-		if(opcodeIndex == Opcode::groupName)
+		if (c == '\n')
 		{
-			if(dynamic_cast<Group*>(currentTarget) != nullptr) dynamic_cast<Group*>(currentTarget)->groupName = opcodeTokens[1];
-			else throw SfzParsingError(currentParseNumber, "group name opcode outside of group definition");
+			lineNumber++;
+			p++;
 		}
-		else if(opcodeIndex != -1)
+		else if (c == ' ' || c == '\t' || c == '\r')
 		{
-			if(currentTarget != nullptr)
-			{
-				currentTarget->setOpcodeValue(opcodeIndex, getOpcodeValue((Opcode)opcodeIndex, opcodeTokens[1]));
-			}
-			else
+			p++;
+		}
+		else if (c == '/' && p + 1 < end && p[1] == '/')
+		{
+			while (p < end && *p != '\n')
+				p++;
+		}
+		else if (c == '/' && p + 1 < end && p[1] == '*')
+		{
+			p += 2;
+
+			while (p < end && !(*p == '*' && p + 1 < end && p[1] == '/'))
 			{
-				throw SfzParsingError(currentParseNumber, "No Region for opcode");
+				if (*p == '\n') lineNumber++;
+				p++;
 			}
+
+			p = jmin<const char*>(end, p + 2);
+		}
+		else
+		{
+			return;
 		}
-				
-	}
-	else
-	{
-		throw SfzParsingError(currentParseNumber, "No opcode found");
 	}
 }
 
-void SfzImporter::parseOpcodes()
+void SfzImporter::Tokeniser::skipSpaces()
 {
-	StringArray fileData;
+	while (p < end && isSfzWhitespace(*p))
+		p++;
+}
 
-	fileToImport.readLines(fileData);
+SfzImporter::TextRange SfzImporter::Tokeniser::readValue()
+{
+	// Values can contain spaces (eg. sample=My Sample.wav), so the value only ends 
+	// at the end of the line, a comment, a header or the next opcode.
 
+	const char *valueStart = p;
+	const char *valueEnd = p;
 
-	for (int i = 0; i < fileData.size(); i++)
+	while (p < end)
 	{
-		String currentLine = fileData[i].trimStart().upToFirstOccurrenceOf("//", false, false);
-
-		currentParseNumber++;
+		const char c = *p;
 
-		if (currentLine.isEmpty() || !currentLine.containsNonWhitespaceChars()) continue; // Skip empty lines
-		if (currentLine.startsWith("//")) continue; // Skip comments
+		if (c == '\n' || c == '\r' || c == '<') break;
+		if (c == '/' && p + 1 < end && (p[1] == '/' || p[1] == '*')) break;
 
-		if (currentLine.startsWith(Global::getTag()))
+		if (isSfzWhitespace(c))
 		{
-			currentTarget = globalSfzObject;
+			if (isOpcodeAhead(p)) break;
 		}
-		else if (currentLine.startsWith(Group::getTag()))
+		else
 		{
-			if (i < fileData.size() - 1)
-			{
-				globalSfzObject->groups.add(new Group());
+			valueEnd = p + 1;
+		}
+		
+		p++;
+	}
 
-				currentTarget = globalSfzObject->groups.getLast();
+	return TextRange(valueStart, valueEnd);
+}
 
-				globalSfzObject->groups.getLast()->groupName = "Group " + String(globalSfzObject->groups.size());
+SfzImporter::TextRange SfzImporter::Tokeniser::readWord()
+{
+	const char *wordStart = p;
 
-			}
-			else
-			{
-				throw SfzParsingError(i, "Empty Group");
-			}
-		}
-		else if (currentLine.startsWith(Region::getTag()))
-		{
-			if (globalSfzObject->groups.size() > 0)
-			{
-				globalSfzObject->groups.getLast()->addRegion(new Region());
+	while (p < end && !isSfzWhitespace(*p) && *p != '\n' && *p != '\r')
+		p++;
 
-				currentTarget = globalSfzObject->groups.getLast()->regions.getLast();
-			}
-			else
-			{
-				throw SfzParsingError(i, "No Group for region");
-			}
-		}
+	return TextRange(wordStart, p);
+}
 
-		parseTagLine(currentLine);
+bool SfzImporter::Tokeniser::isOpcodeAhead(const char *position) const
+{
+	while (position < end && isSfzWhitespace(*position))
+		position++;
 
-		
+	const char *nameStart = position;
+
+	while (position < end && isSfzNameCharacter(*position))
+		position++;
+
+	return position != nameStart && position < end && *position == '=';
+}
+
+void SfzImporter::OpcodeSet::inheritFrom(const OpcodeSet &other)
+{
+	const uint32 missingOpcodes = other.definedOpcodes & ~definedOpcodes;
 
+	if (missingOpcodes == 0) return;
+
+	for (int i = 0; i < numSupportedOpcodes; i++)
+	{
+		if ((missingOpcodes & (1 << i)) != 0)
+			values[i] = other.values[i];
 	}
+
+	if ((missingOpcodes & (1 << sample)) != 0)
+		samplePath = other.samplePath;
+
+	definedOpcodes |= missingOpcodes;
 }
 
+int SfzImporter::getOpcode(const TextRange &opcodeName)
+{
+	for (int i = 0; i < numSupportedOpcodes; i++)
+	{
+		if (opcodeName.equals(opcodeNames[i])) return i;
+	}
+
+	for (int i = 0; i < numElementsInArray(sfz_opcodeAliases); i++)
+	{
+		if (opcodeName.equals(sfz_opcodeAliases[i].name)) return (int)sfz_opcodeAliases[i].opcode;
+	}
+
+	return -1;
+}
+
+int SfzImporter::getIntValue(const TextRange &valueRange)
+{
+	const char *p = valueRange.start;
+
+	const bool isNegative = p < valueRange.end && *p == '-';
+
+	if (p < valueRange.end && (*p == '-' || *p == '+')) p++;
+
+	int value = 0;
+
+	while (p < valueRange.end && *p >= '0' && *p <= '9')
+		value = value * 10 + (*p++ - '0');
+
+	return isNegative ? -value : value;
+}
+
+int SfzImporter::getNoteNumberFromNameOrNumber(const TextRange &valueRange)
+{
+	if (valueRange.isEmpty()) return 0;
+
+	static const int semitones[7] = { 9, 11, 0, 2, 4, 5, 7 }; // A - G
+
+	const char firstChar = (char)CharacterFunctions::toLowerCase((juce_wchar)*valueRange.start);
+
+	if (firstChar < 'a' || firstChar > 'g') return getIntValue(valueRange);
+
+	int noteNumber = semitones[firstChar - 'a'];
+
+	TextRange octaveRange(valueRange.start + 1, valueRange.end);
+
+	if (!octaveRange.isEmpty() && *octaveRange.start == '#')
+	{
+		noteNumber++;
+		octaveRange.start++;
+	}
+	else if (!octaveRange.isEmpty() && *octaveRange.start == 'b')
+	{
+		noteNumber--;
+		octaveRange.start++;
+	}
+
+	// C3 is the middle C (MIDI note 60)
+	noteNumber += (getIntValue(octaveRange) + 2) * 12;
+
+	return jlimit<int>(0, 127, noteNumber);
+}
+
+String SfzImporter::getValueString(const TextRange &valueRange) const
+{
+	String valueString = valueRange.toString();
+
+	if (valueRange.contains('$'))
+	{
+		// The macros are sorted by length so that $KEY doesn't replace the beginning of $KEY_LOW
+		for (int i = 0; i < macroNames.size(); i++)
+			valueString = valueString.replace(macroNames[i], macroValues[i]);
+	}
 
+	return valueString;
+}
 
-void SfzImporter::applyGlobalOpcodesToRegion()
+void SfzImporter::addDefinition(const TextRange &macroName, const TextRange &valueRange)
 {
-	NamedValueSet *globalSet = &globalSfzObject->opcodes;
+	const String name = macroName.toString();
+	const String value = getValueString(valueRange);
+
+	const int existingIndex = macroNames.indexOf(name);
 
-	for (int i = 0; i < globalSfzObject->groups.size(); i++)
+	if (existingIndex != -1)
 	{
-		NamedValueSet *groupSet = &globalSfzObject->groups[i]->opcodes;
+		macroValues.set(existingIndex, value);
+		return;
+	}
+
+	int insertIndex = 0;
 
-		ScopedPointer<XmlElement> xml = new XmlElement("a");
+	while (insertIndex < macroNames.size() && macroNames[insertIndex].length() >= name.length())
+		insertIndex++;
 
-		groupSet->copyToXmlAttributes(*xml);
+	macroNames.insert(insertIndex, name);
+	macroValues.insert(insertIndex, value);
+}
+
+void SfzImporter::addHeader(const TextRange &headerName, int lineNumber)
+{
+	parsingControlHeader = false;
 
-		for (int j = 0; j < globalSfzObject->groups[i]->regions.size(); j++)
+	if (headerName.equals("region"))
+	{
+		if (currentGroup == nullptr)
 		{
-			Region *r = globalSfzObject->groups[i]->regions[j];
-			applyValueSetOnRegion(*globalSet, r);
-			applyValueSetOnRegion(*groupSet, r);
+			// Regions without a <group> header get their own group
+			const int masterIndex = masterOpcodes.size() - 1;
 
-			
+			currentGroup = groups.add(new Group(masterIndex, "Group " + String(groups.size() + 1)));
 		}
+
+		currentGroup->regions.add(OpcodeSet());
+		currentTarget = &currentGroup->regions.getReference(currentGroup->regions.size() - 1);
+	}
+	else if (headerName.equals("group"))
+	{
+		const int masterIndex = masterOpcodes.size() - 1;
+
+		currentGroup = groups.add(new Group(masterIndex, "Group " + String(groups.size() + 1)));
+		currentTarget = &currentGroup->opcodes;
+	}
+	else if (headerName.equals("master"))
+	{
+		masterOpcodes.add(OpcodeSet());
+
+		currentGroup = nullptr;
+		currentTarget = &masterOpcodes.getReference(masterOpcodes.size() - 1);
+	}
+	else if (headerName.equals("global"))
+	{
+		currentGroup = nullptr;
+		currentTarget = &globalOpcodes;
+	}
+	else if (headerName.equals("control"))
+	{
+		parsingControlHeader = true;
+		currentTarget = nullptr;
+	}
+	else if (headerName.isEmpty())
+	{
+		throw SfzParsingError(lineNumber, "Empty header");
+	}
+	else
+	{
+		// Unsupported header: skip all opcodes until the next header
+		currentTarget = nullptr;
 	}
 }
 
+void SfzImporter::addOpcode(const TextRange &opcodeName, const TextRange &valueRange, int lineNumber)
+{
+	if (parsingControlHeader)
+	{
+		if (opcodeName.equals("default_path"))
+			defaultPath = getValueString(valueRange).replaceCharacter('\\', '/');
+
+		return;
+	}
+
+	if (currentTarget == nullptr) return;
+
+	const int opcodeIndex = getOpcode(opcodeName);
+
+	if (opcodeIndex == -1) return;
+
+	// Only values that use a macro need to be copied
+	String substitutedValue;
+	TextRange v = valueRange;
+
+	if (valueRange.contains('$'))
+	{
+		substitutedValue = getValueString(valueRange);
+		v = TextRange(substitutedValue.toRawUTF8(), substitutedValue.toRawUTF8() + substitutedValue.getNumBytesAsUTF8());
+	}
+
+	switch (opcodeIndex)
+	{
+	case groupName:
+	{
+		if (currentGroup == nullptr || currentTarget != &currentGroup->opcodes) throw SfzParsingError(lineNumber, "group name opcode outside of group definition");
+
+		currentGroup->groupName = v.toString();
+		return;
+	}
+	case sample:
+	{
+		const String path = defaultPath + v.toString().replaceCharacter('\\', '/');
 
-void SfzImporter::applyValueSetOnRegion(const NamedValueSet &setToApply, Region * r)
+		currentTarget->samplePath = fileToImport.getParentDirectory().getChildFile(path).getFullPathName();
+		currentTarget->setValue(sample, 0);
+		return;
+	}
+	case loop_mode:
+	{
+		currentTarget->setValue(loop_mode, v.equals("loop_continuous") ? 1 : 0);
+		return;
+	}
+	case lokey:
+	case hikey:
+	case pitch_keycenter:
+	case key:
+	{
+		currentTarget->setValue((Opcode)opcodeIndex, getNoteNumberFromNameOrNumber(v));
+		return;
+	}
+	default:
+	{
+		currentTarget->setValue((Opcode)opcodeIndex, getIntValue(v));
+	}
+	}
+}
+
+void SfzImporter::parseFile(const File &f, int includeDepth)
 {
-	
+	if (includeDepth > 16) throw SfzParsingError(0, "Too many nested #include directives");
+
+	if (!f.existsAsFile()) throw SfzParsingError(0, "File " + f.getFullPathName() + " not found");
+
+	MemoryMappedFile mappedFile(f, MemoryMappedFile::readOnly);
+
+	MemoryBlock fallbackData;
+
+	const char *data = static_cast<const char*>(mappedFile.getData());
+	size_t numBytes = mappedFile.getSize();
+
+	if (data == nullptr && f.getSize() != 0)
+	{
+		f.loadFileAsData(fallbackData);
+
+		data = static_cast<const char*>(fallbackData.getData());
+		numBytes = fallbackData.getSize();
+	}
+
+	if (data == nullptr) return;
+
+	Tokeniser tokeniser(data, numBytes);
+
+	for (;;)
+	{
+		switch (tokeniser.next())
+		{
+		case Tokeniser::EndOfFile:		return;
+		case Tokeniser::Header:			addHeader(tokeniser.name, tokeniser.lineNumber); break;
+		case Tokeniser::OpcodeToken:	addOpcode(tokeniser.name, tokeniser.value, tokeniser.lineNumber); break;
+		case Tokeniser::Define:			addDefinition(tokeniser.name, tokeniser.value); break;
+		case Tokeniser::Include:
+		{
+			// Included paths are relative to the main file
+			const String path = getValueString(tokeniser.value).replaceCharacter('\\', '/');
+			const File includedFile = fileToImport.getParentDirectory().getChildFile(path);
+
+			try
+			{
+				parseFile(includedFile, includeDepth + 1);
+			}
+			catch (SfzParsingError e)
+			{
+				throw SfzParsingError(e.lineNumber, includedFile.getFileName() + ": " + e.message);
+			}
 
-	for (int i = 0; i < setToApply.size(); i++)
+			break;
+		}
+		case Tokeniser::numTokenTypes:
+		default:						jassertfalse; return;
+		}
+	}
+}
+
+void SfzImporter::applyGlobalOpcodesToRegions()
+{
+	for (int i = 0; i < groups.size(); i++)
 	{
-		Identifier opcodeId = setToApply.getName(i);
+		Group *g = groups[i];
 
-		if (setToApply[opcodeId].isUndefined()) continue;
+		const OpcodeSet *masterSet = isPositiveAndBelow(g->masterIndex, masterOpcodes.size()) ? &masterOpcodes.getReference(g->masterIndex) : nullptr;
 
-		if (r->opcodes[opcodeId].isUndefined())
+		for (int j = 0; j < g->regions.size(); j++)
 		{
-			r->opcodes.set(opcodeId, setToApply[opcodeId]);	
+			OpcodeSet &r = g->regions.getReference(j);
+
+			r.inheritFrom(g->opcodes);
+
+			if (masterSet != nullptr) r.inheritFrom(*masterSet);
+
+			r.inheritFrom(globalOpcodes);
 		}
 	}
 }
@@ -283,19 +607,44 @@ SfzImporter::SfzImporter(ModulatorSampler *sampler_, const File &sfzFileToImport
 sampler(sampler_),
 fileToImport(sfzFileToImport),
 currentTarget(nullptr),
-currentParseNumber(0)
+currentGroup(nullptr),
+parsingControlHeader(false)
 {
-	globalSfzObject = new Global();
+	
+}
+
+void SfzImporter::parseFile()
+{
+	globalOpcodes = OpcodeSet();
+	masterOpcodes.clear();
+	groups.clear();
+	macroNames.clear();
+	macroValues.clear();
+	defaultPath = String();
+
+	// Opcodes before the first header are treated as global opcodes
+	currentTarget = &globalOpcodes;
+	currentGroup = nullptr;
+	parsingControlHeader = false;
+
+	parseFile(fileToImport, 0);
 
-	currentTarget = globalSfzObject;
+	applyGlobalOpcodesToRegions();
 }
 
-void SfzImporter::importSfzFile()
+int SfzImporter::getNumRegions() const
 {
-	parseOpcodes();
+	int numRegions = 0;
+
+	for (int i = 0; i < groups.size(); i++)
+		numRegions += groups[i]->regions.size();
 
-	applyGlobalOpcodesToRegion();
+	return numRegions;
+}
 
+ValueTree SfzImporter::createSampleMapData(const Array<int> &rrGroupForEachSfzGroup) const
+{
+	jassert(rrGroupForEachSfzGroup.size() == groups.size());
 
 	ValueTree v("samplemap");
 
@@ -305,9 +654,104 @@ void SfzImporter::importSfzFile()
 	
 	v.setProperty("SaveMode", 1, nullptr);
 
+	int groupAmount = 1;
+
+	for (int i = 0; i < rrGroupForEachSfzGroup.size(); i++)
+		groupAmount = jmax<int>(groupAmount, rrGroupForEachSfzGroup[i]);
+
+	v.setProperty("RRGroupAmount", groupAmount, nullptr);
+
+	// Create the identifiers only once instead of for every region
+	Identifier opcodeProperties[numSupportedOpcodes];
+
+	for (int k = 0; k < numSupportedOpcodes; k++)
+	{
+		const ModulatorSamplerSound::Property p = (k == groupName || k == key) ? ModulatorSamplerSound::numProperties : getSamplerProperty((Opcode)k);
+
+		if (p != ModulatorSamplerSound::numProperties)
+			opcodeProperties[k] = ModulatorSamplerSound::getPropertyName(p);
+	}
+
+	const Identifier idId = ModulatorSamplerSound::getPropertyName(ModulatorSamplerSound::ID);
+	const Identifier veloLowId = ModulatorSamplerSound::getPropertyName(ModulatorSamplerSound::VeloLow);
+	const Identifier veloHighId = ModulatorSamplerSound::getPropertyName(ModulatorSamplerSound::VeloHigh);
+	const Identifier rootNoteId = ModulatorSamplerSound::getPropertyName(ModulatorSamplerSound::RootNote);
+	const Identifier keyLowId = ModulatorSamplerSound::getPropertyName(ModulatorSamplerSound::KeyLow);
+	const Identifier keyHighId = ModulatorSamplerSound::getPropertyName(ModulatorSamplerSound::KeyHigh);
+	const Identifier volumeId = ModulatorSamplerSound::getPropertyName(ModulatorSamplerSound::Volume);
+	const Identifier rrGroupId = ModulatorSamplerSound::getPropertyName(ModulatorSamplerSound::RRGroup);
+
+	int id = 0;
+
+	for (int i = 0; i < groups.size(); i++)
+	{
+		const int rrGroup = rrGroupForEachSfzGroup[i];
+
+		if(rrGroup == -1) continue;
+
+		const Group *g = groups[i];
+
+		for (int j = 0; j < g->regions.size(); j++)
+		{
+			const OpcodeSet &region = g->regions.getReference(j);
+
+			ValueTree s("sample");
+
+			id++;
+
+			s.setProperty(idId, id, nullptr);
+
+			s.setProperty(veloLowId, 0, nullptr);
+			s.setProperty(veloHighId, 127, nullptr);
+
+			for(int k = 0; k < numSupportedOpcodes; k++)
+			{
+				if (!region.isDefined((Opcode)k)) continue;
+
+				if (k == key)
+				{
+					s.setProperty(rootNoteId, region.values[k], nullptr);
+					s.setProperty(keyLowId, region.values[k], nullptr);
+					s.setProperty(keyHighId, region.values[k], nullptr);
+				}
+				else if (k == sample)
+				{
+					s.setProperty(opcodeProperties[k], region.samplePath, nullptr);
+				}
+				else if (opcodeProperties[k].isValid())
+				{
+					s.setProperty(opcodeProperties[k], region.values[k], nullptr);
+				}
+			}
+
+			if (region.isDefined(group_volume))
+			{
+				const int zoneValue = region.isDefined(volume) ? region.values[volume] : 0;
+
+				s.setProperty(volumeId, zoneValue + region.values[group_volume], nullptr);
+			}
+
+			// Add the group properties
+			s.setProperty(rrGroupId, rrGroup, nullptr);
+
+			v.addChild(s, -1, nullptr);
+		}
+	}
+
+	return v;
+}
+
+void SfzImporter::importSfzFile()
+{
+	parseFile();
+
+	if (getNumRegions() == 0) throw SfzParsingError(0, "No regions found");
+
 	OwnedArray<SfzGroupSelectorComponent> groupSelectors;
 
-	if (globalSfzObject->groups.size() > 1)
+	Array<int> rrGroups;
+
+	if (groups.size() > 1)
 	{
 		AlertWindow w("Group Import Settings", String(), AlertWindow::AlertIconType::NoIcon);
 
@@ -321,11 +765,11 @@ void SfzImporter::importSfzFile()
 
 		
 
-		for (int i = 0; i < globalSfzObject->groups.size(); i++)
+		for (int i = 0; i < groups.size(); i++)
 		{
 			SfzGroupSelectorComponent *g = new SfzGroupSelectorComponent();
 
-			g->setData(i, globalSfzObject->groups[i]->groupName, globalSfzObject->groups.size());
+			g->setData(i, groups[i]->groupName, groups.size());
 
 			c->addAndMakeVisible(g);
 
@@ -352,101 +796,18 @@ void SfzImporter::importSfzFile()
 
 		if (w.runModalLoop() == 0) return;
 
-		
+		for (int i = 0; i < groupSelectors.size(); i++)
+			rrGroups.add(groupSelectors[i]->getGroupIndex());
 	}
 	else
 	{
-		groupSelectors.add(new SfzGroupSelectorComponent());
-
-		groupSelectors.getLast()->setFixedReturnValue();
+		rrGroups.add(1);
 	}
 
-	jassert(groupSelectors.size() == globalSfzObject->groups.size());
+	jassert(rrGroups.size() == groups.size());
 	
-    
-	int id = 0;
-
-	for (int i = 0; i < globalSfzObject->groups.size(); i++)
-	{
-		const int rrGroup = groupSelectors[i]->getGroupIndex();
-
-		if(rrGroup == -1) continue;
-
-		for (int j = 0; j < globalSfzObject->groups[i]->regions.size(); j++)
-		{
-			Region *region = globalSfzObject->groups[i]->regions[j];
-
-			ValueTree sample("sample");
-
-			id++;
-
-			sample.setProperty(ModulatorSamplerSound::getPropertyName(ModulatorSamplerSound::ID), id, nullptr);
-
-			sample.setProperty(ModulatorSamplerSound::getPropertyName(ModulatorSamplerSound::VeloLow), 0, nullptr);
-			sample.setProperty(ModulatorSamplerSound::getPropertyName(ModulatorSamplerSound::VeloHigh), 127, nullptr);
-
-			for(int k = 0; k < Opcode::numSupportedOpcodes; k++)
-			{
-				Identifier opcode = Identifier(getOpcodeName((Opcode)k));
-
-				if (k == Opcode::groupName) continue;
-
-				if ( !region->opcodes[opcode].isUndefined() )
-				{
-					if (k == Opcode::key)
-					{
-						sample.setProperty(ModulatorSamplerSound::getPropertyName(ModulatorSamplerSound::RootNote), region->opcodes[opcode], nullptr);
-						sample.setProperty(ModulatorSamplerSound::getPropertyName(ModulatorSamplerSound::KeyLow), region->opcodes[opcode], nullptr);
-						sample.setProperty(ModulatorSamplerSound::getPropertyName(ModulatorSamplerSound::KeyHigh), region->opcodes[opcode], nullptr);
-
-						continue;
-					}
-					
-					ModulatorSamplerSound::Property p = getSamplerProperty((Opcode)k);
-
-					if (p != ModulatorSamplerSound::numProperties)
-					{
-						sample.setProperty(ModulatorSamplerSound::getPropertyName(p), region->opcodes[opcode], nullptr);
-					}
-					
-				}
-			}
-
-			Identifier groupVolumeOpcode = Identifier(getOpcodeName(group_volume));
-
-			if ( !region->opcodes[groupVolumeOpcode].isUndefined() )
-			{
-				int zoneValue = sample.getProperty(ModulatorSamplerSound::getPropertyName(ModulatorSamplerSound::Volume), var(0));
-
-				int groupValue = region->opcodes[groupVolumeOpcode];
-
-				int combinedLevel = zoneValue + groupValue;
-
-				sample.setProperty(ModulatorSamplerSound::getPropertyName(ModulatorSamplerSound::Volume), combinedLevel, nullptr);
-
-			}
-
-			// Add the group properties
-			sample.setProperty(ModulatorSamplerSound::getPropertyName(ModulatorSamplerSound::RRGroup), rrGroup, nullptr);
-
-			v.addChild(sample, -1, nullptr);
-		}
-
-	}
-
-	int groupAmount = 0;
-
-	for (int i = 0; i < groupSelectors.size(); i++)
-	{
-		groupAmount = jmax(groupAmount, groupSelectors[i]->getGroupIndex());
-	}
-
-	sampler->setRRGroupAmount(groupAmount);
-
-	sampler->getSampleMap()->restoreFromValueTree(v);
+	// The sample map adds all sounds in one go without updating the UI for every sound
+	sampler->getSampleMap()->restoreFromValueTree(createSampleMapData(rrGroups));
 
 	//sampler->getSampleMap()->setRelativeSaveMode(true);
-
-	sampler->refreshPreloadSizes();
-	sampler->refreshMemoryUsage();
-};
\ No newline at end of file
+}
@@ -38,6 +38,13 @@
 /** Handles the importing of SFZ sample files.
 *	@ingroup sampler
 *
+*	The file is memory mapped and read by a tokeniser that works directly on the file data, so no String objects are
+*	created except for the sample paths and group names. Opcode values are stored in a fixed array indexed by the
+*	Opcode enum, which keeps the memory footprint small for SFZ files with tens of thousands of regions.
+*
+*	Supported headers are <control>, <global>, <master>, <group> and <region> (all other headers and unsupported
+*	opcodes are skipped). The preprocessor directives #define and #include are supported as well as the default_path
+*	opcode of the <control> header.
 */
 class SfzImporter
 {
@@ -85,6 +92,7 @@ public:
 
 	};
 
+	/** Creates an importer for the given file. You can pass in nullptr as sampler if you only want to parse the file. */
 	SfzImporter(ModulatorSampler *sampler, const File &sfzFileToImport);
 
 	/** imports a SFZ file into the given ModulatorSampler. 
@@ -95,91 +103,165 @@ public:
 	*/
 	void importSfzFile();
 
+	/** Parses the file (and all included files) and applies the global, master and group opcodes to every region. 
+	*
+	*	This does not need a ModulatorSampler and throws a SfzParsingError if the file can't be parsed.
+	*/
+	void parseFile();
+
+	/** Returns the number of groups that were found by parseFile(). */
+	int getNumGroups() const { return groups.size(); }
+
+	/** Returns the number of regions that were found by parseFile(). */
+	int getNumRegions() const;
+
+	/** Creates the sample map data for all parsed regions.
+	*
+	*	The array must contain the round robin group for every SFZ group (or -1 if the group should be skipped).
+	*	The resulting ValueTree can be passed to SampleMap::restoreFromValueTree() which adds all sounds in one go.
+	*/
+	ValueTree createSampleMapData(const Array<int> &rrGroupForEachSfzGroup) const;
+
 private:
 
-	struct SfzOpcodeTarget
+	/** A range of characters inside the file data. It doesn't own the data and is not null terminated. */
+	struct TextRange
 	{
-		virtual ~SfzOpcodeTarget() {};
+		TextRange() : start(nullptr), end(nullptr) {};
 
-		void setOpcodeValue(int opcode, var value) { opcodes.set(Identifier(SfzImporter::getOpcodeName((Opcode)opcode)), value); };
+		TextRange(const char *start_, const char *end_) : start(start_), end(end_) {};
 
-		NamedValueSet opcodes;
-	};
+		int length() const noexcept { return (int)(end - start); }
+
+		bool isEmpty() const noexcept { return end == start; }
+
+		bool equals(const char *text) const noexcept;
 
+		bool contains(char c) const noexcept;
 
-	struct Region: public SfzOpcodeTarget
+		String toString() const { return String(CharPointer_UTF8(start), CharPointer_UTF8(end)); }
+
+		const char *start;
+		const char *end;
+	};
+
+	/** Splits the file data into headers, opcodes and preprocessor directives. */
+	class Tokeniser
 	{
-		Region()
+	public:
+
+		enum TokenType
 		{
-			for (int i = 0; i < numSupportedOpcodes; i++)
-			{
-				setOpcodeValue(i, var::undefined());
-			}
-		}
+			EndOfFile = 0,
+			Header, ///< a header like <region>. The name will be set to the text between the brackets.
+			OpcodeToken, ///< an opcode. The name and value will be set.
+			Define, ///< a #define directive. The name will be the macro (including the $ sign).
+			Include, ///< a #include directive. The value will be the file path (without the quotes).
+			numTokenTypes
+		};
 
-		static String getTag() { return "<region>"; };
-	};
+		Tokeniser(const char *data, size_t numBytes);
 
+		/** Reads the next token. Throws a SfzParsingError if it encounters invalid syntax. */
+		TokenType next();
 
-	struct Group: public SfzOpcodeTarget
-	{	
-		static String getTag() { return "<group>"; };
+		TextRange name;
+		TextRange value;
 
-		void addRegion(Region *r) {	regions.add(r);	}
+		int lineNumber;
 
-		String groupName;
+	private:
+
+		void skipWhitespaceAndComments();
+
+		void skipSpaces();
+
+		TextRange readValue();
+
+		TextRange readWord();
+
+		bool isOpcodeAhead(const char *position) const;
 
-		OwnedArray<Region> regions;
+		const char *p;
+		const char *end;
 	};
 
+	/** Contains the values for all supported opcodes of a header. */
+	struct OpcodeSet
+	{
+		OpcodeSet() : definedOpcodes(0) { zeromem(values, sizeof(values)); };
+
+		bool isDefined(Opcode o) const noexcept { return (definedOpcodes & (1 << (int)o)) != 0; }
+
+		void setValue(Opcode o, int value) noexcept { values[o] = value; definedOpcodes |= (1 << (int)o); }
+
+		/** Copies every opcode that is defined in the other set, but not in this set. */
+		void inheritFrom(const OpcodeSet &other);
+
+		int values[numSupportedOpcodes];
+
+		uint32 definedOpcodes;
 
-	struct Global: public SfzOpcodeTarget
+		String samplePath;
+	};
+
+	struct Group
 	{
-		static String getTag() { return "<global>"; };
+		Group(int masterIndex_, const String &name) : masterIndex(masterIndex_), groupName(name) {};
+
+		const int masterIndex;
+
+		String groupName;
+
+		OpcodeSet opcodes;
 
-		OwnedArray<Group> groups;
+		Array<OpcodeSet> regions;
 	};
 
+	void parseFile(const File &f, int includeDepth);
 
-	void parseTagLine(const String &restOfLine);
+	void addHeader(const TextRange &headerName, int lineNumber);
 
-	StringArray getOpcodeTokens(const String &line) const;
+	void addOpcode(const TextRange &opcodeName, const TextRange &valueRange, int lineNumber);
 
-	void parseOpcode(const String &opcode);
+	void addDefinition(const TextRange &macroName, const TextRange &valueRange);
 
-	void parseOpcodes();
+	String getValueString(const TextRange &valueRange) const;
+
+	void applyGlobalOpcodesToRegions();
 
 	static String getOpcodeName(Opcode opcode) { return String(opcodeNames[opcode]); };
 
-	var getOpcodeValue(Opcode o, const String &valueString) const;
-	
-	static int getOpcode(const StringRef &opcodeName)
-	{
-		for(int i = 0; i < numSupportedOpcodes; i++)
-		{
-			if(StringRef(opcodeNames[i]) == opcodeName) return i;
-		}
+	static int getOpcode(const TextRange &opcodeName);
 
-		return -1;
-	}
+	static int getIntValue(const TextRange &valueRange);
 
-	static ModulatorSamplerSound::Property getSamplerProperty(Opcode opcode);
-	
-	void applyGlobalOpcodesToRegion();
+	static int getNoteNumberFromNameOrNumber(const TextRange &valueRange);
 
-	void applyValueSetOnRegion(const NamedValueSet &setToApply, Region * r);
+	static ModulatorSamplerSound::Property getSamplerProperty(Opcode opcode);
 
 	static const char **opcodeNames;
 
-	const File &fileToImport;
+	const File fileToImport;
 
 	ModulatorSampler *sampler;
 
-	int currentParseNumber;
+	OpcodeSet globalOpcodes;
+
+	Array<OpcodeSet> masterOpcodes;
+
+	OwnedArray<Group> groups;
+
+	OpcodeSet *currentTarget;
+
+	Group *currentGroup;
+
+	bool parsingControlHeader;
 
-	SfzOpcodeTarget *currentTarget;
+	String defaultPath;
 
-	ScopedPointer<Global> globalSfzObject;
+	StringArray macroNames;
+	StringArray macroValues;
 
 	AlertWindowLookAndFeel alaf;
 
@@ -0,0 +1,266 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+#include  "JuceHeader.h"
+
+class SfzImporterUnitTests : public UnitTest
+{
+public:
+
+	SfzImporterUnitTests():
+		UnitTest("Testing SFZ Importer")
+	{
+
+	}
+
+	void runTest() override
+	{
+		testOpcodeParsing();
+
+		testPreprocessor();
+
+		testSyntaxErrors();
+
+		testLargeFile();
+	}
+
+	void testOpcodeParsing()
+	{
+		beginTest("Testing opcode parsing and inheritance");
+
+		TemporaryFile tempFile(".sfz");
+
+		tempFile.getFile().replaceWithText(
+			"// Comment line\n"
+			"<global> volume=-3 lovel=10\n"
+			"<master> pan=20\n"
+			"<group> group_label=Sustains /* block\n"
+			"comment */ hikey=c4\n"
+			"<region> sample=Samples/My Sample.wav lokey=c#3 pitch_keycenter=60 loop_mode=loop_continuous\n"
+			"<region>sample=Samples\\Other.wav key=a-1 lovel=20 volume=-6.5 // trailing comment\n"
+			"<curve> v000=0\n"
+			"<group> group_volume=-2 group_label=Release\n"
+			"<region> sample=release.wav tune=-12 offset=100 end=2000\n");
+
+		SfzImporter importer(nullptr, tempFile.getFile());
+
+		importer.parseFile();
+
+		expectEquals<int>(importer.getNumGroups(), 2, "Group amount");
+		expectEquals<int>(importer.getNumRegions(), 3, "Region amount");
+
+		Array<int> rrGroups;
+		rrGroups.add(1);
+		rrGroups.add(2);
+
+		ValueTree v = importer.createSampleMapData(rrGroups);
+
+		expectEquals<int>(v.getNumChildren(), 3, "Sample amount");
+		expectEquals<int>(v.getProperty("RRGroupAmount"), 2, "RR Group amount");
+
+		const ValueTree first = v.getChild(0);
+
+		expectEquals(first.getProperty(getId(ModulatorSamplerSound::FileName)).toString(), tempFile.getFile().getParentDirectory().getChildFile("Samples/My Sample.wav").getFullPathName(), "Sample path with spaces");
+		expectEquals<int>(first.getProperty(getId(ModulatorSamplerSound::KeyLow)), 61, "Note name with sharp");
+		expectEquals<int>(first.getProperty(getId(ModulatorSamplerSound::KeyHigh)), 72, "Group opcode");
+		expectEquals<int>(first.getProperty(getId(ModulatorSamplerSound::RootNote)), 60, "Note number");
+		expectEquals<int>(first.getProperty(getId(ModulatorSamplerSound::LoopEnabled)), 1, "Loop mode");
+		expectEquals<int>(first.getProperty(getId(ModulatorSamplerSound::Pan)), 20, "Master opcode");
+		expectEquals<int>(first.getProperty(getId(ModulatorSamplerSound::Volume)), -3, "Global opcode");
+		expectEquals<int>(first.getProperty(getId(ModulatorSamplerSound::VeloLow)), 10, "Global velocity");
+		expectEquals<int>(first.getProperty(getId(ModulatorSamplerSound::RRGroup)), 1, "RR Group");
+
+		const ValueTree second = v.getChild(1);
+
+		expectEquals(second.getProperty(getId(ModulatorSamplerSound::FileName)).toString(), tempFile.getFile().getParentDirectory().getChildFile("Samples/Other.wav").getFullPathName(), "Backslash path");
+		expectEquals<int>(second.getProperty(getId(ModulatorSamplerSound::KeyLow)), 21, "key opcode");
+		expectEquals<int>(second.getProperty(getId(ModulatorSamplerSound::KeyHigh)), 21, "key overwrites group");
+		expectEquals<int>(second.getProperty(getId(ModulatorSamplerSound::VeloLow)), 20, "Region overwrites global");
+		expectEquals<int>(second.getProperty(getId(ModulatorSamplerSound::Volume)), -6, "Decimal value");
+		expectEquals<int>(second.getProperty(getId(ModulatorSamplerSound::LoopEnabled), 0), 0, "Loop mode default");
+
+		const ValueTree third = v.getChild(2);
+
+		expectEquals<int>(third.getProperty(getId(ModulatorSamplerSound::Volume)), -5, "Group volume");
+		expectEquals<int>(third.getProperty(getId(ModulatorSamplerSound::Pitch)), -12, "Negative value");
+		expectEquals<int>(third.getProperty(getId(ModulatorSamplerSound::SampleStart)), 100, "Offset");
+		expectEquals<int>(third.getProperty(getId(ModulatorSamplerSound::SampleEnd)), 2000, "End");
+		expectEquals<int>(third.getProperty(getId(ModulatorSamplerSound::RRGroup)), 2, "Second RR Group");
+
+		rrGroups.set(0, -1);
+
+		expectEquals<int>(importer.createSampleMapData(rrGroups).getNumChildren(), 1, "Ignored group");
+	}
+
+	void testPreprocessor()
+	{
+		beginTest("Testing #define and #include");
+
+		TemporaryFile mainFile(".sfz");
+
+		File includedFile = mainFile.getFile().getSiblingFile("included_" + mainFile.getFile().getFileName());
+
+		includedFile.replaceWithText("<region> sample=$DIR/b.wav lokey=$KEY_LOW hikey=$KEY\n");
+
+		mainFile.getFile().replaceWithText(
+			"<control> default_path=Samples/\n"
+			"#define $KEY 64\n"
+			"#define $KEY_LOW 62\n"
+			"#define $DIR Piano\n"
+			"<group>\n"
+			"<region> sample=$DIR/a.wav key=$KEY\n"
+			"#include \"" + includedFile.getFileName() + "\"\n");
+
+		SfzImporter importer(nullptr, mainFile.getFile());
+
+		importer.parseFile();
+
+		includedFile.deleteFile();
+
+		expectEquals<int>(importer.getNumGroups(), 1, "Group amount");
+		expectEquals<int>(importer.getNumRegions(), 2, "Region amount");
+
+		Array<int> rrGroups;
+		rrGroups.add(1);
+
+		ValueTree v = importer.createSampleMapData(rrGroups);
+
+		const File root = mainFile.getFile().getParentDirectory();
+
+		expectEquals(v.getChild(0).getProperty(getId(ModulatorSamplerSound::FileName)).toString(), root.getChildFile("Samples/Piano/a.wav").getFullPathName(), "Default path and macro");
+		expectEquals<int>(v.getChild(0).getProperty(getId(ModulatorSamplerSound::RootNote)), 64, "Macro value");
+		expectEquals(v.getChild(1).getProperty(getId(ModulatorSamplerSound::FileName)).toString(), root.getChildFile("Samples/Piano/b.wav").getFullPathName(), "Included region");
+		expectEquals<int>(v.getChild(1).getProperty(getId(ModulatorSamplerSound::KeyLow)), 62, "Longest macro name first");
+		expectEquals<int>(v.getChild(1).getProperty(getId(ModulatorSamplerSound::KeyHigh)), 64, "Macro in included file");
+	}
+
+	void testSyntaxErrors()
+	{
+		beginTest("Testing syntax errors");
+
+		expectParsingError("<region sample=a.wav\n", 1);
+		expectParsingError("<group>\n\n<region> lokey 60\n", 3);
+		expectParsingError("<region> group_label=Test\n", 1);
+		expectParsingError("#include missing_quotes.sfz\n", 1);
+	}
+
+	void testLargeFile()
+	{
+		beginTest("Benchmarking a SFZ file with 50000 regions");
+
+		const int numGroups = 50;
+		const int numRegionsPerGroup = 1000;
+
+		TemporaryFile tempFile(".sfz");
+
+		{
+			FileOutputStream fos(tempFile.getFile());
+
+			fos << "<control> default_path=Samples/\n";
+			fos << "<global> volume=-3\n";
+
+			for (int i = 0; i < numGroups; i++)
+			{
+				fos << "<group> group_label=Group" << i << " lovel=" << i << " hivel=" << i + 1 << "\n";
+
+				for (int j = 0; j < numRegionsPerGroup; j++)
+				{
+					const int noteNumber = j % 128;
+
+					fos << "<region> sample=Velocity " << i << "/Note " << noteNumber << " " << j << ".wav ";
+					fos << "lokey=" << noteNumber << " hikey=" << noteNumber << " pitch_keycenter=" << noteNumber;
+					fos << " offset=" << j << " loop_mode=loop_continuous loopstart=1000 loopend=20000 tune=" << (j % 100) - 50 << "\n";
+				}
+			}
+		}
+
+		SfzImporter importer(nullptr, tempFile.getFile());
+
+		const double start = Time::getMillisecondCounterHiRes();
+
+		importer.parseFile();
+
+		const double parseTime = Time::getMillisecondCounterHiRes();
+
+		Array<int> rrGroups;
+
+		for (int i = 0; i < numGroups; i++)
+			rrGroups.add(1);
+
+		ValueTree v = importer.createSampleMapData(rrGroups);
+
+		const double conversionTime = Time::getMillisecondCounterHiRes();
+
+		logMessage("File size: " + String(tempFile.getFile().getSize() / 1024) + " kB");
+		logMessage("Parsing: " + String(parseTime - start, 1) + " ms");
+		logMessage("Conversion: " + String(conversionTime - parseTime, 1) + " ms");
+
+		expectEquals<int>(importer.getNumRegions(), numGroups * numRegionsPerGroup, "Region amount");
+		expectEquals<int>(v.getNumChildren(), numGroups * numRegionsPerGroup, "Sample amount");
+
+		const ValueTree last = v.getChild(v.getNumChildren() - 1);
+
+		expectEquals<int>(last.getProperty(getId(ModulatorSamplerSound::VeloLow)), numGroups - 1, "Group opcode");
+		expectEquals<int>(last.getProperty(getId(ModulatorSamplerSound::RootNote)), (numRegionsPerGroup - 1) % 128, "Region opcode");
+		expectEquals<int>(last.getProperty(getId(ModulatorSamplerSound::Volume)), -3, "Global opcode");
+	}
+
+private:
+
+	static Identifier getId(ModulatorSamplerSound::Property p)
+	{
+		return ModulatorSamplerSound::getPropertyName(p);
+	}
+
+	void expectParsingError(const String &fileContent, int expectedLineNumber)
+	{
+		TemporaryFile tempFile(".sfz");
+
+		tempFile.getFile().replaceWithText(fileContent);
+
+		SfzImporter importer(nullptr, tempFile.getFile());
+
+		try
+		{
+			importer.parseFile();
+
+			expect(false, "No error for " + fileContent);
+		}
+		catch (SfzImporter::SfzParsingError e)
+		{
+			expectEquals<int>(e.lineNumber, expectedLineNumber, e.message);
+		}
+	}
+
+};
+
+static SfzImporterUnitTests sfzImporterUnitTest;
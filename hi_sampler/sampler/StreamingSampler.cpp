@@ -32,6 +32,208 @@
 
 #define LOG_SAMPLE_RENDERING 1
 
+// ==================================================================================================== SharedPreloadBuffer methods
+
+Atomic<int64> SharedPreloadBuffer::numLockedBytes;
+
+SharedPreloadBuffer::SharedPreloadBuffer(MonolithInfoToUse* info, const int16* mappedData, int numSamples) :
+	buffer(mappedData, nullptr, numSamples),
+	key(0),
+	mappedInfo(info)
+{
+	numBytesLocked = lockPages(mappedData, (size_t)numSamples * sizeof(int16), lockedData);
+}
+
+SharedPreloadBuffer::~SharedPreloadBuffer()
+{
+	if (numBytesLocked != 0)
+		unlockPages(lockedData, numBytesLocked);
+}
+
+size_t SharedPreloadBuffer::lockPages(const void* data, size_t numBytes, const void*& lockedStart)
+{
+	lockedStart = nullptr;
+
+#if JUCE_LINUX || JUCE_MAC || JUCE_IOS
+	const int64 budget = (int64)ZERO_COPY_PRELOAD_LOCK_BUDGET * 1024 * 1024;
+	const pointer_sized_uint pageSize = (pointer_sized_uint)sysconf(_SC_PAGESIZE);
+
+	// Only lock the pages that lie completely inside the range. mlock() doesn't count
+	// how often a page was locked, so a page shared with the neighbouring sample of the
+	// monolith would be unlocked (and its bytes counted twice) otherwise.
+	const pointer_sized_uint start = reinterpret_cast<pointer_sized_uint>(data);
+	const pointer_sized_uint alignedStart = (start + pageSize - 1) & ~(pageSize - 1);
+	const pointer_sized_uint alignedEnd = (start + numBytes) & ~(pageSize - 1);
+
+	if (alignedEnd > alignedStart)
+	{
+		const int64 numToLock = (int64)(alignedEnd - alignedStart);
+
+		// Reserve the bytes before locking so that concurrent calls can't exceed the budget
+		int64 current;
+
+		do
+		{
+			current = numLockedBytes.get();
+
+			if (current + numToLock > budget)
+				break;
+		}
+		while (!numLockedBytes.compareAndSetBool(current + numToLock, current));
+
+		if (current + numToLock <= budget)
+		{
+			auto p = reinterpret_cast<const void*>(alignedStart);
+
+			if (mlock(p, (size_t)numToLock) == 0)
+			{
+				// The partial pages at the edges are only pre-faulted
+				touchPages(data, (size_t)(alignedStart - start));
+				touchPages(reinterpret_cast<const void*>(alignedEnd), (size_t)(start + numBytes - alignedEnd));
+
+				lockedStart = p;
+				return (size_t)numToLock;
+			}
+
+			numLockedBytes -= numToLock;
+		}
+	}
+#endif
+
+	touchPages(data, numBytes);
+	return 0;
+}
+
+void SharedPreloadBuffer::touchPages(const void* data, size_t numBytes)
+{
+	// Touch every page so that the voices don't run into a page fault
+	const uint8* d = static_cast<const uint8*>(data);
+	volatile uint8 dummy = 0;
+
+	for (size_t i = 0; i < numBytes; i += 4096)
+		dummy += d[i];
+
+	if (numBytes > 0)
+		dummy += d[numBytes - 1];
+}
+
+void SharedPreloadBuffer::unlockPages(const void* data, size_t numBytes)
+{
+#if JUCE_LINUX || JUCE_MAC || JUCE_IOS
+	munlock(data, numBytes);
+#else
+	ignoreUnused(data);
+#endif
+
+	numLockedBytes -= (int64)numBytes;
+}
+
+// ==================================================================================================== SharedSampleCache methods
+
+ReferenceCountedObjectPtr<MonolithInfoToUse> SharedSampleCache::getMonolith(const Array<File>& monolithicFiles, const ValueTree& sampleMap)
+{
+	String k;
+
+	for (int i = 0; i < monolithicFiles.size(); i++)
+		k << String(MonolithInfoToUse::getCacheKey(monolithicFiles[i])) << ";";
+
+	const int64 key = k.hashCode64();
+
+	ScopedLock sl(lock);
+
+	const int index = monolithKeys.indexOf(key);
+
+	if (index != -1)
+		return monoliths[index];
+
+	ReferenceCountedObjectPtr<MonolithInfoToUse> newInfo = new MonolithInfoToUse(monolithicFiles);
+
+	// Only add it to the cache if the metadata could be loaded
+	newInfo->fillMetadataInfo(sampleMap);
+
+	monoliths.add(newInfo);
+	monolithKeys.add(key);
+
+	return newInfo;
+}
+
+SharedPreloadBuffer::Ptr SharedSampleCache::getPreloadBuffer(int64 key)
+{
+	ScopedLock sl(lock);
+
+	return preloadBuffers[key];
+}
+
+SharedPreloadBuffer::Ptr SharedSampleCache::addPreloadBuffer(SharedPreloadBuffer* newBuffer)
+{
+	jassert(newBuffer != nullptr && newBuffer->key != 0);
+
+	ScopedLock sl(lock);
+
+	SharedPreloadBuffer::Ptr existing = preloadBuffers[newBuffer->key];
+
+	if (existing != nullptr)
+		return existing;
+
+	preloadBuffers.set(newBuffer->key, newBuffer);
+
+	return newBuffer;
+}
+
+void SharedSampleCache::removeIfUnused(SharedPreloadBuffer* buffer)
+{
+	ScopedLock sl(lock);
+
+	if (preloadBuffers[buffer->key].get() != buffer)
+		return;
+
+	// One reference for the cache and one for the caller
+	if (buffer->getReferenceCount() <= 2)
+		preloadBuffers.remove(buffer->key);
+}
+
+void SharedSampleCache::clearUnreferencedEntries()
+{
+	ScopedLock sl(lock);
+
+	Array<int64> keysToRemove;
+
+	for (HashMap<int64, SharedPreloadBuffer::Ptr>::Iterator it(preloadBuffers); it.next();)
+	{
+		if (it.getValue()->getReferenceCount() == 1)
+			keysToRemove.add(it.getKey());
+	}
+
+	for (int i = 0; i < keysToRemove.size(); i++)
+		preloadBuffers.remove(keysToRemove[i]);
+
+	for (int i = 0; i < monoliths.size(); i++)
+	{
+		// One reference for the array and one for the temporary pointer
+		if (monoliths[i]->getReferenceCount() == 2)
+		{
+			monoliths.remove(i);
+			monolithKeys.remove(i--);
+		}
+	}
+}
+
+size_t SharedSampleCache::getMemoryUsage() const
+{
+	ScopedLock sl(lock);
+
+	size_t memoryUsage = 0;
+
+	for (HashMap<int64, SharedPreloadBuffer::Ptr>::Iterator it(preloadBuffers); it.next();)
+	{
+		const hlac::HiseSampleBuffer& b = it.getValue()->buffer;
+
+		memoryUsage += (size_t)(b.getNumSamples() * b.getNumChannels()) * (b.isFloatingPoint() ? sizeof(float) : sizeof(int16));
+	}
+
+	return memoryUsage;
+}
+
 // ==================================================================================================== StreamingSamplerSound methods
 
 StreamingSamplerSound::StreamingSamplerSound(const String &fileNameToLoad, ModulatorSamplerSoundPool *pool):
@@ -59,7 +261,7 @@ StreamingSamplerSound::StreamingSamplerSound(const String &fileNameToLoad, Modul
     setPreloadSize(0);
 }
 
-StreamingSamplerSound::StreamingSamplerSound(MonolithInfoToUse *info, int channelIndex, int sampleIndex):
+StreamingSamplerSound::StreamingSamplerSound(MonolithInfoToUse *info, int channelIndex, int sampleIndex, SharedSampleCache* cache):
 	fileReader(this, nullptr),
 	sampleRate(-1.0),
 	purged(false),
@@ -81,6 +283,8 @@ StreamingSamplerSound::StreamingSamplerSound(MonolithInfoToUse *info, int channe
 {
 	fileReader.setMonolithicInfo(info, channelIndex, sampleIndex);
 
+	sharedCache = cache;
+
 	setPreloadSize(0);
 }
 
@@ -97,7 +301,8 @@ void StreamingSamplerSound::setReversed(bool shouldBeReversed)
 		if (shouldBeReversed)
 		{
 			loadEntireSample();
-			preloadBuffer.reverse(0, preloadBuffer.getNumSamples());
+			makePreloadBufferUnique();
+			preloadBuffer->buffer.reverse(0, preloadBuffer->buffer.getNumSamples());
 			reversed = true;
 		}
 		else
@@ -108,7 +313,7 @@ void StreamingSamplerSound::setReversed(bool shouldBeReversed)
 	}
 }
 
-void StreamingSamplerSound::setPreloadSize(int newPreloadSize, bool forceReload)
+void StreamingSamplerSound::setPreloadSize(int newPreloadSize, bool forceReload, const CriticalSection* swapLock)
 {
 	if (reversed)
 	{
@@ -120,6 +325,24 @@ void StreamingSamplerSound::setPreloadSize(int newPreloadSize, bool forceReload)
     
 	if(!forceReload && (preloadSizeChanged || streamingDeactivated)) return;
 
+	SharedPreloadBuffer::Ptr newBuffer = loadPreloadBuffer(newPreloadSize);
+
+	if (swapLock != nullptr)
+	{
+		ScopedLock sl(*swapLock);
+
+		setPreloadBuffer(newBuffer);
+		preloaded.store(true);
+	}
+	else
+	{
+		setPreloadBuffer(newBuffer);
+		preloaded.store(true);
+	}
+}
+
+SharedPreloadBuffer::Ptr StreamingSamplerSound::loadPreloadBuffer(int newPreloadSize)
+{
 	ScopedLock sl(getSampleLock());
 
     const bool sampleDeactivated = !hasActiveState() || newPreloadSize == 0;
@@ -131,9 +354,7 @@ void StreamingSamplerSound::setPreloadSize(int newPreloadSize, bool forceReload)
 		internalPreloadSize = 0;
 		preloadSize = 0;
 
-		preloadBuffer = hlac::HiseSampleBuffer(!fileReader.isMonolithic(), fileReader.isStereo() ? 2 : 1, 0);
-
-		return;
+		return new SharedPreloadBuffer(!fileReader.isMonolithic(), fileReader.isStereo() ? 2 : 1, 0);
 	}
     
 	preloadSize = newPreloadSize;
@@ -153,43 +374,72 @@ void StreamingSamplerSound::setPreloadSize(int newPreloadSize, bool forceReload)
 
 	fileReader.openFileHandles();
 
-	preloadBuffer = hlac::HiseSampleBuffer(!fileReader.isMonolithic(), fileReader.isStereo() ? 2 : 1, 0);
-	
+	if (sampleRate <= 0.0)
+	{
+		if (AudioFormatReader *reader = fileReader.getReader())
+		{
+			sampleRate = reader->sampleRate;
+			sampleEnd = jmin<int>(sampleEnd, (int)reader->lengthInSamples);
+			sampleLength = sampleEnd - sampleStart;
+			loopEnd = jmin(loopEnd, sampleEnd);
+		}
+	}
+
+#if ENABLE_ZERO_COPY_PRELOAD
+
+	// The loop is copied into the preload buffer, so it can't point to the file
+	const bool loopIsBakedIn = loopEnabled && (loopEnd - loopStart > 0) && sampleLength < internalPreloadSize;
+
+	if (!loopIsBakedIn)
+	{
+		if (SharedPreloadBuffer* mappedBuffer = fileReader.createMappedPreloadBuffer(sampleStart + monolithOffset, internalPreloadSize))
+		{
+			return mappedBuffer;
+		}
+	}
+
+#endif
+
+	const int64 cacheKey = getPreloadCacheKey();
+
+	if (cacheKey != 0)
+	{
+		SharedPreloadBuffer::Ptr cachedBuffer = sharedCache->getPreloadBuffer(cacheKey);
+
+		if (cachedBuffer != nullptr)
+		{
+			return cachedBuffer;
+		}
+	}
+
+	SharedPreloadBuffer::Ptr newBuffer = new SharedPreloadBuffer(!fileReader.isMonolithic(), fileReader.isStereo() ? 2 : 1, 0, cacheKey);
+
+	hlac::HiseSampleBuffer& buffer = newBuffer->buffer;
+
 	try
 	{
-		preloadBuffer.setSize(fileReader.isStereo() ? 2 : 1, internalPreloadSize);
+		buffer.setSize(fileReader.isStereo() ? 2 : 1, internalPreloadSize);
 	}
 	catch (std::exception e)
 	{
-		preloadBuffer.setSize(fileReader.isStereo() ? 2 : 1, 0);
+		setPreloadBuffer(new SharedPreloadBuffer(!fileReader.isMonolithic(), fileReader.isStereo() ? 2 : 1, 0));
 
 		throw StreamingSamplerSound::LoadingError(getFileName(), "Preload error (max memory exceeded).");
 	}
 	
-	if (preloadBuffer.getNumSamples() == 0)
+	if (buffer.getNumSamples() == 0)
 	{
-		return;
+		return newBuffer;
 	}
 
-	preloadBuffer.clear();
-	
-	if (sampleRate <= 0.0)
-	{
-		if (AudioFormatReader *reader = fileReader.getReader())
-		{
-			sampleRate = reader->sampleRate;
-			sampleEnd = jmin<int>(sampleEnd, (int)reader->lengthInSamples);
-			sampleLength = sampleEnd - sampleStart;
-			loopEnd = jmin(loopEnd, sampleEnd);
-		}
-	}
+	buffer.clear();
 
 	if (loopEnabled && (loopEnd - loopStart > 0) && sampleLength < internalPreloadSize)
 	{
 		int samplesToFill = internalPreloadSize;
 		int offsetInPreloadBuffer = 0;
 
-		fileReader.readFromDisk(preloadBuffer, 0, sampleLength, sampleStart + monolithOffset, true);
+		fileReader.readFromDisk(buffer, 0, sampleLength, sampleStart + monolithOffset, true);
 
 		const int samplesPerFillOp = (loopEnd - loopStart);
 
@@ -202,7 +452,7 @@ void StreamingSamplerSound::setPreloadSize(int newPreloadSize, bool forceReload)
 			{
 				const int samplesThisTime = jmin<int>(samplesToFill, samplesPerFillOp);
 
-				fileReader.readFromDisk(preloadBuffer, offsetInPreloadBuffer, samplesThisTime, loopStart, true);
+				fileReader.readFromDisk(buffer, offsetInPreloadBuffer, samplesThisTime, loopStart, true);
 
 				offsetInPreloadBuffer += samplesThisTime;
 				samplesToFill -= samplesThisTime;
@@ -217,8 +467,89 @@ void StreamingSamplerSound::setPreloadSize(int newPreloadSize, bool forceReload)
 	}
 	else
 	{
-		fileReader.readFromDisk(preloadBuffer, 0, internalPreloadSize, sampleStart + monolithOffset, true);
+		fileReader.readFromDisk(buffer, 0, internalPreloadSize, sampleStart + monolithOffset, true);
 	}
+
+	if (cacheKey != 0)
+		newBuffer = sharedCache->addPreloadBuffer(newBuffer);
+
+	return newBuffer;
+}
+
+void StreamingSamplerSound::setPreloadBuffer(SharedPreloadBuffer* newBuffer)
+{
+	ScopedLock sl(getSampleLock());
+
+	SharedPreloadBuffer::Ptr oldBuffer;
+
+	{
+		SpinLock::ScopedLockType spl(preloadBufferLock);
+
+		oldBuffer = preloadBuffer;
+		preloadBuffer = newBuffer;
+	}
+
+	if (oldBuffer == nullptr || oldBuffer == preloadBuffer)
+		return;
+
+	if (sharedCache != nullptr && oldBuffer->key != 0)
+	{
+		sharedCache->removeIfUnused(oldBuffer.get());
+	}
+
+	// A voice might still read from the old buffer, so it must not be deleted here
+	retiredPreloadBuffers.add(oldBuffer);
+
+	oldBuffer = nullptr;
+
+	releaseRetiredPreloadBuffers();
+}
+
+void StreamingSamplerSound::releaseRetiredPreloadBuffers()
+{
+	ScopedLock sl(getSampleLock());
+
+	for (int i = 0; i < retiredPreloadBuffers.size(); i++)
+	{
+		// Buffers that are not current anymore can't be acquired again, so this is the last reference
+		if (retiredPreloadBuffers.getObjectPointerUnchecked(i)->getReferenceCount() == 1)
+			retiredPreloadBuffers.remove(i--);
+	}
+}
+
+int64 StreamingSamplerSound::getPreloadCacheKey() const
+{
+	if (sharedCache == nullptr || reversed)
+		return 0;
+
+	const int64 monolithKey = fileReader.getMonolithCacheKey();
+
+	if (monolithKey == 0)
+		return 0;
+
+	String k;
+
+	k << String(monolithKey) << ":" << sampleStart << ":" << internalPreloadSize;
+
+	// The loop is only baked into the preload buffer if the sample is shorter than the preload size
+	if (loopEnabled && (loopEnd - loopStart > 0) && sampleLength < internalPreloadSize)
+		k << ":" << loopStart << ":" << loopEnd;
+
+	return k.hashCode64();
+}
+
+void StreamingSamplerSound::makePreloadBufferUnique()
+{
+	if (preloadBuffer == nullptr || (preloadBuffer->key == 0 && !preloadBuffer->isMappedView()))
+		return;
+
+	const hlac::HiseSampleBuffer& source = preloadBuffer->buffer;
+
+	SharedPreloadBuffer::Ptr copy = new SharedPreloadBuffer(source.isFloatingPoint(), source.getNumChannels(), source.getNumSamples());
+
+	hlac::HiseSampleBuffer::copy(copy->buffer, source, 0, 0, source.getNumSamples());
+
+	setPreloadBuffer(copy);
 }
 
 
@@ -227,7 +558,24 @@ size_t StreamingSamplerSound::getActualPreloadSize() const
 {
 	auto bytesPerSample = fileReader.isMonolithic() ? sizeof(int16) : sizeof(float);
 
-	return hasActiveState() ? (size_t)(internalPreloadSize *preloadBuffer.getNumChannels()) * bytesPerSample + (size_t)(loopBuffer.getNumSamples() *loopBuffer.getNumChannels()) * bytesPerSample : 0;
+	return hasActiveState() ? (size_t)(internalPreloadSize *preloadBuffer->buffer.getNumChannels()) * bytesPerSample + (size_t)(loopBuffer.getNumSamples() *loopBuffer.getNumChannels()) * bytesPerSample : 0;
+}
+
+size_t StreamingSamplerSound::getActualPreloadSize(SortedSet<const SharedPreloadBuffer*>& countedBuffers) const
+{
+	if (!hasActiveState())
+		return 0;
+
+	if (countedBuffers.contains(preloadBuffer.get()))
+	{
+		auto bytesPerSample = fileReader.isMonolithic() ? sizeof(int16) : sizeof(float);
+
+		return (size_t)(loopBuffer.getNumSamples() *loopBuffer.getNumChannels()) * bytesPerSample;
+	}
+	
+	countedBuffers.add(preloadBuffer.get());
+
+	return getActualPreloadSize();
 }
 
 void StreamingSamplerSound::loadEntireSample() { setPreloadSize(-1); }
@@ -628,9 +976,12 @@ void StreamingSamplerSound::fillInternal(hlac::HiseSampleBuffer &sampleBuffer, i
 
 		jassert(indexInPreloadBuffer >= 0);
 
-		if (indexInPreloadBuffer + samplesToCopy < preloadBuffer.getNumSamples())
+		// This is called on the streaming thread while the warm-up thread might replace the buffer
+		const SharedPreloadBuffer::Ptr localPreloadBuffer = getPreloadBufferReference();
+
+		if (localPreloadBuffer != nullptr && indexInPreloadBuffer + samplesToCopy < localPreloadBuffer->buffer.getNumSamples())
 		{
-			hlac::HiseSampleBuffer::copy(sampleBuffer, preloadBuffer, offsetInBuffer, indexInPreloadBuffer, samplesToCopy);
+			hlac::HiseSampleBuffer::copy(sampleBuffer, localPreloadBuffer->buffer, offsetInBuffer, indexInPreloadBuffer, samplesToCopy);
 
 			//FloatVectorOperations::copy(sampleBuffer.getWritePointer(0, offsetInBuffer), preloadBuffer.getReadPointer(0, indexInPreloadBuffer), samplesToCopy);
 			//FloatVectorOperations::copy(sampleBuffer.getWritePointer(1, offsetInBuffer), preloadBuffer.getReadPointer(1, indexInPreloadBuffer), samplesToCopy);
@@ -981,13 +1332,39 @@ AudioFormatReader* StreamingSamplerSound::FileReader::createMonolithicReaderForP
 	}
 }
 
+int64 StreamingSamplerSound::FileReader::getMonolithCacheKey() const
+{
+	// Monoliths without metadata (eg. if the sample map is corrupt) are never shared
+	if (monolithicInfo == nullptr || !monolithicInfo->hasSampleInfo(0, monolithicIndex))
+		return 0;
+
+	String k;
+
+	k << String(monolithicInfo->getCacheKey(monolithicChannelIndex)) << ":" << String(monolithicInfo->getMonolithOffset(monolithicIndex)) << ":" << monolithicIndex;
+
+	return k.hashCode64();
+}
+
+SharedPreloadBuffer* StreamingSamplerSound::FileReader::createMappedPreloadBuffer(int startSample, int numSamples)
+{
+	if (monolithicInfo == nullptr || !monolithicInfo->hasSampleInfo(monolithicChannelIndex, monolithicIndex))
+		return nullptr;
+
+	if (const int16* data = monolithicInfo->getMappedSampleData(monolithicIndex, monolithicChannelIndex, startSample, numSamples))
+		return new SharedPreloadBuffer(monolithicInfo.get(), data, numSamples);
+
+	return nullptr;
+}
+
 void StreamingSamplerSound::FileReader::setMonolithicInfo(MonolithInfoToUse* info, int channelIndex, int sampleIndex)
 {
 	monolithicInfo = info;
 	monolithicIndex = sampleIndex;
-	missing = (sampleIndex == -1);
-	monolithicName = info->getFileName(channelIndex, sampleIndex);
 	monolithicChannelIndex = channelIndex;
+
+	// If the metadata couldn't be loaded, the sample can't be found in the monolith
+	missing = !info->hasSampleInfo(channelIndex, sampleIndex);
+	monolithicName = missing ? String() : info->getFileName(channelIndex, sampleIndex);
 }
 
 // =============================================================================================================================================== SampleLoader methods
@@ -1056,7 +1433,39 @@ void SampleLoader::startNote(StreamingSamplerSound const *s, int startTime)
 
 	sampleStartModValue = (int)startTime;
 
-	auto localReadBuffer = &s->getPreloadBuffer();
+	if (!s->isPreloaded())
+	{
+		// There is no preload buffer yet, so the first streaming buffer is loaded from the start position
+		// and the voice waits until it has arrived (see isWaitingForFirstBuffer()).
+		readBuffer = &b2;
+		writeBuffer = &b1;
+
+		lastSwapPosition = (double)startTime;
+
+		readIndex = 0;
+		readIndexDouble = 0.0;
+
+		isReadingFromPreloadBuffer = false;
+
+		positionInSampleFile = startTime;
+
+		voiceCounterWasIncreased = false;
+
+		firstBufferLoaded = false;
+		waitingForFirstBuffer = true;
+
+		// If the request failed, the write buffer was cleared, so there is nothing to wait for
+		if (!requestNewData())
+			firstBufferLoaded = true;
+
+		return;
+	}
+
+	waitingForFirstBuffer = false;
+
+	preloadBufferReference = s->getPreloadBufferReference();
+
+	auto localReadBuffer = &preloadBufferReference->buffer;
 	auto localWriteBuffer = &b1;
 
 	// the read pointer will be pointing directly to the preload buffer of the sample sound
@@ -1290,6 +1699,26 @@ StereoChannelData SampleLoader::fillVoiceBuffer(hlac::HiseSampleBuffer &voiceBuf
 	}
 }
 
+bool SampleLoader::isWaitingForFirstBuffer()
+{
+	if (!waitingForFirstBuffer)
+		return false;
+
+	if (!firstBufferLoaded.load())
+		return true;
+
+	waitingForFirstBuffer = false;
+
+	// The loaded buffer becomes the read buffer and the next one is requested
+	lastSwapPosition = (double)positionInSampleFile;
+	positionInSampleFile += getNumSamplesForStreamingBuffers();
+
+	swapBuffers();
+	requestNewData();
+
+	return false;
+}
+
 bool SampleLoader::advanceReadIndex(double uptime)
 {
 	const int numSamplesInBuffer = readBuffer.get()->getNumSamples();
@@ -1314,6 +1743,9 @@ bool SampleLoader::requestNewData()
 {
     //ADD_GLITCH_DETECTOR("Requesting new sample data");
 
+	if (logger != nullptr)
+		logger->logStreamingRequest(this->isQueued(), positionInSampleFile);
+
 #if KILL_VOICES_WHEN_STREAMING_IS_BLOCKED
     if(this->isQueued())
     {
@@ -1363,6 +1795,8 @@ SampleThreadPoolJob::JobStatus SampleLoader::runJob()
     fillInactiveBuffer();
     
     writeBufferIsBeingFilled = false;
+
+	firstBufferLoaded.store(true);
     
     const double readStop = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks());
     const double readTime = (readStop - readStart);
@@ -1401,7 +1835,7 @@ void SampleLoader::fillInactiveBuffer()
 		{
 			writeBuffer.get()->clear();
 		}
-        
+
 		logger->checkAssertion(nullptr, DebugLogger::Location::SampleLoaderReadOperation, localSound != nullptr, 1174);
 
 #if 0 && LOG_SAMPLE_RENDERING
@@ -1585,6 +2019,14 @@ void StreamingSamplerVoice::renderNextBlock(AudioSampleBuffer &outputBuffer, int
     
 	if(sound != nullptr)
 	{
+		if (loader.isWaitingForFirstBuffer())
+		{
+			// The sound isn't preloaded and the disk hasn't delivered the start yet,
+			// so the voice stays silent without advancing.
+			outputBuffer.clear(startSample, numSamples);
+			return;
+		}
+
 		const double startAlpha = fmod(voiceUptime, 1.0);
 		
 		jassert(pitchCounter != 0);
@@ -1683,3 +2125,109 @@ void StreamingSamplerVoice::renderNextBlock(AudioSampleBuffer &outputBuffer, int
         resetVoice();
     }
 };
+
+/** ============================================================================================================================== UNIT TEST */
+
+class StreamingSamplerColdStartTest : public UnitTest
+{
+public:
+
+	StreamingSamplerColdStartTest() :
+		UnitTest("Testing cold start of the streaming sampler")
+	{
+
+	}
+
+	void runTest() override
+	{
+		beginTest("A sound that isn't preloaded starts with its first sample");
+
+		const int numSamples = 44100;
+		const int blockSize = 512;
+
+		File f = File::createTempFile(".wav");
+
+		writeRamp(f, numSamples);
+
+		{
+			ModulatorSamplerSoundPool pool(nullptr);
+			ScopedPointer<SampleThreadPool> threadPool = new SampleThreadPool();
+			DebugLogger logger(nullptr);
+
+			StreamingSamplerSound::Ptr sound = new StreamingSamplerSound(f.getFullPathName(), &pool);
+
+			// The sound is flagged as missing until the file is checked (the sampler does this when it loads the sample map)
+			sound->checkFileReference();
+			sound->setPreloadSize(4096, true);
+			sound->markAsNotPreloaded();
+
+			hlac::HiseSampleBuffer tempBuffer(true, 2, 0);
+			StreamingSamplerVoice::initTemporaryVoiceBuffer(&tempBuffer, blockSize);
+
+			StreamingSamplerVoice voice(threadPool);
+
+			voice.setDebugLogger(&logger);
+			voice.setTemporaryVoiceBuffer(&tempBuffer);
+			voice.prepareToPlay(44100.0, blockSize);
+			voice.setLoaderBufferSize(4096);
+			voice.setPitchFactor(60, 60, sound, 1.0);
+			voice.startNote(60, 1.0f, sound, 0);
+
+			AudioSampleBuffer output(2, blockSize);
+
+			bool started = false;
+
+			for (int i = 0; i < 1000 && !started; i++)
+			{
+				output.clear();
+
+				voice.setPitchCounterForThisBlock((double)blockSize);
+				voice.renderNextBlock(output, 0, blockSize);
+
+				started = output.getMagnitude(0, blockSize) > 0.0f;
+
+				if (!started)
+					Thread::sleep(1);
+			}
+
+			expect(started, "Voice started");
+
+			expectWithinAbsoluteError<float>(output.getSample(0, 0), getRampValue(0, numSamples), 0.0001f, "First sample");
+			expectWithinAbsoluteError<float>(output.getSample(1, 100), getRampValue(100, numSamples), 0.0001f, "Sample 100");
+
+			// Stop the streaming thread before the voice is deleted
+			threadPool = nullptr;
+		}
+
+		f.deleteFile();
+	}
+
+private:
+
+	static float getRampValue(int index, int numSamples)
+	{
+		return 0.5f + 0.5f * (float)index / (float)numSamples;
+	}
+
+	void writeRamp(const File& f, int numSamples)
+	{
+		AudioSampleBuffer b(2, numSamples);
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			b.setSample(0, i, getRampValue(i, numSamples));
+			b.setSample(1, i, getRampValue(i, numSamples));
+		}
+
+		WavAudioFormat wav;
+
+		ScopedPointer<AudioFormatWriter> writer = wav.createWriterFor(new FileOutputStream(f), 44100.0, 2, 32, StringPairArray(), 0);
+
+		expect(writer != nullptr, "Writer created");
+
+		if (writer != nullptr)
+			writer->writeFromAudioSampleBuffer(b, 0, numSamples);
+	}
+};
+
+static StreamingSamplerColdStartTest coldStartTest;
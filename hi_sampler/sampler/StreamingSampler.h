@@ -87,6 +87,111 @@ struct StereoChannelData
 
 // ==================================================================================================================================================
 
+/** A reference counted preload buffer.
+*
+*	If the key is not zero, the buffer is stored in the SharedSampleCache and might be used by sounds of other plugin instances,
+*	so you must not change its content after it was added to the cache.
+*/
+class SharedPreloadBuffer : public ReferenceCountedObject
+{
+public:
+
+	typedef ReferenceCountedObjectPtr<SharedPreloadBuffer> Ptr;
+
+	SharedPreloadBuffer(bool isFloat, int numChannels, int numSamples, int64 key_=0) :
+		buffer(isFloat, numChannels, numSamples),
+		key(key_)
+	{};
+
+	/** Creates a read only buffer that points into the memory mapped data of a monolith.
+	*
+	*	It keeps a reference to the monolith so that the mapping stays valid and locks the pages in memory (or pre-faults them
+	*	if the ZERO_COPY_PRELOAD_LOCK_BUDGET is exceeded).
+	*/
+	SharedPreloadBuffer(MonolithInfoToUse* info, const int16* mappedData, int numSamples);
+
+	~SharedPreloadBuffer();
+
+	/** Returns true if the buffer points into a memory mapped file. You can't change the data of these buffers. */
+	bool isMappedView() const noexcept { return mappedInfo != nullptr; }
+
+	hlac::HiseSampleBuffer buffer;
+
+	const int64 key;
+
+private:
+
+	/** Locks the pages that lie completely inside the range and returns the number of locked bytes (0 if nothing was locked). */
+	static size_t lockPages(const void* data, size_t numBytes, const void*& lockedStart);
+
+	static void touchPages(const void* data, size_t numBytes);
+
+	static void unlockPages(const void* data, size_t numBytes);
+
+	static Atomic<int64> numLockedBytes;
+
+	ReferenceCountedObjectPtr<MonolithInfoToUse> mappedInfo;
+
+	const void* lockedData = nullptr;
+	size_t numBytesLocked = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(SharedPreloadBuffer)
+};
+
+/** A process wide cache for monolith files and preload buffers.
+*
+*	If the same library is loaded in multiple plugin instances, every instance would load its own preload buffers and map the monolith
+*	files again. Use this class with a SharedResourcePointer and it will return the already loaded data instead.
+*
+*	Only the read only data is shared: the StreamingSamplerSound objects stay unique for every instance and look up their preload
+*	buffer with a key that contains every property that affects the preload data (sample start, preload size, loop points...).
+*	If one instance changes one of these properties, it will just create a new buffer for itself (copy on write).
+*
+*	Entries are removed from the cache as soon as they are not referenced by any sound.
+*/
+class SharedSampleCache
+{
+public:
+
+	SharedSampleCache() {};
+
+	/** Returns the monolith info for the given files. If they are already loaded by another instance, it returns the existing info,
+	*	otherwise it creates a new one and fills it with the metadata from the sample map.
+	*
+	*	This might throw a StreamingSamplerSound::LoadingError. 
+	*
+	*	The returned pointer holds a reference, so the entry can't be removed by another thread before you use it. */
+	ReferenceCountedObjectPtr<MonolithInfoToUse> getMonolith(const Array<File>& monolithicFiles, const ValueTree& sampleMap);
+
+	/** Returns the preload buffer with the given key (or nullptr if it is not cached). */
+	SharedPreloadBuffer::Ptr getPreloadBuffer(int64 key);
+
+	/** Adds the buffer to the cache. If another thread has added a buffer with the same key in the meantime, it will return this one. */
+	SharedPreloadBuffer::Ptr addPreloadBuffer(SharedPreloadBuffer* newBuffer);
+
+	/** Removes the buffer from the cache if it's not used by any other sound. */
+	void removeIfUnused(SharedPreloadBuffer* buffer);
+
+	/** Removes all entries that are only referenced by the cache. */
+	void clearUnreferencedEntries();
+
+	/** Returns the memory of all preload buffers in the cache. */
+	size_t getMemoryUsage() const;
+
+private:
+
+	CriticalSection lock;
+
+	ReferenceCountedArray<MonolithInfoToUse> monoliths;
+	Array<int64> monolithKeys;
+
+	HashMap<int64, SharedPreloadBuffer::Ptr> preloadBuffers;
+
+	JUCE_DECLARE_NON_COPYABLE(SharedSampleCache)
+};
+
+// ==================================================================================================================================================
+
 /** A SamplerSound which provides buffered disk streaming using memory mapped file access and a preloaded sample start. */
 class StreamingSamplerSound: public SynthesiserSound
 {
@@ -128,8 +233,11 @@ public:
 	*/
 	StreamingSamplerSound(const String &fileNameToLoad, ModulatorSamplerSoundPool *pool);
 
-	/** Creates a new StreamingSamplerSound from a monolithic file. */
-	StreamingSamplerSound(MonolithInfoToUse *info, int channelIndex, int sampleIndex);
+	/** Creates a new StreamingSamplerSound from a monolithic file.
+	*
+	*	If you pass in a SharedSampleCache, the preload buffer will be shared with other sounds that use the same part of the monolith.
+	*/
+	StreamingSamplerSound(MonolithInfoToUse *info, int channelIndex, int sampleIndex, SharedSampleCache* cache=nullptr);
 
 	~StreamingSamplerSound();
 
@@ -215,12 +323,20 @@ public:
 	*
 	*	If the preload size is not changed, it will do nothing, but you can force it to reload it with 'forceReload'.
 	*	You can also tell the sound to load everything into memory by calling loadEntireSample().
+	*
+	*	If you pass a lock, the data is loaded without it and only the swap of the preload buffer happens while it is held.
 	*/
-	void setPreloadSize(int newPreloadSizeInSamples, bool forceReload = false);
+	void setPreloadSize(int newPreloadSizeInSamples, bool forceReload = false, const CriticalSection* swapLock = nullptr);
 
 	/** Returns the size of the preload buffer in bytes. You can use this method to check how much memory the sound uses. It also includes the memory used for the crossfade buffer. */
 	size_t getActualPreloadSize() const;
 
+	/** Same as getActualPreloadSize(), but skips the preload buffer if it is already in the given list. 
+	*
+	*	Use this if you add up the memory of multiple sounds that might share their preload buffers.
+	*/
+	size_t getActualPreloadSize(SortedSet<const SharedPreloadBuffer*>& countedBuffers) const;
+
 	/** Tell the sound to load everything into memory. 
     *
     *   It will also close the file handle.
@@ -238,8 +354,15 @@ public:
 	bool isOpened();
 
 	bool isMonolithic() const;
+
+	/** Checks if the sound reads its data from the given monolith. */
+	bool usesMonolith(const MonolithInfoToUse* info) const { return fileReader.getMonolithInfo() == info; }
+
 	AudioFormatReader* createReaderForPreview() { return fileReader.createMonolithicReaderForPreview(); }
 
+	/** Returns the peak cache of the monolith that contains this sound (or nullptr if it isn't available yet). */
+	MonolithPeakCache* getPeakCache() const { return fileReader.getPeakCache(); }
+
 	AudioFormatReader* createReaderForAnalysis();
     
     int64 getMonolithOffset() const { return fileReader.getMonolithOffset(); }
@@ -292,9 +415,25 @@ public:
 		// This should not happen (either its unloaded or it has some samples)...
 		//jassert(preloadBuffer.getNumSamples() != 0);
 
+		return preloadBuffer->buffer;
+	}
+
+	/** Returns a reference to the current preload buffer.
+	*
+	*	The warm-up thread can replace the preload buffer while voices are playing, so the SampleLoader holds this reference
+	*	until it is reset. The sound keeps the replaced buffers alive until no voice uses them anymore, so the last reference is
+	*	never released on the audio thread. This can be called from any thread.
+	*/
+	SharedPreloadBuffer::Ptr getPreloadBufferReference() const noexcept
+	{
+		SpinLock::ScopedLockType sl(preloadBufferLock);
+
 		return preloadBuffer;
 	}
 
+	/** Deletes the replaced preload buffers that are not used by any voice anymore. Don't call this on the audio thread. */
+	void releaseRetiredPreloadBuffers();
+
 	// ==============================================================================================================================================
 
 	/** Scans the file for the max level. */
@@ -302,6 +441,16 @@ public:
 
 	void setPurged(bool shouldBePurged) { purged = shouldBePurged; };
 	bool isPurged() const noexcept { return purged; }
+
+	/** Returns true if the preload buffer is loaded and can be used by the voices.
+	*
+	*	With lazy preloading, a sound is playable before its preload buffer is loaded. A voice that starts a sound
+	*	which isn't preloaded yet streams it from the start position and stays silent until the first buffer has arrived.
+	*/
+	bool isPreloaded() const noexcept { return preloaded.load(); }
+
+	/** Marks the sound as not preloaded. Voices that are already playing keep their reference to the preload buffer. */
+	void markAsNotPreloaded() noexcept { preloaded.store(false); }
 	
 	// ==============================================================================================================================================
 
@@ -363,6 +512,18 @@ private:
 		bool isOpened() const noexcept { return fileHandlesOpen; }
 		bool isMonolithic() const noexcept{ return monolithicInfo != nullptr; }
 
+		/** Returns the monolith info (or nullptr if the sound isn't monolithic). */
+		const MonolithInfoToUse* getMonolithInfo() const noexcept { return monolithicInfo.get(); }
+
+		/** Returns a key for the monolith section of this sound that can be used to look up shared data (or 0 if it isn't monolithic). */
+		int64 getMonolithCacheKey() const;
+
+		/** Creates a preload buffer that points directly into the memory mapped monolith (or nullptr if the data needs to be converted). */
+		SharedPreloadBuffer* createMappedPreloadBuffer(int startSample, int numSamples);
+
+		/** Returns the peak cache of the monolith (or nullptr if the sound isn't monolithic). */
+		MonolithPeakCache* getPeakCache() const { return monolithicInfo != nullptr ? monolithicInfo->getPeakCache(monolithicChannelIndex) : nullptr; }
+
 		bool isStereo() const noexcept;
 
 		bool isMissing() const { return missing; }
@@ -370,7 +531,7 @@ private:
 
 		int64 getMonolithOffset() const
         {
-            if(monolithicInfo != nullptr)
+            if(monolithicInfo != nullptr && monolithicInfo->hasSampleInfo(0, monolithicIndex))
             {
                 return monolithicInfo->getMonolithOffset(monolithicIndex);
             }
@@ -380,7 +541,7 @@ private:
         
         int64 getMonolithLength() const
         {
-            if(monolithicInfo != nullptr)
+            if(monolithicInfo != nullptr && monolithicInfo->hasSampleInfo(0, monolithicIndex))
             {
                 return monolithicInfo->getMonolithLength(monolithicIndex);
             }
@@ -395,7 +556,7 @@ private:
         
         double getMonolithSampleRate() const
         {
-            if(monolithicInfo != nullptr)
+            if(monolithicInfo != nullptr && monolithicInfo->hasSampleInfo(0, monolithicIndex))
             {
                 return monolithicInfo->getMonolithSampleRate(monolithicIndex);
             }
@@ -481,7 +642,29 @@ private:
 	
 	friend class SampleLoader;
 
-	hlac::HiseSampleBuffer preloadBuffer;	
+	/** Replaces the preload buffer and removes the old one from the cache if it isn't used anymore. */
+	void setPreloadBuffer(SharedPreloadBuffer* newBuffer);
+
+	/** Loads the preload buffer for the given size (without using it). */
+	SharedPreloadBuffer::Ptr loadPreloadBuffer(int newPreloadSize);
+
+	/** Returns the key that is used to share the preload buffer (or 0 if it can't be shared). */
+	int64 getPreloadCacheKey() const;
+
+	/** Replaces a shared preload buffer with a private copy before it is changed. */
+	void makePreloadBufferUnique();
+
+	SharedPreloadBuffer::Ptr preloadBuffer;
+	SharedSampleCache* sharedCache = nullptr;
+
+	// Guards the swap of the preload buffer pointer (it's read by the audio and streaming threads)
+	mutable SpinLock preloadBufferLock;
+
+	// Replaced buffers that might still be used by a voice
+	ReferenceCountedArray<SharedPreloadBuffer> retiredPreloadBuffers;
+
+	std::atomic<bool> preloaded { true };
+
 	double sampleRate;
 
 	int monolithOffset;
@@ -577,6 +760,12 @@ public:
     /** Advances the read index and returns `false` if the streaming thread is blocked. */
 	bool advanceReadIndex(double uptime);
 
+	/** Returns true if the note was started without a preload buffer and the first buffer isn't loaded yet.
+	*
+	*	Call this from the audio thread before rendering. As soon as the buffer has arrived, it is used as read buffer.
+	*/
+	bool isWaitingForFirstBuffer();
+
 	/** Call this whenever a sound was started.
 	*
 	*	This will set the read pointer to the preload buffer of the StreamingSamplerSound and start the background reading.
@@ -665,8 +854,10 @@ public:
     void clearLoader()
     {   
         sound = nullptr;
+		preloadBufferReference = nullptr;
         diskUsage = 0.0f;
         cancelled = false;
+		waitingForFirstBuffer = false;
     }
 
 	/** Calculates and returns the disk usage.
@@ -707,6 +898,7 @@ private:
 
 	void fillInactiveBuffer();
 	void refreshBufferSizes();
+
 	// ============================================================================================ member variables
 
 	Unmapper unmapper;
@@ -737,6 +929,15 @@ private:
 	bool isReadingFromPreloadBuffer;
 
     bool voiceCounterWasIncreased;
+
+	// set when the note was started without a preload buffer until the first streaming buffer is used
+	bool waitingForFirstBuffer = false;
+
+	// set by the streaming thread after the buffer was filled
+	std::atomic<bool> firstBufferLoaded { false };
+
+	// Keeps the preload buffer alive while the voice is reading from it
+	SharedPreloadBuffer::Ptr preloadBufferReference;
     
 	int sampleStartModValue;
 
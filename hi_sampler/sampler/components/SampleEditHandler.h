@@ -144,6 +144,7 @@ public:
 		static void extractToSingleMicSamples(SampleEditHandler * body);
 		static void normalizeSamples(SampleEditHandler *handler, Component* childOfRoot);
 		static void automapUsingMetadata(ModulatorSampler* sampler);
+		static bool setSoundPropertiesFromMetadata(ModulatorSamplerSound *sound, const StringPairArray &metadata);
 		static void trimSampleStart(SampleEditHandler * body);
 		static void createMultimicSampleMap(SampleEditHandler* handler, SampleMapEditor* param2);
 	};
@@ -899,7 +899,7 @@ void SampleEditHandler::SampleEditingActions::extractToSingleMicSamples(SampleEd
 
 #define SET_PROPERTY_FROM_METADATA_STRING(string, prop) if (string.isNotEmpty()) sound->setProperty(prop, string.getIntValue(), sendNotification);
 
-bool setSoundPropertiesFromMetadata(ModulatorSamplerSound *sound, const StringPairArray &metadata)
+bool SampleEditHandler::SampleEditingActions::setSoundPropertiesFromMetadata(ModulatorSamplerSound *sound, const StringPairArray &metadata)
 {
 	const String format = metadata.getValue("MetaDataSource", "");
 	
@@ -653,7 +653,7 @@ void SamplerSettings::labelTextChanged (Label* labelThatHasChanged)
 
 		if(value > 0)
 		{
-			value = jmin(128, value);
+			value = jmin(NUM_MAX_POLYPHONIC_VOICES, value);
 
 			sampler->setAttribute(ModulatorSampler::VoiceAmount, (float)value, dontSendNotification);
 		}
@@ -41,6 +41,7 @@
 #endif
 #include "scripting/api/DspFactory.cpp"
 #include "scripting/api/DspInstance.cpp"
+#include "scripting/api/NativeJITModulationRenderer.cpp"
 
 #include "scripting/engine/JavascriptApiClass.cpp"
 #include "scripting/api/ScriptingBaseObjects.cpp"
@@ -56,6 +57,7 @@
 #include "scripting/engine/JavascriptEngineAdditionalMethods.cpp"
 
 #include "scripting/api/XmlApi.cpp"
+#include "scripting/api/ScriptDisplayList.cpp"
 #include "scripting/api/ScriptingApiObjects.cpp"
 #include "scripting/api/ScriptingApi.cpp"
 #include "scripting/api/ScriptingApiWrappers.cpp"
@@ -53,9 +53,16 @@ END_JUCE_MODULE_DECLARATION
 
 #define MAX_SCRIPT_HEIGHT 700
 
+#include "AppConfig.h"
+
+/** Config: INCLUDE_NATIVE_JIT
+
+If true, the NativeJIT compiler is used for loadJit() and setNativeRenderer(). This needs the hi_native_jit module.
+*/
+#ifndef INCLUDE_NATIVE_JIT
 #define INCLUDE_NATIVE_JIT 0
+#endif
 
-#include "AppConfig.h"
 #include "../hi_sampler/hi_sampler.h"
 #include "../hi_dsp_library/hi_dsp_library.h"
 
@@ -79,6 +86,7 @@ END_JUCE_MODULE_DECLARATION
 #else
 #include "scripting/api/TccDspObject.h"
 #endif
+#include "scripting/api/NativeJITModulationRenderer.h"
 #include "scripting/scripting_audio_processor/ScriptDspModules.h"
 #include "scripting/scripting_audio_processor/ScriptedAudioProcessor.h"
 
@@ -86,6 +94,7 @@ END_JUCE_MODULE_DECLARATION
 #include "scripting/engine/HiseJavascriptEngine.h"
 
 #include "scripting/api/XmlApi.h"
+#include "scripting/api/ScriptDisplayList.h"
 #include "scripting/api/ScriptingApiObjects.h"
 #include "scripting/api/ScriptingApi.h"
 #include "scripting/api/ScriptingApiContent.h"
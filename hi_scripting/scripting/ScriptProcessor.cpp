@@ -32,7 +32,7 @@
 
 
 
-void ProcessorWithScriptingContent::setControlValue(int index, float newValue)
+void ProcessorWithScriptingContent::setControlValue(int index, float newValue, bool notifyHost)
 {
 	jassert(content.get() != nullptr);
 
@@ -63,13 +63,18 @@ void ProcessorWithScriptingContent::setControlValue(int index, float newValue)
 
 #if USE_FRONTEND
 
-			if (c->isAutomatable() &&
+			if (notifyHost &&
+				c->isAutomatable() &&
 				c->getScriptObjectProperty(ScriptingApi::Content::ScriptComponent::Properties::isPluginParameter) &&
 				getMainController_()->getPluginParameterUpdateState())
 			{
 				dynamic_cast<PluginParameterAudioProcessor*>(getMainController_())->setScriptedPluginParameter(c->getName(), newValue);
 			}
 
+#else
+
+			ignoreUnused(notifyHost);
+
 #endif
 
 			controlCallback(c, newValue);
@@ -405,6 +410,7 @@ JavascriptProcessor::~JavascriptProcessor()
 
 void JavascriptProcessor::fileChanged()
 {
+	invalidateCompileState();
 	compileScript();
 }
 
@@ -556,21 +562,28 @@ JavascriptProcessor::SnippetResult JavascriptProcessor::compileScript()
 
 	SnippetResult result = SnippetResult(Result::ok(), 0);
 
-	if (useBackgroundThread)
+	if (!swapChangedCallbacks(result))
 	{
-		CompileThread ct(this);
+		const double startTime = Time::getMillisecondCounterHiRes();
+
+		if (useBackgroundThread)
+		{
+			CompileThread ct(this);
 
-		currentCompileThread = &ct;
+			currentCompileThread = &ct;
 
-		ct.runThread();
+			ct.runThread();
 
-		currentCompileThread = nullptr;
+			currentCompileThread = nullptr;
 
-		result = ct.result;
-	}
-	else
-	{
-		result = compileInternal();
+			result = ct.result;
+		}
+		else
+		{
+			result = compileInternal();
+		}
+
+		updateCompileState(Time::getMillisecondCounterHiRes() - startTime);
 	}
 
 	if (lastCompileWasOK)
@@ -606,6 +619,123 @@ JavascriptProcessor::SnippetResult JavascriptProcessor::compileScript()
 	return result;
 }
 
+bool JavascriptProcessor::swapChangedCallbacks(SnippetResult& result)
+{
+	if (!lastCompileWasOK || compileScriptAsWhole || useStoredContentData || anyBreakpointsActive())
+		return false;
+
+	if (compileState.snippetHashes.size() != getNumSnippets())
+		return false;
+
+	const int numFiles = scriptEngine->getNumIncludedFiles();
+
+	if (compileState.includedFileHashes.size() != numFiles)
+		return false;
+
+	// The included files are parsed as part of onInit...
+	for (int i = 0; i < numFiles; i++)
+	{
+		if (getIncludedFileHash(scriptEngine, i) != compileState.includedFileHashes[i])
+			return false;
+	}
+
+	const static Identifier onInit("onInit");
+
+	Array<int> changedSnippets;
+
+	for (int i = 0; i < getNumSnippets(); i++)
+	{
+		if (getSnippet(i)->getAllContent().hashCode64() == compileState.snippetHashes[i])
+			continue;
+
+		if (getSnippet(i)->getCallbackName() == onInit)
+			return false;
+
+		changedSnippets.add(i);
+	}
+
+	// Compiling an unchanged script resets its state, so it must run onInit again
+	if (changedSnippets.isEmpty())
+		return false;
+
+	const double startTime = Time::getMillisecondCounterHiRes();
+
+	auto thisAsProcessor = dynamic_cast<Processor*>(this);
+
+	{
+		ScopedLock callbackLock(thisAsProcessor->isOnAir() ? mainController->getLock() : thisAsProcessor->getDummyLockWhenNotOnAir());
+
+		ScopedWriteLock sl(mainController->getCompileLock());
+
+		for (int i = 0; i < changedSnippets.size(); i++)
+		{
+			SnippetDocument* snippet = getSnippet(changedSnippets[i]);
+
+			snippet->checkIfScriptActive();
+
+			// Empty callbacks are skipped just like in compileInternal()
+			if (!snippet->isSnippetEmpty())
+			{
+				// If the callback can't be parsed, the full compilation reports the error
+				if (!scriptEngine->execute(snippet->getSnippetAsFunction(), false).wasOk())
+					return false;
+			}
+
+			compileState.snippetHashes.set(changedSnippets[i], snippet->getAllContent().hashCode64());
+		}
+
+		scriptEngine->rebuildDebugInformation();
+
+		postCompileCallback();
+	}
+
+	const double swapTime = Time::getMillisecondCounterHiRes() - startTime;
+
+	String message;
+
+	message << "Swapped ";
+
+	for (int i = 0; i < changedSnippets.size(); i++)
+	{
+		message << getSnippet(changedSnippets[i])->getCallbackName().toString();
+
+		if (i != changedSnippets.size() - 1)
+			message << ", ";
+	}
+
+	message << " in " << String(swapTime, 1) << " ms without running onInit (" << String(jmax<double>(0.0, compileState.lastFullCompileTime - swapTime), 1) << " ms saved)";
+
+	debugToConsole(thisAsProcessor, message);
+
+	lastResult = Result::ok();
+	result = SnippetResult(Result::ok(), getNumSnippets());
+
+	return true;
+}
+
+void JavascriptProcessor::updateCompileState(double compileTime)
+{
+	compileState.clear();
+
+	if (!lastCompileWasOK)
+		return;
+
+	for (int i = 0; i < getNumSnippets(); i++)
+		compileState.snippetHashes.add(getSnippet(i)->getAllContent().hashCode64());
+
+	for (int i = 0; i < scriptEngine->getNumIncludedFiles(); i++)
+		compileState.includedFileHashes.add(getIncludedFileHash(scriptEngine, i));
+
+	compileState.lastFullCompileTime = compileTime;
+}
+
+int64 JavascriptProcessor::getIncludedFileHash(const HiseJavascriptEngine* engine, int fileIndex)
+{
+	const File f = engine->getIncludedFile(fileIndex);
+
+	return f.existsAsFile() ? f.loadFileAsString().hashCode64() : 0;
+}
+
 
 void JavascriptProcessor::setupApi()
 {
@@ -984,3 +1114,97 @@ float ScriptBaseMidiProcessor::getDefaultValue(int index) const
 	else
 		return 0.0f;
 }
+
+/** ============================================================================================================================== UNIT TEST */
+
+class ScriptCompileTest : public UnitTest
+{
+public:
+
+	ScriptCompileTest() :
+		UnitTest("Testing the script compilation")
+	{
+
+	}
+
+	void runTest() override
+	{
+		beginTest("Swapping a changed callback sends the compile message");
+
+		TestController mc;
+		CompileCounter counter;
+
+		mc.addScriptListener(&counter);
+
+		{
+			ScopedPointer<JavascriptMidiProcessor> jmp = new JavascriptMidiProcessor(&mc, "TestScript");
+			JavascriptProcessor* sp = jmp.get();
+
+			sp->getSnippet(Identifier("onInit"))->replaceAllContent("var x = 0;\n");
+			sp->getSnippet(Identifier("onNoteOn"))->replaceAllContent("function onNoteOn()\n{\n\tx = 1;\n}\n");
+
+			jmp->compileScript();
+
+			expect(jmp->wasLastCompileOK(), "The initial compilation failed");
+			expectEquals<int>(counter.numCompileMessages, 1, "Compile message after full compilation");
+
+			const HiseJavascriptEngine* engineBeforeSwap = jmp->getScriptEngine();
+
+			sp->getSnippet(Identifier("onNoteOn"))->replaceAllContent("function onNoteOn()\n{\n\tx = 2;\n}\n");
+
+			jmp->compileScript();
+
+			expect(jmp->wasLastCompileOK(), "The swap failed");
+			expect(jmp->getScriptEngine() == engineBeforeSwap, "The callback wasn't swapped into the existing engine");
+			expectEquals<int>(counter.numCompileMessages, 2, "Compile message after swapping onNoteOn");
+
+			sp->getSnippet(Identifier("onNoteOn"))->replaceAllContent("function onNoteOn()\n{\n\t\n}\n");
+
+			jmp->compileScript();
+
+			expect(sp->getSnippet(Identifier("onNoteOn"))->isSnippetEmpty(), "The emptied callback is still active");
+			expectEquals<int>(counter.numCompileMessages, 3, "Compile message after emptying onNoteOn");
+
+			jmp->invalidateCompileState();
+			jmp->compileScript();
+
+			expect(jmp->getScriptEngine() != engineBeforeSwap, "The invalidated state didn't force a full compilation");
+			expectEquals<int>(counter.numCompileMessages, 4, "Compile message after forced full compilation");
+		}
+
+		mc.removeScriptListener(&counter);
+	}
+
+private:
+
+	class TestController : public MainController
+	{
+	public:
+
+		TestController()
+		{
+			synthChain = new ModulatorSynthChain(this, "Master Chain", 1);
+		}
+
+		~TestController()
+		{
+			synthChain = nullptr;
+		}
+
+		ModulatorSynthChain* getMainSynthChain() override { return synthChain; }
+		const ModulatorSynthChain* getMainSynthChain() const override { return synthChain; }
+
+	private:
+
+		ScopedPointer<ModulatorSynthChain> synthChain;
+	};
+
+	struct CompileCounter : public GlobalScriptCompileListener
+	{
+		void scriptWasCompiled(JavascriptProcessor*) override { numCompileMessages++; }
+
+		int numCompileMessages = 0;
+	};
+};
+
+static ScriptCompileTest scriptCompileTest;
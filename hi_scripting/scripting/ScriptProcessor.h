@@ -79,7 +79,12 @@ public:
 		return content.get();
 	}
 
-	void setControlValue(int index, float newValue);
+	/** Sets the value of the control and executes its callback.
+	*
+	*	If notifyHost is false, a control that is a plugin parameter won't send the value back to the host
+	*	(use this if the value comes from the host).
+	*/
+	void setControlValue(int index, float newValue, bool notifyHost=true);
 
 	float getControlValue(int index) const;
 
@@ -440,6 +445,9 @@ public:
 
 	void setCompileScriptAsWhole(bool shouldCompileWholeScript) { compileScriptAsWhole = shouldCompileWholeScript; }
 
+	/** Forces the next call to compileScript() to run the full compilation (eg. after an included file was edited). */
+	void invalidateCompileState() noexcept { compileState.clear(); }
+
 	void toggleBreakpoint(const Identifier& snippetId, int lineNumber, int charNumber)
 	{
 		HiseJavascriptEngine::Breakpoint bp(snippetId, lineNumber, charNumber, breakpoints.size());
@@ -549,6 +557,35 @@ private:
 
 	};
 
+	/** The hashes of the code that was used for the last successful compilation.
+	*
+	*	If only callbacks other than onInit were changed since then, compileScript() parses these callbacks into the
+	*	existing engine and skips onInit and the interface rebuild. The parsed statements themselves can't be cached
+	*	because the parser resolves every identifier to the storage of the engine that was used for parsing.
+	*/
+	struct CompileState
+	{
+		void clear()
+		{
+			snippetHashes.clear();
+			includedFileHashes.clear();
+		}
+
+		Array<int64> snippetHashes;
+		Array<int64> includedFileHashes;
+
+		double lastFullCompileTime = 0.0;
+	};
+
+	/** Swaps the changed callbacks into the current engine. Returns false if the script needs a full recompile. */
+	bool swapChangedCallbacks(SnippetResult& result);
+
+	void updateCompileState(double compileTime);
+
+	static int64 getIncludedFileHash(const HiseJavascriptEngine* engine, int fileIndex);
+
+	CompileState compileState;
+
 	struct RepaintUpdater : public AsyncUpdater
 	{
 		void handleAsyncUpdate()
@@ -149,6 +149,12 @@ void JavascriptMidiProcessor::processHiseEvent(HiseEvent &m)
 		ScopedWriteLock sl(defferedMessageLock);
 		
 		deferredEvents.addEvent(m);
+
+		getMainController()->getDebugLogger().checkEventBuffer(this, DebugLogger::Location::SynthRendering, deferredEvents);
+
+		// The deferred copy will set the control, so the event must not reach the processors of the child synths
+		if (m.isPluginParameterEvent() && m.getChannel() == getIndexInChain())
+			m.ignoreEvent(true);
 		
 		triggerAsyncUpdate();
 	}
@@ -262,6 +268,15 @@ void JavascriptMidiProcessor::runScriptCallbacks()
 		}
 		break;
 	}
+	case HiseEvent::Type::PluginParameter:
+	{
+		if (!currentEvent->isIgnored() && currentEvent->getChannel() == getIndexInChain())
+		{
+			setControlValue(currentEvent->getParameterControlIndex(), currentEvent->getParameterValue(), false);
+			currentEvent->ignoreEvent(true);
+		}
+		break;
+	}
         case HiseEvent::Type::Empty:
         case HiseEvent::Type::AllNotesOff:
         case HiseEvent::Type::SongPosition:
@@ -406,6 +421,15 @@ void JavascriptMidiProcessor::replaceReferencesWithGlobalFolder()
 }
 
 
+void JavascriptMidiProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+	MidiProcessor::prepareToPlay(sampleRate, samplesPerBlock);
+
+	// The deferred events of a few blocks might pile up until the message thread processes them
+	ScopedWriteLock sl(defferedMessageLock);
+	deferredEvents.ensureAllocatedSize(samplesPerBlock * 4);
+}
+
 void JavascriptMidiProcessor::handleAsyncUpdate()
 {
 	jassert(isDeferred());
@@ -415,6 +439,9 @@ void JavascriptMidiProcessor::handleAsyncUpdate()
 
 	if (!deferredEvents.isEmpty())
 	{
+		// Grow the copy before locking so that the audio thread isn't blocked by the allocation
+		copyEventBuffer.ensureAllocatedSize(deferredEvents.getNumAllocated());
+
 		ScopedWriteLock sl(defferedMessageLock);
 
 		copyEventBuffer.copyFrom(deferredEvents);
@@ -560,6 +587,8 @@ const JavascriptProcessor::SnippetDocument * JavascriptMasterEffect::getSnippet(
 
 void JavascriptMasterEffect::registerApiClasses()
 {
+	directModules.clear();
+
 	content = new ScriptingApi::Content(this);
 
 	engineObject = new ScriptingApi::Engine(this);
@@ -601,7 +630,7 @@ void JavascriptMasterEffect::prepareToPlay(double sampleRate, int samplesPerBloc
 
 void JavascriptMasterEffect::renderWholeBuffer(AudioSampleBuffer &buffer)
 {
-	if (!processBlockCallback->isSnippetEmpty() && lastResult.wasOk())
+	if ((directModules.size() != 0 || !processBlockCallback->isSnippetEmpty()) && lastResult.wasOk())
 	{
 		ScopedReadLock sl(getMainController()->getCompileLock());
 
@@ -609,22 +638,38 @@ void JavascriptMasterEffect::renderWholeBuffer(AudioSampleBuffer &buffer)
 
 		jassert(channelIndexes.size() == channels.size());
 
+		float* channelData[NUM_MAX_CHANNELS];
+
 		for (int i = 0; i < channelIndexes.size(); i++)
 		{
 			float* d = buffer.getWritePointer(channelIndexes[i], 0);
 
 			CHECK_AND_LOG_BUFFER_DATA(this, DebugLogger::Location::ScriptFXRendering, d, true, numSamples);
 
+			channelData[i] = d;
+
 			auto b = channels[i].getBuffer();
 			
 			if(b != nullptr)
 				b->referToData(d, numSamples);
 		}
 
-		scriptEngine->setCallbackParameter((int)Callback::processBlock, 0, channels);
-		scriptEngine->executeCallback((int)Callback::processBlock, &lastResult);
+		if (directModules.size() != 0)
+		{
+			// Refers to the routed channels without allocating
+			AudioSampleBuffer routedChannels(channelData, channelIndexes.size(), numSamples);
 
-		BACKEND_ONLY(if (!lastResult.wasOk()) debugError(this, processBlockCallback->getCallbackName().toString() + ": " + lastResult.getErrorMessage()));
+			for (int i = 0; i < directModules.size(); i++)
+				directModules.getUnchecked(i)->processBuffer(routedChannels, 0, numSamples);
+		}
+
+		if (!processBlockCallback->isSnippetEmpty())
+		{
+			scriptEngine->setCallbackParameter((int)Callback::processBlock, 0, channels);
+			scriptEngine->executeCallback((int)Callback::processBlock, &lastResult);
+
+			BACKEND_ONLY(if (!lastResult.wasOk()) debugError(this, processBlockCallback->getCallbackName().toString() + ": " + lastResult.getErrorMessage()));
+		}
 	}
 }
 
@@ -798,7 +843,7 @@ void JavascriptVoiceStartModulator::registerApiClasses()
 	scriptEngine->registerApiClass(currentMidiMessage);
 	scriptEngine->registerApiClass(engineObject);
 	scriptEngine->registerApiClass(new ScriptingApi::Console(this));
-	scriptEngine->registerApiClass(new ScriptingApi::ModulatorApi(this));
+	scriptEngine->registerApiClass(new ScriptingApi::ModulatorApi(this, this));
 	scriptEngine->registerApiClass(synthObject);
 }
 
@@ -920,6 +965,14 @@ void JavascriptTimeVariantModulator::prepareToPlay(double sampleRate, int sample
 	buffer->referToData(internalBuffer.getWritePointer(0), samplesPerBlock);
 	bufferVar = var(buffer);
 
+#if INCLUDE_NATIVE_JIT
+	if (nativeRenderer != nullptr)
+	{
+		ScopedReadLock sl(mainController->getCompileLock());
+		nativeRenderer->prepareToPlay(sampleRate, samplesPerBlock);
+	}
+#endif
+
 	if (!prepareToPlayCallback->isSnippetEmpty())
 	{
 		ScopedReadLock sl(mainController->getCompileLock());
@@ -934,6 +987,16 @@ void JavascriptTimeVariantModulator::prepareToPlay(double sampleRate, int sample
 
 void JavascriptTimeVariantModulator::calculateBlock(int startSample, int numSamples)
 {
+#if INCLUDE_NATIVE_JIT
+	if (nativeRenderer != nullptr)
+	{
+		ScopedReadLock sl(mainController->getCompileLock());
+
+		if (nativeRenderer != nullptr)
+			nativeRenderer->processBlock(internalBuffer.getWritePointer(0, startSample), numSamples);
+	}
+	else
+#endif
 	if (!processBlockCallback->isSnippetEmpty() && lastResult.wasOk())
 	{
 		buffer->referToData(internalBuffer.getWritePointer(0, startSample), numSamples);
@@ -986,6 +1049,10 @@ const JavascriptProcessor::SnippetDocument * JavascriptTimeVariantModulator::get
 
 void JavascriptTimeVariantModulator::registerApiClasses()
 {
+#if INCLUDE_NATIVE_JIT
+	clearNativeRenderer();
+#endif
+
 	content = new ScriptingApi::Content(this);
 
 	currentMidiMessage = new ScriptingApi::Message(this);
@@ -996,7 +1063,7 @@ void JavascriptTimeVariantModulator::registerApiClasses()
 	scriptEngine->registerApiClass(currentMidiMessage);
 	scriptEngine->registerApiClass(engineObject);
 	scriptEngine->registerApiClass(new ScriptingApi::Console(this));
-	scriptEngine->registerApiClass(new ScriptingApi::ModulatorApi(this));
+	scriptEngine->registerApiClass(new ScriptingApi::ModulatorApi(this, this));
 	scriptEngine->registerApiClass(synthObject);
 
 	scriptEngine->registerNativeObject("Libraries", new DspFactory::LibraryLoader(this));
@@ -1047,6 +1114,10 @@ buffer(new VariantBuffer(0))
 
 JavascriptEnvelopeModulator::~JavascriptEnvelopeModulator()
 {
+#if INCLUDE_NATIVE_JIT
+	cancelPendingUpdate();
+#endif
+
 	clearExternalWindows();
 }
 
@@ -1107,6 +1178,28 @@ void JavascriptEnvelopeModulator::handleHiseEvent(const HiseEvent &m)
 
 }
 
+void JavascriptEnvelopeModulator::setVoiceAmount(int newVoiceAmount)
+{
+	EnvelopeModulator::setVoiceAmount(newVoiceAmount);
+
+#if INCLUDE_NATIVE_JIT
+	// Compiling with the synth lock held would block the audio thread. The renderer outputs zeros for voices
+	// without a scope (and keeps them alive), so the old one can be used until the message thread has compiled the new one.
+	if (hasNativeRenderer())
+		triggerAsyncUpdate();
+#endif
+}
+
+#if INCLUDE_NATIVE_JIT
+void JavascriptEnvelopeModulator::handleAsyncUpdate()
+{
+	const Result r = updateNativeRendererVoiceAmount(mainController->getCompileLock(), getSampleRate(), getBlockSize());
+
+	BACKEND_ONLY(if (!r.wasOk()) debugError(this, "Native renderer: " + r.getErrorMessage()));
+	ignoreUnused(r);
+}
+#endif
+
 void JavascriptEnvelopeModulator::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
 	EnvelopeModulator::prepareToPlay(sampleRate, samplesPerBlock);
@@ -1114,6 +1207,14 @@ void JavascriptEnvelopeModulator::prepareToPlay(double sampleRate, int samplesPe
 	buffer->referToData(internalBuffer.getWritePointer(0), samplesPerBlock);
 	bufferVar = var(buffer);
 
+#if INCLUDE_NATIVE_JIT
+	if (nativeRenderer != nullptr)
+	{
+		ScopedReadLock sl(mainController->getCompileLock());
+		nativeRenderer->prepareToPlay(sampleRate, samplesPerBlock);
+	}
+#endif
+
 	if (!prepareToPlayCallback->isSnippetEmpty())
 	{
 		ScopedReadLock sl(mainController->getCompileLock());
@@ -1131,7 +1232,22 @@ void JavascriptEnvelopeModulator::calculateBlock(int startSample, int numSamples
 	const int voiceIndex = polyManager.getCurrentVoice();
 	ScriptEnvelopeState* state = static_cast<ScriptEnvelopeState*>(states[voiceIndex]);
 
+#if INCLUDE_NATIVE_JIT
+	if (nativeRenderer != nullptr)
+	{
+		ScopedReadLock sl(mainController->getCompileLock());
 
+		if (nativeRenderer != nullptr)
+		{
+			state->isPlaying = nativeRenderer->renderVoice(voiceIndex, internalBuffer.getWritePointer(0, startSample), numSamples, state->uptime);
+			state->uptime += (float)numSamples;
+
+			if (!state->isPlaying)
+				reset(voiceIndex);
+		}
+	}
+	else
+#endif
 	if (!renderVoiceCallback->isSnippetEmpty() && lastResult.wasOk())
 	{
 		buffer->referToData(internalBuffer.getWritePointer(0, startSample), numSamples);
@@ -1165,6 +1281,18 @@ void JavascriptEnvelopeModulator::startVoice(int voiceIndex)
 	state->isPlaying = true;
 	state->isRingingOff = false;
 
+#if INCLUDE_NATIVE_JIT
+	if (nativeRenderer != nullptr)
+	{
+		ScopedReadLock sl(mainController->getCompileLock());
+
+		if (nativeRenderer != nullptr)
+			nativeRenderer->startVoice(voiceIndex);
+
+		return;
+	}
+#endif
+
 	if (!startVoiceCallback->isSnippetEmpty())
 	{
 		ScopedReadLock sl(mainController->getCompileLock());
@@ -1179,6 +1307,18 @@ void JavascriptEnvelopeModulator::stopVoice(int voiceIndex)
 	ScriptEnvelopeState* state = static_cast<ScriptEnvelopeState*>(states[voiceIndex]);
 	state->isRingingOff = true;
 
+#if INCLUDE_NATIVE_JIT
+	if (nativeRenderer != nullptr)
+	{
+		ScopedReadLock sl(mainController->getCompileLock());
+
+		if (nativeRenderer != nullptr)
+			nativeRenderer->stopVoice(voiceIndex);
+
+		return;
+	}
+#endif
+
 	if (!startVoiceCallback->isSnippetEmpty())
 	{
 		ScopedReadLock sl(mainController->getCompileLock());
@@ -1254,6 +1394,10 @@ const JavascriptProcessor::SnippetDocument * JavascriptEnvelopeModulator::getSni
 
 void JavascriptEnvelopeModulator::registerApiClasses()
 {
+#if INCLUDE_NATIVE_JIT
+	clearNativeRenderer();
+#endif
+
 	content = new ScriptingApi::Content(this);
 
 	currentMidiMessage = new ScriptingApi::Message(this);
@@ -1264,7 +1408,7 @@ void JavascriptEnvelopeModulator::registerApiClasses()
 	scriptEngine->registerApiClass(currentMidiMessage);
 	scriptEngine->registerApiClass(engineObject);
 	scriptEngine->registerApiClass(new ScriptingApi::Console(this));
-	scriptEngine->registerApiClass(new ScriptingApi::ModulatorApi(this));
+	scriptEngine->registerApiClass(new ScriptingApi::ModulatorApi(this, this));
 	scriptEngine->registerApiClass(synthObject);
 
 	scriptEngine->registerNativeObject("Libraries", new DspFactory::LibraryLoader(this));
@@ -1415,10 +1559,15 @@ onControlCallback(new SnippetDocument("onControl", "number value"))
 
 	for (int i = 0; i < numVoices; i++)
 	{
-		addVoice(new Voice(this));
+		addVoice(createVoice());
 	}
 }
 
+ModulatorSynthVoice* JavascriptModulatorSynth::createVoice()
+{
+	return new Voice(this);
+}
+
 JavascriptModulatorSynth::~JavascriptModulatorSynth()
 {
 	clearExternalWindows();
@@ -85,6 +85,9 @@ public:
 	const SnippetDocument *getSnippet(int c) const override;
 	int getNumSnippets() const override { return numCallbacks; }
 	void registerApiClasses() override;
+
+	/** Grows the buffer for the deferred events so that it can hold the events of a few blocks. */
+	void prepareToPlay(double sampleRate, int samplesPerBlock) override;
 	
 
 	void addToFront(bool addToFront_) noexcept{ front = addToFront_; };
@@ -233,6 +236,9 @@ private:
 class JavascriptTimeVariantModulator : public JavascriptProcessor,
 									   public ProcessorWithScriptingContent,
 									   public TimeVariantModulator
+#if INCLUDE_NATIVE_JIT
+									 , public NativeJITModulationRenderer::Holder
+#endif
 {
 public:
 
@@ -296,6 +302,11 @@ public:
 
 private:
 
+#if INCLUDE_NATIVE_JIT
+	NativeJITModulationRenderer::Type getNativeRendererType() const override { return NativeJITModulationRenderer::Type::TimeVariant; }
+	int getNumNativeRendererVoices() const override { return 1; }
+#endif
+
 	ReferenceCountedObjectPtr<ScriptingApi::Message> currentMidiMessage;
 	ReferenceCountedObjectPtr<ScriptingApi::Engine> engineObject;
 	ScriptingApi::Synth *synthObject;
@@ -318,6 +329,10 @@ private:
 class JavascriptEnvelopeModulator : public JavascriptProcessor,
 								    public ProcessorWithScriptingContent,
 									public EnvelopeModulator
+#if INCLUDE_NATIVE_JIT
+								  , public NativeJITModulationRenderer::Holder,
+									public AsyncUpdater
+#endif
 {
 public:
 
@@ -368,6 +383,14 @@ public:
 	void prepareToPlay(double sampleRate, int samplesPerBlock) override;
 	void calculateBlock(int startSample, int numSamples) override;;
 
+	/** Resizes the envelope states. The native renderer is recompiled asynchronously (the synth lock is held while this is called). */
+	void setVoiceAmount(int newVoiceAmount) override;
+
+#if INCLUDE_NATIVE_JIT
+	/** Recompiles the native renderer with the new voice amount. The new voices are silent until then. */
+	void handleAsyncUpdate() override;
+#endif
+
 	void startVoice(int voiceIndex) override;
 	void stopVoice(int voiceIndex) override;
 	void reset(int voiceIndex) override;
@@ -401,6 +424,11 @@ private:
 
 	ModulatorState *createSubclassedState(int voiceIndex) const override { return new ScriptEnvelopeState(voiceIndex); };
 
+#if INCLUDE_NATIVE_JIT
+	NativeJITModulationRenderer::Type getNativeRendererType() const override { return NativeJITModulationRenderer::Type::Envelope; }
+	int getNumNativeRendererVoices() const override { return polyManager.getVoiceAmount(); }
+#endif
+
 	ReferenceCountedObjectPtr<ScriptingApi::Message> currentMidiMessage;
 	ReferenceCountedObjectPtr<ScriptingApi::Engine> engineObject;
 	ScriptingApi::Synth *synthObject;
@@ -500,6 +528,8 @@ public:
 
 	ProcessorEditorBody* createEditor(ProcessorEditor *parentEditor) override;
 
+	ModulatorSynthVoice* createVoice() override;
+
 	void calculateScriptChainValuesForVoice(int voiceIndex, int startSample, int numSamples);
 	const float *getScriptChainValues(int chainIndex, int voiceIndex) const;
 
@@ -590,8 +620,13 @@ public:
 
 	int getControlCallbackIndex() const override { return (int)Callback::onControl; };
 
+	/** Adds a module that is processed directly on the routed channels before the processBlock callback. */
+	void addDirectModule(DspInstance* module) { directModules.addIfNotAlreadyThere(module); }
+
 private:
 
+	ReferenceCountedArray<DspInstance> directModules;
+
 	var buffers[NUM_MAX_CHANNELS];
 
 	Array<var> channels;
@@ -229,7 +229,23 @@ void DynamicDspFactory::destroyDspBaseObject(DspBaseObject *object) const
 	}
 }
 
+typedef DspBaseObjectV2*(*getDspObjectV2_)(DspBaseObject*);
+
+DspBaseObjectV2* DynamicDspFactory::getDspObjectV2(DspBaseObject* object) const
+{
+	if (library != nullptr && object != nullptr && apiVersion >= 2)
+	{
+		getDspObjectV2_ g = (getDspObjectV2_)library->getFunction("getDspObjectV2");
+
+		if (g != nullptr)
+			return g(object);
+	}
+
+	return nullptr;
+}
+
 typedef LoadingErrorCode(*init_)(const char* name);
+typedef int(*getDspApiVersion_)();
 
 int DynamicDspFactory::initialise(const String &arguments)
 {
@@ -240,6 +256,15 @@ int DynamicDspFactory::initialise(const String &arguments)
 		if (d != nullptr)
 		{
 			isUnloadedForCompilation = false;
+
+			// Libraries that were built with the old header don't export the version
+			getDspApiVersion_ v = (getDspApiVersion_)library->getFunction("getDspApiVersion");
+
+			apiVersion = v != nullptr ? v() : 1;
+
+			if (apiVersion > (int)DspBaseObjectV2::ApiVersion)
+				return (int)LoadingErrorCode::NoVersionMatch;
+
 			return (int)d(arguments.getCharPointer());
 		}
 		else
@@ -33,6 +33,11 @@
 struct DspInstance::Wrapper
 {
 	API_VOID_METHOD_WRAPPER_1(DspInstance, processBlock);
+	API_VOID_METHOD_WRAPPER_2(DspInstance, processVoice);
+	API_VOID_METHOD_WRAPPER_1(DspInstance, startVoice);
+	API_VOID_METHOD_WRAPPER_1(DspInstance, setNumVoices);
+	API_VOID_METHOD_WRAPPER_3(DspInstance, addParameterEvent);
+	API_VOID_METHOD_WRAPPER_0(DspInstance, connectToScriptFX);
 	API_VOID_METHOD_WRAPPER_2(DspInstance, prepareToPlay);
 	API_VOID_METHOD_WRAPPER_2(DspInstance, setParameter);
 	API_VOID_METHOD_WRAPPER_2(DspInstance, setStringParameter);
@@ -82,7 +87,14 @@ void DspInstance::initialise()
 
 		if (object != nullptr)
 		{
+			objectV2 = factory->getDspObjectV2(object);
+
 			ADD_API_METHOD_1(processBlock);
+			ADD_API_METHOD_2(processVoice);
+			ADD_API_METHOD_1(startVoice);
+			ADD_API_METHOD_1(setNumVoices);
+			ADD_API_METHOD_3(addParameterEvent);
+			ADD_API_METHOD_0(connectToScriptFX);
 			ADD_API_METHOD_2(prepareToPlay);
 			ADD_API_METHOD_2(setParameter);
 			ADD_API_METHOD_1(getParameter);
@@ -164,37 +176,16 @@ void DspInstance::processBlock(const var &data)
 	{
 		if (data.isArray())
 		{
-			Array<var> *a = data.getArray();
-
 			float *sampleData[NUM_MAX_CHANNELS];
 			int numSamples = -1;
-
-			
-			if (a == nullptr)
-				throwError("processBlock must be called on array of buffers");
-
-			int numChannels = a->size();
+			int numChannels = 0;
 
 			sampleData[0] = nullptr;
 			sampleData[1] = nullptr;
 
-			CHECK_AND_LOG_ASSERTION(processor, DebugLogger::Location::ScriptFXRendering, a->size() == 2, 165);
+			getChannelPointers(data, sampleData, numChannels, numSamples);
 
-			for (int i = 0; i < numChannels; i++)
-			{
-				VariantBuffer *b = a->getUnchecked(i).getBuffer();
-
-				if (b != nullptr)
-				{
-					if (numSamples != -1 && b->size != numSamples)
-						throwError("Buffer size mismatch");
-
-					numSamples = b->size;
-
-					sampleData[i] = b->buffer.getWritePointer(0);
-				}
-				else throwError("processBlock must be called on array of buffers");
-			}
+			CHECK_AND_LOG_ASSERTION(processor, DebugLogger::Location::ScriptFXRendering, numChannels == 2, 165);
 
 			if (switchBypassFlag)
 			{
@@ -217,7 +208,7 @@ void DspInstance::processBlock(const var &data)
 				FloatVectorOperations::copy(leftSamples, sampleData[0], numSamples);
 				FloatVectorOperations::copy(rightSamples, sampleData[1], numSamples);
 
-				object->processBlock(sampleData, a->size(), numSamples);
+				processChannels(sampleData, numChannels, numSamples, -1);
 
 				if (rampUp)
 				{
@@ -253,7 +244,7 @@ void DspInstance::processBlock(const var &data)
 				for (int i = 0; i < numChannels; i++)
 					FloatSanitizers::sanitizeArray(sampleData[i], numSamples);
 
-				object->processBlock(sampleData, numChannels, numSamples);
+				processChannels(sampleData, numChannels, numSamples, -1);
 
 				CHECK_AND_LOG_BUFFER_DATA_WITH_ID(processor, debugId, DebugLogger::Location::DspInstanceRenderingPost, sampleData[0], true, numSamples);
 				CHECK_AND_LOG_BUFFER_DATA_WITH_ID(processor, debugId, DebugLogger::Location::DspInstanceRenderingPost, sampleData[1], false, numSamples);
@@ -275,7 +266,7 @@ void DspInstance::processBlock(const var &data)
 				CHECK_AND_LOG_BUFFER_DATA_WITH_ID(processor, debugId, DebugLogger::Location::DspInstanceRendering, sampleData[0], true, numSamples);
 				FloatSanitizers::sanitizeArray(sampleData[0], numSamples);
 
-				object->processBlock(sampleData, 1, numSamples);
+				processChannels(sampleData, 1, numSamples, -1);
 
 				CHECK_AND_LOG_BUFFER_DATA_WITH_ID(processor, debugId, DebugLogger::Location::DspInstanceRenderingPost, sampleData[0], true, numSamples);
 				FloatSanitizers::sanitizeArray(sampleData[0], numSamples);
@@ -285,6 +276,208 @@ void DspInstance::processBlock(const var &data)
 	}
 }
 
+void DspInstance::processVoice(int voiceIndex, const var &data)
+{
+	if (!prepareToPlayWasCalled) throw String(moduleName + ": prepareToPlay must be called before processing buffers.");
+
+	checkPriorityInversion();
+
+	const SpinLock::ScopedLockType sl(getLock());
+
+	if (object != nullptr && !isBypassed())
+	{
+		if (!isValidVoiceIndex(voiceIndex))
+			throwError("Voice index " + String(voiceIndex) + " is out of range. Call setNumVoices() before prepareToPlay()");
+
+		float *sampleData[NUM_MAX_CHANNELS];
+		int numChannels = 0;
+		int numSamples = -1;
+
+		getChannelPointers(data, sampleData, numChannels, numSamples);
+
+		for (int i = 0; i < numChannels; i++)
+			FloatSanitizers::sanitizeArray(sampleData[i], numSamples);
+
+		processChannels(sampleData, numChannels, numSamples, voiceIndex);
+
+		for (int i = 0; i < numChannels; i++)
+			FloatSanitizers::sanitizeArray(sampleData[i], numSamples);
+	}
+}
+
+void DspInstance::startVoice(int voiceIndex)
+{
+	const SpinLock::ScopedLockType sl(getLock());
+
+	if (void* state = getVoiceState(voiceIndex))
+	{
+		zeromem(state, voiceStateStride);
+		objectV2->resetVoiceState(voiceIndex, state);
+	}
+}
+
+void DspInstance::setNumVoices(int newNumVoices)
+{
+	if (newNumVoices < 0 || newNumVoices > NUM_MAX_POLYPHONIC_VOICES)
+		throwError("The voice amount must be between 0 and " + String(NUM_MAX_POLYPHONIC_VOICES));
+
+	const SpinLock::ScopedLockType sl(getLock());
+
+	numVoices = newNumVoices;
+}
+
+void DspInstance::addParameterEvent(int index, float newValue, int sampleOffset)
+{
+	if (object == nullptr || !isPositiveAndBelow(index, object->getNumParameters()))
+		return;
+
+	const SpinLock::ScopedLockType sl(getLock());
+
+	if (numPendingEvents == MaxNumParameterEvents)
+		throwError("Too many parameter events for one block");
+
+	// Keep the events sorted by their offset (events with the same offset stay in the order they were added)
+	int insertIndex = numPendingEvents;
+
+	while (insertIndex > 0 && pendingEvents[insertIndex - 1].sampleOffset > sampleOffset)
+	{
+		pendingEvents[insertIndex] = pendingEvents[insertIndex - 1];
+		insertIndex--;
+	}
+
+	pendingEvents[insertIndex].sampleOffset = jmax<int>(0, sampleOffset);
+	pendingEvents[insertIndex].parameterIndex = index;
+	pendingEvents[insertIndex].value = newValue;
+
+	numPendingEvents++;
+}
+
+void DspInstance::processBuffer(AudioSampleBuffer& buffer, int startSample, int numSamples, int voiceIndex)
+{
+	jassert(startSample + numSamples <= buffer.getNumSamples());
+
+	if (!prepareToPlayWasCalled || numSamples <= 0)
+		return;
+
+	if (voiceIndex != -1 && !isValidVoiceIndex(voiceIndex))
+		return;
+
+	float* sampleData[NUM_MAX_CHANNELS];
+
+	const int numChannels = jmin<int>(buffer.getNumChannels(), NUM_MAX_CHANNELS);
+
+	for (int i = 0; i < numChannels; i++)
+		sampleData[i] = buffer.getWritePointer(i, startSample);
+
+	const SpinLock::ScopedLockType sl(getLock());
+
+	if (object != nullptr && !isBypassed())
+		processChannels(sampleData, numChannels, numSamples, voiceIndex);
+}
+
+void DspInstance::connectToScriptFX()
+{
+	JavascriptMasterEffect* fx = dynamic_cast<JavascriptMasterEffect*>(processor.get());
+
+	if (fx == nullptr)
+		throwError("connectToScriptFX() can only be used in a Script FX");
+
+	if (!fx->objectsCanBeCreated())
+		throwError("connectToScriptFX() can only be called in the onInit callback");
+
+	fx->addDirectModule(this);
+}
+
+void DspInstance::getChannelPointers(const var& data, float** sampleData, int& numChannels, int& numSamples)
+{
+	if (VariantBuffer *b = data.getBuffer())
+	{
+		sampleData[0] = b->buffer.getWritePointer(0);
+		numChannels = 1;
+		numSamples = b->size;
+		return;
+	}
+
+	Array<var> *a = data.getArray();
+
+	if (a == nullptr)
+		throwError("processBlock must be called on array of buffers");
+
+	if (a->size() > NUM_MAX_CHANNELS)
+		throwError("Too many channels: " + String(a->size()));
+
+	numChannels = a->size();
+
+	for (int i = 0; i < numChannels; i++)
+	{
+		VariantBuffer *b = a->getUnchecked(i).getBuffer();
+
+		if (b != nullptr)
+		{
+			if (numSamples != -1 && b->size != numSamples)
+				throwError("Buffer size mismatch");
+
+			numSamples = b->size;
+
+			sampleData[i] = b->buffer.getWritePointer(0);
+		}
+		else throwError("processBlock must be called on array of buffers");
+	}
+}
+
+void DspInstance::processChannels(float** sampleData, int numChannels, int numSamples, int voiceIndex)
+{
+	jassert(voiceIndex < 0 || isValidVoiceIndex(voiceIndex));
+
+	DspProcessData d;
+
+	d.data = sampleData;
+	d.numChannels = numChannels;
+	d.numSamples = numSamples;
+	d.events = pendingEvents;
+	d.numEvents = numPendingEvents;
+	d.voiceIndex = voiceIndex;
+	d.voiceState = getVoiceState(voiceIndex);
+
+	if (objectV2 != nullptr)
+	{
+		if (voiceIndex >= 0)
+			objectV2->processVoice(d);
+		else
+			objectV2->process(d);
+	}
+	else
+	{
+		processBlockWithParameterEvents(*object, d);
+	}
+
+	numPendingEvents = 0;
+}
+
+void DspInstance::allocateVoiceStates()
+{
+	const int stateSize = objectV2 != nullptr ? objectV2->getVoiceStateSize() : 0;
+
+	if (stateSize > 0 && numVoices > 0)
+	{
+		// Align every state to 16 bytes so the module can use SSE instructions on its members
+		voiceStateStride = ((size_t)stateSize + 15) & ~(size_t)15;
+		voiceStateData.calloc(voiceStateStride * (size_t)numVoices + 16);
+		voiceStates = reinterpret_cast<uint8*>(((pointer_sized_int)voiceStateData.getData() + 15) & ~(pointer_sized_int)15);
+		numAllocatedVoices = numVoices;
+
+		for (int i = 0; i < numAllocatedVoices; i++)
+			objectV2->resetVoiceState(i, getVoiceState(i));
+	}
+	else
+	{
+		voiceStateData.free();
+		voiceStates = nullptr;
+		voiceStateStride = 0;
+		numAllocatedVoices = 0;
+	}
+}
+
 void DspInstance::setParameter(int index, float newValue)
 {
 	if (object != nullptr && index < object->getNumParameters())
@@ -485,6 +678,8 @@ void DspInstance::prepareToPlay(double sampleRate, int samplesPerBlock)
 
 		bypassSwitchBuffer.setSize(2, samplesPerBlock);
 
+		allocateVoiceStates();
+
 		for (int i = 0; i < object->getNumConstants(); i++)
 		{
 			if (getConstantValue(i).isBuffer())
@@ -511,6 +706,8 @@ void DspInstance::unload()
         
 		factory->destroyDspBaseObject(object);
 		object = nullptr;
+		objectV2 = nullptr;
+		allocateVoiceStates();
 		factory = nullptr;
 	}
 }
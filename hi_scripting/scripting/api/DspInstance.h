@@ -48,6 +48,7 @@ public:
 
 	DspBaseObject *createDspBaseObject(const String &moduleName) const override;
 	void destroyDspBaseObject(DspBaseObject *object) const override;
+	DspBaseObjectV2* getDspObjectV2(DspBaseObject* object) const override;
 
 	int initialise(const String &args);
 	var createModule(const String &moduleName) const override;
@@ -71,6 +72,7 @@ private:
 	bool isUnloadedForCompilation = false;
 
 	int errorCode;
+	int apiVersion = 1;
 	const String name;
 	const String args;
 	ScopedPointer<DynamicLibrary> library;
@@ -168,6 +170,28 @@ public:
 	/** Calls the processMethod of the external module. */
 	void processBlock(const var &data);
 
+	/** Processes the data with the state of the given voice. */
+	void processVoice(int voiceIndex, const var &data);
+
+	/** Clears the state of the given voice. Call this when the voice starts. */
+	void startVoice(int voiceIndex);
+
+	/** Sets the amount of voices. The voice states will be allocated with the next call to prepareToPlay. */
+	void setNumVoices(int numVoices);
+
+	/** Sets the parameter at the given sample position of the next processed block. */
+	void addParameterEvent(int index, float newValue, int sampleOffset);
+
+	/** Processes the buffer directly without wrapping the channels into buffer objects. 
+	*
+	*	Use this from C++ code: it skips the bypass crossfade and returns silently if the module is not prepared
+	*	or if there is no allocated state for the voice index. If voiceIndex is -1, the module will be processed without a voice state.
+	*/
+	void processBuffer(AudioSampleBuffer& buffer, int startSample, int numSamples, int voiceIndex = -1);
+
+	/** Processes the module directly on the channels of the Script FX before its processBlock callback. Call this in the onInit callback. */
+	void connectToScriptFX();
+
 	/** Sets the float parameter with the given index. */
 	void setParameter(int index, float newValue);
 
@@ -251,11 +275,45 @@ private:
 		throw String(errorMessage);
 	}
 
+	/** Fills the channel pointers with the data of the given array of buffers (or a single buffer). */
+	void getChannelPointers(const var& data, float** sampleData, int& numChannels, int& numSamples);
+
+	/** Processes the data with the module (using the new interface if available) and consumes the pending parameter events. */
+	void processChannels(float** sampleData, int numChannels, int numSamples, int voiceIndex);
+
+	void allocateVoiceStates();
+
+	/** Returns false if the module needs a voice state and there is no allocated state for the given voice. */
+	bool isValidVoiceIndex(int voiceIndex) const
+	{
+		return objectV2 == nullptr || objectV2->getVoiceStateSize() == 0 || isPositiveAndBelow(voiceIndex, numAllocatedVoices);
+	}
+
+	void* getVoiceState(int voiceIndex)
+	{
+		return isPositiveAndBelow(voiceIndex, numAllocatedVoices) ? voiceStates + voiceIndex * voiceStateStride : nullptr;
+	}
+
 	const String moduleName;
 
 	DspBaseObject *object;
+	DspBaseObjectV2* objectV2 = nullptr;
 	DspFactory::Ptr factory;
 
+	enum
+	{
+		MaxNumParameterEvents = 128
+	};
+
+	DspParameterEvent pendingEvents[MaxNumParameterEvents];
+	int numPendingEvents = 0;
+
+	HeapBlock<uint8> voiceStateData;
+	uint8* voiceStates = nullptr;
+	size_t voiceStateStride = 0;
+	int numVoices = 0;
+	int numAllocatedVoices = 0;
+
 	AudioSampleBuffer bypassSwitchBuffer;
 
 	std::atomic<bool> bypassed;
@@ -32,6 +32,90 @@
 
 #include  "JuceHeader.h"
 
+/** A polyphonic gain module that counts the processed samples per voice. */
+class TestV2Module : public DspBaseObjectV2
+{
+public:
+
+	struct VoiceState
+	{
+		int numProcessedSamples;
+	};
+
+	static Identifier getName() { RETURN_STATIC_IDENTIFIER("v2gain"); }
+
+	void prepareToPlay(double /*sampleRate*/, int /*blockSize*/) override {}
+
+	void processBlock(float** data, int numChannels, int numSamples) override
+	{
+		for (int i = 0; i < numChannels; i++)
+			FloatVectorOperations::multiply(data[i], gain, numSamples);
+	}
+
+	void processVoice(const DspProcessData& d) override
+	{
+		static_cast<VoiceState*>(d.voiceState)->numProcessedSamples += d.numSamples;
+		process(d);
+	}
+
+	int getVoiceStateSize() const override { return sizeof(VoiceState); }
+
+	int getNumParameters() const override { return 1; }
+	float getParameter(int /*index*/) const override { return gain; }
+	void setParameter(int /*index*/, float newValue) override { gain = newValue; }
+
+	float gain = 1.0f;
+};
+
+/** A polyphonic module that writes the running sample count of the voice into every channel. */
+class TestV2CounterModule : public DspBaseObjectV2
+{
+public:
+
+	struct VoiceState
+	{
+		int counter;
+	};
+
+	static Identifier getName() { RETURN_STATIC_IDENTIFIER("v2counter"); }
+
+	void prepareToPlay(double /*sampleRate*/, int /*blockSize*/) override {}
+
+	void processBlock(float** /*data*/, int /*numChannels*/, int /*numSamples*/) override {}
+
+	void processVoice(const DspProcessData& d) override
+	{
+		VoiceState* state = static_cast<VoiceState*>(d.voiceState);
+
+		for (int i = 0; i < d.numSamples; i++)
+		{
+			for (int c = 0; c < d.numChannels; c++)
+				d.data[c][i] = (float)state->counter;
+
+			state->counter++;
+		}
+	}
+
+	int getVoiceStateSize() const override { return sizeof(VoiceState); }
+
+	int getNumParameters() const override { return 0; }
+	float getParameter(int /*index*/) const override { return 0.0f; }
+	void setParameter(int /*index*/, float /*newValue*/) override {}
+};
+
+class TestV2Factory : public StaticDspFactory
+{
+public:
+
+	Identifier getId() const override { RETURN_STATIC_IDENTIFIER("v2test"); }
+
+	void registerModules() override 
+	{ 
+		registerDspModule<TestV2Module>(); 
+		registerDspModule<TestV2CounterModule>();
+	}
+};
+
 class DspUnitTests : public UnitTest
 {
 public:
@@ -49,6 +133,12 @@ public:
 		testVariantBufferWithCorruptValues();
 
 		testDspInstances();
+
+		testFusedBufferOperations();
+
+#if INCLUDE_NATIVE_JIT
+		testNativeJITModulationRenderer();
+#endif
 	}
 
 	void testVariantBuffer()
@@ -121,10 +211,125 @@ public:
 			expectEquals<String>(message, "stereo: prepareToPlay must be called before processing buffers.");
 		}
 		
+		beginTest("Testing the second version of the module interface");
+
+		DspFactory::Handler::registerStaticFactory<TestV2Factory>(&handler);
+
+		var m = handler.getFactory("v2test", "")->createModule("v2gain");
+		DspInstance* v2Module = dynamic_cast<DspInstance*>(m.getObject());
+		expect(v2Module != nullptr, "V2 Module creation");
+
+		v2Module->setNumVoices(4);
+		v2Module->prepareToPlay(44100.0, 64);
+
+		AudioSampleBuffer b(6, 64);
+
+		for (int i = 0; i < b.getNumChannels(); i++)
+			FloatVectorOperations::fill(b.getWritePointer(i), 1.0f, 64);
+
+		v2Module->addParameterEvent(0, 0.25f, 48);
+		v2Module->addParameterEvent(0, 0.5f, 16);
+
+		v2Module->processBuffer(b, 0, 64, 2);
+
+		for (int i = 0; i < b.getNumChannels(); i++)
+		{
+			expectEquals<float>(b.getSample(i, 0), 1.0f, "Sample before the first event");
+			expectEquals<float>(b.getSample(i, 16), 0.5f, "Sample at the first event");
+			expectEquals<float>(b.getSample(i, 63), 0.25f, "Sample after the second event");
+		}
+
+		v2Module->startVoice(2);
+		v2Module->processBuffer(b, 0, 32, 2);
+
+		expectEquals<float>(b.getSample(5, 0), 0.25f, "Events are consumed after the block");
+
+		beginTest("Testing the voice state isolation");
+
+		var cm = handler.getFactory("v2test", "")->createModule("v2counter");
+		DspInstance* counterModule = dynamic_cast<DspInstance*>(cm.getObject());
+
+		counterModule->setNumVoices(2);
+		counterModule->prepareToPlay(44100.0, 64);
+
+		AudioSampleBuffer vb(2, 16);
 
+		counterModule->processBuffer(vb, 0, 16, 0);
+		expectEquals<float>(vb.getSample(1, 15), 15.0f, "First block of voice 0");
+
+		counterModule->processBuffer(vb, 0, 8, 1);
+		expectEquals<float>(vb.getSample(0, 0), 0.0f, "Voice 1 starts with its own state");
+		expectEquals<float>(vb.getSample(0, 7), 7.0f, "Last sample of voice 1");
+		expectEquals<float>(vb.getSample(0, 8), 8.0f, "Samples after the block are untouched");
+
+		counterModule->processBuffer(vb, 0, 4, 0);
+		expectEquals<float>(vb.getSample(0, 0), 16.0f, "Voice 0 continues with its state");
+
+		counterModule->startVoice(1);
+		counterModule->processBuffer(vb, 0, 4, 1);
+		expectEquals<float>(vb.getSample(1, 0), 0.0f, "Starting a voice clears its state");
+
+		counterModule->processBuffer(vb, 0, 4, 0);
+		expectEquals<float>(vb.getSample(1, 0), 20.0f, "Starting another voice keeps the state");
+
+		vb.clear();
+		counterModule->processBuffer(vb, 0, 16, 2);
+		expectEquals<float>(vb.getMagnitude(0, 16), 0.0f, "A voice without a state is skipped");
 	}
 
 
+	void testFusedBufferOperations()
+	{
+		beginTest("Testing fused buffer operations");
+
+		String code;
+		NewLine nl;
+
+		code << "function process(b, c)" << nl;
+		code << "{" << nl;
+		code << "	b *= 2.0;" << nl;
+		code << "	b += c;" << nl;
+		code << "	b -= 0.5;" << nl;
+		code << "	return b;" << nl;
+		code << "}" << nl;
+
+		DynamicObject::Ptr globals = new DynamicObject();
+
+		HiseJavascriptEngine engine(nullptr);
+
+		engine.registerGlobalStorge(globals.get());
+
+		Result r = engine.execute(code);
+
+		expect(r.wasOk(), r.getErrorMessage());
+
+		static const Identifier process("process");
+
+		VariantBuffer::Ptr b = new VariantBuffer(16);
+		VariantBuffer::Ptr c = new VariantBuffer(16);
+
+		1.0f >> *b;
+		0.25f >> *c;
+
+		var bufferArgs[2] = { var(b), var(c) };
+
+		engine.callFunction(process, var::NativeFunctionArgs(var(), bufferArgs, 2), &r);
+
+		expectEquals<float>((*b)[15], 1.75f, "Fused buffer chain");
+
+		// Numbers fall back to the single statements and skip the target check for a while
+		var numberArgs[2] = { var(1.0), var(0.25) };
+
+		for (int i = 0; i < 100; i++)
+			expectEquals<double>((double)engine.callFunction(process, var::NativeFunctionArgs(var(), numberArgs, 2), &r), 1.75, "Number chain");
+
+		1.0f >> *b;
+
+		engine.callFunction(process, var::NativeFunctionArgs(var(), bufferArgs, 2), &r);
+
+		expectEquals<float>((*b)[0], 1.75f, "Buffer chain after a number chain");
+	}
+
 	void testVariantBufferWithCorruptValues()
 	{
 		VariantBuffer b(6);
@@ -182,6 +387,99 @@ public:
 
 
 
+#if INCLUDE_NATIVE_JIT
+
+	void testNativeJITModulationRenderer()
+	{
+		beginTest("Testing NativeJIT modulation renderer");
+
+		const int numVoices = 64;
+		const int blockSize = 64;
+		const int numBlocks = 200;
+
+		String jitCode;
+		NewLine nl;
+
+		jitCode << "class Envelope" << nl;
+		jitCode << "{" << nl;
+		jitCode << "public:" << nl;
+		jitCode << "	float process(float uptime)" << nl;
+		jitCode << "	{" << nl;
+		jitCode << "		return expf(-0.0001f * uptime);" << nl;
+		jitCode << "	};" << nl;
+		jitCode << "	int isPlaying()" << nl;
+		jitCode << "	{" << nl;
+		jitCode << "		return 1;" << nl;
+		jitCode << "	};" << nl;
+		jitCode << "};" << nl;
+
+		NativeJITModulationRenderer renderer(NativeJITModulationRenderer::Type::Envelope, jitCode, numVoices);
+
+		expect(renderer.getResult().wasOk(), renderer.getResult().getErrorMessage());
+
+		String scriptCode;
+
+		scriptCode << "function renderVoice(uptime, data)" << nl;
+		scriptCode << "{" << nl;
+		scriptCode << "	for(var i = 0; i < data.length; i++)" << nl;
+		scriptCode << "		data[i] = Math.exp(-0.0001 * (uptime + i));" << nl;
+		scriptCode << "	return 1;" << nl;
+		scriptCode << "}" << nl;
+
+		DynamicObject::Ptr globals = new DynamicObject();
+
+		HiseJavascriptEngine engine(nullptr);
+
+		engine.registerGlobalStorge(globals.get());
+
+		Result r = engine.execute(scriptCode);
+
+		expect(r.wasOk(), r.getErrorMessage());
+
+		VariantBuffer::Ptr interpretedData = new VariantBuffer(blockSize);
+		VariantBuffer::Ptr nativeData = new VariantBuffer(blockSize);
+
+		static const Identifier renderVoice("renderVoice");
+
+		var args[2] = { var(0.0f), var(interpretedData) };
+
+		double interpretedTime = 0.0;
+		double nativeTime = 0.0;
+
+		for (int i = 0; i < numBlocks; i++)
+		{
+			const float uptime = (float)(i * blockSize);
+
+			args[0] = uptime;
+
+			const double start = Time::getMillisecondCounterHiRes();
+
+			for (int v = 0; v < numVoices; v++)
+				engine.callFunction(renderVoice, var::NativeFunctionArgs(var(), args, 2), &r);
+
+			const double middle = Time::getMillisecondCounterHiRes();
+
+			for (int v = 0; v < numVoices; v++)
+				renderer.renderVoice(v, nativeData->buffer.getWritePointer(0), blockSize, uptime);
+
+			const double end = Time::getMillisecondCounterHiRes();
+
+			interpretedTime += middle - start;
+			nativeTime += end - middle;
+
+			for (int s = 0; s < blockSize; s++)
+			{
+				expect(std::abs((*interpretedData)[s] - (*nativeData)[s]) < 0.0001f, "Sample mismatch at block " + String(i));
+			}
+		}
+
+		expect(r.wasOk(), r.getErrorMessage());
+
+		logMessage(String(numVoices) + " voices, " + String(numBlocks) + " blocks: interpreted " + String(interpretedTime, 2) + " ms, NativeJIT " + String(nativeTime, 2) + " ms");
+	}
+
+#endif
+
 	void fillFloatArrayWithRandomNumbers(float *data, int numSamples)
 	{
 		for (int i = 0; i < numSamples; i++)
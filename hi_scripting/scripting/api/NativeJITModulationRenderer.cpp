@@ -0,0 +1,218 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+#if INCLUDE_NATIVE_JIT
+
+Result NativeJITModulationRenderer::Holder::setNativeRendererCode(const String& code)
+{
+	ScopedPointer<NativeJITModulationRenderer> newRenderer = new NativeJITModulationRenderer(getNativeRendererType(), code, getNumNativeRendererVoices());
+
+	if (newRenderer->getResult().failed())
+		return newRenderer->getResult();
+
+	nativeRenderer = newRenderer.release();
+	nativeRendererCode = code;
+
+	return Result::ok();
+}
+
+Result NativeJITModulationRenderer::Holder::updateNativeRendererVoiceAmount(ReadWriteLock& compileLock, double sampleRate, int samplesPerBlock)
+{
+	String code;
+
+	{
+		ScopedReadLock sl(compileLock);
+
+		if (nativeRenderer == nullptr || nativeRenderer->getNumVoices() >= getNumNativeRendererVoices())
+			return Result::ok();
+
+		code = nativeRendererCode;
+	}
+
+	ScopedPointer<NativeJITModulationRenderer> newRenderer = new NativeJITModulationRenderer(getNativeRendererType(), code, getNumNativeRendererVoices());
+
+	if (newRenderer->getResult().failed())
+		return newRenderer->getResult();
+
+	if (sampleRate > 0.0)
+		newRenderer->prepareToPlay(sampleRate, samplesPerBlock);
+
+	ScopedPointer<NativeJITModulationRenderer> oldRenderer;
+
+	{
+		ScopedWriteLock sl(compileLock);
+
+		// The script was recompiled in the meantime
+		if (nativeRenderer == nullptr || code != nativeRendererCode)
+			return Result::ok();
+
+		oldRenderer = nativeRenderer.release();
+		nativeRenderer = newRenderer.release();
+	}
+
+	return Result::ok();
+}
+
+NativeJITModulationRenderer::NativeJITModulationRenderer(Type type_, const String& code, int numVoices) :
+	type(type_),
+	result(Result::ok())
+{
+	static const Identifier process_("process");
+	static const Identifier prepare_("prepareToPlay");
+	static const Identifier start_("startVoice");
+	static const Identifier stop_("stopVoice");
+	static const Identifier isPlaying_("isPlaying");
+
+	ScopedPointer<NativeJITCompiler> compiler = new NativeJITCompiler(code);
+
+	const int numScopes = type == Type::Envelope ? jmax<int>(1, numVoices) : 1;
+
+	try
+	{
+		for (int i = 0; i < numScopes; i++)
+		{
+			ScopedPointer<VoiceScope> v = new VoiceScope();
+
+			v->scope = compiler->compileAndReturnScope();
+
+			if (v->scope == nullptr || !compiler->wasCompiledOK())
+			{
+				result = Result::fail("NativeJIT compile error: " + compiler->getErrorMessage());
+				return;
+			}
+
+			v->process = v->scope->getCompiledFunction<float, float>(process_);
+			v->prepare = v->scope->getCompiledFunction<int, double, int>(prepare_);
+
+			if (v->process == nullptr)
+			{
+				result = Result::fail("float process(float input) is not defined");
+				return;
+			}
+
+			if (type == Type::Envelope)
+			{
+				v->start = v->scope->getCompiledFunction<int, int>(start_);
+				v->stop = v->scope->getCompiledFunction<int, int>(stop_);
+				v->isPlaying = v->scope->getCompiledFunction<int>(isPlaying_);
+
+				if (v->isPlaying == nullptr)
+				{
+					result = Result::fail("int isPlaying() is not defined");
+					return;
+				}
+			}
+
+			voices.add(v.release());
+		}
+	}
+	catch (String& error)
+	{
+		voices.clear();
+		result = Result::fail(error);
+	}
+}
+
+NativeJITModulationRenderer::~NativeJITModulationRenderer()
+{
+	voices.clear();
+}
+
+void NativeJITModulationRenderer::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+	for (int i = 0; i < voices.size(); i++)
+	{
+		if (voices[i]->prepare != nullptr)
+			voices[i]->prepare(sampleRate, samplesPerBlock);
+	}
+}
+
+void NativeJITModulationRenderer::processBlock(float* data, int numSamples)
+{
+	jassert(type == Type::TimeVariant);
+
+	VoiceScope* v = voices.getFirst();
+
+	if (v == nullptr)
+		return;
+
+	float value = v->lastValue;
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		value = v->process(value);
+		data[i] = value;
+	}
+
+	v->lastValue = value;
+}
+
+void NativeJITModulationRenderer::startVoice(int voiceIndex)
+{
+	if (VoiceScope* v = voices[voiceIndex])
+	{
+		if (v->start != nullptr)
+			v->start(voiceIndex);
+	}
+}
+
+void NativeJITModulationRenderer::stopVoice(int voiceIndex)
+{
+	if (VoiceScope* v = voices[voiceIndex])
+	{
+		if (v->stop != nullptr)
+			v->stop(voiceIndex);
+	}
+}
+
+bool NativeJITModulationRenderer::renderVoice(int voiceIndex, float* data, int numSamples, float uptime)
+{
+	jassert(type == Type::Envelope);
+
+	VoiceScope* v = voices[voiceIndex];
+
+	if (v == nullptr)
+	{
+		FloatVectorOperations::clear(data, numSamples);
+		return true;
+	}
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		data[i] = v->process(uptime);
+		uptime += 1.0f;
+	}
+
+	return v->isPlaying() != 0;
+}
+
+#endif
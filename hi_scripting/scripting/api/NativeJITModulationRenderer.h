@@ -0,0 +1,165 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+#ifndef NATIVEJITMODULATIONRENDERER_H_INCLUDED
+#define NATIVEJITMODULATIONRENDERER_H_INCLUDED
+
+#if INCLUDE_NATIVE_JIT
+
+/** Renders the values of a script modulator with compiled NativeJIT code instead of the interpreted callbacks.
+*
+*	The code must be a NativeJIT class that defines these functions:
+*
+*		class Envelope
+*		{
+*		public:
+*
+*			void prepareToPlay(double sampleRate, int blockSize) {}; // optional
+*			void startVoice(int voiceIndex) {};						// envelopes only
+*			void stopVoice(int voiceIndex) {};						// envelopes only
+*			int isPlaying() { return 1; };							// envelopes only
+*			float process(float input) { return input; };
+*		};
+*
+*	For a time variant modulator, process() is called for every sample with the last calculated value as input.
+*	For an envelope, it is called with the uptime of the voice (in samples) and isPlaying() is called after each
+*	block to check whether the voice should be killed.
+*
+*	Every voice gets its own compiled scope, so the global variables of the class are the per voice state and you
+*	don't need to manage arrays indexed by the voice index like in the interpreted renderVoice callback.
+*
+*	Compiling the scopes takes some time, so you should create this object during compilation only (the script
+*	API does this with Modulator.setNativeRenderer() in the onInit callback).
+*/
+class NativeJITModulationRenderer
+{
+public:
+
+	enum class Type
+	{
+		TimeVariant = 0,
+		Envelope,
+		numTypes
+	};
+
+	/** A modulator that can be rendered with a NativeJITModulationRenderer. */
+	class Holder
+	{
+	public:
+
+		virtual ~Holder() {};
+
+		/** Compiles the code and replaces the current renderer if successful. Call this with the compile lock held. */
+		Result setNativeRendererCode(const String& code);
+
+		/** Removes the renderer, so that the interpreted callbacks are used again. */
+		void clearNativeRenderer() { nativeRenderer = nullptr; nativeRendererCode = String(); }
+
+		/** Recompiles the renderer if it has less voices than the modulator.
+		*
+		*	The new renderer is compiled and prepared without the lock, which is only held to swap the renderers.
+		*/
+		Result updateNativeRendererVoiceAmount(ReadWriteLock& compileLock, double sampleRate, int samplesPerBlock);
+
+		bool hasNativeRenderer() const noexcept { return nativeRenderer != nullptr; }
+
+	protected:
+
+		virtual Type getNativeRendererType() const = 0;
+
+		virtual int getNumNativeRendererVoices() const = 0;
+
+		ScopedPointer<NativeJITModulationRenderer> nativeRenderer;
+
+	private:
+
+		String nativeRendererCode;
+	};
+
+	/** Compiles one scope for each voice. Check getResult() before using it. */
+	NativeJITModulationRenderer(Type type, const String& code, int numVoices);
+
+	~NativeJITModulationRenderer();
+
+	Result getResult() const { return result; }
+
+	int getNumVoices() const noexcept { return voices.size(); }
+
+	/** Calls the prepareToPlay function of every scope. */
+	void prepareToPlay(double sampleRate, int samplesPerBlock);
+
+	/** Fills the buffer of a time variant modulator. */
+	void processBlock(float* data, int numSamples);
+
+	void startVoice(int voiceIndex);
+
+	void stopVoice(int voiceIndex);
+
+	/** Fills the buffer with the envelope values of the given voice. Returns false if the voice has finished.
+	*
+	*	If there is no compiled scope for the voice yet (because the voice amount was increased and the new renderer
+	*	isn't swapped in yet), the buffer is cleared and the voice is kept alive.
+	*/
+	bool renderVoice(int voiceIndex, float* data, int numSamples, float uptime);
+
+private:
+
+	typedef float(*ProcessFunction)(float);
+	typedef int(*PrepareFunction)(double, int);
+	typedef int(*VoiceFunction)(int);
+	typedef int(*StateFunction)();
+
+	struct VoiceScope
+	{
+		NativeJITScope::Ptr scope;
+
+		ProcessFunction process = nullptr;
+		PrepareFunction prepare = nullptr;
+		VoiceFunction start = nullptr;
+		VoiceFunction stop = nullptr;
+		StateFunction isPlaying = nullptr;
+
+		float lastValue = 1.0f;
+	};
+
+	const Type type;
+
+	OwnedArray<VoiceScope> voices;
+
+	Result result;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NativeJITModulationRenderer)
+};
+
+#endif
+
+#endif  // NATIVEJITMODULATIONRENDERER_H_INCLUDED
@@ -51,6 +51,7 @@ Array<ScriptComponentPropertyTypeSelector::SliderRange> ScriptComponentPropertyT
 void ScriptCreatedComponentWrapper::changed(var newValue)
 {
 	getScriptComponent()->value = newValue;
+	getScriptComponent()->setValueChangedFlag();
 
 	dynamic_cast<ProcessorWithScriptingContent*>(getProcessor())->controlCallback(getScriptComponent(), newValue);
 }
@@ -845,6 +846,10 @@ ScriptedControlAudioParameter::ScriptedControlAudioParameter(ScriptingApi::Conte
   suffix(String()),
   deactivated(false)
 {
+#if ENABLE_HOST_AUTOMATION_QUEUE
+	automationIndex = dynamic_cast<MainController*>(parentProcessor)->getHostAutomationQueue().addParameter(scriptProcessor_->getIndexInChain(), index_);
+#endif
+
 	setControlledScriptComponent(newComponent);
 }
 
@@ -880,6 +885,10 @@ void ScriptedControlAudioParameter::setControlledScriptComponent(ScriptingApi::C
 			}
 
 			suffix = c->getScriptObjectProperty(ScriptingApi::Content::ScriptSlider::Properties::suffix);
+
+#if ENABLE_HOST_AUTOMATION_QUEUE
+			dynamic_cast<MainController*>(parentProcessor)->getHostAutomationQueue().setSmoothingTime(automationIndex, c->getScriptObjectProperty(ScriptingApi::Content::ScriptComponent::Properties::pluginParameterSmoothing));
+#endif
 			break;
 		}
 		case ScriptedControlAudioParameter::Type::Button:
@@ -906,6 +915,12 @@ float ScriptedControlAudioParameter::getValue() const
 {
 	if (scriptProcessor.get() != nullptr)
 	{
+#if ENABLE_HOST_AUTOMATION_QUEUE
+		// The control hasn't received the last value yet...
+		if (lastValueInitialised && dynamic_cast<MainController*>(parentProcessor)->getHostAutomationQueue().hasPendingChanges(automationIndex))
+			return jlimit<float>(0.0f, 1.0f, range.convertTo0to1(lastValue));
+#endif
+
 		const float value = jlimit<float>(0.0f, 1.0f, range.convertTo0to1(scriptProcessor->getAttribute(componentIndex)));
 
 		return value;
@@ -922,10 +937,17 @@ void ScriptedControlAudioParameter::setValue(float newValue)
 {
 	if (scriptProcessor.get() != nullptr)
 	{
-		bool *enableUpdate = &dynamic_cast<MainController*>(parentProcessor)->getPluginParameterUpdateState();
+		MainController* mc = dynamic_cast<MainController*>(parentProcessor);
+
+		bool *enableUpdate = &mc->getPluginParameterUpdateState();
 
 		if (enableUpdate)
 		{
+#if ENABLE_HOST_AUTOMATION_QUEUE
+			// If the update is disabled, the value comes from the control itself (via setParameterNotifyingHost()).
+			const bool isHostChange = *enableUpdate;
+#endif
+
 			ScopedValueSetter<bool> setter(*enableUpdate, false, true);
 
 			const float convertedValue = range.convertFrom0to1(newValue);
@@ -935,6 +957,19 @@ void ScriptedControlAudioParameter::setValue(float newValue)
 			{
 				lastValue = snappedValue;
 				lastValueInitialised = true;
+
+#if ENABLE_HOST_AUTOMATION_QUEUE
+				HostAutomationQueue& queue = mc->getHostAutomationQueue();
+
+				if (isHostChange && queue.isAudioThreadRunning())
+				{
+					queue.addChange(automationIndex, snappedValue);
+					return;
+				}
+
+				queue.invalidate(automationIndex);
+#endif
+
 				scriptProcessor->setAttribute(componentIndex, snappedValue, sendNotification);
 			}
 		}
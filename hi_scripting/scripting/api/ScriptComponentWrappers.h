@@ -99,6 +99,8 @@ private:
 	float lastValue = -1.0f;
 	bool lastValueInitialised = false;
 
+	int automationIndex = -1;
+
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScriptedControlAudioParameter);
 
 	// ================================================================================================================
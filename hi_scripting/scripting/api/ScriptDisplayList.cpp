@@ -0,0 +1,109 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+void DrawActionList::perform(Graphics& g, Image& canvas) const
+{
+	for (int i = 0; i < actions.size(); i++)
+		actions.getUnchecked(i)->perform(g, canvas);
+}
+
+Image DrawActionList::createImage(int width, int height, float scaleFactor, bool clearImage) const
+{
+	Image canvas(Image::PixelFormat::ARGB, width, height, clearImage);
+
+	Graphics g(canvas);
+
+	g.addTransform(AffineTransform::scale(scaleFactor));
+
+	perform(g, canvas);
+
+	return canvas;
+}
+
+class DrawActionRasteriser::Job : public ThreadPoolJob
+{
+public:
+
+	Job(Target* target_, DrawActionList* list_, int width_, int height_, float scaleFactor_, bool clearImage_) :
+		ThreadPoolJob("Rasterise Draw Actions"),
+		target(target_),
+		list(list_),
+		width(width_),
+		height(height_),
+		scaleFactor(scaleFactor_),
+		clearImage(clearImage_),
+		index(++target_->jobIndex)
+	{}
+
+	JobStatus runJob() override
+	{
+		// A newer list is already waiting...
+		if (index != target->jobIndex.get())
+			return jobHasFinished;
+
+		const double start = Time::getMillisecondCounterHiRes();
+
+		Image newImage = list->createImage(width, height, scaleFactor, clearImage);
+
+		const double time = Time::getMillisecondCounterHiRes() - start;
+
+		ScopedLock sl(target->lock);
+
+		if (target->updater != nullptr)
+		{
+			target->image = newImage;
+			target->rasteriseTime = time;
+			target->updater->triggerAsyncUpdate();
+		}
+
+		return jobHasFinished;
+	}
+
+private:
+
+	Target::Ptr target;
+	DrawActionList::Ptr list;
+
+	const int width;
+	const int height;
+	const float scaleFactor;
+	const bool clearImage;
+	const int index;
+};
+
+void DrawActionRasteriser::rasterise(Target* target, DrawActionList* list, int width, int height, float scaleFactor, bool clearImage)
+{
+	if (width <= 0 || height <= 0)
+		return;
+
+	addJob(new Job(target, list, width, height, scaleFactor, clearImage), true);
+}
@@ -0,0 +1,334 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for cloused source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+
+#ifndef SCRIPTDISPLAYLIST_H_INCLUDED
+#define SCRIPTDISPLAYLIST_H_INCLUDED
+
+/** A recorded list of drawing commands.
+*
+*	The Graphics object of a ScriptPanel doesn't draw directly, but adds a DrawAction with the given parameters to
+*	this list. The list is then replayed into the canvas of the panel, which can happen without executing the
+*	paint routine again (eg. if only the scale factor changed) and on a background thread (because it only needs
+*	the parameters and no access to the scripting engine).
+*/
+class DrawActionList : public ReferenceCountedObject
+{
+public:
+
+	typedef ReferenceCountedObjectPtr<DrawActionList> Ptr;
+
+	/** A single drawing command. */
+	class DrawAction
+	{
+	public:
+
+		virtual ~DrawAction() {};
+
+		/** Draws this action. The image is the canvas that the graphics context draws into. */
+		virtual void perform(Graphics& g, Image& canvas) const = 0;
+	};
+
+	DrawActionList() {};
+
+	void addAction(DrawAction* newAction) { actions.add(newAction); }
+
+	/** Replays all actions in the given graphics context. */
+	void perform(Graphics& g, Image& canvas) const;
+
+	/** Creates a new image with the given size and replays all actions with the scale factor. */
+	Image createImage(int width, int height, float scaleFactor, bool clearImage) const;
+
+	int getNumActions() const { return actions.size(); }
+
+	// ================================================================================================================
+
+	struct FillAll;
+	struct SetColour;
+	struct SetGradientFill;
+	struct SetOpacity;
+	struct SetFont;
+	struct FillRect;
+	struct DrawRect;
+	struct FillRoundedRectangle;
+	struct DrawRoundedRectangle;
+	struct DrawHorizontalLine;
+	struct DrawLine;
+	struct DrawText;
+	struct FillEllipse;
+	struct DrawEllipse;
+	struct DrawImage;
+	struct DrawDropShadow;
+	struct FillPath;
+	struct StrokePath;
+	struct AddDropShadowFromAlpha;
+
+private:
+
+	OwnedArray<DrawAction> actions;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DrawActionList);
+};
+
+
+/** Rasterises DrawActionLists on a background thread.
+*
+*	Use this class with a SharedResourcePointer. It uses a single thread, so the lists are rasterised in the order
+*	they were added. If a Target requests a new image before the last one was rasterised, the older job is skipped.
+*/
+class DrawActionRasteriser : public ThreadPool
+{
+public:
+
+	/** The receiver of a rasterised image. */
+	class Target : public ReferenceCountedObject
+	{
+	public:
+
+		typedef ReferenceCountedObjectPtr<Target> Ptr;
+
+		/** Creates a target. The AsyncUpdater will be triggered when a new image is ready. */
+		Target(AsyncUpdater* updater_) : updater(updater_), rasteriseTime(0.0), jobIndex(0) {};
+
+		/** Call this in the destructor of the owner so that pending jobs don't trigger the updater anymore. */
+		void detach()
+		{
+			ScopedLock sl(lock);
+			updater = nullptr;
+		}
+
+		/** Returns the last rasterised image. Call this in the callback of the AsyncUpdater. */
+		Image getImage() const
+		{
+			ScopedLock sl(lock);
+			return image;
+		}
+
+		/** Returns the time in milliseconds it took to rasterise the last image. */
+		double getRasteriseTime() const
+		{
+			ScopedLock sl(lock);
+			return rasteriseTime;
+		}
+
+	private:
+
+		friend class DrawActionRasteriser;
+
+		CriticalSection lock;
+
+		AsyncUpdater* updater;
+		Image image;
+		double rasteriseTime;
+
+		Atomic<int> jobIndex;
+	};
+
+	DrawActionRasteriser() : ThreadPool(1) {};
+
+	/** Rasterises the list into a new image with the given size and calls the target when it's ready. */
+	void rasterise(Target* target, DrawActionList* list, int width, int height, float scaleFactor, bool clearImage);
+
+private:
+
+	class Job;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DrawActionRasteriser);
+};
+
+// ==================================================================================================================== Actions
+
+struct DrawActionList::FillAll : public DrawAction
+{
+	FillAll(Colour c_) : c(c_) {};
+	void perform(Graphics& g, Image&) const override { g.fillAll(c); }
+	const Colour c;
+};
+
+struct DrawActionList::SetColour : public DrawAction
+{
+	SetColour(Colour c_) : c(c_) {};
+	void perform(Graphics& g, Image&) const override { g.setColour(c); }
+	const Colour c;
+};
+
+struct DrawActionList::SetGradientFill : public DrawAction
+{
+	SetGradientFill(const ColourGradient& gradient_) : gradient(gradient_) {};
+	void perform(Graphics& g, Image&) const override { g.setGradientFill(gradient); }
+	const ColourGradient gradient;
+};
+
+struct DrawActionList::SetOpacity : public DrawAction
+{
+	SetOpacity(float alpha_) : alpha(alpha_) {};
+	void perform(Graphics& g, Image&) const override { g.setOpacity(alpha); }
+	const float alpha;
+};
+
+struct DrawActionList::SetFont : public DrawAction
+{
+	SetFont(const Font& f_) : f(f_) {};
+	void perform(Graphics& g, Image&) const override { g.setFont(f); }
+	const Font f;
+};
+
+struct DrawActionList::FillRect : public DrawAction
+{
+	FillRect(Rectangle<float> area_) : area(area_) {};
+	void perform(Graphics& g, Image&) const override { g.fillRect(area); }
+	const Rectangle<float> area;
+};
+
+struct DrawActionList::DrawRect : public DrawAction
+{
+	DrawRect(Rectangle<float> area_, float borderSize_) : area(area_), borderSize(borderSize_) {};
+	void perform(Graphics& g, Image&) const override { g.drawRect(area, borderSize); }
+	const Rectangle<float> area;
+	const float borderSize;
+};
+
+struct DrawActionList::FillRoundedRectangle : public DrawAction
+{
+	FillRoundedRectangle(Rectangle<float> area_, float cornerSize_) : area(area_), cornerSize(cornerSize_) {};
+	void perform(Graphics& g, Image&) const override { g.fillRoundedRectangle(area, cornerSize); }
+	const Rectangle<float> area;
+	const float cornerSize;
+};
+
+struct DrawActionList::DrawRoundedRectangle : public DrawAction
+{
+	DrawRoundedRectangle(Rectangle<float> area_, float cornerSize_, float borderSize_) : area(area_), cornerSize(cornerSize_), borderSize(borderSize_) {};
+	void perform(Graphics& g, Image&) const override { g.drawRoundedRectangle(area, cornerSize, borderSize); }
+	const Rectangle<float> area;
+	const float cornerSize;
+	const float borderSize;
+};
+
+struct DrawActionList::DrawHorizontalLine : public DrawAction
+{
+	DrawHorizontalLine(int y_, float x1_, float x2_) : y(y_), x1(x1_), x2(x2_) {};
+	void perform(Graphics& g, Image&) const override { g.drawHorizontalLine(y, x1, x2); }
+	const int y;
+	const float x1, x2;
+};
+
+struct DrawActionList::DrawLine : public DrawAction
+{
+	DrawLine(Line<float> line_, float thickness_) : line(line_), thickness(thickness_) {};
+	void perform(Graphics& g, Image&) const override { g.drawLine(line, thickness); }
+	const Line<float> line;
+	const float thickness;
+};
+
+struct DrawActionList::DrawText : public DrawAction
+{
+	DrawText(const String& text_, Rectangle<float> area_, const Font& f_) : text(text_), area(area_), f(f_) {};
+	void perform(Graphics& g, Image&) const override
+	{
+		g.setFont(f);
+		g.drawText(text, area, Justification::centred);
+	}
+	const String text;
+	const Rectangle<float> area;
+	const Font f;
+};
+
+struct DrawActionList::FillEllipse : public DrawAction
+{
+	FillEllipse(Rectangle<float> area_) : area(area_) {};
+	void perform(Graphics& g, Image&) const override { g.fillEllipse(area); }
+	const Rectangle<float> area;
+};
+
+struct DrawActionList::DrawEllipse : public DrawAction
+{
+	DrawEllipse(Rectangle<float> area_, float thickness_) : area(area_), thickness(thickness_) {};
+	void perform(Graphics& g, Image&) const override { g.drawEllipse(area, thickness); }
+	const Rectangle<float> area;
+	const float thickness;
+};
+
+struct DrawActionList::DrawImage : public DrawAction
+{
+	DrawImage(const Image& img_, Rectangle<int> area_, Rectangle<int> source_) : img(img_), area(area_), source(source_) {};
+	void perform(Graphics& g, Image&) const override
+	{
+		g.drawImage(img, area.getX(), area.getY(), area.getWidth(), area.getHeight(), source.getX(), source.getY(), source.getWidth(), source.getHeight());
+	}
+	const Image img;
+	const Rectangle<int> area;
+	const Rectangle<int> source;
+};
+
+struct DrawActionList::DrawDropShadow : public DrawAction
+{
+	DrawDropShadow(Rectangle<int> area_, const DropShadow& shadow_) : area(area_), shadow(shadow_) {};
+	void perform(Graphics& g, Image&) const override { shadow.drawForRectangle(g, area); }
+	const Rectangle<int> area;
+	const DropShadow shadow;
+};
+
+struct DrawActionList::FillPath : public DrawAction
+{
+	FillPath(const Path& p_) : p(p_) {};
+	void perform(Graphics& g, Image&) const override { g.fillPath(p); }
+	const Path p;
+};
+
+struct DrawActionList::StrokePath : public DrawAction
+{
+	StrokePath(const Path& p_, const PathStrokeType& stroke_) : p(p_), stroke(stroke_) {};
+	void perform(Graphics& g, Image&) const override { g.strokePath(p, stroke); }
+	const Path p;
+	const PathStrokeType stroke;
+};
+
+struct DrawActionList::AddDropShadowFromAlpha : public DrawAction
+{
+	AddDropShadowFromAlpha(const DropShadow& shadow_, float scaleFactor_) : shadow(shadow_), scaleFactor(scaleFactor_) {};
+	void perform(Graphics&, Image& canvas) const override
+	{
+		// This uses the content of the canvas, so it can't use the graphics context
+		Graphics g2(canvas);
+
+		if (scaleFactor != 1.0f)
+			g2.addTransform(AffineTransform::scale(1.0f / scaleFactor));
+
+		shadow.drawForImage(g2, canvas);
+	}
+	const DropShadow shadow;
+	const float scaleFactor;
+};
+
+#endif  // SCRIPTDISPLAYLIST_H_INCLUDED
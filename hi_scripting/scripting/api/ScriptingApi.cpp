@@ -1140,8 +1140,10 @@ struct ScriptingApi::Sampler::Wrapper
 	API_METHOD_WRAPPER_2(Sampler, getRRGroupsForMessage);
 	API_VOID_METHOD_WRAPPER_0(Sampler, refreshRRMap);
 	API_VOID_METHOD_WRAPPER_1(Sampler, selectSounds);
+	API_VOID_METHOD_WRAPPER_1(Sampler, selectSoundsWithQuery);
 	API_METHOD_WRAPPER_0(Sampler, getNumSelectedSounds);
 	API_VOID_METHOD_WRAPPER_2(Sampler, setSoundPropertyForSelection);
+	API_VOID_METHOD_WRAPPER_1(Sampler, setSoundPropertiesForSelection);
 	API_METHOD_WRAPPER_2(Sampler, getSoundProperty);
 	API_VOID_METHOD_WRAPPER_3(Sampler, setSoundProperty);
 	API_VOID_METHOD_WRAPPER_2(Sampler, purgeMicPosition);
@@ -1165,8 +1167,10 @@ sampler(sampler_)
 	ADD_API_METHOD_2(getRRGroupsForMessage);
 	ADD_API_METHOD_0(refreshRRMap);
 	ADD_API_METHOD_1(selectSounds);
+	ADD_API_METHOD_1(selectSoundsWithQuery);
 	ADD_API_METHOD_0(getNumSelectedSounds);
 	ADD_API_METHOD_2(setSoundPropertyForSelection);
+	ADD_API_METHOD_1(setSoundPropertiesForSelection);
 	ADD_API_METHOD_2(getSoundProperty);
 	ADD_API_METHOD_3(setSoundProperty);
 	ADD_API_METHOD_2(purgeMicPosition);
@@ -1271,7 +1275,98 @@ void ScriptingApi::Sampler::selectSounds(String regexWildcard)
 		return;
 	}
 
-	ModulatorSamplerSound::selectSoundsBasedOnRegex(regexWildcard, s, soundSelection);
+	String wildcard = regexWildcard;
+	String mode;
+
+	if (wildcard.startsWith("sub:") || wildcard.startsWith("add:"))
+	{
+		mode = wildcard.substring(0, 3);
+		wildcard = wildcard.substring(4);
+	}
+
+	Array<ModulatorSamplerSound*> matches;
+
+	Result r = s->getSoundIndex().queryRegex(wildcard, matches);
+
+	if (r.failed())
+	{
+		reportScriptError(r.getErrorMessage());
+		return;
+	}
+
+	applySelection(matches, mode);
+}
+
+void ScriptingApi::Sampler::selectSoundsWithQuery(var query)
+{
+	ModulatorSampler *s = static_cast<ModulatorSampler*>(sampler.get());
+
+	if (s == nullptr)
+	{
+		reportScriptError("selectSoundsWithQuery() only works with Samplers.");
+		return;
+	}
+
+	if (query.getDynamicObject() == nullptr)
+	{
+		reportScriptError("selectSoundsWithQuery() needs a query object");
+		return;
+	}
+
+	Array<ModulatorSamplerSound*> matches;
+
+	s->getSoundIndex().query(SamplerSoundIndex::Query::fromVar(query), matches);
+
+	applySelection(matches, query.getProperty("Mode", "").toString());
+}
+
+void ScriptingApi::Sampler::applySelection(const Array<ModulatorSamplerSound*>& matches, const String& mode)
+{
+	// The lookups use a sorted copy, so that big selections don't need a linear search for every sound
+
+	DefaultElementComparator<ModulatorSamplerSound*> comparator;
+
+	if (mode == "add")
+	{
+		Array<ModulatorSamplerSound*> existingSounds;
+
+		existingSounds.ensureStorageAllocated(soundSelection.size());
+
+		for (int i = 0; i < soundSelection.size(); i++)
+			existingSounds.add(soundSelection.getReference(i).get());
+
+		existingSounds.sort(comparator);
+
+		for (int i = 0; i < matches.size(); i++)
+		{
+			if (existingSounds.indexOfSorted(comparator, matches.getUnchecked(i)) == -1)
+				soundSelection.add(matches.getUnchecked(i));
+		}
+	}
+	else if (mode == "sub")
+	{
+		Array<ModulatorSamplerSound*> soundsToRemove(matches);
+
+		soundsToRemove.sort(comparator);
+
+		Array<WeakReference<ModulatorSamplerSound>> remainingSounds;
+
+		for (int i = 0; i < soundSelection.size(); i++)
+		{
+			if (soundsToRemove.indexOfSorted(comparator, soundSelection.getReference(i).get()) == -1)
+				remainingSounds.add(soundSelection.getReference(i));
+		}
+
+		soundSelection.swapWith(remainingSounds);
+	}
+	else
+	{
+		soundSelection.clearQuick();
+		soundSelection.ensureStorageAllocated(matches.size());
+
+		for (int i = 0; i < matches.size(); i++)
+			soundSelection.add(matches.getUnchecked(i));
+	}
 }
 
 int ScriptingApi::Sampler::getNumSelectedSounds()
@@ -1284,7 +1379,7 @@ int ScriptingApi::Sampler::getNumSelectedSounds()
 		return -1;
 	}
 
-	return soundSelection.getNumSelected();
+	return soundSelection.size();
 }
 
 void ScriptingApi::Sampler::setSoundPropertyForSelection(int propertyId, var newValue)
@@ -1297,7 +1392,7 @@ void ScriptingApi::Sampler::setSoundPropertyForSelection(int propertyId, var new
 		return;
 	}
 
-	Array<WeakReference<ModulatorSamplerSound>> sounds = soundSelection.getItemArray();
+	const Array<WeakReference<ModulatorSamplerSound>>& sounds = soundSelection;
 
 	const int numSelected = sounds.size();
 
@@ -1310,6 +1405,67 @@ void ScriptingApi::Sampler::setSoundPropertyForSelection(int propertyId, var new
 	}
 }
 
+void ScriptingApi::Sampler::setSoundPropertiesForSelection(var properties)
+{
+	ModulatorSampler *s = static_cast<ModulatorSampler*>(sampler.get());
+
+	if (s == nullptr)
+	{
+		reportScriptError("setSoundPropertiesForSelection() only works with Samplers.");
+		return;
+	}
+
+	DynamicObject* obj = properties.getDynamicObject();
+
+	if (obj == nullptr)
+	{
+		reportScriptError("setSoundPropertiesForSelection() needs an object with the property names as keys");
+		return;
+	}
+
+	// Resolve the names before the loop so that every sound only needs the setProperty() calls
+
+	Array<ModulatorSamplerSound::Property> propertyIds;
+	Array<var> values;
+
+	const NamedValueSet& set = obj->getProperties();
+
+	for (int i = 0; i < set.size(); i++)
+	{
+		const String name = set.getName(i).toString();
+
+		bool found = false;
+
+		for (int p = ModulatorSamplerSound::RootNote; p < ModulatorSamplerSound::numProperties; p++)
+		{
+			if (ModulatorSamplerSound::getPropertyName((ModulatorSamplerSound::Property)p) == name)
+			{
+				propertyIds.add((ModulatorSamplerSound::Property)p);
+				values.add(set.getValueAt(i));
+				found = true;
+				break;
+			}
+		}
+
+		if (!found)
+		{
+			reportScriptError("Unknown sound property: " + name);
+			return;
+		}
+	}
+
+	for (int i = 0; i < soundSelection.size(); i++)
+	{
+		if (ModulatorSamplerSound* sound = soundSelection.getReference(i).get())
+		{
+			for (int j = 0; j < propertyIds.size(); j++)
+				sound->setProperty(propertyIds.getUnchecked(j), values.getReference(j), dontSendNotification);
+		}
+	}
+
+	s->sendChangeMessage();
+}
+
 var ScriptingApi::Sampler::getSoundProperty(int propertyIndex, int soundIndex)
 {
 	ModulatorSampler *s = static_cast<ModulatorSampler*>(sampler.get());
@@ -1320,7 +1476,7 @@ var ScriptingApi::Sampler::getSoundProperty(int propertyIndex, int soundIndex)
 		return var::undefined();
 	}
 
-	ModulatorSamplerSound *sound = soundSelection.getSelectedItem(soundIndex);
+	ModulatorSamplerSound *sound = soundSelection[soundIndex].get();
 
 	if (sound != nullptr)
 	{
@@ -1343,7 +1499,7 @@ void ScriptingApi::Sampler::setSoundProperty(int soundIndex, int propertyIndex,
 		reportScriptError("setSoundProperty() only works with Samplers.");
 	}
 
-	ModulatorSamplerSound *sound = soundSelection.getSelectedItem(soundIndex);
+	ModulatorSamplerSound *sound = soundSelection[soundIndex].get();
 
 	if (sound != nullptr)
 	{
@@ -1594,6 +1750,7 @@ struct ScriptingApi::Synth::Wrapper
 	API_METHOD_WRAPPER_1(Synth, isKeyDown);
 	API_VOID_METHOD_WRAPPER_1(Synth, setClockSpeed);
 	API_VOID_METHOD_WRAPPER_1(Synth, setShouldKillRetriggeredNote);
+	API_VOID_METHOD_WRAPPER_1(Synth, setVoiceStealingPolicy);
 };
 
 
@@ -1655,6 +1812,7 @@ ScriptingApi::Synth::Synth(ProcessorWithScriptingContent *p, ModulatorSynth *own
 	ADD_API_METHOD_1(isKeyDown);
 	ADD_API_METHOD_1(setClockSpeed);
 	ADD_API_METHOD_1(setShouldKillRetriggeredNote);
+	ADD_API_METHOD_1(setVoiceStealingPolicy);
 	
 };
 
@@ -2470,6 +2628,20 @@ void ScriptingApi::Synth::setShouldKillRetriggeredNote(bool killNote)
 	}
 }
 
+void ScriptingApi::Synth::setVoiceStealingPolicy(int policyIndex)
+{
+	if (!isPositiveAndBelow(policyIndex, (int)VoiceAllocator::StealingPolicy::numStealingPolicies))
+	{
+		reportScriptError("Unknown stealing policy. Use 0 (oldest), 1 (quietest), 2 (same note first) or 3 (lowest priority)");
+		return;
+	}
+
+	if (owner != nullptr)
+	{
+		owner->setVoiceStealingPolicy((VoiceAllocator::StealingPolicy)policyIndex);
+	}
+}
+
 void ScriptingApi::Synth::setModulatorAttribute(int chain, int modulatorIndex, int attributeIndex, float newValue)
 {
 	if(owner == nullptr)
@@ -2774,13 +2946,38 @@ void ScriptingApi::Console::clear()
 #undef ADD_TO_TYPE_SELECTOR
 #undef ADD_AS_SLIDER_TYPE
 
-ScriptingApi::ModulatorApi::ModulatorApi(Modulator* mod_) :
+ScriptingApi::ModulatorApi::ModulatorApi(ProcessorWithScriptingContent* scriptProcessor_, Modulator* mod_) :
 ApiClass(0),
+scriptProcessor(scriptProcessor_),
 mod(mod_),
 m(dynamic_cast<Modulation*>(mod_))
 {
 	ADD_API_METHOD_1(setIntensity);
 	ADD_API_METHOD_1(setBypassed);
+	ADD_API_METHOD_1(setNativeRenderer);
+}
+
+void ScriptingApi::ModulatorApi::setNativeRenderer(String code)
+{
+#if INCLUDE_NATIVE_JIT
+	NativeJITModulationRenderer::Holder* holder = dynamic_cast<NativeJITModulationRenderer::Holder*>(mod);
+
+	if (holder == nullptr)
+		throw String("This modulator can't be rendered with NativeJIT code");
+
+	// The renderer replaces the callbacks of the script that calls this method, so it must be in its onInit callback
+	if (scriptProcessor == nullptr || !scriptProcessor->objectsCanBeCreated())
+		throw String("setNativeRenderer() can only be called in onInit");
+
+	Result r = holder->setNativeRendererCode(code);
+
+	if (r.failed())
+		throw r.getErrorMessage();
+#else
+	ignoreUnused(code);
+
+	throw String("setNativeRenderer() needs INCLUDE_NATIVE_JIT");
+#endif
 }
 
 struct ScriptingApi::Colours::Wrapper
@@ -382,12 +382,18 @@ public:
 		/** Selects samples using the regex string as wildcard and the selectMode ("SELECT", "ADD", "SUBTRACT")*/
 		void selectSounds(String regex);
 
+		/** Selects samples that match the query object (eg. `{"KeyRange": [36, 48], "RRGroup": 2, "Tokens": ["sustain"], "Mode": "add"}`). */
+		void selectSoundsWithQuery(var query);
+
 		/** Returns the amount of selected samples. */
 		int getNumSelectedSounds();
 
 		/** Sets the property of the sampler sound for the selection. */
 		void setSoundPropertyForSelection(int propertyIndex, var newValue);
 
+		/** Sets multiple properties (eg. `{"Volume": -6, "Pan": 20}`) for the selection and sends one update message. */
+		void setSoundPropertiesForSelection(var properties);
+
 		/** Returns the property of the sound with the specified index. */
 		var getSoundProperty(int propertyIndex, int soundIndex);
 
@@ -427,8 +433,11 @@ public:
 
 	private:
 
+		/** Replaces the selection with the given sounds or adds / subtracts them if the mode is "add" or "sub". */
+		void applySelection(const Array<ModulatorSamplerSound*>& matches, const String& mode);
+
 		WeakReference<Processor> sampler;
-		SelectedItemSet<WeakReference<ModulatorSamplerSound>> soundSelection;
+		Array<WeakReference<ModulatorSamplerSound>> soundSelection;
 	};
 	
 
@@ -513,6 +522,9 @@ public:
 		/** If set to true, this will kill retriggered notes (default). */
 		void setShouldKillRetriggeredNote(bool killNote);
 
+		/** Sets the voice stealing policy (0 = oldest, 1 = quietest, 2 = same note first, 3 = lowest priority). */
+		void setVoiceStealingPolicy(int policyIndex);
+
 		/** Stops the timer of the synth. You can call this also in the timer callback. */
 		void stopTimer();
 
@@ -749,7 +761,7 @@ public:
 	{
 	public:
 
-		ModulatorApi(Modulator* mod_);
+		ModulatorApi(ProcessorWithScriptingContent* scriptProcessor_, Modulator* mod_);
 
 		Identifier getName() const override { RETURN_STATIC_IDENTIFIER("Modulator") }
 
@@ -767,14 +779,19 @@ public:
 			BACKEND_ONLY(mod->sendChangeMessage());
 		}
 
+		/** Renders the modulator with compiled NativeJIT code instead of the script callbacks (onInit only). */
+		void setNativeRenderer(String code);
+
 	private:
 
 		struct Wrapper
 		{
 			API_VOID_METHOD_WRAPPER_1(ModulatorApi, setIntensity);
 			API_VOID_METHOD_WRAPPER_1(ModulatorApi, setBypassed);
+			API_VOID_METHOD_WRAPPER_1(ModulatorApi, setNativeRenderer);
 		};
 
+		ProcessorWithScriptingContent* scriptProcessor;
 		Modulator* mod;
 		Modulation* m;
 
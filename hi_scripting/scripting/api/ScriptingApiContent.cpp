@@ -126,11 +126,13 @@ parentComponentIndex(-1)
 	propertyIds.add(Identifier("saveInPreset")); ADD_TO_TYPE_SELECTOR(SelectorTypes::ToggleSelector);
 	propertyIds.add(Identifier("isPluginParameter")); ADD_TO_TYPE_SELECTOR(SelectorTypes::ToggleSelector);
 	propertyIds.add(Identifier("pluginParameterName"));
+	propertyIds.add(Identifier("pluginParameterSmoothing")); ADD_AS_SLIDER_TYPE(0, 1000, 1);
 	propertyIds.add(Identifier("useUndoManager"));	ADD_TO_TYPE_SELECTOR(SelectorTypes::ToggleSelector);
 	propertyIds.add(Identifier("parentComponent"));	ADD_TO_TYPE_SELECTOR(SelectorTypes::ChoiceSelector);
 	
 
 	deactivatedProperties.add(getIdFor(isPluginParameter));
+	deactivatedProperties.add(getIdFor(pluginParameterSmoothing));
 
 	setDefaultValue(Properties::text, name.toString());
 	setDefaultValue(Properties::visible, true);
@@ -150,6 +152,7 @@ parentComponentIndex(-1)
 	setDefaultValue(Properties::saveInPreset, true);
 	setDefaultValue(Properties::isPluginParameter, false);
 	setDefaultValue(Properties::pluginParameterName, "");
+	setDefaultValue(Properties::pluginParameterSmoothing, 0);
 	setDefaultValue(Properties::useUndoManager, false);
 	setDefaultValue(Properties::parentComponent, "");
 
@@ -171,6 +174,9 @@ parentComponentIndex(-1)
     ADD_API_METHOD_0(getGlobalPositionY);
 	ADD_API_METHOD_1(setControlCallback);
 
+	// The name is registered here so that parameter changes can be traced without allocating on the audio thread
+	traceNameIndex = base->getMainController_()->getDebugLogger().getTraceRecorder().getNameIndex(name_.toString());
+
 	//setName(name_.toString());
 
 
@@ -257,6 +263,8 @@ void ScriptingApi::Content::ScriptComponent::restoreFromValueTree(const ValueTre
 	{
 		value = (double)data;
 	}
+
+	setValueChangedFlag();
 }
 
 void ScriptingApi::Content::ScriptComponent::doubleClickCallback(const MouseEvent &, Component* componentToNotify)
@@ -460,6 +468,8 @@ void ScriptingApi::Content::ScriptComponent::setValue(var controlValue)
 		skipRestoring = true;
 	}
 
+	setValueChangedFlag();
+
     SEND_MESSAGE(this);
 };
 
@@ -759,6 +769,7 @@ maximum(1.0f)
 	propertyIds.add(Identifier("dragDirection"));	ADD_TO_TYPE_SELECTOR(SelectorTypes::ChoiceSelector);
 
 	deactivatedProperties.removeAllInstancesOf(getIdFor(isPluginParameter));
+	deactivatedProperties.removeAllInstancesOf(getIdFor(pluginParameterSmoothing));
 
 	componentProperties->setProperty(getIdFor(Mode), 0);
 	componentProperties->setProperty(getIdFor(Style), 0);
@@ -981,6 +992,7 @@ void ScriptingApi::Content::ScriptSlider::setMinValue(double min) noexcept
 	if (styleId == Slider::TwoValueHorizontal)
 	{
 		minimum = min;
+		setValueChangedFlag();
 		sendChangeMessage();
 	}
 	else
@@ -994,6 +1006,7 @@ void ScriptingApi::Content::ScriptSlider::setMaxValue(double max) noexcept
 	if (styleId == Slider::TwoValueHorizontal)
 	{
 		maximum = max;
+		setValueChangedFlag();
 		sendChangeMessage();
 	}
 	else
@@ -1496,6 +1509,7 @@ ScriptCreatedComponentWrapper * ScriptingApi::Content::ScriptTable::createCompon
 float ScriptingApi::Content::ScriptTable::getTableValue(int inputValue)
 {
 	value = inputValue;
+	setValueChangedFlag();
 
 	parent->sendChangeMessage();
 
@@ -1615,6 +1629,21 @@ const Table * ScriptingApi::Content::ScriptTable::getTable() const
 	return useOtherTable ? referencedTable.get() : ownedTable;
 }
 
+bool ScriptingApi::Content::ScriptTable::checkAndResetValueChangedFlag() noexcept
+{
+	const bool valueChanged = ScriptComponent::checkAndResetValueChangedFlag();
+
+	const Table* t = getTable();
+	const int version = t != nullptr ? t->getDataVersion() : -1;
+
+	const bool tableChanged = t != lastTable || version != lastTableVersion;
+
+	lastTable = t;
+	lastTableVersion = version;
+
+	return valueChanged || tableChanged;
+}
+
 struct ScriptingApi::Content::ScriptSliderPack::Wrapper
 {
 	API_VOID_METHOD_WRAPPER_2(ScriptSliderPack, setSliderAtIndex);
@@ -1823,6 +1852,21 @@ const SliderPackData * ScriptingApi::Content::ScriptSliderPack::getSliderPackDat
 	return (existingData != nullptr) ? existingData.get() : packData.get();
 }
 
+bool ScriptingApi::Content::ScriptSliderPack::checkAndResetValueChangedFlag() noexcept
+{
+	const bool valueChanged = ScriptComponent::checkAndResetValueChangedFlag();
+
+	const SliderPackData* d = getSliderPackData();
+	const int version = d != nullptr ? d->getDataVersion() : -1;
+
+	const bool dataChanged = d != lastPackData || version != lastPackVersion;
+
+	lastPackData = d;
+	lastPackVersion = version;
+
+	return valueChanged || dataChanged;
+}
+
 void ScriptingApi::Content::ScriptSliderPack::setValue(var newValue)
 {
 	ScriptComponent::setValue(newValue);
@@ -2035,7 +2079,9 @@ ScriptComponent(base, parentContent, panelName, x, y, width, height, 1),
 graphics(new ScriptingObjects::GraphicsObject(base, this)),
 repainter(this),
 repaintNotifier(this),
-controlSender(this, base)
+controlSender(this, base),
+rasterisedImageReceiver(this),
+rasteriseTarget(new DrawActionRasteriser::Target(&rasterisedImageReceiver))
 {
 	//deactivatedProperties.add(getIdFor(ScriptComponent::Properties::max));
 	//deactivatedProperties.add(getIdFor(ScriptComponent::Properties::min));
@@ -2058,6 +2104,8 @@ controlSender(this, base)
 	propertyIds.add(Identifier("stepSize"));
 	propertyIds.add(Identifier("enableMidiLearn"));	ADD_TO_TYPE_SELECTOR(SelectorTypes::ToggleSelector);
 	propertyIds.add(Identifier("holdIsRightClick"));	ADD_TO_TYPE_SELECTOR(SelectorTypes::ToggleSelector);
+	propertyIds.add(Identifier("useDisplayList"));	ADD_TO_TYPE_SELECTOR(SelectorTypes::ToggleSelector);
+	propertyIds.add(Identifier("cachePaintRoutine"));	ADD_TO_TYPE_SELECTOR(SelectorTypes::ToggleSelector);
 	
 	
 	componentProperties->setProperty(getIdFor(borderSize), 0);
@@ -2080,6 +2128,8 @@ controlSender(this, base)
 	setDefaultValue(stepSize, 0.0);
 	setDefaultValue(enableMidiLearn, false);
 	setDefaultValue(holdIsRightClick, true);
+	setDefaultValue(useDisplayList, false);
+	setDefaultValue(cachePaintRoutine, false);
 	
 	addConstant("data", new DynamicObject());
 
@@ -2142,48 +2192,182 @@ void ScriptingApi::Content::ScriptPanel::internalRepaint()
 	int canvasWidth = (int)(scaleFactor * (double)getScriptObjectProperty(ScriptComponent::Properties::width));
 	int canvasHeight = (int)(scaleFactor * (double)getScriptObjectProperty(ScriptComponent::Properties::height));
 
-	
+	const bool isOpaque = getScriptObjectProperty(Properties::opaque);
+	const bool useDisplayList = getScriptObjectProperty(Properties::useDisplayList);
+	const bool cacheRoutine = getScriptObjectProperty(Properties::cachePaintRoutine);
+
+	if (cacheRoutine && drawActions != nullptr && getPaintInputHash() == lastPaintInputHash)
+	{
+		// Nothing the paint routine depends on has changed, so the recorded actions are still valid
+		paintStatistics.numSkippedCalls++;
+
+		if (paintCanvas.getWidth() == canvasWidth && paintCanvas.getHeight() == canvasHeight)
+			return;
+	}
+	else
+	{
+		DrawActionList::Ptr newActions = new DrawActionList();
+
+		var thisObject(this);
+		var arguments = var(graphics);
+		var::NativeFunctionArgs args(thisObject, &arguments, 1);
+
+		graphics->setDrawActionList(newActions);
+
+		Result r = Result::ok();
+
+		HiseJavascriptEngine* engine = dynamic_cast<JavascriptProcessor*>(getScriptProcessor())->getScriptEngine();
+
+		engine->maximumExecutionTime = RelativeTime(0.2);
+
+		const double startTime = Time::getMillisecondCounterHiRes();
+
+		engine->callExternalFunction(paintRoutine, args, &r);
+
+		const double scriptTime = Time::getMillisecondCounterHiRes() - startTime;
+
+		graphics->setDrawActionList(nullptr);
+
+		paintStatistics.numScriptCalls++;
+		paintStatistics.numActions = newActions->getNumActions();
+		paintStatistics.lastScriptTime = scriptTime;
+		paintStatistics.totalScriptTime += scriptTime;
+
+		drawActions = newActions;
+		lastPaintInputHash = cacheRoutine ? getPaintInputHash() : 0;
+
+		if (r.failed())
+		{
+			reportScriptError(r.getErrorMessage());
+		}
+	}
+
+	if (useDisplayList)
+	{
+		rasteriser->rasterise(rasteriseTarget, drawActions, canvasWidth, canvasHeight, (float)scaleFactor, !isOpaque);
+		return;
+	}
 
 	if (paintCanvas.getWidth() != canvasWidth ||
 		paintCanvas.getHeight() != canvasHeight)
 	{
-		paintCanvas = Image(Image::PixelFormat::ARGB, canvasWidth, canvasHeight, !getScriptObjectProperty(Properties::opaque));
+		paintCanvas = Image(Image::PixelFormat::ARGB, canvasWidth, canvasHeight, !isOpaque);
 	}
-	else if (!getScriptObjectProperty(Properties::opaque))
+	else if (!isOpaque)
 	{
 		paintCanvas.clear(Rectangle<int>(0, 0, canvasWidth, canvasHeight));
 	}
-	
-	Graphics g(paintCanvas);
 
-	g.addTransform(AffineTransform::scale((float)scaleFactor));
-	
-	var thisObject(this);
-	var arguments = var(graphics);
-	var::NativeFunctionArgs args(thisObject, &arguments, 1);
-
-	graphics->setGraphics(&g, &paintCanvas);
-
-	Result r = Result::ok();
+	const double rasteriseStart = Time::getMillisecondCounterHiRes();
 
-	HiseJavascriptEngine* engine = dynamic_cast<JavascriptProcessor*>(getScriptProcessor())->getScriptEngine();
+	{
+		Graphics g(paintCanvas);
 
-    engine->maximumExecutionTime = RelativeTime(0.2);
-    
-	engine->callExternalFunction(paintRoutine, args, &r);
+		g.addTransform(AffineTransform::scale((float)scaleFactor));
 
-	if (r.failed())
-	{
-		reportScriptError(r.getErrorMessage());
+		drawActions->perform(g, paintCanvas);
 	}
 
-	graphics->setGraphics(nullptr, nullptr);
+	paintStatistics.lastRasteriseTime = Time::getMillisecondCounterHiRes() - rasteriseStart;
 
     repaintNotifier.sendSynchronousChangeMessage();
     
 	//SEND_MESSAGE(this);
 }
 
+int64 ScriptingApi::Content::ScriptPanel::getPaintInputHash() const
+{
+	struct Hasher
+	{
+		/** visited contains the objects and arrays of the current path so self references don't recurse forever. */
+		static int64 getHash(const var& v, Array<const void*>& visited)
+		{
+			if (DynamicObject* obj = v.getDynamicObject())
+			{
+				if (visited.contains(obj))
+					return 23;
+
+				visited.add(obj);
+
+				int64 hash = 17;
+
+				for (int i = 0; i < obj->getProperties().size(); i++)
+				{
+					hash = hash * 31 + obj->getProperties().getName(i).toString().hashCode64();
+					hash = hash * 31 + getHash(obj->getProperties().getValueAt(i), visited);
+				}
+
+				visited.removeLast();
+
+				return hash;
+			}
+			else if (const Array<var>* ar = v.getArray())
+			{
+				if (visited.contains(ar))
+					return 29;
+
+				visited.add(ar);
+
+				int64 hash = 19;
+
+				for (int i = 0; i < ar->size(); i++)
+					hash = hash * 31 + getHash(ar->getUnchecked(i), visited);
+
+				visited.removeLast();
+
+				return hash;
+			}
+			else if (v.isObject())
+			{
+				// Other objects (eg. Paths) are only compared by their identity
+				return (int64)(pointer_sized_int)v.getObject();
+			}
+
+			return v.toString().hashCode64();
+		}
+	};
+
+	Array<const void*> visited;
+
+	int64 hash = Hasher::getHash(getValue(), visited);
+
+	hash = hash * 31 + Hasher::getHash(var(componentProperties.get()), visited);
+	hash = hash * 31 + Hasher::getHash(getConstantValue(0), visited);
+	hash = hash * 31 + (int64)(pointer_sized_int)paintRoutine.getObject();
+
+	return hash;
+}
+
+void ScriptingApi::Content::ScriptPanel::RasterisedImageReceiver::handleAsyncUpdate()
+{
+	parent->paintCanvas = parent->rasteriseTarget->getImage();
+	parent->paintStatistics.lastRasteriseTime = parent->rasteriseTarget->getRasteriseTime();
+
+	parent->repaintNotifier.sendSynchronousChangeMessage();
+}
+
+#if USE_BACKEND
+String ScriptingApi::Content::ScriptPanel::getDebugValue() const
+{
+	if (paintStatistics.numScriptCalls == 0)
+		return ScriptComponent::getDebugValue();
+
+	const double averageTime = paintStatistics.totalScriptTime / (double)paintStatistics.numScriptCalls;
+
+	String s;
+
+	s << ScriptComponent::getDebugValue();
+	s << " | Paint: " << String(paintStatistics.lastScriptTime, 2) << " ms (avg: " << String(averageTime, 2) << " ms)";
+	s << ", Rasterise: " << String(paintStatistics.lastRasteriseTime, 2) << " ms";
+	s << ", " << paintStatistics.numActions << " actions";
+
+	if (paintStatistics.numSkippedCalls > 0)
+		s << ", " << paintStatistics.numSkippedCalls << " skipped";
+
+	return s;
+}
+#endif
+
 void ScriptingApi::Content::ScriptPanel::setMouseCallback(var mouseCallbackFunction)
 {
 	mouseRoutine = mouseCallbackFunction;
@@ -2615,6 +2799,31 @@ AudioSampleProcessor * ScriptingApi::Content::ScriptAudioWaveform::getAudioProce
 	return dynamic_cast<AudioSampleProcessor*>(connectedProcessor.get());
 }
 
+bool ScriptingApi::Content::ScriptAudioWaveform::checkAndResetValueChangedFlag() noexcept
+{
+	bool changed = ScriptComponent::checkAndResetValueChangedFlag();
+
+	const Processor* p = connectedProcessor.get();
+
+	if (p != lastProcessor)
+	{
+		lastProcessor = p;
+		changed = true;
+	}
+
+	if (const AudioSampleProcessor* asp = dynamic_cast<const AudioSampleProcessor*>(p))
+	{
+		if (asp->getRange() != lastRange || asp->getFileName() != lastFileName)
+		{
+			lastRange = asp->getRange();
+			lastFileName = asp->getFileName();
+			changed = true;
+		}
+	}
+
+	return changed;
+}
+
 // ====================================================================================================== ScriptFloatingTile functions
 
 struct ScriptingApi::Content::ScriptFloatingTile::Wrapper
@@ -2730,6 +2939,7 @@ template <class Subtype> Subtype* ScriptingApi::Content::addComponent(Identifier
 	if (!savedValue.isUndefined())
 	{
 		components.getLast()->value = savedValue;
+		components.getLast()->setValueChangedFlag();
 	}
 
 	return t;
@@ -3129,28 +3339,115 @@ void ScriptingApi::Content::restoreAllControlsFromPreset(const ValueTree &preset
 
 
 
-		var v = components[i]->getValue();
+		restoreControlValue(i, macroNames);
+	}
+}
 
-		if (v.isObject())
-		{
-			getScriptProcessor()->controlCallback(components[i], v);
-		}
-		else
-		{
-			getProcessor()->setAttribute(i, components[i]->getValue(), sendNotification);
-		}
+bool ScriptingApi::Content::canRestoreChangedControlsOnly(const ValueTree &preset) const
+{
+	static const Identifier value("value");
 
-		const String macroName = components[i]->getScriptObjectProperty(ScriptComponent::macroControl).toString();
+	for (int i = 0; i < components.size(); i++)
+	{
+		ValueTree child = getPresetDataForComponent(preset, i);
+
+		if (!child.isValid()) continue;
+
+		const var newValue = child.getProperty(value);
+
+		if (components[i]->getValue().isObject() || (newValue.isString() && newValue.toString().startsWith("JSON")))
+			return false;
 
-		const int macroIndex = macroNames.indexOf(macroName) - 1;
+		// Everything except the value must stay the same (eg. the table data or the slider range)
+		ValueTree current = components[i]->exportAsValueTree();
 
-		if (macroIndex >= 0)
+		if (current.getNumChildren() != 0 || child.getNumChildren() != 0 || current.getNumProperties() != child.getNumProperties())
+			return false;
+
+		for (int j = 0; j < child.getNumProperties(); j++)
 		{
-			NormalisableRange<float> range(components[i]->getScriptObjectProperty(ScriptComponent::min), components[i]->getScriptObjectProperty(ScriptComponent::max));
+			const Identifier id = child.getPropertyName(j);
 
-			getProcessor()->getMainController()->getMacroManager().getMacroChain()->setMacroControl(macroIndex, range.convertTo0to1(components[i]->getValue()) * 127.0f, sendNotification);
+			if (id != value && !(current.getProperty(id) == child.getProperty(id)))
+				return false;
 		}
 	}
+
+	return true;
+}
+
+int ScriptingApi::Content::restoreChangedControlsFromPreset(const ValueTree &preset)
+{
+	jassert(canRestoreChangedControlsOnly(preset));
+
+	StringArray macroNames;
+
+	if (components.size() != 0)
+	{
+		macroNames = components[0]->getOptionsFor(components[0]->getIdFor(ScriptComponent::macroControl));
+	}
+
+	int numChangedControls = 0;
+
+	for (int i = 0; i < components.size(); i++)
+	{
+		ValueTree child = getPresetDataForComponent(preset, i);
+
+		if (!child.isValid()) continue;
+
+		const var oldValue = components[i]->getValue();
+
+		components[i]->restoreFromValueTree(child);
+
+		if (components[i]->getValue() == oldValue) continue;
+
+		restoreControlValue(i, macroNames);
+		numChangedControls++;
+	}
+
+	return numChangedControls;
+}
+
+ValueTree ScriptingApi::Content::getPresetDataForComponent(const ValueTree &preset, int componentIndex) const
+{
+	ScriptComponent* c = components[componentIndex];
+
+	if (!c->getScriptObjectProperty(ScriptComponent::Properties::saveInPreset)) return ValueTree();
+
+	ValueTree child = preset.getChildWithProperty("id", c->name.toString());
+
+	const String childTypeString = child.getProperty("type");
+
+	if (childTypeString.isEmpty() || Identifier(childTypeString) != c->getObjectName()) return ValueTree();
+
+	return child;
+}
+
+void ScriptingApi::Content::restoreControlValue(int componentIndex, const StringArray &macroNames)
+{
+	ScriptComponent* c = components[componentIndex];
+
+	var v = c->getValue();
+
+	if (v.isObject())
+	{
+		getScriptProcessor()->controlCallback(c, v);
+	}
+	else
+	{
+		getProcessor()->setAttribute(componentIndex, c->getValue(), sendNotification);
+	}
+
+	const String macroName = c->getScriptObjectProperty(ScriptComponent::macroControl).toString();
+
+	const int macroIndex = macroNames.indexOf(macroName) - 1;
+
+	if (macroIndex >= 0)
+	{
+		NormalisableRange<float> range(c->getScriptObjectProperty(ScriptComponent::min), c->getScriptObjectProperty(ScriptComponent::max));
+
+		getProcessor()->getMainController()->getMacroManager().getMacroChain()->setMacroControl(macroIndex, range.convertTo0to1(c->getValue()) * 127.0f, sendNotification);
+	}
 }
 
 
@@ -95,6 +95,7 @@ public:
 			saveInPreset,
 			isPluginParameter,
 			pluginParameterName,
+			pluginParameterSmoothing,
 			useUndoManager,
 			parentComponent,
 			numProperties
@@ -231,6 +232,19 @@ public:
 		void setChanged(bool isChanged = true) noexcept{ changed = isChanged; }
 		bool isChanged() const noexcept{ return changed; };
 
+		/** Marks the value (or the data that is saved together with the value) as changed. */
+		void setValueChangedFlag() noexcept { valueChangedFlag.store(true); }
+
+		/** Returns true if the value (or the data that is saved together with the value) has changed since the last call.
+		*
+		*	This is used by the plugin state to skip the serialisation of unchanged controls. If you change an object
+		*	value in place, call setValue() afterwards so that the change is picked up.
+		*/
+		virtual bool checkAndResetValueChangedFlag() noexcept { return valueChangedFlag.exchange(false); }
+
+		/** Returns the index of the component name in the trace recorder of the debug logger. */
+		int getTraceNameIndex() const noexcept { return traceNameIndex; }
+
 		var value;
 		Identifier name;
 		Content *parent;
@@ -257,8 +271,12 @@ public:
 		NamedValueSet defaultValues;
 		bool changed;
 
+		std::atomic<bool> valueChangedFlag { true };
+
 		int parentComponentIndex;
 
+		int traceNameIndex = -1;
+
 		JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScriptComponent);
 	};
 
@@ -498,6 +516,8 @@ public:
 		const Table *getTable() const;
 		LookupTableProcessor * getTableProcessor() const;
 
+		bool checkAndResetValueChangedFlag() noexcept override;
+
 		// ======================================================================================================== API Method
 
 		/** Returns the table value from 0.0 to 1.0 according to the input value from 0 to 127. */
@@ -520,6 +540,9 @@ public:
 		bool useOtherTable;
 		int lookupTableIndex;
 
+		const Table* lastTable = nullptr;
+		int lastTableVersion = -1;
+
 		JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScriptTable);
 	};
 
@@ -559,6 +582,8 @@ public:
 		SliderPackData *getSliderPackData();
 		const SliderPackData *getSliderPackData() const;
 
+		bool checkAndResetValueChangedFlag() noexcept override;
+
 		// ======================================================================================================== API Methods
 
 		/** sets the slider value at the given index.*/
@@ -587,6 +612,9 @@ public:
 		ScopedPointer<SliderPackData> packData;
 		WeakReference<SliderPackData> existingData;
 
+		const SliderPackData* lastPackData = nullptr;
+		int lastPackVersion = -1;
+
 		JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScriptSliderPack);
 
 		// ========================================================================================================
@@ -669,13 +697,28 @@ public:
 			stepSize,
 			enableMidiLearn,
 			holdIsRightClick,
+			useDisplayList,
+			cachePaintRoutine,
 			numProperties
 		};
 
+		/** The paint costs of a panel (all times are in milliseconds). */
+		struct PaintStatistics
+		{
+			int numScriptCalls = 0;
+			int numSkippedCalls = 0;
+			int numActions = 0;
+			double lastScriptTime = 0.0;
+			double totalScriptTime = 0.0;
+			double lastRasteriseTime = 0.0;
+		};
+
 		ScriptPanel(ProcessorWithScriptingContent *base, Content *parentContent, Identifier panelName, int x, int y, int width, int height);;
 		~ScriptPanel()
 		{
 			masterReference.clear();
+
+			rasteriseTarget->detach();
 			
 			graphics = nullptr;
 
@@ -739,6 +782,12 @@ public:
 
 		bool isUsingCustomPaintRoutine() const { return !paintRoutine.isUndefined(); }
 
+		const PaintStatistics& getPaintStatistics() const { return paintStatistics; }
+
+#if USE_BACKEND
+		String getDebugValue() const override;
+#endif
+
 		void scaleFactorChanged(float newScaleFactor) override {} // Do nothing until fixed...
 
 		void mouseCallback(var mouseInformation);
@@ -787,6 +836,13 @@ public:
 
 		void internalRepaint();
 
+		/** Creates a hash of the value, the properties and the data object. 
+		*
+		*	The paint routine is only skipped if the cachePaintRoutine property is set, because the hash doesn't
+		*	cover anything else the routine reads (eg. global variables).
+		*/
+		int64 getPaintInputHash() const;
+
 		struct AsyncControlCallbackSender : public AsyncUpdater
 		{
 			AsyncControlCallbackSender(ScriptPanel* parent_, ProcessorWithScriptingContent* p_) : parent(parent_), p(p_) {};
@@ -823,7 +879,14 @@ public:
 			WeakReference<ScriptPanel> parent;
 		};
 
-        
+		struct RasterisedImageReceiver : public AsyncUpdater
+		{
+			RasterisedImageReceiver(ScriptPanel* parent_) : parent(parent_) {};
+
+			void handleAsyncUpdate() override;
+
+			ScriptPanel* parent;
+		};
         
 		JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScriptPanel);
 
@@ -858,6 +921,15 @@ public:
         
 		AsyncControlCallbackSender controlSender;
 
+		DrawActionList::Ptr drawActions;
+		int64 lastPaintInputHash = 0;
+
+		PaintStatistics paintStatistics;
+
+		RasterisedImageReceiver rasterisedImageReceiver;
+		DrawActionRasteriser::Target::Ptr rasteriseTarget;
+		SharedResourcePointer<DrawActionRasteriser> rasteriser;
+
 		// ========================================================================================================
 	};
 
@@ -971,12 +1043,19 @@ public:
 		AudioSampleProcessor * getAudioProcessor();;
 		void connectToAudioSampleProcessor(String processorId);
 
+		/** The sample processor has no change notification for the range and the file, so they are compared with the last seen values. */
+		bool checkAndResetValueChangedFlag() noexcept override;
+
 		// ========================================================================================================
 
 	private:
 
 		WeakReference<Processor> connectedProcessor;
 
+		const Processor* lastProcessor = nullptr;
+		Range<int> lastRange;
+		String lastFileName;
+
 		JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScriptAudioWaveform);
 
 		// ========================================================================================================
@@ -1132,6 +1211,12 @@ public:
 	// Restores the content and sets the attributes so that the macros and the control callbacks gets executed.
 	void restoreAllControlsFromPreset(const ValueTree &preset);
 
+	// Returns true if the preset only changes the plain values of the controls (no table data, ranges or JSON objects).
+	bool canRestoreChangedControlsOnly(const ValueTree &preset) const;
+
+	// Restores only the controls whose value differs from the preset and returns the number of changed controls.
+	int restoreChangedControlsFromPreset(const ValueTree &preset);
+
 	Colour getColour() const { return colour; };
 	void endInitialization();
 
@@ -1160,6 +1245,10 @@ private:
 
 	template<class Subtype> Subtype *addComponent(Identifier name, int x, int y, int width = -1, int height = -1);
 
+	ValueTree getPresetDataForComponent(const ValueTree &preset, int componentIndex) const;
+
+	void restoreControlValue(int componentIndex, const StringArray &macroNames);
+
 	friend class ScriptContentComponent;
 	friend class WeakReference<ScriptingApi::Content>;
 	WeakReference<ScriptingApi::Content>::Master masterReference;
@@ -1389,76 +1389,53 @@ rectangleResult(Result::ok())
 ScriptingObjects::GraphicsObject::~GraphicsObject()
 {
 	parent = nullptr;
-	imageToDraw = nullptr;
-	g = nullptr;
+	list = nullptr;
 }
 
 void ScriptingObjects::GraphicsObject::fillAll(int colour)
 {
-	initGraphics();
-	Colour c((uint32)colour);
-
-	g->fillAll(c);
-
-	
+	addAction(new DrawActionList::FillAll(Colour((uint32)colour)));
 }
 
 void ScriptingObjects::GraphicsObject::fillRect(var area)
 {
-	initGraphics();
-
-	g->fillRect(getRectangleFromVar(area));
+	addAction(new DrawActionList::FillRect(getRectangleFromVar(area)));
 }
 
 void ScriptingObjects::GraphicsObject::drawRect(var area, float borderSize)
 {
-	initGraphics();
-
-	g->drawRect(getRectangleFromVar(area), borderSize);
+	addAction(new DrawActionList::DrawRect(getRectangleFromVar(area), borderSize));
 }
 
 void ScriptingObjects::GraphicsObject::fillRoundedRectangle(var area, float cornerSize)
 {
-	initGraphics();
-
-	g->fillRoundedRectangle(getRectangleFromVar(area), cornerSize);
+	addAction(new DrawActionList::FillRoundedRectangle(getRectangleFromVar(area), cornerSize));
 }
 
 void ScriptingObjects::GraphicsObject::drawRoundedRectangle(var area, float cornerSize, float borderSize)
 {
-	initGraphics();
-
-	g->drawRoundedRectangle(getRectangleFromVar(area), cornerSize, borderSize);
+	addAction(new DrawActionList::DrawRoundedRectangle(getRectangleFromVar(area), cornerSize, borderSize));
 }
 
 void ScriptingObjects::GraphicsObject::drawHorizontalLine(int y, float x1, float x2)
 {
-	initGraphics();
-
-	g->drawHorizontalLine(y, x1, x2);
+	addAction(new DrawActionList::DrawHorizontalLine(y, x1, x2));
 }
 
 void ScriptingObjects::GraphicsObject::setOpacity(float alphaValue)
 {
-	initGraphics();
-
-	
-
-	g->setOpacity(alphaValue);
+	addAction(new DrawActionList::SetOpacity(alphaValue));
 }
 
 void ScriptingObjects::GraphicsObject::drawLine(float x1, float x2, float y1, float y2, float lineThickness)
 {
-	initGraphics();
-
-	g->drawLine(x1, y1, x2, y2, lineThickness);
+	addAction(new DrawActionList::DrawLine(Line<float>(x1, y1, x2, y2), lineThickness));
 }
 
 void ScriptingObjects::GraphicsObject::setColour(int colour)
 {
-	
 	currentColour = Colour((uint32)colour);
-	g->setColour(currentColour);
+	addAction(new DrawActionList::SetColour(currentColour));
 
 	useGradient = false;
 }
@@ -1478,20 +1455,16 @@ void ScriptingObjects::GraphicsObject::setFont(String fontName, float fontSize)
 		currentFont = Font(fontName, fontSize, Font::plain);
 	}
 
-	g->setFont(currentFont);
+	addAction(new DrawActionList::SetFont(currentFont));
 }
 
 void ScriptingObjects::GraphicsObject::drawText(String text, var area)
 {
-	initGraphics();
-
 	Rectangle<float> r = getRectangleFromVar(area);
 
 	currentFont.setHeightWithoutChangingWidth(r.getHeight());
 
-	g->setFont(currentFont);
-
-	g->drawText(text, r, Justification::centred);
+	addAction(new DrawActionList::DrawText(text, r, currentFont));
 }
 
 void ScriptingObjects::GraphicsObject::setGradientFill(var gradientData)
@@ -1507,7 +1480,7 @@ void ScriptingObjects::GraphicsObject::setGradientFill(var gradientData)
 
 			useGradient = true;
 
-			g->setGradientFill(currentGradient);
+			addAction(new DrawActionList::SetGradientFill(currentGradient));
 		}
 		else
 		{
@@ -1524,16 +1497,12 @@ void ScriptingObjects::GraphicsObject::setGradientFill(var gradientData)
 
 void ScriptingObjects::GraphicsObject::drawEllipse(var area, float lineThickness)
 {
-	initGraphics();
-
-	g->drawEllipse(getRectangleFromVar(area), lineThickness);
+	addAction(new DrawActionList::DrawEllipse(getRectangleFromVar(area), lineThickness));
 }
 
 void ScriptingObjects::GraphicsObject::fillEllipse(var area)
 {
-	initGraphics();
-
-	g->fillEllipse(getRectangleFromVar(area));
+	addAction(new DrawActionList::FillEllipse(getRectangleFromVar(area)));
 }
 
 void ScriptingObjects::GraphicsObject::drawImage(String imageName, var area, int /*xOffset*/, int yOffset)
@@ -1552,7 +1521,10 @@ void ScriptingObjects::GraphicsObject::drawImage(String imageName, var area, int
         {
             const double scaleFactor = (double)img->getWidth() / (double)r.getWidth();
             
-            g->drawImage(*img, (int)r.getX(), (int)r.getY(), (int)r.getWidth(), (int)r.getHeight(), 0, yOffset, (int)img->getWidth(), (int)((double)r.getHeight() * scaleFactor));
+			Rectangle<int> targetArea((int)r.getX(), (int)r.getY(), (int)r.getWidth(), (int)r.getHeight());
+			Rectangle<int> sourceArea(0, yOffset, (int)img->getWidth(), (int)((double)r.getHeight() * scaleFactor));
+
+			addAction(new DrawActionList::DrawImage(*img, targetArea, sourceArea));
         }        
 	}
 	else
@@ -1563,22 +1535,16 @@ void ScriptingObjects::GraphicsObject::drawImage(String imageName, var area, int
 
 void ScriptingObjects::GraphicsObject::drawDropShadow(var area, int colour, int radius)
 {
-	initGraphics();
-
 	DropShadow shadow;
 
 	shadow.colour = Colour((uint32)colour);
 	shadow.radius = radius;
 
-	auto r = getIntRectangleFromVar(area);
-
-	shadow.drawForRectangle(*g, r);
+	addAction(new DrawActionList::DrawDropShadow(getIntRectangleFromVar(area), shadow));
 }
 
 void ScriptingObjects::GraphicsObject::drawTriangle(var area, float angle, float lineThickness)
 {
-	initGraphics();
-
 	Path p;
 	p.startNewSubPath(0.5f, 0.0f);
 	p.lineTo(1.0f, 1.0f);
@@ -1588,14 +1554,11 @@ void ScriptingObjects::GraphicsObject::drawTriangle(var area, float angle, float
 	auto r = getRectangleFromVar(area);
 	p.scaleToFit(r.getX(), r.getY(), r.getWidth(), r.getHeight(), false);
 	
-	PathStrokeType pst(lineThickness);
-	g->strokePath(p, pst);
+	addAction(new DrawActionList::StrokePath(p, PathStrokeType(lineThickness)));
 }
 
 void ScriptingObjects::GraphicsObject::fillTriangle(var area, float angle)
 {
-	initGraphics();
-
 	Path p;
 	p.startNewSubPath(0.5f, 0.0f);
 	p.lineTo(1.0f, 1.0f);
@@ -1605,31 +1568,23 @@ void ScriptingObjects::GraphicsObject::fillTriangle(var area, float angle)
 	auto r = getRectangleFromVar(area);
 	p.scaleToFit(r.getX(), r.getY(), r.getWidth(), r.getHeight(), false);
 
-	g->fillPath(p);
+	addAction(new DrawActionList::FillPath(p));
 }
 
 void ScriptingObjects::GraphicsObject::addDropShadowFromAlpha(int colour, int radius)
 {
-	initGraphics();
-
 	DropShadow shadow;
 
 	shadow.colour = Colour((uint32)colour);
 	shadow.radius = radius;
 
-
-    
-    
-    Graphics g2(*imageToDraw);
-    
 #if JUCE_MAC || HISE_IOS
-    const double scaleFactor = dynamic_cast<ScriptingApi::Content::ScriptPanel*>(parent)->parent->usesDoubleResolution() ? 2.0 : 1.0;
-    
-    // don't ask why...
-    g2.addTransform(AffineTransform::scale((float)(1.0 / scaleFactor)));
+    const float scaleFactor = dynamic_cast<ScriptingApi::Content::ScriptPanel*>(parent)->parent->usesDoubleResolution() ? 2.0f : 1.0f;
+#else
+	const float scaleFactor = 1.0f;
 #endif
-    
-	shadow.drawForImage(g2, *imageToDraw);
+
+	addAction(new DrawActionList::AddDropShadowFromAlpha(shadow, scaleFactor));
 }
 
 void ScriptingObjects::GraphicsObject::fillPath(var path, var area)
@@ -1644,7 +1599,7 @@ void ScriptingObjects::GraphicsObject::fillPath(var path, var area)
 			p.scaleToFit(r.getX(), r.getY(), r.getWidth(), r.getHeight(), false);
 		}
 
-		g->fillPath(p);
+		addAction(new DrawActionList::FillPath(p));
 	}
 }
 
@@ -1660,7 +1615,7 @@ void ScriptingObjects::GraphicsObject::drawPath(var path, var area, var thicknes
 			p.scaleToFit(r.getX(), r.getY(), r.getWidth(), r.getHeight(), false);
 		}
 
-		g->strokePath(p, PathStrokeType(thickness));
+		addAction(new DrawActionList::StrokePath(p, PathStrokeType(thickness)));
 	}
 }
 
@@ -1684,8 +1639,17 @@ Rectangle<int> ScriptingObjects::GraphicsObject::getIntRectangleFromVar(const va
 
 void ScriptingObjects::GraphicsObject::initGraphics()
 {
-	if (g == nullptr) reportScriptError("Graphics not initialised");
+	if (list == nullptr) reportScriptError("Graphics not initialised");
+
+}
+
+void ScriptingObjects::GraphicsObject::addAction(DrawActionList::DrawAction* newAction)
+{
+	ScopedPointer<DrawActionList::DrawAction> action = newAction;
+
+	initGraphics();
 
+	list->addAction(action.release());
 }
 
 struct ScriptingObjects::ScriptingMessageHolder::Wrapper
@@ -1753,6 +1717,7 @@ ScriptingObjects::ScriptingMessageHolder::ScriptingMessageHolder(ProcessorWithSc
 	addConstant("VolumeFade", 10);
 	addConstant("PitchFade", 11);
 	addConstant("TimerEvent", 12);
+	addConstant("PluginParameter", 13);
 }
 
 int ScriptingObjects::ScriptingMessageHolder::getNoteNumber() const { return (int)e.getNoteNumber(); }
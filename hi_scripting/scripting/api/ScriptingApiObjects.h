@@ -823,11 +823,10 @@ public:
 
 		struct Wrapper;
 
-		
-		void setGraphics(Graphics *g_, Image* image_)
+		/** Sets the list that records the drawing commands. Call this with nullptr after the paint routine. */
+		void setDrawActionList(DrawActionList* newList)
 		{
-			g = g_;
-			imageToDraw = image_;
+			list = newList;
 		}
 
 	private:
@@ -837,11 +836,11 @@ public:
 
 		void initGraphics();
 
-		Result rectangleResult;
+		void addAction(DrawActionList::DrawAction* newAction);
 
-		Image *imageToDraw = nullptr;
+		Result rectangleResult;
 
-		Graphics *g = nullptr;
+		DrawActionList* list = nullptr;
 
 		Colour currentColour;
 		Font currentFont;
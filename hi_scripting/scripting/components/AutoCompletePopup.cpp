@@ -84,6 +84,8 @@ void JavascriptCodeEditor::AutoCompletePopup::createVariableRows()
 {
 	HiseJavascriptEngine *engine = sp->getScriptEngine();
 
+	SortedSet<String> existingNames;
+
 	for (int i = 0; i < engine->getNumDebugObjects(); i++)
 	{
 		DebugInformation *info = engine->getDebugInformation(i);
@@ -96,6 +98,42 @@ void JavascriptCodeEditor::AutoCompletePopup::createVariableRows()
 		row->value = info->getTextForValue();
 		row->codeToInsert = info->getTextForName();
 
+		existingNames.add(row->name);
+		allInfo.add(row.release());
+	}
+
+	// Add the symbols that are declared in the document, but not compiled yet
+	Array<JavascriptTokenCache::Declaration> declarations;
+
+	editor->tokenCache.getDeclarations(declarations);
+
+	for (int i = 0; i < declarations.size(); i++)
+	{
+		const JavascriptTokenCache::Declaration& d = declarations.getReference(i);
+
+		if (existingNames.contains(d.name))
+			continue;
+
+		ScopedPointer<RowInfo> row = new RowInfo();
+
+		switch (d.type)
+		{
+		case JavascriptTokenCache::DeclarationType::Register:	row->type = (int)DebugInformation::Type::RegisterVariable; row->typeName = "reg"; break;
+		case JavascriptTokenCache::DeclarationType::Constant:	row->type = (int)DebugInformation::Type::Constant; row->typeName = "const"; break;
+		case JavascriptTokenCache::DeclarationType::Global:		row->type = (int)DebugInformation::Type::Globals; row->typeName = "global"; break;
+		case JavascriptTokenCache::DeclarationType::Function:	row->type = (int)DebugInformation::Type::InlineFunction; row->typeName = "function"; break;
+		case JavascriptTokenCache::DeclarationType::Namespace:	row->type = (int)DebugInformation::Type::Namespace; row->typeName = "namespace"; break;
+		case JavascriptTokenCache::DeclarationType::Local:		row->type = (int)DebugInformation::Type::Variables; row->typeName = "local"; break;
+		case JavascriptTokenCache::DeclarationType::Variable:
+		case JavascriptTokenCache::DeclarationType::numDeclarationTypes:
+		default:												row->type = (int)DebugInformation::Type::Variables; row->typeName = "var"; break;
+		}
+
+		row->name = d.name;
+		row->codeToInsert = d.name;
+		row->value = "Line " + String(d.lineNumber + 1);
+
+		existingNames.add(row->name);
 		allInfo.add(row.release());
 	}
 }
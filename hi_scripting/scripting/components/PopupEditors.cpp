@@ -140,6 +140,9 @@ bool PopupIncludeEditor::keyPressed(const KeyPress& key)
 		{
 			String editorContent = doc->getAllContent();
 			file.replaceWithText(editorContent);
+
+			// The included files are parsed as part of onInit...
+			sp->invalidateCompileState();
 		}
 
 		if (isWholeScriptEditor())
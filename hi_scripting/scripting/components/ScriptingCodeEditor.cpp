@@ -38,8 +38,11 @@ JavascriptCodeEditor::JavascriptCodeEditor(CodeDocument &document, CodeTokeniser
 CodeEditorComponent(document, codeTokeniser),
 scriptProcessor(p),
 processor(dynamic_cast<Processor*>(p)),
-snippetId(snippetId_)
+snippetId(snippetId_),
+tokenCache(document)
 {
+	if (auto jsTokeniser = dynamic_cast<JavascriptTokeniser*>(codeTokeniser))
+		jsTokeniser->setTokenCache(&tokenCache);
 
 	p->addEditor(this);
 
@@ -817,6 +820,29 @@ void JavascriptCodeEditor::paintOverChildren(Graphics& g)
 		}
 	}
 
+	if (!matchingBrackets.isEmpty())
+	{
+		const int bracketPositions[2] = { matchingBrackets.getStart(), matchingBrackets.getEnd() };
+
+		for (int i = 0; i < 2; i++)
+		{
+			if (bracketPositions[i] >= getDocument().getNumCharacters())
+				continue;
+
+			CodeDocument::Position pos(getDocument(), bracketPositions[i]);
+
+			if (lineRange.contains(pos.getLineNumber()))
+			{
+				const Rectangle<float> area = getCharacterBounds(pos).toFloat();
+
+				g.setColour(Colours::white.withAlpha(0.15f));
+				g.fillRoundedRectangle(area, 2.0f);
+				g.setColour(Colours::white.withAlpha(0.5f));
+				g.drawRoundedRectangle(area, 2.0f, 1.0f);
+			}
+		}
+	}
+
 #if ENABLE_SCRIPTING_BREAKPOINTS
 	if (scriptProcessor->anyBreakpointsActive())
 	{
@@ -850,6 +876,31 @@ void JavascriptCodeEditor::paintOverChildren(Graphics& g)
 }
 
 
+void JavascriptCodeEditor::updateMatchingBrackets()
+{
+	const int caretPosition = getCaretPos().getPosition();
+
+	Range<int> newBrackets;
+
+	// Check the character after the caret first, then the one before it
+	for (int bracketPosition = caretPosition; bracketPosition >= caretPosition - 1; bracketPosition--)
+	{
+		const int matchingPosition = tokenCache.findMatchingBracket(bracketPosition);
+
+		if (matchingPosition != -1)
+		{
+			newBrackets = Range<int>(jmin<int>(bracketPosition, matchingPosition), jmax<int>(bracketPosition, matchingPosition));
+			break;
+		}
+	}
+
+	if (newBrackets != matchingBrackets)
+	{
+		matchingBrackets = newBrackets;
+		repaint();
+	}
+}
+
 bool JavascriptCodeEditor::isNothingSelected() const
 {
 	return getSelectionStart() == getSelectionEnd();
@@ -869,22 +920,10 @@ void JavascriptCodeEditor::handleDoubleCharacter(const KeyPress &k, char openCha
 			moveCaretLeft(false, false);
 		}
 
-		CodeDocument::Iterator it(getDocument());
-
-		char c;
-
-		int numCharacters = 0;
-
-		while (!it.isEOF())
-		{
-			c = (char)it.nextChar();
-
-			if (c == openCharacter || c == closeCharacter)
-			{
-				numCharacters++;
-			}
+		int numCharacters = tokenCache.getNumBrackets(openCharacter);
 
-		}
+		if (openCharacter != closeCharacter)
+			numCharacters += tokenCache.getNumBrackets(closeCharacter);
 
 		if (numCharacters % 2 == 0)
 		{
@@ -1090,7 +1129,11 @@ bool JavascriptCodeEditor::keyPressed(const KeyPress& k)
 
     
 
-	return CodeEditorComponent::keyPressed(k);
+	const bool keyWasUsed = CodeEditorComponent::keyPressed(k);
+
+	updateMatchingBrackets();
+
+	return keyWasUsed;
 }
 
 
@@ -1130,16 +1173,7 @@ if (remainderOfBrokenLine.trimStart().startsWithChar('}'))
 
 	if (trimmedPreviousLine.endsWith("{"))
 	{
-		int openedBrackets = 0;
-		CodeDocument::Iterator it(getDocument());
-
-		while (!it.isEOF())
-		{
-			juce_wchar c = it.nextChar();
-
-			if (c == '{')		openedBrackets++;
-			else if (c == '}')	openedBrackets--;
-		}
+		const int openedBrackets = tokenCache.getNumBrackets('{') - tokenCache.getNumBrackets('}');
 
 		if (openedBrackets == 1)
 		{
@@ -1226,6 +1260,8 @@ void JavascriptCodeEditor::mouseDown(const MouseEvent& e)
 {
 	CodeEditorComponent::mouseDown(e);
 
+	updateMatchingBrackets();
+
 #if ENABLE_SCRIPTING_BREAKPOINTS
 	if (e.x < 35)
 	{
@@ -183,6 +183,7 @@ private:
 	Range<int> getCurrentTokenRange() const;
 	bool isNothingSelected() const;
 	void handleDoubleCharacter(const KeyPress &k, char openCharacter, char closeCharacter);
+	void updateMatchingBrackets();
 
 	Component::SafePointer<Component> currentModalWindow;
 
@@ -195,6 +196,10 @@ private:
 	
 	const Identifier snippetId;
 
+	JavascriptTokenCache tokenCache;
+
+	Range<int> matchingBrackets;
+
 	PopupLookAndFeel plaf;
 
 	DragState positionFound;
@@ -500,6 +500,238 @@ struct HiseJavascriptEngine::RootObject::CallbackLocalReference : public Express
 	var* data;
 };
 
+/** Replaces consecutive inplace operations on the same buffer with a single pass.
+*
+*	The parser creates this statement for lines like
+*
+*		b *= gain;
+*		b += other;
+*		b *= 0.5;
+*
+*	If the target is a buffer when the statement is executed, all operations are applied using a
+*	VariantBuffer::OperationChain. Otherwise (or if the operands don't allow a single pass), the original
+*	statements are executed one by one.
+*
+*	Only operands without side effects (literals and variable references) are allowed, so evaluating them
+*	before the first operation is applied doesn't change the result.
+*
+*	The parser can't know the type of the target, so chains on numbers are also wrapped. If the target is
+*	not a buffer, the next executions run the original statements directly and check the target type again
+*	after NumCallsBetweenTargetChecks calls.
+*/
+struct HiseJavascriptEngine::RootObject::FusedBufferStatement : public Statement
+{
+	FusedBufferStatement(const CodeLocation& l) noexcept : Statement(l) {}
+
+	enum
+	{
+		NumCallsBetweenTargetChecks = 64
+	};
+
+	ResultCode perform(const Scope& s, var* returnedValue) const override
+	{
+		const int numCallsToSkip = numCallsUntilTargetCheck.load(std::memory_order_relaxed);
+
+		if (numCallsToSkip > 0)
+		{
+			numCallsUntilTargetCheck.store(numCallsToSkip - 1, std::memory_order_relaxed);
+			return performStatements(s, returnedValue);
+		}
+
+		var t(target->getResult(s));
+
+		if (VariantBuffer* b = t.getBuffer())
+		{
+			VariantBuffer::OperationChain chain(*b);
+
+			bool canBeFused = true;
+
+			for (int i = 0; i < operands.size(); i++)
+			{
+				const var v(operands.getUnchecked(i)->getResult(s));
+				const VariantBuffer::OperationChain::OpType type = types.getUnchecked(i);
+
+				if (VariantBuffer* other = v.getBuffer())
+					canBeFused = chain.addOperation(type, *other);
+				else if (isNumericOrUndefined(v))
+					canBeFused = chain.addOperation(type, (float)v);
+				else
+					canBeFused = false;
+
+				if (!canBeFused)
+					break;
+			}
+
+			if (canBeFused)
+			{
+				chain.process();
+				target->assign(s, t);
+				return ok;
+			}
+		}
+		else
+		{
+			numCallsUntilTargetCheck.store(NumCallsBetweenTargetChecks, std::memory_order_relaxed);
+		}
+
+		return performStatements(s, returnedValue);
+	}
+
+	/** Executes the original statements one by one. */
+	ResultCode performStatements(const Scope& s, var* returnedValue) const
+	{
+		for (int i = 0; i < statements.size(); i++)
+		{
+#if ENABLE_SCRIPTING_SAFE_CHECKS
+			s.root->currentLocation = &statements.getUnchecked(i)->location;
+#endif
+
+			if (ResultCode r = statements.getUnchecked(i)->perform(s, returnedValue))
+				return r;
+		}
+
+		return ok;
+	}
+
+	/** Merges all fusable statements in the given list. This is called by the parser for every block. */
+	static void fuseStatements(OwnedArray<Statement>& list)
+	{
+		for (int i = 0; i < list.size() - 1; i++)
+		{
+			const SelfAssignment* first = getFusableAssignment(list.getUnchecked(i));
+
+			if (first == nullptr)
+				continue;
+
+			int numToFuse = 1;
+
+			while (i + numToFuse < list.size())
+			{
+				const SelfAssignment* next = getFusableAssignment(list.getUnchecked(i + numToFuse));
+
+				if (next == nullptr || !isSameReference(first->target, next->target))
+					break;
+
+				numToFuse++;
+			}
+
+			if (numToFuse < 2)
+				continue;
+
+			numToFuse = jmin<int>(numToFuse, VariantBuffer::OperationChain::MaxNumOperations);
+
+			ScopedPointer<FusedBufferStatement> fs = new FusedBufferStatement(first->location);
+
+			fs->target = first->target;
+
+			for (int j = 0; j < numToFuse; j++)
+			{
+				SelfAssignment* sa = dynamic_cast<SelfAssignment*>(list.removeAndReturn(i));
+				const BinaryOperatorBase* op = dynamic_cast<const BinaryOperatorBase*>(sa->newValue.get());
+
+				fs->statements.add(sa);
+				fs->operands.add(op->rhs.get());
+				fs->types.add(getOpType(op));
+			}
+
+			list.insert(i, fs.release());
+		}
+	}
+
+private:
+
+	/** Returns the assignment if it is an inplace buffer operator with an operand that can be evaluated in advance. */
+	static const SelfAssignment* getFusableAssignment(const Statement* s)
+	{
+		if (s->breakpointReference.index != -1)
+			return nullptr;
+
+		const SelfAssignment* sa = dynamic_cast<const SelfAssignment*>(s);
+
+		if (sa == nullptr || dynamic_cast<const PostAssignment*>(s) != nullptr)
+			return nullptr;
+
+		const BinaryOperatorBase* op = dynamic_cast<const BinaryOperatorBase*>(sa->newValue.get());
+
+		if (op == nullptr || getOpType(op) == VariantBuffer::OperationChain::numOpTypes)
+			return nullptr;
+
+		if (!isReference(sa->target) || (!isReference(op->rhs) && dynamic_cast<const LiteralValue*>(op->rhs.get()) == nullptr))
+			return nullptr;
+
+		return sa;
+	}
+
+	static VariantBuffer::OperationChain::OpType getOpType(const BinaryOperatorBase* op)
+	{
+		if (dynamic_cast<const LeftShiftOp*>(op) != nullptr)	return VariantBuffer::OperationChain::Assign;
+		if (dynamic_cast<const AdditionOp*>(op) != nullptr)		return VariantBuffer::OperationChain::Add;
+		if (dynamic_cast<const SubtractionOp*>(op) != nullptr)	return VariantBuffer::OperationChain::Subtract;
+		if (dynamic_cast<const MultiplyOp*>(op) != nullptr)		return VariantBuffer::OperationChain::Multiply;
+
+		return VariantBuffer::OperationChain::numOpTypes;
+	}
+
+	static bool isReference(const Expression* e)
+	{
+		return dynamic_cast<const UnqualifiedName*>(e) != nullptr ||
+			   dynamic_cast<const RegisterName*>(e) != nullptr ||
+			   dynamic_cast<const ConstReference*>(e) != nullptr ||
+			   dynamic_cast<const GlobalReference*>(e) != nullptr ||
+			   dynamic_cast<const LocalReference*>(e) != nullptr ||
+			   dynamic_cast<const CallbackParameterReference*>(e) != nullptr ||
+			   dynamic_cast<const CallbackLocalReference*>(e) != nullptr;
+	}
+
+	static bool isSameReference(const Expression* a, const Expression* b)
+	{
+		if (const UnqualifiedName* ua = dynamic_cast<const UnqualifiedName*>(a))
+		{
+			const UnqualifiedName* ub = dynamic_cast<const UnqualifiedName*>(b);
+			return ub != nullptr && ua->name == ub->name;
+		}
+		if (const RegisterName* ra = dynamic_cast<const RegisterName*>(a))
+		{
+			const RegisterName* rb = dynamic_cast<const RegisterName*>(b);
+			return rb != nullptr && ra->data == rb->data;
+		}
+		if (const ConstReference* ca = dynamic_cast<const ConstReference*>(a))
+		{
+			const ConstReference* cb = dynamic_cast<const ConstReference*>(b);
+			return cb != nullptr && ca->ns == cb->ns && ca->index == cb->index;
+		}
+		if (const GlobalReference* ga = dynamic_cast<const GlobalReference*>(a))
+		{
+			const GlobalReference* gb = dynamic_cast<const GlobalReference*>(b);
+			return gb != nullptr && ga->id == gb->id;
+		}
+		if (const LocalReference* la = dynamic_cast<const LocalReference*>(a))
+		{
+			const LocalReference* lb = dynamic_cast<const LocalReference*>(b);
+			return lb != nullptr && la->parentFunction == lb->parentFunction && la->id == lb->id;
+		}
+		if (const CallbackParameterReference* pa = dynamic_cast<const CallbackParameterReference*>(a))
+		{
+			const CallbackParameterReference* pb = dynamic_cast<const CallbackParameterReference*>(b);
+			return pb != nullptr && pa->data == pb->data;
+		}
+		if (const CallbackLocalReference* cla = dynamic_cast<const CallbackLocalReference*>(a))
+		{
+			const CallbackLocalReference* clb = dynamic_cast<const CallbackLocalReference*>(b);
+			return clb != nullptr && cla->data == clb->data;
+		}
+
+		return false;
+	}
+
+	Expression* target; // aliases the target of the first statement
+	OwnedArray<Statement> statements;
+	Array<Expression*> operands; // aliases the right hand sides of the statements
+	Array<VariantBuffer::OperationChain::OpType> types;
+
+	mutable std::atomic<int> numCallsUntilTargetCheck { 0 };
+};
+
 #if INCLUDE_NATIVE_JIT
 
 struct HiseJavascriptEngine::RootObject::NativeJIT
@@ -22,6 +22,7 @@
 #include <hi_dsp_library/hi_dsp_library.h>
 #include <hi_lac/hi_lac.h>
 #include <hi_modules/hi_modules.h>
+#include <hi_native_jit/hi_native_jit.h>
 #include <hi_sampler/hi_sampler.h>
 #include <hi_scripting/hi_scripting.h>
 #include <juce_audio_basics/juce_audio_basics.h>
@@ -53,6 +53,38 @@ public:
 			quit();
 			return;
 		}
+		else if (commandLine.startsWith("benchmark"))
+		{
+			OfflineBenchmark::ErrorCodes result = OfflineBenchmark::benchmarkFromCommandLine(commandLine);
+
+			if (result != OfflineBenchmark::OK)
+			{
+				std::cout << std::endl << "==============================================================================" << std::endl;
+				std::cout << "BENCHMARK ERROR: " << OfflineBenchmark::getErrorMessage(result) << std::endl;
+				std::cout << "==============================================================================" << std::endl << std::endl;
+
+				exit((int)result);
+			}
+
+			quit();
+			return;
+		}
+		else if (commandLine.startsWith("trace"))
+		{
+			Result result = TraceRecorder::decodeFromCommandLine(commandLine);
+
+			if (!result.wasOk())
+			{
+				std::cout << std::endl << "==============================================================================" << std::endl;
+				std::cout << "TRACE ERROR: " << result.getErrorMessage() << std::endl;
+				std::cout << "==============================================================================" << std::endl << std::endl;
+
+				exit(1);
+			}
+
+			quit();
+			return;
+		}
 		else if (commandLine.startsWith("--help"))
 		{
 			std::cout << std::endl;
@@ -68,6 +100,20 @@ public:
 			std::cout << "          (Leave empty for standalone export)" << std::endl;
 			std::cout << "-a:{TEXT} sets the architecture ('x86', 'x64', 'x86x64')." << std::endl;
 			std::cout << "          (Leave empty on OSX for Universal binary.)" << std::endl << std::endl;
+			std::cout << "HISE benchmark \"File.hip\" -m:\"File.mid\" [-sr:RATE -bs:SIZE -t:THREADS -tail:SECONDS -realtime -o:\"Result.json\" -profile:\"Profile.json\"]" << std::endl << std::endl;
+			std::cout << "Options: " << std::endl << std::endl;
+			std::cout << "-m:{PATH}  the MIDI file that is rendered" << std::endl;
+			std::cout << "-sr:{NUM}  the sample rate (default 44100)" << std::endl;
+			std::cout << "-bs:{NUM}  the block size (default 512)" << std::endl;
+			std::cout << "-t:{NUM}   the number of instances that are rendered in parallel threads (default 1)" << std::endl;
+			std::cout << "-tail:{NUM} the seconds that are rendered after the last MIDI event (default 2)" << std::endl;
+			std::cout << "-realtime  renders at real time speed to measure streaming underruns" << std::endl;
+			std::cout << "-o:{PATH}  writes the JSON result to the given file instead of the console" << std::endl;
+			std::cout << "-profile:{PATH} writes the per processor CPU profile as JSON to the given file" << std::endl << std::endl;
+			std::cout << "HISE trace \"Debuglog.htrace\" [-chrome -o:\"Output.json\"]" << std::endl << std::endl;
+			std::cout << "Options: " << std::endl << std::endl;
+			std::cout << "-chrome    converts the trace into the JSON format of chrome://tracing instead of a timeline" << std::endl;
+			std::cout << "-o:{PATH}  writes the result to the given file instead of the console" << std::endl << std::endl;
 
 			quit();
 			return;